@@ -0,0 +1,359 @@
+/**
+ * @file booking_benchmarks.cpp
+ * @brief Microbenchmarks of the booking hot paths (Google Benchmark)
+ * @author Gebremedhin Abreha
+ *
+ * Covers Theater::bookSeat and FixedTheater::bookSeat, Theater::getAvailableSeats, Theater::findBestAvailable,
+ * MovieBookingService::bookSeats, bookBatch, getTheatersForMovie and addTheater over
+ * seat counts, theater counts and thread counts, and how catalog builds
+ * (AllocationEngine, single adds and the bulk service API) scale with catalog size. Build and run with
+ * 'make bench'; pass Google Benchmark flags (e.g. --benchmark_filter) when
+ * running booking_benchmarks directly.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "movie_booking_service.hpp"
+#include "allocation_engine.hpp"
+#include "theater.hpp"
+#include "fixed_theater.hpp"
+#include "movie.hpp"
+#include "seat.hpp"
+#include "test_service.hpp"
+
+namespace {
+
+constexpr int kMaxThreads = 8;              /**< Highest thread count benchmarked. */
+constexpr int kBookingsPerThread = 1 << 12; /**< Bookings per thread in service benchmarks. */
+
+/** @brief Movies in service benchmarks. */
+const std::vector<int> kMovieIds = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+
+std::unique_ptr<MovieBookingService> gService; /**< Service shared by the threads of a run. */
+std::atomic<int> gNextSeat{0};                 /**< Next seat of the shared theater. */
+int gNextTheaterId = 0;                        /**< Next ID for addTheater. */
+
+/*----------------------------------------------------*/
+// Theater::bookSeat on fresh seats; full theaters are replaced untimed
+void BM_TheaterBookSeat(benchmark::State& state)
+{
+    const int seatCount = static_cast<int>(state.range(0));
+    const auto seats = numberedSeats(seatCount);
+    const int poolSize = std::max(1, (1 << 18) / seatCount);
+
+    std::vector<std::unique_ptr<TheaterBase>> pool;
+    int theater = poolSize;
+    int seat = seatCount;
+    for (auto _ : state)
+    {
+        if (seat == seatCount)
+        {
+            seat = 0;
+            if (++theater >= poolSize)
+            {
+                state.PauseTiming();
+                pool.clear();
+                for (int i = 0; i < poolSize; ++i)
+                    pool.push_back(std::make_unique<Theater>(i, "Theater", seats));
+                theater = 0;
+                state.ResumeTiming();
+            }
+        }
+        benchmark::DoNotOptimize(pool[theater]->bookSeat(seat++));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TheaterBookSeat)->Arg(20)->Arg(1000)->Arg(100000);
+
+/*----------------------------------------------------*/
+// FixedTheater::bookSeat called directly, as BM_TheaterBookSeat
+template <std::size_t Capacity>
+void BM_FixedTheaterBookSeat(benchmark::State& state)
+{
+    const int seatCount = static_cast<int>(Capacity);
+    const auto seats = numberedSeats(seatCount);
+    const int poolSize = std::max(1, (1 << 18) / seatCount);
+
+    std::vector<std::unique_ptr<FixedTheater<Capacity>>> pool;
+    int theater = poolSize;
+    int seat = seatCount;
+    for (auto _ : state)
+    {
+        if (seat == seatCount)
+        {
+            seat = 0;
+            if (++theater >= poolSize)
+            {
+                state.PauseTiming();
+                pool.clear();
+                for (int i = 0; i < poolSize; ++i)
+                    pool.push_back(std::make_unique<FixedTheater<Capacity>>(i, "Theater", seats));
+                theater = 0;
+                state.ResumeTiming();
+            }
+        }
+        benchmark::DoNotOptimize(pool[theater]->bookSeat(seat++));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_FixedTheaterBookSeat, 20);
+BENCHMARK_TEMPLATE(BM_FixedTheaterBookSeat, 1000);
+
+/*----------------------------------------------------*/
+// Theater::getAvailableSeats with every other seat booked
+void BM_TheaterGetAvailableSeats(benchmark::State& state)
+{
+    const int seatCount = static_cast<int>(state.range(0));
+    Theater theater(1, "Theater", numberedSeats(seatCount));
+    for (int seat = 0; seat < seatCount; seat += 2)
+        theater.bookSeat(seat);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(theater.getAvailableSeats());
+    }
+    state.SetItemsProcessed(state.iterations() * seatCount);
+}
+BENCHMARK(BM_TheaterGetAvailableSeats)->Arg(20)->Arg(1000)->Arg(100000);
+
+/*----------------------------------------------------*/
+// Theater::findBestAvailable for a party of 4 in rows of 50, 90% sold at random
+void BM_TheaterFindBestAvailable(benchmark::State& state)
+{
+    const int seatCount = static_cast<int>(state.range(0));
+    auto seats = numberedSeats(seatCount);
+    for (int i = 0; i < seatCount; ++i)
+    {
+        seats[i].row = i / 50;
+        seats[i].position = i % 50;
+    }
+    Theater theater(1, "Theater", seats);
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> sold(0, 9);
+    for (int seat = 0; seat < seatCount; ++seat)
+    {
+        if (sold(random) != 0)
+            theater.bookSeat(seat);
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(theater.findBestAvailable(4));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TheaterFindBestAvailable)->Arg(1000)->Arg(10000)->Arg(100000);
+
+/*----------------------------------------------------*/
+// MovieBookingService::bookSeats, one theater per thread
+void BM_ServiceBookSeatsDisjoint(benchmark::State& state)
+{
+    // Thread 0 builds the service; the other threads wait at the loop start
+    if (state.thread_index() == 0)
+    {
+        const int theaterCount = std::max<int>(kMaxThreads, static_cast<int>(state.range(0)));
+        gService = makeService(kMovieIds, theaterCount, kBookingsPerThread, 0);
+    }
+
+    std::vector<int> seatIds(1);
+    int seat = 0;
+    for (auto _ : state)
+    {
+        seatIds[0] = seat++;
+        benchmark::DoNotOptimize(gService->bookSeats(state.thread_index(), seatIds));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ServiceBookSeatsDisjoint)
+    ->Arg(kMaxThreads)->Arg(256)
+    ->Iterations(kBookingsPerThread)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+/*----------------------------------------------------*/
+// MovieBookingService::bookSeats, every thread in the same theater
+void BM_ServiceBookSeatsShared(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+    {
+        gService = makeService(kMovieIds, 1, kBookingsPerThread * state.threads(), 0);
+        gNextSeat = 0;
+    }
+
+    std::vector<int> seatIds(1);
+    for (auto _ : state)
+    {
+        seatIds[0] = gNextSeat.fetch_add(1, std::memory_order_relaxed);
+        benchmark::DoNotOptimize(gService->bookSeats(0, seatIds));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ServiceBookSeatsShared)
+    ->Iterations(kBookingsPerThread)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+/*----------------------------------------------------*/
+// MovieBookingService::bookBatch over a flash sale of single-seat requests
+// spread over 16 theaters, in batches of range(0) requests; a sold out
+// service is replaced untimed
+void BM_ServiceBookBatch(benchmark::State& state)
+{
+    constexpr int kTheaters = 16;
+    constexpr int kRequests = 1 << 14;
+    const auto batchSize = static_cast<std::size_t>(state.range(0));
+
+    std::vector<std::vector<MovieBookingService::BookingRequest>> batches(1);
+    for (int i = 0; i < kRequests; ++i)
+    {
+        if (batches.back().size() == batchSize)
+            batches.emplace_back();
+        batches.back().push_back({static_cast<std::uint64_t>(i), i % kTheaters, {i / kTheaters}});
+    }
+
+    auto service = makeService(kMovieIds, kTheaters, kRequests / kTheaters, 0);
+    std::size_t next = 0;
+    for (auto _ : state)
+    {
+        if (next == batches.size())
+        {
+            state.PauseTiming();
+            service = makeService(kMovieIds, kTheaters, kRequests / kTheaters, 0);
+            next = 0;
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(service->bookBatch(batches[next++]));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batchSize));
+}
+BENCHMARK(BM_ServiceBookBatch)->Arg(1)->Arg(64)->Arg(1024);
+
+/*----------------------------------------------------*/
+// MovieBookingService::getTheatersForMovie over catalog sizes
+void BM_ServiceGetTheatersForMovie(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+        gService = makeService(kMovieIds, static_cast<int>(state.range(0)), 20, 0);
+
+    int movieId = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(gService->getTheatersForMovie(movieId));
+        movieId = movieId % static_cast<int>(kMovieIds.size()) + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ServiceGetTheatersForMovie)
+    ->Arg(16)->Arg(1000)->Arg(100000)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+/*----------------------------------------------------*/
+// MovieBookingService::addTheater into catalogs of increasing size
+void BM_ServiceAddTheater(benchmark::State& state)
+{
+    gService = makeService(kMovieIds, static_cast<int>(state.range(0)), 20, 0);
+    gNextTheaterId = static_cast<int>(state.range(0));
+
+    const auto seats = numberedSeats(20);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(gService->addTheater(std::make_unique<Theater>(gNextTheaterId++, "Theater", seats)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ServiceAddTheater)
+    ->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)
+    ->Iterations(1000);
+
+/*----------------------------------------------------*/
+// Catalog of n theaters through single addTheater calls, after the benchmark movies
+void BM_ServiceAddTheatersOneByOne(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    const auto layout = std::make_shared<const SeatLayout>(numberedSeats(20));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<std::unique_ptr<TheaterBase>> theaters;
+        for (int id = 0; id < count; ++id)
+            theaters.push_back(std::make_unique<Theater>(id, "Theater", layout));
+        MovieBookingService service;
+        for (const int id : kMovieIds)
+            service.addMovie(std::make_unique<Movie>(id, "Movie"));
+        state.ResumeTiming();
+
+        for (auto& theater : theaters)
+            benchmark::DoNotOptimize(service.addTheater(std::move(theater)));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetComplexityN(count);
+}
+BENCHMARK(BM_ServiceAddTheatersOneByOne)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 16)
+    ->Complexity(benchmark::oN);
+
+/*----------------------------------------------------*/
+// AllocationEngine: n theaters then n movies, each movie paired with a theater
+void BM_AllocationEngineBuild(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        AllocationEngine engine;
+        for (int id = 0; id < count; ++id)
+            engine.addTheater(id);
+        for (int id = 0; id < count; ++id)
+        {
+            engine.addMovie(id);
+            benchmark::DoNotOptimize(engine.allocateNext());
+        }
+        benchmark::DoNotOptimize(engine.isShownIn(count - 1, count - 1));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetComplexityN(count);
+}
+BENCHMARK(BM_AllocationEngineBuild)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 19)
+    ->Complexity(benchmark::oN);
+
+/*----------------------------------------------------*/
+// Catalog of n theaters and n/2 movies through addTheaters and addMovies
+void BM_ServiceBuildCatalog(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    const auto layout = std::make_shared<const SeatLayout>(numberedSeats(20));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<std::unique_ptr<TheaterBase>> theaters;
+        for (int id = 0; id < count; ++id)
+            theaters.push_back(std::make_unique<Theater>(id, "Theater", layout));
+        std::vector<std::unique_ptr<Movie>> movies;
+        for (int id = 0; id < count / 2; ++id)
+            movies.push_back(std::make_unique<Movie>(id, "Movie"));
+        MovieBookingService service;
+        state.ResumeTiming();
+
+        service.addTheaters(std::move(theaters));
+        service.addMovies(std::move(movies));
+        benchmark::DoNotOptimize(service.isMovieShownInTheater(0, 0));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetComplexityN(count);
+}
+BENCHMARK(BM_ServiceBuildCatalog)
+    ->RangeMultiplier(8)->Range(1 << 10, 1 << 16)
+    ->Complexity(benchmark::oN);
+
+} // namespace
+
+BENCHMARK_MAIN();
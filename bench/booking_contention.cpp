@@ -0,0 +1,162 @@
+/**
+ * @file booking_contention.cpp
+ * @brief Contention benchmark: bookSeats throughput vs number of threads
+ * @author Gebremedhin Abreha
+ *
+ * Every thread books single seats in its own theater, so the only thing the
+ * threads share is the service's synchronization. Throughput that stays flat
+ * as threads are added means bookings are serialized.
+ *
+ * With a log path the service is durable: every booking is appended to the
+ * write-ahead log and acknowledged only once synced (group commit).
+ *
+ * Each round is run twice: with the threads calling bookSeats directly, and
+ * with the threads submitting to a BookingPipeline with one worker per
+ * thread, keeping up to kPipelineWindow bookings in flight each.
+ *
+ * Usage: booking_contention [maxThreads] [bookingsPerThread] [logPath]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "movie_booking_service.hpp"
+#include "booking_pipeline.hpp"
+#include "theater.hpp"
+#include "movie.hpp"
+#include "seat.hpp"
+
+namespace {
+
+constexpr std::size_t kPipelineWindow = 256; /**< Pipelined bookings in flight per thread. */
+
+/**
+ * @brief Build a service with one movie and one theater per thread.
+ */
+std::unique_ptr<MovieBookingService> makeService(int theaterCount, int seatCapacity, const std::string& logPath)
+{
+    const auto seats = numberedSeats(seatCapacity);
+
+    std::unique_ptr<MovieBookingService> service;
+    if (logPath.empty())
+    {
+        service = std::make_unique<MovieBookingService>();
+    }
+    else
+    {
+        // Start from an empty log every round
+        for (const auto& suffix : {"", ".old", ".checkpoint"})
+            std::remove((logPath + suffix).c_str());
+        service = std::make_unique<MovieBookingService>(logPath);
+    }
+    service->addMovie(std::make_unique<Movie>(1, "Movie01"));
+    for (int id = 0; id < theaterCount; ++id)
+    {
+        service->addTheater(std::make_unique<Theater>(id, "Theater" + std::to_string(id), seats));
+    }
+    return service;
+}
+
+/**
+ * @brief Run one round and return bookings per second.
+ */
+double runRound(int threadCount, int bookingsPerThread, const std::string& logPath)
+{
+    auto service = makeService(threadCount, bookingsPerThread, logPath);
+
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threadCount; ++t)
+    {
+        workers.emplace_back([&service, t, bookingsPerThread]() {
+            std::vector<int> seatIds(1);
+            for (int seatId = 0; seatId < bookingsPerThread; ++seatId)
+            {
+                seatIds[0] = seatId;
+                service->bookSeats(t, seatIds);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(threadCount) * bookingsPerThread / elapsed.count();
+}
+
+/**
+ * @brief Run one round through a BookingPipeline and return bookings per second.
+ */
+double runPipelinedRound(int threadCount, int bookingsPerThread, const std::string& logPath)
+{
+    auto service = makeService(threadCount, bookingsPerThread, logPath);
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        BookingPipeline pipeline(*service, static_cast<std::size_t>(threadCount));
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            workers.emplace_back([&pipeline, t, bookingsPerThread]() {
+                std::deque<std::future<BookingPipeline::Result>> inFlight;
+                for (int seatId = 0; seatId < bookingsPerThread; ++seatId)
+                {
+                    inFlight.push_back(pipeline.submit({static_cast<std::uint64_t>(seatId), t, {seatId}}));
+                    if (inFlight.size() == kPipelineWindow)
+                    {
+                        inFlight.front().get();
+                        inFlight.pop_front();
+                    }
+                }
+                for (auto& booking : inFlight)
+                {
+                    booking.get();
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(threadCount) * bookingsPerThread / elapsed.count();
+}
+
+} // namespace
+
+/**
+ * @brief Benchmark entry point.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit code.
+ */
+int main(int argc, const char * argv[]) {
+
+    const int maxThreads = argc > 1 ? std::atoi(argv[1]) : 8;
+    const int bookingsPerThread = argc > 2 ? std::atoi(argv[2]) : 200000;
+    const std::string logPath = argc > 3 ? argv[3] : "";
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "durability: " << (logPath.empty() ? "off" : "write-ahead log at " + logPath) << std::endl;
+    std::cout << "threads  bookings/s  pipelined/s" << std::endl;
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        std::cout << threads << "\t " << static_cast<long long>(runRound(threads, bookingsPerThread, logPath))
+                  << "\t     " << static_cast<long long>(runPipelinedRound(threads, bookingsPerThread, logPath))
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,425 @@
+/**
+ * @file load_generator.cpp
+ * @brief Flash-sale load generator: throughput, tail latency and conflicts per operation
+ * @author Gebremedhin Abreha
+ *
+ * N simulated users run in closed loop against one MovieBookingService,
+ * each in its own thread. Every step a user browses (getTheatersForMovie,
+ * then getAvailableSeats), holds seats and then confirms or releases them,
+ * or books seats directly, in the configured mix. Seat requests are runs
+ * of adjacent seats at a random position, and a configurable share of the
+ * traffic goes to a few hot theaters, so theaters sell out and requests
+ * start to conflict as they would in a flash sale.
+ *
+ * For every operation the run reports throughput, latency percentiles
+ * (p50, p99, p99.9, max) and the share of requests that failed because a
+ * seat was taken (for confirm, because the hold had expired; for browse,
+ * because the theater was sold out).
+ *
+ * Usage: load_generator [--option=value ...]; see usage() for the options.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "movie_booking_service.hpp"
+#include "latency_histogram.hpp"
+#include "theater.hpp"
+#include "movie.hpp"
+#include "seat.hpp"
+
+namespace {
+
+/**
+ * @brief Operations timed by the load generator.
+ */
+enum Operation : std::size_t {
+    Browse,   /**< getTheatersForMovie and getAvailableSeats. */
+    Hold,     /**< holdSeats. */
+    Confirm,  /**< confirmHold of a successful hold. */
+    Release,  /**< releaseHold of a successful hold. */
+    Book,     /**< bookSeats. */
+    kOperationCount
+};
+
+const char* const kOperationNames[kOperationCount] = {"browse", "hold", "confirm", "release", "book"};
+
+/**
+ * @struct Options
+ * @brief Load generator configuration.
+ */
+struct Options {
+    int users = 8;              /**< Concurrent simulated users (threads). */
+    double durationSeconds = 5; /**< Length of the run. */
+    int movies = 16;            /**< Movies in the catalog. */
+    int theaters = 100;         /**< Theaters in the catalog. */
+    int seats = 1000;           /**< Seats per theater. */
+    int browseWeight = 60;      /**< Relative weight of browse steps. */
+    int holdWeight = 20;        /**< Relative weight of hold steps. */
+    int bookWeight = 20;        /**< Relative weight of direct book steps. */
+    int confirmPercent = 70;    /**< Share of successful holds that are confirmed, the rest are released. */
+    int hotTheaters = 1;        /**< Theaters receiving the hot share of traffic. */
+    int hotPercent = 80;        /**< Share of steps aimed at the hot theaters. */
+    int minSeats = 1;           /**< Smallest seat request. */
+    int maxSeats = 4;           /**< Largest seat request. */
+    int holdTtlMs = 5000;       /**< Time to live of holds. */
+    int thinkMicros = 0;        /**< Pause between a user's steps. */
+    std::uint64_t seed = 1;     /**< Random seed; user u uses seed + u. */
+    std::string logPath;        /**< Write-ahead log path; empty for a non-durable service. */
+};
+
+/**
+ * @struct UserStats
+ * @brief Latencies and conflicts recorded by one user.
+ */
+struct UserStats {
+    std::array<LatencyHistogram, kOperationCount> latency; /**< Latency in nanoseconds per operation. */
+    std::array<std::uint64_t, kOperationCount> conflicts{}; /**< Failed requests per operation. */
+};
+
+/**
+ * @brief Print the usage message and return the failure exit code.
+ */
+int usage()
+{
+    const Options defaults;
+    std::cerr << "Usage: load_generator [--option=value ...]" << std::endl
+              << "  --users=N          concurrent simulated users (" << defaults.users << ")" << std::endl
+              << "  --duration=S       run length in seconds (" << defaults.durationSeconds << ")" << std::endl
+              << "  --movies=N         movies in the catalog (" << defaults.movies << ")" << std::endl
+              << "  --theaters=N       theaters in the catalog (" << defaults.theaters << ")" << std::endl
+              << "  --seats=N          seats per theater (" << defaults.seats << ")" << std::endl
+              << "  --mix=B:H:K        browse:hold:book step weights (" << defaults.browseWeight << ":"
+              << defaults.holdWeight << ":" << defaults.bookWeight << ")" << std::endl
+              << "  --confirm=P        percent of holds confirmed, the rest released (" << defaults.confirmPercent << ")" << std::endl
+              << "  --hot-theaters=N   theaters taking the hot share (" << defaults.hotTheaters << ")" << std::endl
+              << "  --hot-share=P      percent of steps aimed at hot theaters (" << defaults.hotPercent << ")" << std::endl
+              << "  --request=MIN:MAX  seats per hold or booking (" << defaults.minSeats << ":" << defaults.maxSeats << ")" << std::endl
+              << "  --hold-ttl=MS      hold time to live (" << defaults.holdTtlMs << ")" << std::endl
+              << "  --think=US         pause between a user's steps (" << defaults.thinkMicros << ")" << std::endl
+              << "  --seed=N           random seed (" << defaults.seed << ")" << std::endl
+              << "  --log=PATH         make the service durable with a write-ahead log at PATH" << std::endl;
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Split "a:b[:c]" into integers.
+ *
+ * @return True if the value has exactly count integer fields.
+ */
+bool parseFields(const std::string& value, std::size_t count, std::vector<int>& fields)
+{
+    fields.clear();
+    std::size_t start = 0;
+    while (true)
+    {
+        const auto end = value.find(':', start);
+        const auto field = value.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (field.empty() || field.find_first_not_of("0123456789") != std::string::npos)
+            return false;
+        fields.push_back(std::atoi(field.c_str()));
+        if (end == std::string::npos)
+            break;
+        start = end + 1;
+    }
+    return fields.size() == count;
+}
+
+/**
+ * @brief Parse the command line into options.
+ *
+ * @return True if every argument is a known, well-formed option.
+ */
+bool parseOptions(int argc, const char * argv[], Options& options)
+{
+    std::vector<int> fields;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const auto equals = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || equals == std::string::npos)
+            return false;
+        const std::string name = arg.substr(2, equals - 2);
+        const std::string value = arg.substr(equals + 1);
+
+        if (name == "users") options.users = std::atoi(value.c_str());
+        else if (name == "duration") options.durationSeconds = std::atof(value.c_str());
+        else if (name == "movies") options.movies = std::atoi(value.c_str());
+        else if (name == "theaters") options.theaters = std::atoi(value.c_str());
+        else if (name == "seats") options.seats = std::atoi(value.c_str());
+        else if (name == "confirm") options.confirmPercent = std::atoi(value.c_str());
+        else if (name == "hot-theaters") options.hotTheaters = std::atoi(value.c_str());
+        else if (name == "hot-share") options.hotPercent = std::atoi(value.c_str());
+        else if (name == "hold-ttl") options.holdTtlMs = std::atoi(value.c_str());
+        else if (name == "think") options.thinkMicros = std::atoi(value.c_str());
+        else if (name == "seed") options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (name == "log") options.logPath = value;
+        else if (name == "mix")
+        {
+            if (!parseFields(value, 3, fields))
+                return false;
+            options.browseWeight = fields[0];
+            options.holdWeight = fields[1];
+            options.bookWeight = fields[2];
+        }
+        else if (name == "request")
+        {
+            if (!parseFields(value, 2, fields))
+                return false;
+            options.minSeats = fields[0];
+            options.maxSeats = fields[1];
+        }
+        else
+            return false;
+    }
+
+    return options.users > 0 && options.durationSeconds > 0 && options.movies > 0 &&
+           options.theaters > 0 && options.seats > 0 &&
+           options.browseWeight + options.holdWeight + options.bookWeight > 0 &&
+           options.hotTheaters > 0 && options.hotTheaters <= options.theaters &&
+           options.hotPercent >= 0 && options.hotPercent <= 100 &&
+           options.confirmPercent >= 0 && options.confirmPercent <= 100 &&
+           options.minSeats > 0 && options.minSeats <= options.maxSeats && options.maxSeats <= options.seats &&
+           options.holdTtlMs > 0 && options.thinkMicros >= 0;
+}
+
+/**
+ * @brief Build a service with the configured catalog, loaded in bulk.
+ */
+std::unique_ptr<MovieBookingService> makeService(const Options& options)
+{
+    const auto seats = numberedSeats(options.seats);
+
+    std::unique_ptr<MovieBookingService> service;
+    if (options.logPath.empty())
+    {
+        service = std::make_unique<MovieBookingService>();
+    }
+    else
+    {
+        // Start from an empty log every run
+        for (const auto& suffix : {"", ".old", ".checkpoint"})
+            std::remove((options.logPath + suffix).c_str());
+        service = std::make_unique<MovieBookingService>(options.logPath);
+    }
+
+    std::vector<std::unique_ptr<Movie>> movies;
+    for (int id = 1; id <= options.movies; ++id)
+    {
+        movies.push_back(std::make_unique<Movie>(id, "Movie" + std::to_string(id)));
+    }
+    std::vector<std::unique_ptr<TheaterBase>> theaters;
+    for (int id = 0; id < options.theaters; ++id)
+    {
+        theaters.push_back(std::make_unique<Theater>(id, "Theater" + std::to_string(id), seats));
+    }
+    service->addMovies(std::move(movies));
+    service->addTheaters(std::move(theaters));
+    return service;
+}
+
+/**
+ * @brief Nanoseconds elapsed since start.
+ */
+std::uint64_t elapsedNanos(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+/**
+ * @brief Run one simulated user until stop is set.
+ */
+void runUser(MovieBookingService& service, const Options& options, std::uint64_t seed,
+             const std::atomic<bool>& stop, UserStats& stats)
+{
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> pickStep(0, options.browseWeight + options.holdWeight + options.bookWeight - 1);
+    std::uniform_int_distribution<int> pickPercent(0, 99);
+    std::uniform_int_distribution<int> pickHot(0, options.hotTheaters - 1);
+    std::uniform_int_distribution<int> pickAny(0, options.theaters - 1);
+    std::uniform_int_distribution<int> pickMovie(1, options.movies);
+    std::uniform_int_distribution<int> pickSize(options.minSeats, options.maxSeats);
+    const std::chrono::milliseconds holdTtl(options.holdTtlMs);
+
+    std::vector<int> seatIds;
+    seatIds.reserve(options.maxSeats);
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        const int theaterId = pickPercent(random) < options.hotPercent ? pickHot(random) : pickAny(random);
+        const int step = pickStep(random);
+
+        if (step < options.browseWeight)
+        {
+            const int movieId = pickMovie(random);
+            const auto start = std::chrono::steady_clock::now();
+            service.getTheatersForMovie(movieId);
+            const auto availableSeats = service.getAvailableSeats(theaterId);
+            stats.latency[Browse].record(elapsedNanos(start));
+            // A browse "conflicts" when the theater is sold out
+            if (availableSeats.empty())
+                ++stats.conflicts[Browse];
+        }
+        else
+        {
+            // A run of adjacent seats at a random position
+            const int size = pickSize(random);
+            const int first = std::uniform_int_distribution<int>(0, options.seats - size)(random);
+            seatIds.clear();
+            for (int seatId = first; seatId < first + size; ++seatId)
+            {
+                seatIds.push_back(seatId);
+            }
+
+            if (step < options.browseWeight + options.holdWeight)
+            {
+                auto start = std::chrono::steady_clock::now();
+                const auto holdId = service.holdSeats(theaterId, seatIds, holdTtl);
+                stats.latency[Hold].record(elapsedNanos(start));
+                if (holdId)
+                {
+                    const Operation decision = pickPercent(random) < options.confirmPercent ? Confirm : Release;
+                    start = std::chrono::steady_clock::now();
+                    const bool decided = decision == Confirm ? service.confirmHold(*holdId) : service.releaseHold(*holdId);
+                    stats.latency[decision].record(elapsedNanos(start));
+                    if (!decided)
+                        ++stats.conflicts[decision];
+                }
+                else
+                {
+                    ++stats.conflicts[Hold];
+                }
+            }
+            else
+            {
+                const auto start = std::chrono::steady_clock::now();
+                const bool booked = service.bookSeats(theaterId, seatIds);
+                stats.latency[Book].record(elapsedNanos(start));
+                if (!booked)
+                    ++stats.conflicts[Book];
+            }
+        }
+
+        if (options.thinkMicros > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(options.thinkMicros));
+    }
+}
+
+/**
+ * @brief Format nanoseconds as microseconds.
+ */
+std::string micros(std::uint64_t nanos)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << static_cast<double>(nanos) / 1000.0;
+    return out.str();
+}
+
+/**
+ * @brief Print the per-operation report of a run.
+ */
+void report(const Options& options, const UserStats& total, double seconds, std::size_t seatsLeft)
+{
+    std::cout << "users: " << options.users << "  theaters: " << options.theaters
+              << " (" << options.hotTheaters << " hot, " << options.hotPercent << "% of steps)"
+              << "  seats/theater: " << options.seats
+              << "  mix browse:hold:book " << options.browseWeight << ":" << options.holdWeight << ":" << options.bookWeight
+              << "  request " << options.minSeats << "-" << options.maxSeats << " seats" << std::endl;
+    std::cout << "elapsed: " << std::fixed << std::setprecision(2) << seconds << " s"
+              << "  seats left: " << seatsLeft << " of "
+              << static_cast<std::uint64_t>(options.theaters) * static_cast<std::uint64_t>(options.seats) << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::left << std::setw(9) << "op" << std::right
+              << std::setw(12) << "count" << std::setw(12) << "ops/s" << std::setw(11) << "conflict%"
+              << std::setw(11) << "p50 us" << std::setw(11) << "p99 us" << std::setw(11) << "p99.9 us"
+              << std::setw(11) << "max us" << std::endl;
+
+    std::uint64_t allCount = 0;
+    for (std::size_t op = 0; op < kOperationCount; ++op)
+    {
+        const auto& histogram = total.latency[op];
+        const std::uint64_t count = histogram.count();
+        allCount += count;
+        const double conflictPercent = count == 0 ? 0.0 : 100.0 * static_cast<double>(total.conflicts[op]) / static_cast<double>(count);
+
+        std::cout << std::left << std::setw(9) << kOperationNames[op] << std::right
+                  << std::setw(12) << count
+                  << std::setw(12) << static_cast<std::uint64_t>(static_cast<double>(count) / seconds)
+                  << std::setw(11) << std::fixed << std::setprecision(2) << conflictPercent
+                  << std::setw(11) << micros(histogram.percentile(0.5))
+                  << std::setw(11) << micros(histogram.percentile(0.99))
+                  << std::setw(11) << micros(histogram.percentile(0.999))
+                  << std::setw(11) << micros(histogram.max()) << std::endl;
+    }
+    std::cout << std::left << std::setw(9) << "total" << std::right << std::setw(12) << allCount
+              << std::setw(12) << static_cast<std::uint64_t>(static_cast<double>(allCount) / seconds) << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief Load generator entry point.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit code.
+ */
+int main(int argc, const char * argv[]) {
+
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return usage();
+
+    auto service = makeService(options);
+
+    std::vector<UserStats> stats(options.users);
+    std::vector<std::thread> users;
+    std::atomic<bool> stop{false};
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int user = 0; user < options.users; ++user)
+    {
+        users.emplace_back(runUser, std::ref(*service), std::cref(options), options.seed + user,
+                           std::cref(stop), std::ref(stats[user]));
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.durationSeconds));
+    stop = true;
+    for (auto& user : users)
+    {
+        user.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    UserStats total;
+    for (const auto& userStats : stats)
+    {
+        for (std::size_t op = 0; op < kOperationCount; ++op)
+        {
+            total.latency[op].merge(userStats.latency[op]);
+            total.conflicts[op] += userStats.conflicts[op];
+        }
+    }
+
+    std::size_t seatsLeft = 0;
+    for (int theaterId = 0; theaterId < options.theaters; ++theaterId)
+    {
+        seatsLeft += service->getAvailableSeats(theaterId).size();
+    }
+
+    report(options, total, elapsed.count(), seatsLeft);
+    return EXIT_SUCCESS;
+}
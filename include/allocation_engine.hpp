@@ -0,0 +1,132 @@
+/**
+ * @file allocation_engine.hpp
+ * @brief Constant-time bookkeeping of which movie each theater shows.
+ * @author Gebremedhin Abreha
+ */
+#ifndef ALLOCATION_ENGINE_HPP
+#define ALLOCATION_ENGINE_HPP
+
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+#include "id_table.hpp"
+#include "shared_vector.hpp"
+
+/**
+ * @class AllocationEngine
+ * @brief Allocations of movies to theaters with O(1) updates and lookups.
+ *
+ * A theater shows at most one movie; a movie can be shown in many theaters.
+ * The engine keeps the allocations both ways (movie -> theaters and
+ * theater -> movie) in IdTables, plus the theaters and the movies in the
+ * order they were added with a cursor each to the longest free theater and
+ * the longest waiting movie, so pairing the two never scans the catalog.
+ * Entries allocated explicitly through allocate() are passed over lazily
+ * when a cursor reaches them.
+ *
+ * Everything is held in IdTables and SharedVectors, so copying an engine is
+ * O(1) and updating the copy leaves the original as it was.
+ *
+ * The engine only knows IDs: the caller checks that movies and theaters
+ * exist and adds each ID once.
+ */
+class AllocationEngine {
+public:
+    using Allocation = std::pair<int, int>; /**< Movie ID and theater ID. */
+
+    /**
+     * @brief Register a movie, shown nowhere yet.
+     *
+     * @param movieId The ID of the movie.
+     */
+    void addMovie(int movieId);
+
+    /**
+     * @brief Register a theater, showing nothing yet.
+     *
+     * @param theaterId The ID of the theater.
+     */
+    void addTheater(int theaterId);
+
+    /**
+     * @brief Allocate a movie to a theater.
+     *
+     * @param movieId The ID of the movie.
+     * @param theaterId The ID of the theater.
+     * @return True if allocated, false if the theater already shows a movie.
+     */
+    bool allocate(int movieId, int theaterId);
+
+    /**
+     * @brief Allocate the longest waiting movie to the longest free theater.
+     *
+     * @return The allocation made, or std::nullopt if no movie is waiting or
+     *         no theater is free.
+     */
+    std::optional<Allocation> allocateNext();
+
+    /**
+     * @brief Allocate a randomly picked movie to the longest free theater.
+     *
+     * @param random The random number generator to pick the movie with.
+     * @return The allocation made, or std::nullopt if there are no movies or
+     *         no theater is free.
+     */
+    std::optional<Allocation> fillNext(std::mt19937& random);
+
+    /**
+     * @brief Get the theaters a movie is allocated to.
+     *
+     * @param movieId The ID of the movie.
+     * @return The theater IDs in allocation order; empty if none.
+     */
+    std::vector<int> getTheaters(int movieId) const;
+
+    /**
+     * @brief Append the theaters a movie is allocated to to a caller's vector.
+     *
+     * @param movieId The ID of the movie.
+     * @param theaterIds Receives the theater IDs in allocation order.
+     */
+    void appendTheaters(int movieId, std::vector<int>& theaterIds) const;
+
+    /**
+     * @brief Get the movie a theater shows.
+     *
+     * @param theaterId The ID of the theater.
+     * @return The movie ID, or std::nullopt if the theater shows nothing.
+     */
+    std::optional<int> getMovie(int theaterId) const;
+
+    /**
+     * @brief Check if a movie is allocated to a theater.
+     */
+    bool isShownIn(int theaterId, int movieId) const;
+
+    /**
+     * @brief Check if a movie is allocated to at least one theater.
+     */
+    bool isMovieAllocated(int movieId) const;
+
+    /**
+     * @brief Check if a theater shows a movie.
+     */
+    bool isTheaterAllocated(int theaterId) const;
+
+private:
+    /**
+     * @brief Move the cursors past allocated entries.
+     */
+    void skipAllocated();
+
+    IdTable<SharedVector<int>> mMovieTheaters; /**< Movie ID -> theater IDs, allocated movies only. */
+    IdTable<int> mTheaterMovies;               /**< Theater ID -> movie ID, allocated theaters only. */
+    SharedVector<int> mTheaterIds;             /**< Every theater, in the order added. */
+    SharedVector<int> mMovieIds;               /**< Every movie, in the order added; also for random picks. */
+    std::size_t mNextFreeTheater = 0;          /**< No theater before this position of mTheaterIds is free. */
+    std::size_t mNextWaitingMovie = 0;         /**< No movie before this position of mMovieIds is waiting. */
+};
+
+#endif /* ALLOCATION_ENGINE_HPP */
@@ -0,0 +1,95 @@
+/**
+ * @file booking_client.hpp
+ * @brief Blocking client for BookingServer.
+ * @author Gebremedhin Abreha
+ */
+#ifndef BOOKING_CLIENT_HPP
+#define BOOKING_CLIENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @class BookingClient
+ * @brief One connection to a BookingServer, over TCP or a Unix socket.
+ *
+ * call() sends a request and waits for its response. To pipeline, send()
+ * several requests and then receive() their responses in the same order;
+ * requests are buffered until a receive() or flush().
+ *
+ * @note Methods throw std::system_error on socket errors and
+ *       std::runtime_error if the server closed the connection.
+ */
+class BookingClient {
+public:
+    /**
+     * @brief Constructor, connects over TCP.
+     *
+     * @param host IPv4 address of the server.
+     * @param port TCP port of the server.
+     */
+    BookingClient(const std::string& host, std::uint16_t port);
+
+    /**
+     * @brief Constructor, connects to a Unix socket.
+     *
+     * @param unixPath Path of the server's socket.
+     */
+    explicit BookingClient(const std::string& unixPath);
+
+    /**
+     * @brief Destructor, closes the connection.
+     */
+    ~BookingClient();
+
+    /**
+     * @brief Connect to a server given as "host:port" or as a Unix socket path.
+     *
+     * @param address The server; anything containing a '/' is a socket path.
+     * @return The connected client.
+     */
+    static BookingClient connect(const std::string& address);
+
+    BookingClient(BookingClient&& other) noexcept;
+    BookingClient& operator=(BookingClient&& other) noexcept;
+    BookingClient(const BookingClient&) = delete;
+    BookingClient& operator=(const BookingClient&) = delete;
+
+    /**
+     * @brief Send a request and wait for its response.
+     *
+     * @param request The request line, without terminator.
+     * @return The response line, without terminator.
+     */
+    std::string call(std::string_view request);
+
+    /**
+     * @brief Queue a request without waiting for its response.
+     */
+    void send(std::string_view request);
+
+    /**
+     * @brief Send every queued request.
+     */
+    void flush();
+
+    /**
+     * @brief Wait for the response to the oldest unanswered request.
+     */
+    std::string receive();
+
+private:
+    /**
+     * @brief Take ownership of a connected socket.
+     */
+    explicit BookingClient(int fd);
+
+    int mFd = -1;            /**< The socket. */
+    std::string mOutput;     /**< Requests not sent yet. */
+    std::string mInput;      /**< Bytes received and not returned yet. */
+    std::size_t mConsumed = 0; /**< Bytes of mInput already returned. */
+};
+
+#endif /* BOOKING_CLIENT_HPP */
@@ -0,0 +1,125 @@
+/**
+ * @file booking_pipeline.hpp
+ * @brief Asynchronous bookings through per-shard worker threads.
+ * @author Gebremedhin Abreha
+ */
+#ifndef BOOKING_PIPELINE_HPP
+#define BOOKING_PIPELINE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "movie_booking_service.hpp"
+
+/**
+ * @class BookingPipeline
+ * @brief Books seats asynchronously, one worker thread per shard of theaters.
+ *
+ * Theaters are split into shards by ID and every booking is queued to the
+ * shard owning its theater, so each theater is booked by a single thread
+ * and its seat claims never contend. Callers never block: they get a
+ * std::future that completes once the booking is applied (and, for a
+ * durable service, logged).
+ *
+ * The queues are lock-free multi-producer single-consumer lists. A worker
+ * takes everything queued since its last pass in one exchange and books it
+ * with a single MovieBookingService::bookBatch call, so a burst costs one
+ * snapshot read and at most one log append per shard. Idle workers sleep
+ * until a request arrives.
+ *
+ * Bookings made directly on the service still work alongside the pipeline
+ * and stay all or nothing; they just contend with the shard's worker.
+ */
+class BookingPipeline {
+public:
+    using Result = MovieBookingService::BookingResult; /**< Outcome of one booking. */
+
+    /**
+     * @brief Constructor, starts the workers.
+     *
+     * @param service The service to book in; must outlive the pipeline.
+     * @param shards Number of shards and worker threads; 0 means one per
+     *               hardware thread.
+     * @param pinWorkers True to pin worker i to CPU i modulo the number of
+     *                   CPUs (Linux only; ignored elsewhere).
+     */
+    explicit BookingPipeline(MovieBookingService& service, std::size_t shards = 0, bool pinWorkers = false);
+
+    /**
+     * @brief Destructor, books whatever is still queued and stops the workers.
+     */
+    ~BookingPipeline();
+
+    BookingPipeline(const BookingPipeline&) = delete;
+    BookingPipeline& operator=(const BookingPipeline&) = delete;
+
+    /**
+     * @brief Queue a booking.
+     *
+     * Bookings submitted by one thread for one theater are applied in the
+     * order submitted.
+     *
+     * @param request The booking; its request ID is echoed in the result.
+     * @return The result as MovieBookingService::bookBatch reports it. The
+     *         future holds the exception instead if booking threw (e.g. the
+     *         log failed).
+     */
+    std::future<Result> submit(MovieBookingService::BookingRequest request);
+
+    /**
+     * @brief Get the number of shards.
+     */
+    std::size_t shardCount() const;
+
+    /**
+     * @brief Get the shard owning a theater.
+     */
+    std::size_t shardOf(int theaterId) const;
+
+private:
+    /**
+     * @struct Request
+     * @brief A queued booking, linked into its shard's queue.
+     */
+    struct Request {
+        MovieBookingService::BookingRequest booking; /**< The booking. */
+        std::promise<Result> promise;                /**< Completed by the worker. */
+        Request* next = nullptr;                     /**< Request queued before this one. */
+    };
+
+    /**
+     * @struct Shard
+     * @brief A worker and its queue, on cache lines of its own.
+     */
+    struct alignas(64) Shard {
+        std::atomic<Request*> head{nullptr}; /**< Most recently queued request. */
+        std::atomic<bool> sleeping{false};   /**< True while the worker waits for requests. */
+        std::mutex mutex;                    /**< Guards the worker's sleep. */
+        std::condition_variable wake;        /**< Signalled when a request arrives or on stop. */
+        std::thread worker;                  /**< Thread booking the shard's requests. */
+    };
+
+    /**
+     * @brief Worker loop of a shard.
+     */
+    void run(Shard& shard);
+
+    /**
+     * @brief Book a list of requests taken off a queue and complete them.
+     *
+     * @param newest The most recently queued request; the list is in
+     *               reverse order of queueing.
+     */
+    void process(Request* newest);
+
+    MovieBookingService& mService;              /**< Service to book in. */
+    std::vector<std::unique_ptr<Shard>> mShards; /**< Shards, by index. */
+    std::atomic<bool> mStopping{false};          /**< Set by the destructor. */
+};
+
+#endif /* BOOKING_PIPELINE_HPP */
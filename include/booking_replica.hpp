@@ -0,0 +1,144 @@
+/**
+ * @file booking_replica.hpp
+ * @brief Read replica of a primary booking server, kept current by log shipping.
+ * @author Gebremedhin Abreha
+ */
+#ifndef BOOKING_REPLICA_HPP
+#define BOOKING_REPLICA_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "booking_client.hpp"
+#include "movie_booking_service.hpp"
+#include "service_protocol.hpp"
+
+/**
+ * @class BookingReplica
+ * @brief Mirrors a primary's MovieBookingService and serves reads from the copy.
+ *
+ * The primary is a BookingServer whose service enabled replication. A
+ * follower thread loads a snapshot (REPL_SNAPSHOT), then pulls the records
+ * logged after it (REPL_PULL) and applies them in order, every
+ * pollInterval once it has caught up. When it is lapped, or the primary
+ * restarted, it loads a new snapshot.
+ *
+ * Reads are answered from the local copy, which may trail the primary:
+ * the replica is fresh while it was caught up with the primary within the
+ * last maxStaleness, and refuses reads ("ERR stale replica") otherwise, e.g.
+ * while the primary is unreachable. Writes are refused ("ERR read-only
+ * replica"); bookings go to the primary. Holds are not replicated, so held
+ * seats are available on the replica until the hold is confirmed.
+ *
+ * handle() answers REPLICA_STATUS with "OK <appliedSequence> <fresh 1|0>".
+ * A client that needs to read its own writes compares the applied sequence
+ * with the primary's REPL_SEQUENCE taken after the write.
+ */
+class BookingReplica {
+public:
+    /**
+     * @struct Options
+     * @brief Where the primary is and how closely to follow it.
+     */
+    struct Options {
+        std::string primary;                           /**< "host:port" or a Unix socket path. */
+        std::chrono::milliseconds pollInterval{5};     /**< Wait between pulls once caught up. */
+        std::chrono::milliseconds maxStaleness{1000};  /**< Longest time since last caught up to serve reads. */
+        std::size_t batchRecords = 4096;               /**< Records per pull. */
+    };
+
+    /**
+     * @brief Constructor; starts following the primary.
+     *
+     * The replica is stale until it first catches up.
+     *
+     * @param options The primary and the follow settings.
+     */
+    explicit BookingReplica(Options options);
+
+    /**
+     * @brief Destructor; stops following.
+     */
+    ~BookingReplica();
+
+    BookingReplica(const BookingReplica&) = delete;
+    BookingReplica& operator=(const BookingReplica&) = delete;
+
+    /**
+     * @brief Handle one request; usable as a BookingServer::Handler.
+     *
+     * @param request The request line.
+     * @param response Receives the response line.
+     */
+    void handle(std::string_view request, std::string& response) const;
+
+    /**
+     * @brief Get the sequence of the last primary change applied.
+     */
+    std::uint64_t appliedSequence() const;
+
+    /**
+     * @brief Check if reads are served: caught up within maxStaleness.
+     */
+    bool isFresh() const;
+
+    /**
+     * @brief Wait until the changes up to a sequence are applied.
+     *
+     * @param sequence A primary sequence, e.g. from REPL_SEQUENCE.
+     * @param timeout How long to wait.
+     * @return True if the sequence was applied in time.
+     */
+    bool waitForSequence(std::uint64_t sequence, std::chrono::milliseconds timeout) const;
+
+    /**
+     * @brief Get the local copy, for in-process reads.
+     */
+    const MovieBookingService& service() const;
+
+private:
+    /**
+     * @brief Follower thread body.
+     */
+    void follow();
+
+    /**
+     * @brief Replace the copy with a snapshot of the primary.
+     */
+    void loadSnapshot(BookingClient& primary);
+
+    /**
+     * @brief Apply the next batch of records.
+     *
+     * @return True if more records are waiting.
+     */
+    bool pull(BookingClient& primary);
+
+    /**
+     * @brief Publish progress and wake waiters.
+     *
+     * @param sequence The sequence now applied.
+     * @param caughtUp True if nothing older than the pull is missing.
+     */
+    void advance(std::uint64_t sequence, bool caughtUp);
+
+    Options mOptions;                             /**< Follow settings. */
+    MovieBookingService mService;                 /**< The copy. */
+    ServiceProtocol mProtocol{mService};          /**< Answers reads from the copy. */
+    std::uint64_t mLogId = 0;                     /**< Primary log followed; 0 before a snapshot. Follower only. */
+    std::atomic<std::uint64_t> mApplied{0};       /**< Sequence of the last applied record. */
+    std::atomic<std::int64_t> mCaughtUpAt{0};     /**< Steady clock time last caught up, in ns; 0 for never. */
+    mutable std::mutex mMutex;                    /**< Guards mStopping; pairs with mProgress. */
+    mutable std::condition_variable mProgress;    /**< Signalled on progress and on stop. */
+    bool mStopping = false;                       /**< Set by the destructor. */
+    std::thread mFollower;                        /**< Pulls from the primary. */
+};
+
+#endif /* BOOKING_REPLICA_HPP */
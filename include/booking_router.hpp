@@ -0,0 +1,145 @@
+/**
+ * @file booking_router.hpp
+ * @brief Routes protocol requests across theater-partitioned service instances.
+ * @author Gebremedhin Abreha
+ */
+#ifndef BOOKING_ROUTER_HPP
+#define BOOKING_ROUTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "booking_client.hpp"
+#include "hash_ring.hpp"
+
+/**
+ * @class BookingRouter
+ * @brief Speaks the ServiceProtocol, spreading theaters over several instances.
+ *
+ * Each shard is a BookingServer in front of its own MovieBookingService.
+ * Theaters are assigned to shards by consistent hashing on the theater ID
+ * (HashRing), so every theater, its seats, its shows and their holds live
+ * on exactly one shard:
+ *
+ * - Theater calls (ADD_THEATER, SEATS, BOOK, HOLD, ...) go to the owner.
+ * - Shows follow their theater; the router remembers which shard has a show
+ *   and asks the shards (SHOW) for one it has not seen.
+ * - Hold IDs are made unique across shards: the router hands out
+ *   (shard << kHoldShardShift) | shardHoldId and decodes it on CONFIRM and
+ *   RELEASE. The shard sits in fixed bits, so IDs stay valid whatever the
+ *   shard count; a shard hold ID too large for the low bits is released
+ *   and the hold refused.
+ * - BOOK_BATCH is split per shard and the results are put back in order.
+ * - Movies are added to every shard, so each shard allocates its own
+ *   theaters to them. Movie queries (MOVIES, THEATERS, SHOWS_FOR_MOVIE,
+ *   MOVIE_SEAT_COUNT, ...) go to every shard and the answers are merged.
+ *
+ * Requests to several shards are pipelined: sent to all, then answered by
+ * all, so a fan-out costs about one round trip. Connections to the shards
+ * are pooled and created on demand, so handle() may be called from many
+ * threads; a connection that fails is dropped and the request answered
+ * with an error.
+ *
+ * LOAD_CATALOG, LOAD_IMAGE, EVENT_SEQUENCE and the REPL_ commands are per
+ * instance and not routed; catalogs are loaded through ADD_* requests to
+ * the router.
+ */
+class BookingRouter {
+public:
+    /** @brief Bit where a global hold ID keeps its shard. */
+    static constexpr unsigned kHoldShardShift = 48;
+    /** @brief Largest hold ID of a shard the router can hand out. */
+    static constexpr std::uint64_t kMaxShardHoldId = (std::uint64_t(1) << kHoldShardShift) - 1;
+    /** @brief Most shards global hold IDs can name. */
+    static constexpr std::size_t kMaxShards = std::size_t(1) << (64 - kHoldShardShift);
+
+    /**
+     * @brief Constructor; connects lazily.
+     *
+     * @param shards Shard addresses, "host:port" or Unix socket paths. The
+     *               order defines the partitioning and must stay the same.
+     * @param virtualNodes Points per shard on the hash ring.
+     * @throws std::invalid_argument If there are more than kMaxShards shards.
+     */
+    explicit BookingRouter(std::vector<std::string> shards,
+                           std::size_t virtualNodes = HashRing::kDefaultVirtualNodes);
+
+    BookingRouter(const BookingRouter&) = delete;
+    BookingRouter& operator=(const BookingRouter&) = delete;
+
+    /**
+     * @brief Handle one request; usable as a BookingServer::Handler.
+     *
+     * @param request The request line.
+     * @param response Receives the response line.
+     * @note Can throw std::system_error or std::runtime_error if a shard
+     *       cannot be reached
+     */
+    void handle(std::string_view request, std::string& response);
+
+    /**
+     * @brief Get the shard owning a theater.
+     */
+    std::size_t shardOf(int theaterId) const;
+
+    /**
+     * @brief Get the number of shards.
+     */
+    std::size_t shardCount() const;
+
+private:
+    /**
+     * @struct Backend
+     * @brief A shard's address and its idle connections.
+     */
+    struct Backend {
+        std::string address;              /**< Where the shard listens. */
+        std::mutex mutex;                 /**< Guards idle. */
+        std::vector<BookingClient> idle;  /**< Connections not in use. */
+    };
+
+    using Requests = std::vector<std::pair<std::size_t, std::string>>; /**< (shard, request) pairs. */
+
+    /**
+     * @brief Send requests to shards, pipelined, and collect the responses.
+     *
+     * @param requests Requests and the shards they go to.
+     * @return The responses, in the order of the requests.
+     */
+    std::vector<std::string> send(const Requests& requests);
+
+    /**
+     * @brief Send one request to one shard.
+     */
+    std::string forward(std::size_t shard, std::string_view request);
+
+    /**
+     * @brief Send a request to every shard.
+     */
+    std::vector<std::string> broadcast(std::string_view request);
+
+    /**
+     * @brief Find the shard holding a show.
+     */
+    std::optional<std::size_t> locateShow(int showId);
+
+    /**
+     * @brief Split a batch booking per shard and merge the results.
+     */
+    void bookBatch(std::string_view arguments, std::string& response);
+
+    HashRing mRing; /**< Theater ID -> shard. */
+    std::vector<std::unique_ptr<Backend>> mBackends; /**< Shards, by index. */
+    std::mutex mShowMutex; /**< Guards mShowShards. */
+    std::unordered_map<int, std::size_t> mShowShards; /**< Show ID -> shard, as learned. */
+};
+
+#endif /* BOOKING_ROUTER_HPP */
@@ -0,0 +1,181 @@
+/**
+ * @file booking_server.hpp
+ * @brief Non-blocking epoll server for line-based requests.
+ * @author Gebremedhin Abreha
+ */
+#ifndef BOOKING_SERVER_HPP
+#define BOOKING_SERVER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class BookingServer
+ * @brief Serves newline-terminated requests over TCP or a Unix socket.
+ *
+ * Each request is one line and gets one response line, in order. Clients
+ * may pipeline: every complete request in what a read returned is handled
+ * and the responses go out together. Connections stay open until the
+ * client closes them or sends QUIT.
+ *
+ * The server runs a configurable number of event loops, each a thread with
+ * its own epoll instance. All loops watch the listening socket (with
+ * EPOLLEXCLUSIVE, so a new connection wakes one loop) and a connection
+ * stays with the loop that accepted it. Sockets are non-blocking; a
+ * connection whose responses pile up past a limit is not read until its
+ * client catches up. A loop that runs out of descriptors stops watching
+ * the listening socket for a short while instead of retrying at once.
+ *
+ * What a request means is up to the handler, which is called from the loop
+ * threads concurrently and must be thread-safe.
+ */
+class BookingServer {
+public:
+    /**
+     * @brief Handles one request.
+     *
+     * Receives the request line without its terminator and appends the
+     * response to the string, without a terminator either.
+     */
+    using Handler = std::function<void(std::string_view request, std::string& response)>;
+
+    /**
+     * @struct Options
+     * @brief Where and how to serve.
+     */
+    struct Options {
+        std::string host = "127.0.0.1";         /**< IPv4 address to listen on. */
+        std::uint16_t port = 0;                 /**< TCP port; 0 picks a free one. */
+        std::string unixPath;                   /**< If set, listen on this Unix socket instead of TCP. */
+        std::size_t threads = 1;                /**< Number of event loops. */
+        std::size_t maxRequestBytes = 1 << 16;  /**< Longest request; a longer one closes the connection. */
+        std::size_t maxPendingBytes = 1 << 20;  /**< Unsent response bytes at which reading pauses. */
+    };
+
+    /**
+     * @brief Constructor, starts listening and serving.
+     *
+     * @param handler Handles every request.
+     * @param options Where and how to serve.
+     * @note Can throw std::system_error if the socket cannot be set up
+     */
+    BookingServer(Handler handler, Options options);
+
+    /**
+     * @brief Destructor, closes every connection and stops the loops.
+     */
+    ~BookingServer();
+
+    BookingServer(const BookingServer&) = delete;
+    BookingServer& operator=(const BookingServer&) = delete;
+
+    /**
+     * @brief Get the TCP port listened on, 0 for a Unix socket.
+     */
+    std::uint16_t port() const;
+
+    /**
+     * @brief Get the number of open connections.
+     */
+    std::size_t connectionCount() const;
+
+private:
+    /**
+     * @struct Connection
+     * @brief A client socket and its buffers.
+     */
+    struct Connection {
+        int fd = -1;              /**< The socket. */
+        std::string input;        /**< Received bytes not yet handled. */
+        std::string output;       /**< Responses not yet sent. */
+        std::size_t sent = 0;     /**< Bytes of output already sent. */
+        bool closing = false;     /**< Close once output is sent. */
+        std::uint32_t events = 0; /**< Events the loop waits for. */
+    };
+
+    /**
+     * @struct Loop
+     * @brief An event loop thread and the connections it owns.
+     */
+    struct Loop {
+        int epollFd = -1;  /**< Its epoll instance. */
+        int wakeFd = -1;   /**< eventfd signalled on stop. */
+        std::unordered_map<int, std::unique_ptr<Connection>> connections; /**< Open connections by socket. */
+        std::thread thread; /**< The loop thread. */
+        bool accepting = true; /**< Watching the listening socket. */
+        std::chrono::steady_clock::time_point acceptPausedUntil; /**< When to watch it again if not. */
+    };
+
+    /**
+     * @brief Create and bind the listening socket.
+     */
+    void listen();
+
+    /**
+     * @brief Close the listening socket and the loops' descriptors.
+     */
+    void closeSockets();
+
+    /**
+     * @brief Event loop body.
+     */
+    void run(Loop& loop);
+
+    /**
+     * @brief Accept every pending connection.
+     */
+    void accept(Loop& loop);
+
+    /**
+     * @brief Stop watching the listening socket for a while.
+     */
+    void pauseAccepting(Loop& loop);
+
+    /**
+     * @brief Watch the listening socket again.
+     */
+    void resumeAccepting(Loop& loop);
+
+    /**
+     * @brief Read what a connection sent and handle its complete requests.
+     *
+     * @return False if the connection is to be closed now.
+     */
+    bool receive(Connection& connection);
+
+    /**
+     * @brief Send pending responses.
+     *
+     * @return False if the connection is to be closed now.
+     */
+    bool flush(Connection& connection);
+
+    /**
+     * @brief Wait for the events the connection's buffers call for.
+     */
+    void watch(Loop& loop, Connection& connection);
+
+    /**
+     * @brief Close a connection and forget it.
+     */
+    void close(Loop& loop, int fd);
+
+    Handler mHandler;      /**< Handles requests. */
+    Options mOptions;      /**< Where and how to serve. */
+    int mListenFd = -1;    /**< Listening socket. */
+    std::uint16_t mPort = 0; /**< Bound TCP port. */
+    std::vector<std::unique_ptr<Loop>> mLoops; /**< Event loops. */
+    std::atomic<bool> mStopping{false};        /**< Set by the destructor. */
+    std::atomic<std::size_t> mConnections{0};  /**< Open connections over all loops. */
+};
+
+#endif /* BOOKING_SERVER_HPP */
@@ -0,0 +1,251 @@
+/**
+ * @file catalog_image.hpp
+ * @brief Versioned binary catalog image, memory-mapped for zero-copy reads.
+ * @author Gebremedhin Abreha
+ */
+#ifndef CATALOG_IMAGE_HPP
+#define CATALOG_IMAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "seat.hpp"
+
+/**
+ * @brief On-disk layout of a catalog image (version 2, little-endian).
+ *
+ * The file is a header followed by tables of fixed-size records and a string
+ * pool. Seat layouts are stored once and shared by every theater using them.
+ */
+namespace catalog_format {
+
+constexpr std::uint32_t kMagic = 0x4943424d;   /**< "MBCI" */
+constexpr std::uint32_t kVersion = 2;          /**< Current format version; 2 added seat places. */
+
+/**
+ * @brief File header; all offsets are from the start of the file.
+ */
+struct Header {
+    std::uint32_t magic;           /**< kMagic. */
+    std::uint32_t version;         /**< kVersion. */
+    std::uint32_t movieCount;      /**< Entries in the movie table. */
+    std::uint32_t theaterCount;    /**< Entries in the theater table. */
+    std::uint32_t seatCount;       /**< Entries in the seat table. */
+    std::uint32_t allocationCount; /**< Entries in the allocation table. */
+    std::uint64_t moviesOffset;    /**< Offset of the movie table. */
+    std::uint64_t theatersOffset;  /**< Offset of the theater table. */
+    std::uint64_t seatsOffset;     /**< Offset of the seat table. */
+    std::uint64_t allocationsOffset; /**< Offset of the allocation table. */
+    std::uint64_t stringsOffset;   /**< Offset of the string pool. */
+    std::uint64_t stringsSize;     /**< Size of the string pool in bytes. */
+};
+
+/**
+ * @brief Reference to a string in the string pool.
+ */
+struct StringRef {
+    std::uint32_t offset; /**< Offset in the string pool. */
+    std::uint32_t length; /**< Length in bytes. */
+};
+
+/**
+ * @brief Movie table entry.
+ */
+struct MovieRecord {
+    std::int32_t id;  /**< Movie ID. */
+    StringRef name;   /**< Movie name. */
+};
+
+/**
+ * @brief Theater table entry; its seats are a range of the seat table.
+ */
+struct TheaterRecord {
+    std::int32_t id;        /**< Theater ID. */
+    StringRef name;         /**< Theater name. */
+    std::uint32_t firstSeat; /**< Index of the first seat in the seat table. */
+    std::uint32_t seatCount; /**< Number of seats. */
+};
+
+/**
+ * @brief Seat table entry.
+ */
+struct SeatRecord {
+    std::int32_t id;        /**< Seat ID. */
+    StringRef seatNumber;   /**< Seat number. */
+    std::uint32_t isBooked; /**< Non-zero if the seat is booked. */
+    std::int32_t section;   /**< Section of the seat. */
+    std::int32_t row;       /**< Row within the section, Seat::kNoRow if none. */
+    std::int32_t position;  /**< Position within the row. */
+};
+
+/**
+ * @brief Allocation table entry.
+ */
+struct AllocationRecord {
+    std::int32_t movieId;   /**< Movie ID. */
+    std::int32_t theaterId; /**< Theater ID. */
+};
+
+} // namespace catalog_format
+
+/**
+ * @class CatalogImage
+ * @brief Read-only, memory-mapped view of a catalog image file.
+ *
+ * Opening validates the header, the table bounds and every seat range and
+ * string reference of the records; afterwards every accessor reads straight
+ * from the mapping without copying, parsing or bounds checks.
+ *
+ * @note The constructor can throw runtime_error exception for a missing or invalid image
+ */
+class CatalogImage {
+public:
+    /**
+     * @brief Movie as seen through the mapping.
+     */
+    struct MovieView {
+        int id;                /**< Movie ID. */
+        std::string_view name; /**< Movie name. */
+    };
+
+    /**
+     * @brief Theater as seen through the mapping.
+     */
+    struct TheaterView {
+        int id;                                    /**< Theater ID. */
+        std::string_view name;                     /**< Theater name. */
+        const catalog_format::SeatRecord* seats;   /**< First seat record. */
+        std::size_t seatCount;                     /**< Number of seat records. */
+    };
+
+    /**
+     * @brief Constructor, maps and validates an image file.
+     *
+     * @param path Path of the image.
+     */
+    explicit CatalogImage(const std::string& path);
+
+    /**
+     * @brief Destructor, unmaps the image.
+     */
+    ~CatalogImage();
+
+    CatalogImage(const CatalogImage&) = delete;
+    CatalogImage& operator=(const CatalogImage&) = delete;
+
+    /**
+     * @brief Number of movies in the image.
+     */
+    std::size_t movieCount() const;
+
+    /**
+     * @brief Get a movie by its position in the image.
+     */
+    MovieView movie(std::size_t index) const;
+
+    /**
+     * @brief Number of theaters in the image.
+     */
+    std::size_t theaterCount() const;
+
+    /**
+     * @brief Get a theater by its position in the image.
+     */
+    TheaterView theater(std::size_t index) const;
+
+    /**
+     * @brief Number of movie to theater allocations in the image.
+     */
+    std::size_t allocationCount() const;
+
+    /**
+     * @brief Get an allocation by its position in the image.
+     */
+    const catalog_format::AllocationRecord& allocation(std::size_t index) const;
+
+    /**
+     * @brief Resolve a string of the string pool.
+     */
+    std::string_view string(const catalog_format::StringRef& ref) const;
+
+    /**
+     * @brief Copy the seats of a theater into Seat objects.
+     */
+    std::vector<Seat> seats(const TheaterView& theater) const;
+
+private:
+    /**
+     * @brief Check that a string reference lies inside the string pool.
+     */
+    bool validString(const catalog_format::StringRef& ref) const;
+
+    /**
+     * @brief Check the seat ranges and string references of every record.
+     */
+    bool validRecords() const;
+
+    /**
+     * @brief Pointer to a table entry of the mapping.
+     */
+    template <typename T>
+    const T* table(std::uint64_t offset) const
+    {
+        return reinterpret_cast<const T*>(mData + offset);
+    }
+
+    const char* mData;                     /**< Start of the mapping. */
+    std::size_t mSize;                     /**< Size of the mapping. */
+    const catalog_format::Header* mHeader; /**< Header at the start of the mapping. */
+};
+
+/**
+ * @class CatalogImageWriter
+ * @brief Collects a catalog and writes it as an image file.
+ *
+ * Identical seat layouts are written once and shared between theaters.
+ */
+class CatalogImageWriter {
+public:
+    /**
+     * @brief Add a movie.
+     */
+    void addMovie(int id, const std::string& name);
+
+    /**
+     * @brief Add a theater with its seats.
+     */
+    void addTheater(int id, const std::string& name, const std::vector<Seat>& seats);
+
+    /**
+     * @brief Allocate a movie to a theater.
+     */
+    void addAllocation(int movieId, int theaterId);
+
+    /**
+     * @brief Write the image.
+     *
+     * @param path Path of the image file.
+     * @note Can throw runtime_error exception if the file cannot be written
+     */
+    void write(const std::string& path) const;
+
+private:
+    /**
+     * @brief Add a string to the pool, reusing an identical one.
+     */
+    catalog_format::StringRef intern(const std::string& value);
+
+    std::vector<catalog_format::MovieRecord> mMovies;           /**< Movie table. */
+    std::vector<catalog_format::TheaterRecord> mTheaters;       /**< Theater table. */
+    std::vector<catalog_format::SeatRecord> mSeats;             /**< Seat table. */
+    std::vector<catalog_format::AllocationRecord> mAllocations; /**< Allocation table. */
+    std::string mStrings;                                       /**< String pool. */
+    std::map<std::string, catalog_format::StringRef> mStringIndex; /**< Pool lookup. */
+    std::map<std::vector<std::uint32_t>, std::uint32_t> mLayoutIndex; /**< Encoded layout -> first seat. */
+};
+
+#endif /* CATALOG_IMAGE_HPP */
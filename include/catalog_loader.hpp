@@ -0,0 +1,85 @@
+/**
+ * @file catalog_loader.hpp
+ * @brief Streaming loader for line-delimited catalog files.
+ * @author Gebremedhin Abreha
+ */
+#ifndef CATALOG_LOADER_HPP
+#define CATALOG_LOADER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "seat.hpp"
+#include "seat_layout.hpp"
+
+class MovieBookingService;
+
+/**
+ * @class CatalogLoader
+ * @brief Reads a catalog from comma-separated lines, one entry per line.
+ *
+ * Recognized lines (blank lines and lines starting with '#' are ignored):
+ *
+ *     movie,<id>,<name>
+ *     layout,<layout>,<seatCount>[,<seatsPerRow>]
+ *                                       seats 0..seatCount-1 named "Seat 1".."Seat N",
+ *                                       in rows of seatsPerRow if given
+ *     seat,<layout>,<id>,<seatNumber>[,<section>,<row>,<position>]
+ *                                       appends one seat to a layout
+ *     theater,<id>,<name>,<layout>
+ *
+ * A layout must be defined before the theaters that use it. The input is
+ * read one line at a time, so catalogs need not fit in memory as text.
+ *
+ * @note Can throw invalid_argument exception on a malformed line
+ */
+class CatalogLoader {
+public:
+    using MovieSink = std::function<void(int id, const std::string& name)>; /**< Receives each movie. */
+    using TheaterSink = std::function<void(int id, const std::string& name,
+                                           const std::vector<Seat>& seats)>; /**< Receives each theater. */
+    using LayoutTheaterSink = std::function<void(int id, const std::string& name,
+                                                 const std::shared_ptr<const SeatLayout>& layout)>; /**< Receives each theater with a shared layout. */
+
+    /**
+     * @brief Parse a catalog, passing each movie and theater to a sink.
+     *
+     * @param input The catalog text.
+     * @param onMovie Called for each movie line.
+     * @param onTheater Called for each theater line with the seats of its layout.
+     * @return The number of movies and theaters read.
+     */
+    static std::size_t parse(std::istream& input, const MovieSink& onMovie, const TheaterSink& onTheater);
+
+    /**
+     * @brief Parse a catalog, passing each theater the SeatLayout of its layout.
+     *
+     * The SeatLayout of a layout is built once, for its first theater, and
+     * shared by every later theater using it (until a seat line changes it).
+     *
+     * @param input The catalog text.
+     * @param onMovie Called for each movie line.
+     * @param onTheater Called for each theater line with its shared layout.
+     * @return The number of movies and theaters read.
+     */
+    static std::size_t parse(std::istream& input, const MovieSink& onMovie, const LayoutTheaterSink& onTheater);
+
+    /**
+     * @brief Load a catalog into a service with one bulk call per kind.
+     *
+     * Movies and theaters are collected while parsing and handed to
+     * addMovies and addTheaters, so allocations are planned once. Theaters
+     * of one layout share its SeatLayout.
+     *
+     * @param input The catalog text.
+     * @param service The service to populate.
+     * @return The number of movies and theaters added.
+     */
+    static std::size_t load(std::istream& input, MovieBookingService& service);
+};
+
+#endif /* CATALOG_LOADER_HPP */
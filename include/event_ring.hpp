@@ -0,0 +1,211 @@
+/**
+ * @file event_ring.hpp
+ * @brief Bounded lock-free ring of seat and catalog change events.
+ * @author Gebremedhin Abreha
+ */
+#ifndef EVENT_RING_HPP
+#define EVENT_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @enum EventType
+ * @brief What changed.
+ */
+enum class EventType : std::uint8_t {
+    SeatBooked,     /**< A free or held seat was sold. */
+    SeatHeld,       /**< A free seat was held for a checkout. */
+    SeatReleased,   /**< A held seat became free again (released or expired). */
+    MovieAdded,     /**< A movie was added to the catalog. */
+    TheaterAdded,   /**< A theater was added to the catalog. */
+    ShowAdded,      /**< A show was added to the catalog. */
+    MovieAllocated  /**< A movie was allocated to a theater. */
+};
+
+/**
+ * @struct ServiceEvent
+ * @brief One change, as read by a subscriber. IDs that do not apply are -1.
+ */
+struct ServiceEvent {
+    std::uint64_t sequence = 0;           /**< Position in the stream, gap-free from 0. */
+    EventType type = EventType::SeatBooked; /**< What changed. */
+    int theaterId = -1;                   /**< Theater of the seat, added or allocated theater. */
+    int showId = -1;                      /**< Show of the seat, or added show. */
+    int movieId = -1;                     /**< Added or allocated movie, or movie of the show. */
+    int seatId = -1;                      /**< Seat that changed. */
+};
+
+/**
+ * @class EventRing
+ * @brief Bounded multi-producer ring of events, read by any number of subscribers.
+ *
+ * Producers claim sequence numbers with one fetch_add and then commit each
+ * event to slot sequence % capacity; neither step takes a lock. Readers do
+ * not consume: each keeps its own position and copies events out under a
+ * per-slot sequence check (a seqlock), so a slow reader never holds
+ * producers back. Instead the ring overwrites it, and the reader learns
+ * that it was lapped and must resynchronize.
+ *
+ * Claiming and committing are separate so a producer can reserve its place
+ * in the stream before it makes the change the event describes. Readers
+ * stop at the first claimed but uncommitted sequence, so events are always
+ * delivered in sequence order.
+ */
+class EventRing {
+public:
+    /**
+     * @enum ReadStatus
+     * @brief Outcome of a read.
+     */
+    enum class ReadStatus {
+        Ok,     /**< Every committed event from the position on was read, up to the limit. */
+        Lapped  /**< Events at the position were overwritten; nothing was read. */
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param capacity Number of events kept; rounded up to a power of two.
+     */
+    explicit EventRing(std::size_t capacity);
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    /**
+     * @brief Reserve consecutive sequence numbers.
+     *
+     * Every claimed sequence must be committed; readers wait for it.
+     *
+     * @param count Number of events to reserve.
+     * @return The first sequence reserved.
+     */
+    std::uint64_t claim(std::size_t count = 1);
+
+    /**
+     * @brief Publish a claimed event.
+     *
+     * Only waits if the producer that claimed the same slot one lap earlier
+     * has not committed yet.
+     *
+     * @param event The event; its sequence selects the slot.
+     */
+    void commit(const ServiceEvent& event);
+
+    /**
+     * @brief Claim and commit one event.
+     *
+     * @return The event's sequence.
+     */
+    std::uint64_t publish(EventType type, int theaterId, int showId, int movieId, int seatId);
+
+    /**
+     * @brief Get the next sequence to be claimed.
+     */
+    std::uint64_t nextSequence() const;
+
+    /**
+     * @brief Wait until every sequence below a bound is committed.
+     *
+     * @param sequence The bound, usually a past nextSequence().
+     */
+    void waitCommitted(std::uint64_t sequence) const;
+
+    /**
+     * @brief Get the number of events kept.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * @brief Copy committed events out of the ring.
+     *
+     * @param position First sequence to read; advanced past the events read.
+     *                 Left unchanged if the reader was lapped.
+     * @param events Receives the events, appended in sequence order.
+     * @param maxEvents Maximum number of events to read.
+     * @return Lapped if the event at position was overwritten.
+     */
+    ReadStatus read(std::uint64_t& position, std::vector<ServiceEvent>& events, std::size_t maxEvents) const;
+
+private:
+    /**
+     * @struct Slot
+     * @brief One event; the fields are atomics so torn reads are detected, not undefined.
+     *
+     * state is 2 * sequence + 1 while the event of that sequence is written
+     * and 2 * sequence + 2 once it is committed; 0 means never written.
+     */
+    struct Slot {
+        std::atomic<std::uint64_t> state{0};  /**< Sequence and phase of the slot. */
+        std::atomic<EventType> type{EventType::SeatBooked}; /**< Event type. */
+        std::atomic<int> theaterId{-1};       /**< Theater ID. */
+        std::atomic<int> showId{-1};          /**< Show ID. */
+        std::atomic<int> movieId{-1};         /**< Movie ID. */
+        std::atomic<int> seatId{-1};          /**< Seat ID. */
+    };
+
+    /**
+     * @brief State of a slot once the event of a sequence is committed.
+     */
+    static std::uint64_t committed(std::uint64_t sequence);
+
+    const std::size_t mMask;             /**< capacity - 1. */
+    std::unique_ptr<Slot[]> mSlots;      /**< The ring. */
+    alignas(64) std::atomic<std::uint64_t> mNext{0}; /**< Next sequence to claim. */
+};
+
+/**
+ * @class EventSubscription
+ * @brief A reader's position in an EventRing.
+ *
+ * A subscriber mirrors service state by applying events in order. Seat
+ * events set a seat's state rather than change it, so applying an event
+ * twice is harmless. That is what makes the snapshot fallback work: after
+ * being lapped, call resync(), then read the state to mirror from the
+ * service, then keep polling. Events from the resync point on may already
+ * be reflected in what was read; applying them again converges.
+ */
+class EventSubscription {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param ring The ring to read; must outlive the subscription.
+     * @param position First sequence to read.
+     */
+    EventSubscription(const EventRing& ring, std::uint64_t position);
+
+    /**
+     * @brief Read the events committed since the last poll.
+     *
+     * @param events Receives the events, appended in sequence order.
+     * @param maxEvents Maximum number of events to read.
+     * @return Lapped if events were lost; the position is kept, call resync().
+     */
+    EventRing::ReadStatus poll(std::vector<ServiceEvent>& events, std::size_t maxEvents = SIZE_MAX);
+
+    /**
+     * @brief Skip to the end of the stream, for a fresh snapshot.
+     *
+     * Returns once every change of an earlier sequence is applied to the
+     * service, so state read afterwards reflects all of them.
+     *
+     * @return The new position.
+     */
+    std::uint64_t resync();
+
+    /**
+     * @brief Get the next sequence to read.
+     */
+    std::uint64_t position() const;
+
+private:
+    const EventRing* mRing;  /**< The ring read. */
+    std::uint64_t mPosition; /**< Next sequence to read. */
+};
+
+#endif /* EVENT_RING_HPP */
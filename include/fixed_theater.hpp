@@ -0,0 +1,126 @@
+/**
+ * @file fixed_theater.hpp
+ * @brief Theater with a compile-time seat capacity and inline seat state.
+ * @author Gebremedhin Abreha
+ */
+#ifndef FIXED_THEATER_HPP
+#define FIXED_THEATER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "seat.hpp"
+#include "seat_inventory.hpp"
+#include "seat_layout.hpp"
+#include "theater.hpp"
+
+/**
+ * @class FixedTheater
+ * @brief A theater of at most Capacity seats whose seat state lives inline.
+ *
+ * The seat state is a FixedSeatInventory: the same inventory as a Theater's,
+ * over bitmaps whose words are arrays inside the object instead of heap
+ * blocks. Booking, holding and releasing therefore never allocate, seat
+ * sets being grouped into per-word masks on the stack. Every seat method is
+ * final and defined in this header, so callers holding a FixedTheater
+ * (rather than a TheaterBase) get direct, inlinable calls. Through a
+ * TheaterBase pointer, e.g. in MovieBookingService, it behaves exactly like
+ * a Theater with the same seats.
+ *
+ * @tparam Capacity The most seats the theater can have.
+ */
+template <std::size_t Capacity>
+class FixedTheater final : public TheaterBase {
+public:
+    static_assert(Capacity > 0, "FixedTheater needs room for at least one seat");
+
+    static constexpr std::size_t kCapacity = Capacity; /**< Most seats of the theater. */
+
+    /**
+     * @brief Constructor to initialize the theater with an ID, name and seats
+     *
+     * @param id The unique identifier for the theater.
+     * @param name The name of the theater.
+     * @param seats A vector of Seat objects representing seats in the theater.
+     * @throws std::invalid_argument If there are more than Capacity seats.
+     */
+    FixedTheater(const int& id, std::string_view name, const std::vector<Seat>& seats):
+    FixedTheater(id, name, std::make_shared<const SeatLayout>(seats))
+    {
+        for (const auto& seat: seats)
+        {
+            if (seat.isBooked)
+                mSeats.bookSeat(seat.id);
+        }
+    }
+
+    /**
+     * @brief Constructor to initialize the theater with an existing layout
+     *
+     * Every seat starts free.
+     *
+     * @param id The unique identifier for the theater.
+     * @param name The name of the theater.
+     * @param layout The seats of the theater, possibly shared with other theaters.
+     * @throws std::invalid_argument If the layout has more than Capacity seats.
+     */
+    FixedTheater(const int& id, std::string_view name, std::shared_ptr<const SeatLayout> layout):
+    TheaterBase(id, name), mSeats(checkCapacity(id, std::move(layout)))
+    {
+    }
+
+    FixedTheater(const FixedTheater&) = delete;
+    FixedTheater& operator=(const FixedTheater&) = delete;
+
+    bool bookSeat(const int& id) final { return mSeats.bookSeat(id); }
+    bool bookSeats(const std::vector<int>& ids) final { return mSeats.bookSeats(ids); }
+    bool holdSeats(const std::vector<int>& ids) final { return mSeats.holdSeats(ids); }
+    bool confirmSeats(const std::vector<int>& ids) final { return mSeats.confirmSeats(ids); }
+    bool releaseSeats(const std::vector<int>& ids) final { return mSeats.releaseSeats(ids); }
+    bool cancelSeats(const std::vector<int>& ids) final { return mSeats.cancelSeats(ids); }
+    SeatState getSeatState(const int& id) const final { return mSeats.getSeatState(id); }
+    std::vector<Seat> getSeats() const final { return mSeats.getSeats(); }
+    std::vector<int> getAvailableSeats() const final { return mSeats.getAvailableSeats(); }
+    void appendAvailableSeats(std::vector<int>& seatIds) const final { mSeats.appendAvailableSeats(seatIds); }
+    std::size_t getAvailableSeatCount() const final { return mSeats.getAvailableSeatCount(); }
+    std::string getSeatNumber(const int& id) const final { return mSeats.getSeatNumber(id); }
+    std::shared_ptr<const SeatLayout> getLayout() const final { return mSeats.getLayout(); }
+
+    std::vector<int> findBestAvailable(std::size_t partySize) const final
+    {
+        return mSeats.findBestAvailable(partySize);
+    }
+
+    bool attachAvailabilityCounter(std::shared_ptr<std::atomic<std::int64_t>> counter) final
+    {
+        return mSeats.attachAvailabilityCounter(std::move(counter));
+    }
+
+private:
+    /**
+     * @brief Pass a layout on if it fits the capacity.
+     *
+     * @throws std::invalid_argument If the layout has more than Capacity seats.
+     */
+    static std::shared_ptr<const SeatLayout> checkCapacity(int id, std::shared_ptr<const SeatLayout> layout)
+    {
+        if (layout->size() > Capacity)
+            throw std::invalid_argument("Theater " + std::to_string(id) + ": " + std::to_string(layout->size())
+                                        + " seats exceed the capacity of " + std::to_string(Capacity));
+        return layout;
+    }
+
+    FixedSeatInventory<Capacity> mSeats; /**< Seat state over the theater's layout, inline. */
+};
+
+/**
+ * @brief Theater sized for the standard auditorium of 20 seats.
+ */
+using StandardTheater = FixedTheater<20>;
+
+#endif /* FIXED_THEATER_HPP */
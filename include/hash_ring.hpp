@@ -0,0 +1,57 @@
+/**
+ * @file hash_ring.hpp
+ * @brief Consistent hashing of theater IDs onto shards.
+ * @author Gebremedhin Abreha
+ */
+#ifndef HASH_RING_HPP
+#define HASH_RING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @class HashRing
+ * @brief Maps keys to shards so that resizing moves few keys.
+ *
+ * Each shard owns a number of virtual points on a 64-bit ring; a key
+ * belongs to the shard of the first point at or after the key's hash. With
+ * enough points per shard the keys spread evenly, and adding a shard only
+ * takes over the keys falling just before its own points, about 1/N of
+ * them. Points depend only on the shard index, so every router built with
+ * the same shard count agrees on the mapping.
+ */
+class HashRing {
+public:
+    static constexpr std::size_t kDefaultVirtualNodes = 128; /**< Points per shard. */
+
+    /**
+     * @brief Constructor
+     *
+     * @param shardCount Number of shards; at least one.
+     * @param virtualNodes Points per shard.
+     */
+    explicit HashRing(std::size_t shardCount, std::size_t virtualNodes = kDefaultVirtualNodes);
+
+    /**
+     * @brief Get the shard owning a key, in O(log(points)).
+     */
+    std::size_t shardOf(int key) const;
+
+    /**
+     * @brief Get the number of shards.
+     */
+    std::size_t shardCount() const;
+
+private:
+    /**
+     * @brief 64-bit mix of a value (splitmix64 finalizer).
+     */
+    static std::uint64_t hash(std::uint64_t value);
+
+    std::size_t mShardCount; /**< Number of shards. */
+    std::vector<std::pair<std::uint64_t, std::size_t>> mPoints; /**< (point, shard), by point. */
+};
+
+#endif /* HASH_RING_HPP */
@@ -0,0 +1,332 @@
+/**
+ * @file id_table.hpp
+ * @brief Table of values keyed by integer ID whose copies share storage.
+ * @author Gebremedhin Abreha
+ */
+#ifndef ID_TABLE_HPP
+#define ID_TABLE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "shared_vector.hpp"
+
+/**
+ * @class IdTable
+ * @brief Values keyed by int ID, found with one probe; copies share storage.
+ *
+ * Entries are appended to a SharedVector in the order their values were set
+ * and never move, so an entry's position is a stable handle. IDs are located
+ * through an open-addressing index of 32-bit entry positions (linear
+ * probing, at most half full), which usually resolves a lookup in one cache
+ * line. Entries cannot be removed; the catalog never removes any.
+ *
+ * Copying a table is O(1): the copy shares the entries and the index with
+ * the original and sees the entries that were there when it was made.
+ * Adding to or assigning in the latest copy writes in place in O(1)
+ * amortized; the index is only rebuilt when it doubles. Assigning an ID
+ * again appends its new value and links it to the old one, so older copies
+ * still find the old value. Writing to a copy that another copy wrote past
+ * first gives it storage of its own, in O(n).
+ *
+ * As with SharedVector, one thread at a time may write through the copies
+ * of a table, while other threads read copies handed to them with
+ * release/acquire ordering.
+ */
+template <typename T>
+class IdTable {
+    struct Node;
+
+public:
+    using Entry = std::pair<int, T>; /**< ID and value. */
+
+    /**
+     * @class const_iterator
+     * @brief Iterates the entries of a copy in the order their values were set.
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag; /**< Forward only. */
+        using value_type = Entry;                            /**< Entry type. */
+        using difference_type = std::ptrdiff_t;              /**< Distance between positions. */
+        using pointer = const Entry*;                        /**< Pointer to an entry. */
+        using reference = const Entry&;                      /**< Reference to an entry. */
+
+        const_iterator(const SharedVector<Node>* nodes, std::size_t position) : mNodes(nodes), mPosition(position)
+        {
+            skipReplaced();
+        }
+
+        reference operator*() const { return (*mNodes)[mPosition].entry; }
+        pointer operator->() const { return &(*mNodes)[mPosition].entry; }
+        const_iterator& operator++() { ++mPosition; skipReplaced(); return *this; }
+        const_iterator operator++(int) { const_iterator previous = *this; ++*this; return previous; }
+        bool operator==(const const_iterator& other) const { return mPosition == other.mPosition; }
+        bool operator!=(const const_iterator& other) const { return mPosition != other.mPosition; }
+
+    private:
+        /**
+         * @brief Move past entries whose ID was assigned again in this copy.
+         */
+        void skipReplaced()
+        {
+            while (mPosition < mNodes->size() && (*mNodes)[mPosition].next.load(std::memory_order_relaxed) < mNodes->size())
+                ++mPosition;
+        }
+
+        const SharedVector<Node>* mNodes; /**< Entries of the iterated copy. */
+        std::size_t mPosition;            /**< Position of the current entry. */
+    };
+
+    /**
+     * @brief Add a value unless the ID is known.
+     *
+     * @param id The ID.
+     * @param value The value.
+     * @return The value stored for the ID, and true if it was added.
+     */
+    std::pair<const T*, bool> emplace(int id, T value)
+    {
+        const std::uint32_t position = locate(id);
+        if (position != kEmpty)
+            return {&mNodes[position].entry.second, false};
+        return {&append(id, std::move(value), kEmpty), true};
+    }
+
+    /**
+     * @brief Set the value of an ID, adding the ID if it is unknown.
+     *
+     * Copies made before keep seeing the previous value.
+     *
+     * @param id The ID.
+     * @param value The value.
+     * @return The value stored for the ID.
+     */
+    const T& assign(int id, T value)
+    {
+        return append(id, std::move(value), locate(id));
+    }
+
+    /**
+     * @brief Find the value of an ID.
+     *
+     * @return The value, or nullptr if the ID is unknown.
+     */
+    const T* find(int id) const
+    {
+        const std::uint32_t position = locate(id);
+        return position == kEmpty ? nullptr : &mNodes[position].entry.second;
+    }
+
+    /**
+     * @brief Check if an ID is known.
+     */
+    bool contains(int id) const
+    {
+        return locate(id) != kEmpty;
+    }
+
+    /**
+     * @brief Number of IDs.
+     */
+    std::size_t size() const { return mCount; }
+
+    /**
+     * @brief True if there are no entries.
+     */
+    bool empty() const { return mCount == 0; }
+
+    /**
+     * @brief Get the known IDs in ascending order.
+     */
+    std::vector<int> ids() const
+    {
+        std::vector<int> result;
+        ids(result);
+        return result;
+    }
+
+    /**
+     * @brief Get the known IDs in ascending order into a caller's vector.
+     *
+     * @param result Replaced by the IDs; it allocates only if its capacity
+     *               is too small.
+     */
+    void ids(std::vector<int>& result) const
+    {
+        result.clear();
+        result.reserve(mCount);
+        for (const auto& entry : *this)
+        {
+            result.push_back(entry.first);
+        }
+        // IDs usually arrive in order; only sort when they did not
+        if (!mAscending)
+            std::sort(result.begin(), result.end());
+    }
+
+    const_iterator begin() const { return const_iterator(&mNodes, 0); }           /**< First entry. */
+    const_iterator end() const { return const_iterator(&mNodes, mNodes.size()); } /**< Past the last entry. */
+
+private:
+    static constexpr std::uint32_t kEmpty = UINT32_MAX; /**< Index slot holding no entry, or no linked entry. */
+    static constexpr std::size_t kMinIndexSize = 16;    /**< Smallest index, a power of two. */
+
+    /**
+     * @struct Node
+     * @brief An entry and the links to the other values set for its ID.
+     */
+    struct Node {
+        Node() = default;
+        Node(Entry entry_, std::uint32_t previous_) : entry(std::move(entry_)), previous(previous_) { }
+        Node(const Node& other) : entry(other.entry), previous(other.previous), next(other.next.load(std::memory_order_relaxed)) { }
+        Node& operator=(Node&& other)
+        {
+            entry = std::move(other.entry);
+            previous = other.previous;
+            next.store(other.next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        Entry entry;                                     /**< ID and value. */
+        std::uint32_t previous = kEmpty;                 /**< Position of the ID's previous value. */
+        mutable std::atomic<std::uint32_t> next{kEmpty}; /**< Position of the ID's next value; set while copies read. */
+    };
+
+    /**
+     * @struct Index
+     * @brief Open-addressing slots shared by copies; the latest copy fills
+     *        them while others read.
+     */
+    struct Index {
+        explicit Index(std::size_t size) : mask(size - 1), slots(std::make_unique<std::atomic<std::uint32_t>[]>(size))
+        {
+            for (std::size_t slot = 0; slot < size; ++slot)
+                slots[slot].store(kEmpty, std::memory_order_relaxed);
+        }
+
+        std::size_t mask;                                   /**< Slot count minus one. */
+        std::unique_ptr<std::atomic<std::uint32_t>[]> slots; /**< Latest entry position per slot, kEmpty if none. */
+    };
+
+    /**
+     * @brief First slot to probe for an ID.
+     */
+    static std::size_t home(int id, std::size_t mask)
+    {
+        // Fibonacci hashing spreads consecutive IDs over the index
+        return static_cast<std::size_t>(
+            (static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+
+    /**
+     * @brief Position of the value this copy sees for an ID, or kEmpty.
+     */
+    std::uint32_t locate(int id) const
+    {
+        if (!mIndex)
+            return kEmpty;
+        for (std::size_t slot = home(id, mIndex->mask);; slot = (slot + 1) & mIndex->mask)
+        {
+            std::uint32_t position = mIndex->slots[slot].load(std::memory_order_acquire);
+            if (position == kEmpty)
+                return kEmpty;
+            if (mNodes[position].entry.first != id)
+                continue;
+            // Later copies may have added the ID or assigned it again: go back to the value this copy saw
+            while (position != kEmpty && position >= mNodes.size())
+                position = mNodes[position].previous;
+            return position;
+        }
+    }
+
+    /**
+     * @brief Slot holding an ID, or the empty slot where it would go, in
+     *        the index of the latest copy.
+     */
+    std::size_t slotOf(const Index& index, int id) const
+    {
+        std::size_t slot = home(id, index.mask);
+        for (std::uint32_t position = index.slots[slot].load(std::memory_order_relaxed);
+             position != kEmpty && mNodes[position].entry.first != id;
+             position = index.slots[slot].load(std::memory_order_relaxed))
+        {
+            slot = (slot + 1) & index.mask;
+        }
+        return slot;
+    }
+
+    /**
+     * @brief Append a value for an ID.
+     *
+     * @param previous Position of the value the ID has now, or kEmpty.
+     */
+    const T& append(int id, T value, std::uint32_t previous)
+    {
+        // Another copy wrote past this one: continue on storage of its own
+        if (!mNodes.empty() && !mNodes.isLatest())
+            detach();
+
+        mAscending = mAscending && (mNodes.empty() || id > mNodes.back().entry.first);
+        mCount += previous == kEmpty ? 1 : 0;
+        mNodes.push_back(Node(Entry(id, std::move(value)), previous));
+        const auto position = static_cast<std::uint32_t>(mNodes.size() - 1);
+        if (previous != kEmpty)
+            mNodes[previous].next.store(position, std::memory_order_relaxed);
+
+        if (!mIndex || 2 * mNodes.size() > mIndex->mask + 1)
+            rehash();
+        else
+            mIndex->slots[slotOf(*mIndex, id)].store(position, std::memory_order_release);
+        return mNodes[position].entry.second;
+    }
+
+    /**
+     * @brief Copy this copy's entries to storage of its own.
+     */
+    void detach()
+    {
+        SharedVector<Node> nodes;
+        for (std::size_t position = 0; position < mNodes.size(); ++position)
+        {
+            Node node(mNodes[position]);
+            // Values assigned past this copy belong to the copy that wrote them
+            if (node.next.load(std::memory_order_relaxed) >= mNodes.size())
+                node.next.store(kEmpty, std::memory_order_relaxed);
+            nodes.push_back(std::move(node));
+        }
+        mNodes = std::move(nodes);
+        mIndex.reset();
+    }
+
+    /**
+     * @brief Build an index of its own for this copy, a quarter full.
+     */
+    void rehash()
+    {
+        std::size_t size = kMinIndexSize;
+        while (size < 4 * mNodes.size())
+            size *= 2;
+
+        auto index = std::make_shared<Index>(size);
+        for (std::size_t position = 0; position < mNodes.size(); ++position)
+        {
+            // Later values of an ID take its slot over
+            index->slots[slotOf(*index, mNodes[position].entry.first)].store(
+                static_cast<std::uint32_t>(position), std::memory_order_relaxed);
+        }
+        mIndex = std::move(index);
+    }
+
+    SharedVector<Node> mNodes;     /**< Entries in the order their values were set. */
+    std::shared_ptr<Index> mIndex; /**< Index shared with copies; null until the first entry. */
+    std::size_t mCount = 0;        /**< IDs this copy knows. */
+    bool mAscending = true;        /**< True if IDs were set in ascending order. */
+};
+
+#endif /* ID_TABLE_HPP */
@@ -0,0 +1,147 @@
+/**
+ * @file latency_histogram.hpp
+ * @brief Log-bucketed histogram of latencies.
+ * @author Gebremedhin Abreha
+ */
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LatencyHistogram
+ * @brief Histogram of non-negative values in log-linear buckets.
+ *
+ * Values below 2^kSubBucketBits get a bucket each; above that, every power
+ * of two is split into 2^kSubBucketBits equal buckets, so a reported value
+ * is within 1/2^kSubBucketBits (about 6%) of the recorded one. Recording is
+ * a few instructions and never allocates. A histogram is not thread-safe:
+ * keep one per thread and merge them for reporting.
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @brief Constructor for an empty histogram.
+     */
+    LatencyHistogram() = default;
+
+    /**
+     * @brief Record one value.
+     *
+     * @param value The value, e.g. a latency in nanoseconds.
+     */
+    void record(std::uint64_t value);
+
+    /**
+     * @brief Add the values of another histogram to this one.
+     *
+     * @param other The histogram to merge.
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief Forget every recorded value.
+     */
+    void reset();
+
+    /**
+     * @brief Number of recorded values.
+     */
+    std::uint64_t count() const;
+
+    /**
+     * @brief Smallest recorded value, 0 when empty.
+     */
+    std::uint64_t min() const;
+
+    /**
+     * @brief Largest recorded value, 0 when empty.
+     */
+    std::uint64_t max() const;
+
+    /**
+     * @brief Mean of the recorded values, 0 when empty.
+     */
+    double mean() const;
+
+    /**
+     * @brief Value at a quantile.
+     *
+     * @param quantile The quantile, from 0 to 1 (e.g. 0.999 for p99.9).
+     * @return The upper bound of the bucket holding the quantile, clamped to
+     *         the recorded range; 0 when empty.
+     */
+    std::uint64_t percentile(double quantile) const;
+
+private:
+    friend class ConcurrentLatencyHistogram;
+
+    static constexpr std::size_t kSubBucketBits = 4; /**< log2 of buckets per power of two. */
+    static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits; /**< Buckets per power of two. */
+    static constexpr std::size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets; /**< Buckets covering 64-bit values. */
+
+    /**
+     * @brief Bucket holding a value.
+     */
+    static std::size_t bucketOf(std::uint64_t value);
+
+    /**
+     * @brief Largest value held by a bucket.
+     */
+    static std::uint64_t bucketUpperBound(std::size_t bucket);
+
+    std::array<std::uint64_t, kBuckets> mBuckets{}; /**< Values per bucket. */
+    std::uint64_t mCount = 0;                       /**< Recorded values. */
+    std::uint64_t mSum = 0;                         /**< Sum of recorded values. */
+    std::uint64_t mMin = UINT64_MAX;                /**< Smallest recorded value. */
+    std::uint64_t mMax = 0;                         /**< Largest recorded value. */
+};
+
+/**
+ * @class ConcurrentLatencyHistogram
+ * @brief LatencyHistogram buckets that many threads can record into.
+ *
+ * Every field is a relaxed atomic, so recording never blocks and reading
+ * gives a value-by-value (not point-in-time) copy. Values from 2^kMaxValueBits
+ * up share the last bucket, which keeps the histogram small enough to
+ * have one per thread and operation; min and max stay exact.
+ */
+class ConcurrentLatencyHistogram {
+public:
+    /**
+     * @brief Constructor for an empty histogram.
+     */
+    ConcurrentLatencyHistogram() = default;
+
+    ConcurrentLatencyHistogram(const ConcurrentLatencyHistogram&) = delete;
+    ConcurrentLatencyHistogram& operator=(const ConcurrentLatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one value.
+     *
+     * @param value The value, e.g. a latency in nanoseconds.
+     */
+    void record(std::uint64_t value);
+
+    /**
+     * @brief Add the recorded values to a histogram.
+     *
+     * @param histogram The histogram to add to.
+     */
+    void addTo(LatencyHistogram& histogram) const;
+
+private:
+    static constexpr std::size_t kMaxValueBits = 40; /**< Values of 2^40 and up (about 18 minutes in ns) share the last bucket. */
+    static constexpr std::size_t kBuckets = (kMaxValueBits - LatencyHistogram::kSubBucketBits + 1) * LatencyHistogram::kSubBuckets; /**< Buckets kept. */
+
+    std::array<std::atomic<std::uint64_t>, kBuckets> mBuckets{}; /**< Values per bucket. */
+    std::atomic<std::uint64_t> mCount{0};                       /**< Recorded values. */
+    std::atomic<std::uint64_t> mSum{0};                         /**< Sum of recorded values. */
+    std::atomic<std::uint64_t> mMin{UINT64_MAX};                /**< Smallest recorded value. */
+    std::atomic<std::uint64_t> mMax{0};                         /**< Largest recorded value. */
+};
+
+#endif /* LATENCY_HISTOGRAM_HPP */
@@ -6,16 +6,19 @@
 #ifndef MOVIE_HPP
 #define MOVIE_HPP
 
-#include <string>
+#include <string_view>
+#include "name_pool.hpp"
 
 /**
  * @struct Movie
  * @brief Represents a movie with an ID, and movie name.
+ *
+ * The name is interned in NamePool::shared(), so it can be read as a view
+ * without copying and equal names are stored once.
  */
 struct Movie {
     int id;             /**< Unique identifier for the movie. */
-    std::string name;  /**< Name of the movie. */
-    bool isAllocated;   /**< Flag indicating if the movie is allocated to a theater. */
+    std::string_view name; /**< Name of the movie, interned; assign only interned names. */
     
     /**
      * @brief Constructor to initialize the movie with an ID and name.
@@ -23,7 +26,7 @@ struct Movie {
      * @param id_ The unique identifier for the movie.
      * @param name_ The name of the movie.
      */
-    Movie(int id_, const std::string& name_) : id(id_), name(name_) { }
+    Movie(int id_, std::string_view name_) : id(id_), name(NamePool::shared().intern(name_)) { }
     
     Movie(Movie&& other) = default;
 
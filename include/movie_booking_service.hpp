@@ -8,14 +8,30 @@
 #define MOVIE_BOOKING_SERVICE_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <random>
 #include <unordered_map>
-#include <map>
+#include <utility>
 
 #include "movie.hpp"
 #include "theater.hpp"
+#include "show.hpp"
+#include "timer_wheel.hpp"
+#include "write_ahead_log.hpp"
+#include "service_metrics.hpp"
+#include "allocation_engine.hpp"
+#include "id_table.hpp"
+#include "shared_vector.hpp"
+#include "event_ring.hpp"
+#include "replication_log.hpp"
 
 /**
  * @class MovieBookingService
@@ -23,15 +39,102 @@
  *
  * The MovieBookingService class provides methods for managing movie bookings,
  * theaters, and seat allocations.
+ *
+ * Catalog state (movies, theaters, allocations) is published as immutable
+ * snapshots swapped in atomically, so reads never take a lock. Seat state
+ * needs no lock either: theaters claim seats with compare-and-swap on their
+ * occupancy words.
+ *
+ * Seats can also be held for a limited time during checkout. Hold
+ * expirations are kept in a hierarchical timing wheel and processed lazily
+ * by the service's own calls (or explicitly via expireHolds()), so no thread
+ * ever scans theaters for stale holds.
+ *
+ * Optionally the service is durable: successful addMovie, addTheater,
+ * addShow and bookings are appended to a write-ahead log with group commit before they
+ * are acknowledged, state is recovered from the latest checkpoint plus the
+ * log on construction, and a checkpoint replaces the log every
+ * checkpointInterval records. Holds are not durable; a confirmed hold is
+ * logged as a booking. A booking whose log append throws is undone (the
+ * seats are free again, a confirmed hold is gone) before the exception
+ * reaches the caller.
+ *
+ * Seats are also sold per showtime: a show screens a movie in a theater at a
+ * start time, shares the theater's immutable seat layout and carries only
+ * its own occupancy bitmaps, so a week of shows across every screen is
+ * cheap to add. Show seats are booked and held like theater seats.
+ *
+ * Every public call is timed and counted in per-thread metrics, together
+ * with lock waits and seat conflicts; getMetrics() and dumpMetrics() sum
+ * them on demand.
+ *
+ * Every seat change (booked, held, released) and catalog change is also
+ * published, one event per seat, to a bounded lock-free ring that
+ * subscribers read at their own pace (see subscribe()). Events of a seat
+ * come in the order its state changed.
  */
 class MovieBookingService {
 public:
 
+    using HoldId = std::uint64_t; /**< Identifier of a seat hold. */
+
+    /**
+     * @struct BookingRequest
+     * @brief One customer's booking within a batch.
+     */
+    struct BookingRequest {
+        std::uint64_t requestId;  /**< Caller's identifier, echoed in the result. */
+        int theaterId;            /**< The ID of the theater. */
+        std::vector<int> seatIds; /**< Seat IDs to book, all or nothing. */
+    };
+
+    /**
+     * @enum BookingStatus
+     * @brief Outcome of one request of a batch.
+     */
+    enum class BookingStatus {
+        Booked,         /**< Every requested seat was booked. */
+        Conflict,       /**< A seat was taken, held, repeated or unknown; nothing was booked. */
+        UnknownTheater, /**< No theater has the requested ID. */
+        NoSeats         /**< The request listed no seats. */
+    };
+
+    /**
+     * @struct BookingResult
+     * @brief Outcome of one request of a batch.
+     */
+    struct BookingResult {
+        std::uint64_t requestId = 0;                   /**< The request's identifier. */
+        BookingStatus status = BookingStatus::NoSeats; /**< What happened to the request. */
+        std::vector<int> conflictingSeats;             /**< For a conflict, the requested seats that were not free. */
+    };
+
+    static constexpr std::size_t kDefaultCheckpointInterval = 100000; /**< Log records between checkpoints. */
+
+    static constexpr std::size_t kEventCapacity = std::size_t{1} << 14; /**< Events kept for subscribers. */
+
+    static constexpr std::size_t kReplicationCapacity = std::size_t{1} << 16; /**< Log records kept for replicas. */
+
     /**
      * @brief Constructor
      */
      MovieBookingService() = default;
 
+    /**
+     * @brief Constructor for a durable service.
+     *
+     * Recovers the state stored at logPath (checkpoint, then log records),
+     * then logs every further mutation there.
+     *
+     * @param logPath Path of the write-ahead log; the checkpoint is stored
+     *                next to it with a ".checkpoint" suffix.
+     * @param checkpointInterval Number of log records after which a
+     *                checkpoint is taken and the log truncated.
+     * @note Can throw std::system_error if the log cannot be opened
+     */
+     explicit MovieBookingService(const std::string& logPath,
+                                  std::size_t checkpointInterval = kDefaultCheckpointInterval);
+
     /**
      * @brief Destructor for the MovieBookingService class.
      */
@@ -51,7 +154,69 @@ public:
       * @param theater A  pointer to the theater to be added.
       * @return True if theater is added successfully , false otherwise
       */
-    bool addTheater(std::unique_ptr<Theater> theater);
+    bool addTheater(std::unique_ptr<TheaterBase> theater);
+
+    /**
+     * @brief Add many movies at once.
+     *
+     * Equivalent to calling addMovie for each movie, but the catalog is
+     * updated in one pass, allocations are planned once for the whole batch
+     * and a single snapshot is published.
+     *
+     * @param movies The movies to be added; null entries and known IDs are skipped.
+     * @return The number of movies added.
+     */
+    std::size_t addMovies(std::vector<std::unique_ptr<Movie>> movies);
+
+    /**
+     * @brief Add many theaters at once.
+     *
+     * Equivalent to calling addTheater for each theater, but the catalog is
+     * updated in one pass, allocations are planned once for the whole batch
+     * and a single snapshot is published. Theaters left over once every
+     * movie is allocated are given a randomly picked movie.
+     *
+     * @param theaters The theaters to be added; null entries and known IDs are skipped.
+     * @return The number of theaters added.
+     */
+    std::size_t addTheaters(std::vector<std::unique_ptr<TheaterBase>> theaters);
+
+    /**
+     * @brief Load a whole catalog from a binary catalog image.
+     *
+     * The image is memory-mapped and read in one pass; its movies, theaters
+     * and allocations are published as a single snapshot. Movies and theaters
+     * whose IDs are already known are skipped, and allocations are applied as
+     * recorded in the image rather than re-planned.
+     *
+     * @param path Path of an image written by CatalogImageWriter.
+     * @return True if the image is loaded, false if it cannot be opened or is invalid.
+     */
+    bool loadCatalogImage(const std::string& path);
+
+    /**
+     * @brief Add a show of a movie in a theater.
+     *
+     * Any movie can be shown in any theater, whatever the theater is
+     * allocated to. Every seat of the show starts free.
+     *
+     * @param show The ID, theater, movie and start time of the show.
+     * @return True if the show is added; false if its ID is known, its movie
+     *         or theater is unknown, or the theater already has a show
+     *         starting at that time.
+     */
+    bool addShow(const ShowInfo& show);
+
+    /**
+     * @brief Add many shows at once, e.g. a week of showtimes.
+     *
+     * Equivalent to calling addShow for each show, but a single snapshot is
+     * published and a single log record written.
+     *
+     * @param shows The shows to be added; invalid ones are skipped.
+     * @return The number of shows added.
+     */
+    std::size_t addShows(const std::vector<ShowInfo>& shows);
 
     /**
      * @brief Get a list of all playing movies.
@@ -59,6 +224,14 @@ public:
      * @return A vector of Movie ids representing available movies.
      */
     std::vector< int > getAllMovies() const;
+
+    /**
+     * @brief Get the IDs of all playing movies into a caller's vector.
+     *
+     * @param movieIds Replaced by the movie IDs, ascending; it allocates only
+     *                 if its capacity is too small.
+     */
+    void getAllMovies(std::vector<int>& movieIds) const;
     
     /**
      * @brief Get theaters showing a specific movie.
@@ -67,7 +240,37 @@ public:
      * @return A vector of Theater ids showing the specified movie.
      */
     std::vector<int> getTheatersForMovie(int movieId) const;
+
+    /**
+     * @brief Get theaters showing a specific movie into a caller's vector.
+     *
+     * Unlike the returning overload, an unknown movie is reported, not thrown.
+     *
+     * @param movieId The ID of the movie.
+     * @param theaterIds Replaced by the theater IDs; it allocates only if its
+     *                   capacity is too small. Cleared for an unknown movie.
+     * @return True if the movie exists, false otherwise.
+     */
+    bool getTheatersForMovie(int movieId, std::vector<int>& theaterIds) const;
     
+    /**
+     * @brief Get the shows of a movie.
+     *
+     * @param movieId The ID of the movie.
+     * @return The shows, by start time.
+     * @note Can throw invalid_argument exception
+     */
+    std::vector<ShowInfo> getShowsForMovie(int movieId) const;
+
+    /**
+     * @brief Get the shows of a theater.
+     *
+     * @param theaterId The ID of the theater.
+     * @return The shows, by start time.
+     * @note Can throw invalid_argument exception
+     */
+    std::vector<ShowInfo> getShowsForTheater(int theaterId) const;
+
     /**
      * @brief Get available (free/unbooked) seats for a specific theater and movie.
      *
@@ -76,14 +279,188 @@ public:
      */
     std::vector<int> getAvailableSeats(int theaterId ) const;
 
+    /**
+     * @brief Get available seats of a theater into a caller's vector.
+     *
+     * @param theaterId The ID of the theater.
+     * @param seatIds Replaced by the seat IDs; it allocates only if its
+     *                capacity is too small. Cleared for an unknown theater.
+     * @return True if the theater exists, false otherwise.
+     */
+    bool getAvailableSeats(int theaterId, std::vector<int>& seatIds) const;
+
+    /**
+     * @brief Get the number of available seats of a theater, in constant time.
+     *
+     * @param theaterId The ID of the theater.
+     * @return The seats neither booked nor held; 0 if the theater is unknown.
+     */
+    std::size_t getAvailableSeatCount(int theaterId) const;
+
+    /**
+     * @brief Get the number of available seats for a movie, in constant time.
+     *
+     * Counts the seats of the theaters the movie is allocated to, from a
+     * counter every booking, hold and release in those theaters updates.
+     * Show seats are not included.
+     *
+     * @param movieId The ID of the movie.
+     * @return The seats neither booked nor held; 0 if the movie is unknown.
+     */
+    std::size_t getMovieAvailableSeatCount(int movieId) const;
+
+    /**
+     * @brief Get the movies with at least one available seat.
+     *
+     * @return The movie IDs, ascending.
+     */
+    std::vector<int> getMoviesWithAvailability() const;
+
+    /**
+     * @brief Get the movies with at least one available seat into a caller's vector.
+     *
+     * @param movieIds Replaced by the movie IDs, ascending; it allocates
+     *                 only if its capacity is too small.
+     */
+    void getMoviesWithAvailability(std::vector<int>& movieIds) const;
+
+    /**
+     * @brief Find adjacent free seats for a party in the best row of a theater.
+     *
+     * The seats are not claimed: pass them to bookSeats or holdSeats, and
+     * search again if that fails because someone else took them first.
+     *
+     * @param theaterId The ID of the theater.
+     * @param partySize The number of adjacent seats wanted.
+     * @return The seat IDs, or an empty vector if the theater is unknown or
+     *         no row has that many adjacent free seats.
+     */
+    std::vector<int> findBestAvailable(int theaterId, int partySize) const;
+
+    /**
+     * @brief Get available seats of a show.
+     *
+     * @param showId The ID of the show.
+     * @return A vector of seat IDs; empty if the show is unknown.
+     */
+    std::vector<int> getAvailableShowSeats(int showId) const;
+
+    /**
+     * @brief Find adjacent free seats for a party in the best row of a show.
+     *
+     * Like findBestAvailable; the seats are not claimed.
+     *
+     * @param showId The ID of the show.
+     * @param partySize The number of adjacent seats wanted.
+     * @return The seat IDs, or an empty vector if the show is unknown or no
+     *         row has that many adjacent free seats.
+     */
+    std::vector<int> findBestAvailableForShow(int showId, int partySize) const;
+
+    /**
+     * @brief Look up a show without throwing.
+     *
+     * @param showId The ID of the show.
+     * @return What is shown where and when, or std::nullopt if the show is unknown.
+     */
+    std::optional<ShowInfo> findShow(int showId) const;
+
     /**
      * @brief Book seats for a specific theater and movie.
      *
+     * The booking is all or nothing: if any seat is unknown or already
+     * booked, none of the requested seats is booked.
+     *
      * @param theaterId The ID of the theater.
      * @param seatIds A vector of seat IDs to be booked.
      * @return True if seats were booked successfully, false otherwise.
      */
     bool bookSeats(int theaterId, const std::vector<int>& seatIds);
+
+    /**
+     * @brief Book the seats of many requests at once.
+     *
+     * Requests are grouped by theater; each theater is looked up once and
+     * its requests are applied in the order given, each all or nothing as in
+     * bookSeats, so an earlier request wins a seat two requests want. The
+     * catalog snapshot is taken and expired holds are swept once for the
+     * whole batch, and a durable service logs every booking of the batch
+     * with a single append before returning.
+     *
+     * @param requests The requests; their IDs need not be unique.
+     * @return One result per request, in the order of requests.
+     */
+    std::vector<BookingResult> bookBatch(const std::vector<BookingRequest>& requests);
+
+    /**
+     * @brief Book seats of a show, all or nothing.
+     *
+     * @param showId The ID of the show.
+     * @param seatIds A vector of seat IDs to be booked.
+     * @return True if seats were booked successfully, false otherwise.
+     */
+    bool bookShowSeats(int showId, const std::vector<int>& seatIds);
+
+    /**
+     * @brief Hold seats of a theater for a limited time, all or nothing.
+     *
+     * Held seats are not available to other customers. The hold must be
+     * confirmed before it expires, or the seats become free again.
+     *
+     * @param theaterId The ID of the theater.
+     * @param seatIds A vector of seat IDs to be held.
+     * @param ttl How long the hold stays valid.
+     * @return The hold ID, or std::nullopt if the seats could not be held.
+     */
+    std::optional<HoldId> holdSeats(int theaterId, const std::vector<int>& seatIds,
+                                    std::chrono::milliseconds ttl);
+
+    /**
+     * @brief Hold seats of a show for a limited time, all or nothing.
+     *
+     * The hold is confirmed or released with confirmHold and releaseHold.
+     *
+     * @param showId The ID of the show.
+     * @param seatIds A vector of seat IDs to be held.
+     * @param ttl How long the hold stays valid.
+     * @return The hold ID, or std::nullopt if the seats could not be held.
+     */
+    std::optional<HoldId> holdShowSeats(int showId, const std::vector<int>& seatIds,
+                                        std::chrono::milliseconds ttl);
+
+    /**
+     * @brief Book the seats of a live hold.
+     *
+     * @param holdId The ID returned by holdSeats.
+     * @return True if the hold was live and its seats are now booked, false otherwise.
+     */
+    bool confirmHold(HoldId holdId);
+
+    /**
+     * @brief Release the seats of a live hold.
+     *
+     * @param holdId The ID returned by holdSeats.
+     * @return True if the hold was live and its seats are now free, false otherwise.
+     */
+    bool releaseHold(HoldId holdId);
+
+    /**
+     * @brief Release every hold whose time to live has passed.
+     *
+     * Expired holds are also processed by the service's own calls; this is
+     * for callers that want seats freed without waiting for traffic.
+     *
+     * @return The number of holds that expired.
+     */
+    std::size_t expireHolds();
+
+    /**
+     * @brief Write a checkpoint of the current state and truncate the log.
+     *
+     * Does nothing for a service without a log. Bookings continue while the
+     * checkpoint is written; catalog changes wait for it.
+     */
+    void checkpoint();
     
     /**
      * @brief Check if a movie with a given ID exists.
@@ -119,41 +496,441 @@ public:
      * @note Can throw invalid_argument exception
      */
     std::string getTheaterName(int theaterId) const;
+
+    /**
+     * @brief Get the name of a movie by its ID without copying it.
+     *
+     * @param movieId The ID of the movie.
+     * @return A view of the interned name, valid until the process exits.
+     * @note Can throw invalid_argument exception
+     */
+    std::string_view getMovieNameView(int movieId) const;
+
+    /**
+     * @brief Get the name of a theater by its ID without copying it.
+     *
+     * @param theaterId The ID of the theater.
+     * @return A view of the interned name, valid until the process exits.
+     * @note Can throw invalid_argument exception
+     */
+    std::string_view getTheaterNameView(int theaterId) const;
+
+    /**
+     * @brief Look up the name of a movie without throwing.
+     *
+     * @param movieId The ID of the movie.
+     * @return A view of the interned name, or std::nullopt if the movie is unknown.
+     */
+    std::optional<std::string_view> findMovieName(int movieId) const;
+
+    /**
+     * @brief Look up the name of a theater without throwing.
+     *
+     * @param theaterId The ID of the theater.
+     * @return A view of the interned name, or std::nullopt if the theater is unknown.
+     */
+    std::optional<std::string_view> findTheaterName(int theaterId) const;
+
+    /**
+     * @brief Get the sequence the next event will have.
+     *
+     * Subscribing from here and then reading the state to mirror misses
+     * nothing, provided the subscriber is not lapped.
+     */
+    std::uint64_t getEventSequence() const;
+
+    /**
+     * @brief Follow seat and catalog changes.
+     *
+     * Events are kept for the last kEventCapacity changes; a subscriber
+     * that falls further behind is told it was lapped and falls back to a
+     * snapshot (see EventSubscription). Changes recovered from the log at
+     * construction are not published.
+     *
+     * @param fromSequence First sequence to read, e.g. from getEventSequence()
+     *                     or the position of an earlier subscription.
+     * @return The subscription; valid while the service lives.
+     */
+    EventSubscription subscribe(std::uint64_t fromSequence) const;
+
+    /**
+     * @brief Keep the log records of changes for read replicas.
+     *
+     * From here on every change the write-ahead log would record is also
+     * appended, once durable, to a ReplicationLog, whether or not this
+     * service is durable. A replica loads getReplicationSnapshot() and then
+     * applies readReplicationLog() from the returned sequence on. Holds are
+     * not replicated; a confirmed hold is replicated as a booking. Calling
+     * it again has no effect.
+     *
+     * @param retainedRecords Records kept for replicas that fall behind.
+     */
+    void enableReplication(std::size_t retainedRecords = kReplicationCapacity);
+
+    /**
+     * @brief Get the ID of the replication log, or 0 if replication is off.
+     */
+    std::uint64_t getReplicationLogId() const;
+
+    /**
+     * @brief Get the sequence of the last replicated change, or 0 if none.
+     */
+    std::uint64_t getReplicationSequence() const;
+
+    /**
+     * @brief Encode the current state for a new replica.
+     *
+     * @param records Receives the state as log records; cleared first.
+     * @return The sequence the state is current to: the replica then reads
+     *         the log after it. Changes after it may already be reflected;
+     *         applying them again is harmless.
+     * @note Can throw std::logic_error if replication is off
+     */
+    std::uint64_t getReplicationSnapshot(std::vector<std::string>& records);
+
+    /**
+     * @brief Read the replicated changes following a position.
+     *
+     * @param logId The replication log the position refers to.
+     * @param after Sequence of the last change the replica applied.
+     * @param records Receives the log records after it, in order.
+     * @param maxRecords Maximum number of records to read.
+     * @return Ok, or Lapped if the replica must load a new snapshot (also
+     *         when replication is off).
+     */
+    ReplicationLog::ReadStatus readReplicationLog(std::uint64_t logId, std::uint64_t after,
+                                                  std::vector<std::string>& records, std::size_t maxRecords) const;
+
+    /**
+     * @brief Replace the whole state with a primary's snapshot; replica side.
+     *
+     * @param records The records of getReplicationSnapshot().
+     */
+    void loadReplicationSnapshot(const std::vector<std::string>& records);
+
+    /**
+     * @brief Apply a primary's replicated changes in order; replica side.
+     *
+     * Neither this nor loadReplicationSnapshot() publishes events.
+     *
+     * @param records The records of readReplicationLog().
+     */
+    void applyReplicationRecords(const std::vector<std::string>& records);
+
+    /**
+     * @brief Get the operation metrics recorded so far.
+     *
+     * @return Calls, failures and latency per public method, lock waits and
+     *         event counters, summed over all threads.
+     */
+    ServiceMetrics::Snapshot getMetrics() const;
+
+    /**
+     * @brief Dump the operation metrics recorded so far.
+     *
+     * @param format Text tables or a JSON object.
+     * @return The formatted metrics.
+     */
+    std::string dumpMetrics(ServiceMetrics::Format format = ServiceMetrics::Format::Text) const;
     
 private:
 
-    mutable std::mutex mBookingMutex;  /**< Mutex for synchronization of booking operations. */
+    /**
+     * @struct Catalog
+     * @brief Immutable snapshot of movies, theaters, allocations and shows.
+     *
+     * Readers load the current snapshot and never see it change. Writers copy
+     * it, apply their change to the copy and publish the copy. Every table
+     * is an IdTable, so a lookup on the request path is a single probe, and
+     * copies share the tables' storage, so a copy is O(1) and adding a movie
+     * or a theater costs O(1) amortized whatever the catalog size.
+     * Movie, Theater and Show objects are shared between snapshots; seat state
+     * lives in the theaters and shows and is updated in place with atomics.
+     */
+    struct Catalog {
+        IdTable<std::shared_ptr<Movie>> movies; /**< Stores movie data*/
+
+        IdTable<std::shared_ptr<TheaterBase>> theaters; /**< Stores theater  data*/
+
+        AllocationEngine allocations; /**< Which movie each theater shows, both ways. */
+
+        IdTable<std::shared_ptr<Show>> shows; /**< Show ID -> show. */
+
+        IdTable<SharedVector<int>> movieShows; /**< Movie ID -> show IDs in the order added. */
+
+        IdTable<SharedVector<int>> theaterShows; /**< Theater ID -> show IDs in the order added. */
+
+        IdTable<std::shared_ptr<std::atomic<std::int64_t>>> movieAvailability; /**< Movie ID -> free seats of its theaters, shared by snapshots. */
 
-    std::map<int, std::unique_ptr<Movie>> mMovies; /**< Stores movie data*/
+        /**
+         * @brief Check if a movie with a given ID exists.
+         */
+        bool hasMovie(int movieId) const;
+
+        /**
+         * @brief Check if a theater with a given ID exists.
+         */
+        bool hasTheater(int theaterId) const;
+
+        /**
+         * @brief Add a movie, shown nowhere yet.
+         *
+         * @return False if the movie ID is known.
+         */
+        bool addMovie(std::shared_ptr<Movie> movie);
+
+        /**
+         * @brief Add a theater, showing nothing yet.
+         *
+         * @return False if the theater ID is known.
+         */
+        bool addTheater(int theaterId, std::shared_ptr<TheaterBase> theater);
+
+        /**
+         * @brief Allocate a movie to a theater in this catalog only; see markAllocated.
+         *
+         * @return False if either is unknown or the theater already shows a movie.
+         */
+        bool allocate(int movieId, int theaterId);
+
+        /**
+         * @brief Allocate waiting movies to free theaters.
+         *
+         * Movies shown nowhere are paired with theaters showing nothing, each
+         * in the order they were added, in O(1) per allocation.
+         *
+         * @param random If not null, theaters still free afterwards are given
+         *               a movie picked with it.
+         * @return The (movie ID, theater ID) pairs allocated, in this catalog only;
+         *         see markAllocated.
+         */
+        std::vector<std::pair<int, int>> planAllocations(std::mt19937* random);
+
+        /**
+         * @brief Flag newly allocated theaters and count their free seats for
+         *        their movies.
+         *
+         * The theaters and counters are shared with other snapshots and a
+         * counter attaches once, so this runs only after the catalog holding
+         * the allocations is logged and published.
+         *
+         * @param allocated The (movie ID, theater ID) pairs allocated.
+         */
+        void markAllocated(const std::vector<std::pair<int, int>>& allocated) const;
+
+        /**
+         * @brief Add a show over its theater's layout and index it.
+         *
+         * @return False if the show is rejected (see addShow).
+         */
+        bool addShow(const ShowInfo& show);
+
+        /**
+         * @brief Get the shows listed in an index entry by start time; shows
+         *        starting together stay in the order they were added.
+         */
+        std::vector<ShowInfo> showInfos(const SharedVector<int>& showIds) const;
+    };
 
-    std::map<int, std::unique_ptr<Theater>> mTheaters; /**< Stores theater  data*/
     /**
-     * @brief A map to track movie allocations to theaters.
+     * @brief Get the currently published catalog snapshot.
      *
-     * This map associates movie IDs with vectors of theater IDs to represent
-     * which theaters are allocated for each movie.
+     * @return The snapshot; it stays valid and unchanged while referenced.
      */
-    std::map<int, std::vector<int>> mMovieTheaterAllocations;
-    
+    std::shared_ptr<const Catalog> catalog() const;
+
     /**
-     * @brief Allocate a movie to one or more theaters.
+     * @brief Publish a new catalog snapshot. The caller must hold mWriterMutex.
      *
-     * This method allocates the specified movie to one or more theaters.
+     * @param catalog The snapshot to publish.
+     */
+    void publish(std::shared_ptr<const Catalog> catalog);
+
+    /**
+     * @brief Apply one log record to an unpublished catalog during recovery.
      *
-     * @param movie  Movie id to allocate to theaters.
-     * @return True if the allocated, false otherwise.
+     * Records are applied idempotently, so replaying a record that is
+     * already reflected in the checkpoint is harmless.
+     *
+     * @param catalog The catalog being recovered.
+     * @param record The encoded record.
+     * @param allocated Receives the allocations made, to mark once the
+     *                  catalog is published.
      */
-    bool allocateMovieToTheaters(int movieId);
-    
+    static void replayRecord(Catalog& catalog, const std::string& record,
+                             std::vector<std::pair<int, int>>& allocated);
+
     /**
-     * @brief Check if a theater with a given ID exists.
+     * @brief Apply a record holding only bookings to a published catalog.
      *
-     * @param theaterId The ID of the theater to check.
-     * @return True if the theater exists, false otherwise.
+     * @param catalog The catalog whose theaters and shows are booked.
+     * @param record The encoded record.
+     */
+    static void replayBookings(const Catalog& catalog, const std::string& record);
+
+    /**
+     * @brief Check if changes are encoded as log records: the service is
+     *        durable or replicated.
+     */
+    bool logsChanges() const;
+
+    /**
+     * @brief Append a record to the log, if the service is durable, and to
+     *        the replication log, if replication is enabled.
+     *
+     * @param record The encoded record.
+     */
+    void logRecord(const std::string& record);
+
+    /**
+     * @brief Take a checkpoint if enough records were logged since the last one.
+     *
+     * Must be called without mWriterMutex held.
+     */
+    void checkpointIfDue();
+
+    /**
+     * @brief Start a new log and write a checkpoint covering the old one.
+     *
+     * The caller must hold mCheckpointMutex.
+     */
+    void rotateLog();
+
+    /**
+     * @brief Write the current state to the checkpoint file.
+     *
+     * The caller must hold mCheckpointMutex and mWriterMutex.
+     */
+    void writeCheckpoint() const;
+
+    /**
+     * @brief Encode a catalog as log records, as checkpoints and replica snapshots hold it.
+     *
+     * @param catalog The catalog; seat state is read live.
+     * @param sink Callable invoked with each record.
+     */
+    static void writeSnapshotRecords(const Catalog& catalog, const std::function<void(const std::string&)>& sink);
+
+    /**
+     * @struct Hold
+     * @brief Seats held for a pending checkout.
+     */
+    struct Hold {
+        std::shared_ptr<TheaterBase> theater; /**< Theater owning the seats, null for a show hold. */
+        std::shared_ptr<Show> show;       /**< Show owning the seats, null for a theater hold. */
+        std::vector<int> seatIds;         /**< Held seat IDs. */
+
+        /**
+         * @brief Book the held seats in their theater or show.
+         */
+        bool confirmSeats() const;
+
+        /**
+         * @brief Free the held seats in their theater or show.
+         */
+        bool releaseSeats() const;
+
+        /**
+         * @brief Free the seats again after confirming them, in their theater or show.
+         */
+        bool cancelSeats() const;
+
+        /**
+         * @brief Get the theater of the seats.
+         */
+        int theaterId() const;
+    };
+
+    /**
+     * @brief Commit one seat event per seat to claimed sequences.
+     *
+     * Bookings, holds and confirmations are sequenced after they change the
+     * seats. Releases are sequenced before they free them, so whoever takes
+     * a seat next is sequenced after the release. Either way a seat's events
+     * are in the order of its state changes.
+     *
+     * @param first First sequence claimed for the seats.
+     * @param type The change.
+     * @param theaterId The theater, for theater seats.
+     * @param show The show, for show seats; null for theater seats.
+     * @param seatIds The seats, one event each.
+     */
+    void commitSeatEvents(std::uint64_t first, EventType type, int theaterId, const Show* show,
+                          const std::vector<int>& seatIds);
+
+    /**
+     * @brief Publish the events of added movies or theaters and of the
+     *        allocations that followed. The caller must hold mWriterMutex.
+     *
+     * @param type MovieAdded or TheaterAdded.
+     * @param ids Movie or theater IDs added.
+     * @param allocations The (movie ID, theater ID) pairs allocated.
+     */
+    void publishCatalogEvents(EventType type, const std::vector<int>& ids,
+                              const std::vector<std::pair<int, int>>& allocations);
+
+    /**
+     * @brief Register held seats and schedule their expiration.
+     *
+     * @param hold The seats, already held in their theater or show.
+     * @param ttl How long the hold stays valid.
+     * @return The hold ID.
+     */
+    HoldId addHold(Hold hold, std::chrono::milliseconds ttl);
+
+    /**
+     * @brief Current hold clock tick, in milliseconds since construction.
+     */
+    std::uint64_t currentTick() const;
+
+    /**
+     * @brief Release expired holds. The caller must hold mHoldMutex.
+     *
+     * @return The number of holds that expired.
+     */
+    std::size_t expireHoldsLocked();
+
+    /**
+     * @brief Release expired holds if there are holds and nobody else is at it.
      */
-    bool isValidTheater(int theaterId) const;
+    void expireHoldsIfDue();
+
+    mutable ServiceMetrics mMetrics; /**< Operation metrics; recorded by const calls too. */
+
+    std::mutex mWriterMutex;  /**< Serializes catalog writers (addMovie, addTheater). */
+
+    std::mt19937 mRandom{std::random_device{}()}; /**< Picks movies for theaters left free; guarded by mWriterMutex. */
+
+    std::shared_ptr<const Catalog> mCatalog = std::make_shared<const Catalog>(); /**< Published snapshot, accessed atomically. */
+
+    std::unique_ptr<WriteAheadLog> mLog; /**< Write-ahead log, null when not durable. */
+
+    std::string mCheckpointPath; /**< Path of the checkpoint file. */
+
+    std::size_t mCheckpointInterval = kDefaultCheckpointInterval; /**< Log records between checkpoints. */
+
+    std::atomic<std::size_t> mRecordsSinceCheckpoint{0}; /**< Log records appended since the last checkpoint. */
+
+    std::mutex mCheckpointMutex; /**< Serializes checkpoints. */
+
+    std::mutex mHoldMutex;  /**< Guards mHolds, mHoldTimers and mNextHoldId. */
+
+    std::unordered_map<HoldId, Hold> mHolds; /**< Live holds. */
+
+    TimerWheel mHoldTimers; /**< Hold expirations, one tick per millisecond. */
+
+    HoldId mNextHoldId = 1; /**< Next hold ID to hand out. */
+
+    std::atomic<std::size_t> mActiveHolds{0}; /**< Number of live holds, read without the lock. */
+
+    EventRing mEvents{kEventCapacity}; /**< Seat and catalog change events. */
+
+    std::unique_ptr<ReplicationLog> mReplicationLog; /**< Records for replicas, null until replication is enabled. */
+
+    std::atomic<ReplicationLog*> mReplication{nullptr}; /**< mReplicationLog, read without the writer lock. */
+
+    const std::chrono::steady_clock::time_point mClockStart = std::chrono::steady_clock::now(); /**< Hold clock origin. */
 
 };
 
 #endif // MOVIE_BOOKING_SERVICE_HPP
-
@@ -0,0 +1,62 @@
+/**
+ * @file name_pool.hpp
+ * @brief Process-wide pool of interned movie and theater names.
+ * @author Gebremedhin Abreha
+ */
+#ifndef NAME_POOL_HPP
+#define NAME_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @class NamePool
+ * @brief Stores each distinct name once and hands out views of it.
+ *
+ * Names are copied into large blocks that are never freed or moved, so a
+ * view returned by intern() stays valid for the life of the process and
+ * can be passed around without allocating. Equal names share one copy,
+ * which matters for catalogs where many theaters are called "Screen 1".
+ *
+ * Interning takes a lock; reading an interned name does not.
+ */
+class NamePool {
+public:
+    /**
+     * @brief Get the pool shared by all movies and theaters.
+     */
+    static NamePool& shared();
+
+    /**
+     * @brief Get the pooled copy of a name, adding it if it is new.
+     *
+     * @param name The name.
+     * @return A view of the pooled copy, valid until the process exits.
+     */
+    std::string_view intern(std::string_view name);
+
+    /**
+     * @brief Get the number of distinct names in the pool.
+     */
+    std::size_t size() const;
+
+private:
+    static constexpr std::size_t kBlockSize = 4096; /**< Bytes per block of names. */
+
+    /**
+     * @brief Copy a name into the pool's blocks.
+     */
+    std::string_view store(std::string_view name);
+
+    mutable std::mutex mMutex;                     /**< Guards everything below. */
+    std::unordered_set<std::string_view> mNames;   /**< Views of the pooled names. */
+    std::vector<std::unique_ptr<char[]>> mBlocks;  /**< Storage of the pooled names. */
+    char* mFree = nullptr;                         /**< First unused byte of the current block. */
+    std::size_t mFreeSize = 0;                     /**< Unused bytes left in the current block. */
+};
+
+#endif /* NAME_POOL_HPP */
@@ -0,0 +1,90 @@
+/**
+ * @file replication_log.hpp
+ * @brief Bounded, sequenced copy of a primary's log records for its replicas.
+ * @author Gebremedhin Abreha
+ */
+#ifndef REPLICATION_LOG_HPP
+#define REPLICATION_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class ReplicationLog
+ * @brief Keeps the latest log records of a primary, numbered in append order.
+ *
+ * Records are numbered from 1 without gaps. Replicas read the records after
+ * the last one they applied; only the latest capacity() records are kept,
+ * so a replica that falls further behind is told it was lapped and starts
+ * over from a snapshot. Every log has a random ID: a replica that was
+ * following another log, e.g. before the primary restarted, is lapped too,
+ * since the same sequence numbers mean different records there.
+ */
+class ReplicationLog {
+public:
+    /**
+     * @enum ReadStatus
+     * @brief Outcome of a read.
+     */
+    enum class ReadStatus {
+        Ok,    /**< The records after the position were returned (possibly none). */
+        Lapped /**< The position is no longer, or never was, in this log. */
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param capacity Number of records kept; at least one.
+     */
+    explicit ReplicationLog(std::size_t capacity);
+
+    ReplicationLog(const ReplicationLog&) = delete;
+    ReplicationLog& operator=(const ReplicationLog&) = delete;
+
+    /**
+     * @brief Append a record, dropping the oldest one when full.
+     *
+     * @return The record's sequence number.
+     */
+    std::uint64_t append(const std::string& record);
+
+    /**
+     * @brief Copy the records following a position.
+     *
+     * @param logId The log the position refers to.
+     * @param after Sequence of the last record the reader has; 0 for none.
+     * @param records Receives the records after it, in order; cleared first.
+     * @param maxRecords Maximum number of records to copy.
+     * @return Ok, or Lapped if the reader must start over from a snapshot.
+     */
+    ReadStatus read(std::uint64_t logId, std::uint64_t after, std::vector<std::string>& records,
+                    std::size_t maxRecords) const;
+
+    /**
+     * @brief Get the sequence of the last record appended; 0 for none.
+     */
+    std::uint64_t lastSequence() const;
+
+    /**
+     * @brief Get the random ID of this log.
+     */
+    std::uint64_t id() const;
+
+    /**
+     * @brief Get the number of records kept.
+     */
+    std::size_t capacity() const;
+
+private:
+    const std::uint64_t mId;        /**< Random log ID. */
+    const std::size_t mCapacity;    /**< Records kept. */
+    mutable std::mutex mMutex;      /**< Guards the members below. */
+    std::deque<std::string> mRecords; /**< The latest records, oldest first. */
+    std::uint64_t mLastSequence = 0; /**< Sequence of the newest record. */
+};
+
+#endif /* REPLICATION_LOG_HPP */
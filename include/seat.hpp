@@ -6,15 +6,34 @@
 #define SEAT_HPP
 
 #include <string>
+#include <vector>
+
+/**
+ * @enum SeatState
+ * @brief Booking state of a seat.
+ */
+enum class SeatState {
+    Free,   /**< The seat can be held or booked. */
+    Held,   /**< The seat is held for a pending checkout. */
+    Booked  /**< The seat is sold. */
+};
 
 /**
  * @struct Seat
  * @brief Represents a seat with an ID, seat number, and booking status.
+ *
+ * A seat can also be placed in the auditorium by section, row and position,
+ * which lets the theater find adjacent seats for a party.
  */
 struct Seat {
+    static constexpr int kNoRow = -1; /**< Row of a seat that is not placed in a row. */
+
     int id;             /**< Unique identifier for the seat. */
     std::string seatNumber; /**< Seat number or identifier. */
     bool isBooked;      /**< True if the seat is booked, false if it's available. */
+    int section = 0;    /**< Section of the auditorium the seat is in. */
+    int row = kNoRow;   /**< Row within the section, kNoRow if the seat has no row. */
+    int position = 0;   /**< Position within the row; adjacent seats differ by one. */
     
     /**
      * @brief Equality operator for comparing seats based on their  unique IDs.
@@ -29,4 +48,28 @@ struct Seat {
     }
 };
 
+/**
+ * @brief Free seats with IDs 0..count-1 numbered "Seat 1".."Seat <count>".
+ *
+ * @param count The number of seats.
+ * @param seatsPerRow If positive, the seats fill rows of this many, row by
+ *                    row; otherwise they have no rows.
+ * @return The seats in ID order.
+ */
+inline std::vector<Seat> numberedSeats(int count, int seatsPerRow = 0)
+{
+    std::vector<Seat> seats;
+    seats.reserve(count > 0 ? count : 0);
+    for (int i = 0; i < count; ++i)
+    {
+        seats.push_back(Seat{i, "Seat " + std::to_string(i + 1), false});
+        if (seatsPerRow > 0)
+        {
+            seats.back().row = i / seatsPerRow;
+            seats.back().position = i % seatsPerRow;
+        }
+    }
+    return seats;
+}
+
 #endif /* SEAT_HPP */
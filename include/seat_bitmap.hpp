@@ -0,0 +1,615 @@
+/**
+ * @file seat_bitmap.hpp
+ * @brief Word-packed occupancy bitmap used for seat state.
+ * @author Gebremedhin Abreha
+ */
+#ifndef SEAT_BITMAP_HPP
+#define SEAT_BITMAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Bit helpers used by the bitmap scans.
+ */
+namespace bits {
+
+constexpr std::size_t kWordBits = 64; /**< Bits per bitmap word. */
+
+/**
+ * @brief Number of words holding a bit count.
+ */
+constexpr std::size_t wordCount(std::size_t bitCount)
+{
+    return (bitCount + kWordBits - 1) / kWordBits;
+}
+
+/**
+ * @brief Count the set bits of a 64-bit word.
+ */
+inline std::size_t popcount(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_popcountll(word));
+#else
+    std::size_t count = 0;
+    for (; word; word &= word - 1) ++count;
+    return count;
+#endif
+}
+
+/**
+ * @brief Index of the lowest set bit of a non-zero 64-bit word.
+ */
+inline std::size_t countTrailingZeros(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+    std::size_t index = 0;
+    for (; !(word & 1u); word >>= 1) ++index;
+    return index;
+#endif
+}
+
+} // namespace bits
+
+/**
+ * @struct WordMask
+ * @brief Bits to change within one bitmap word.
+ */
+struct WordMask {
+    std::size_t word;   /**< Word index. */
+    std::uint64_t mask; /**< Bits of the word. */
+};
+
+/**
+ * @class InlineWordMasks
+ * @brief Up to WordCount WordMasks kept in place, for seat sets that never allocate.
+ */
+template <std::size_t WordCount>
+class InlineWordMasks {
+public:
+    WordMask* begin() { return mMasks.data(); }
+    WordMask* end() { return mMasks.data() + mSize; }
+    const WordMask* begin() const { return mMasks.data(); }
+    const WordMask* end() const { return mMasks.data() + mSize; }
+
+    /**
+     * @brief Insert a mask before a position; there must be room for it.
+     */
+    WordMask* insert(WordMask* position, const WordMask& mask)
+    {
+        std::copy_backward(position, end(), end() + 1);
+        *position = mask;
+        ++mSize;
+        return position;
+    }
+
+private:
+    std::array<WordMask, WordCount> mMasks; /**< Masks, the first mSize in use. */
+    std::size_t mSize = 0;                  /**< Masks in use. */
+};
+
+/**
+ * @class HeapSeatWords
+ * @brief Bitmap words on the heap, as many as the seats need.
+ */
+class HeapSeatWords {
+public:
+    using Masks = std::vector<WordMask>; /**< Bits of a seat set, word by word. */
+
+    /**
+     * @brief Constructor allocating the words for a number of seats, uninitialized.
+     */
+    explicit HeapSeatWords(std::size_t seats);
+
+    /**
+     * @brief Copy constructor, copies a point-in-time view of the words.
+     */
+    HeapSeatWords(const HeapSeatWords& other);
+
+    /**
+     * @brief Move constructor, leaves the source without seats.
+     */
+    HeapSeatWords(HeapSeatWords&& other) noexcept;
+
+    /**
+     * @brief Copy assignment, copies a point-in-time view of the words.
+     */
+    HeapSeatWords& operator=(const HeapSeatWords& other);
+
+    /**
+     * @brief Move assignment, leaves the source without seats.
+     */
+    HeapSeatWords& operator=(HeapSeatWords&& other) noexcept;
+
+    std::size_t seats() const { return mSeats; }
+    std::size_t size() const { return mWordCount; }
+    std::atomic<std::uint64_t>& operator[](std::size_t word) { return mWords[word]; }
+    const std::atomic<std::uint64_t>& operator[](std::size_t word) const { return mWords[word]; }
+
+private:
+    std::size_t mSeats;                /**< Number of seats tracked. */
+    std::size_t mWordCount;            /**< Number of words. */
+    std::unique_ptr<std::atomic<std::uint64_t>[]> mWords; /**< The words. */
+};
+
+/**
+ * @class InlineSeatWords
+ * @brief Bitmap words in place, for at most WordCount words of seats.
+ */
+template <std::size_t WordCount>
+class InlineSeatWords {
+public:
+    using Masks = InlineWordMasks<WordCount>; /**< Bits of a seat set, word by word. */
+
+    /**
+     * @brief Constructor for a number of seats, words uninitialized.
+     *
+     * @throws std::invalid_argument If the seats need more than WordCount words.
+     */
+    explicit InlineSeatWords(std::size_t seats):
+    mSeats(seats)
+    {
+        if (bits::wordCount(seats) > WordCount)
+            throw std::invalid_argument("Too many seats for the inline bitmap");
+    }
+
+    /**
+     * @brief Copy constructor, copies a point-in-time view of the words.
+     */
+    InlineSeatWords(const InlineSeatWords& other):
+    mSeats(other.mSeats)
+    {
+        copyWords(other);
+    }
+
+    /**
+     * @brief Copy assignment, copies a point-in-time view of the words.
+     */
+    InlineSeatWords& operator=(const InlineSeatWords& other)
+    {
+        mSeats = other.mSeats;
+        copyWords(other);
+        return *this;
+    }
+
+    std::size_t seats() const { return mSeats; }
+    std::size_t size() const { return bits::wordCount(mSeats); }
+    std::atomic<std::uint64_t>& operator[](std::size_t word) { return mWords[word]; }
+    const std::atomic<std::uint64_t>& operator[](std::size_t word) const { return mWords[word]; }
+
+private:
+    void copyWords(const InlineSeatWords& other)
+    {
+        for (std::size_t w = 0; w < other.size(); ++w)
+        {
+            mWords[w].store(other.mWords[w].load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t mSeats;                                  /**< Number of seats tracked. */
+    std::array<std::atomic<std::uint64_t>, WordCount> mWords; /**< The words, the first size() in use. */
+};
+
+/**
+ * @class BasicSeatBitmap
+ * @brief Dense seat-index -> occupied bit map packed into 64-bit words.
+ *
+ * Bit i is set when the seat at index i is taken. The unused tail bits of the
+ * last word are kept set, so scans for free seats never need a tail mask.
+ *
+ * Words are atomic: single bits are claimed with fetch_or and seat sets with
+ * a compare-and-swap per word, so concurrent bookings need no mutex.
+ *
+ * Where the words live is up to the Words storage: SeatBitmap keeps them on
+ * the heap, FixedSeatBitmap inside the object. A seat set is first grouped
+ * into Words::Masks, which for inline storage never allocates either.
+ *
+ * @tparam Words HeapSeatWords or InlineSeatWords.
+ */
+template <typename Words>
+class BasicSeatBitmap {
+public:
+    static constexpr std::size_t kWordBits = bits::kWordBits; /**< Bits per occupancy word. */
+
+    using Masks = typename Words::Masks; /**< Bits of a seat set, word by word. */
+
+    /**
+     * @brief Constructor creating a bitmap with all seats free.
+     *
+     * @param size Number of seats tracked by the bitmap.
+     */
+    explicit BasicSeatBitmap(std::size_t size = 0);
+
+    /**
+     * @brief Number of seats tracked by the bitmap.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Check if the seat at an index is taken.
+     *
+     * @param index Seat index.
+     * @return True if the bit is set, false if free or out of range.
+     */
+    bool test(std::size_t index) const;
+
+    /**
+     * @brief Mark the seat at an index as taken.
+     *
+     * @param index Seat index.
+     * @return True if the bit changed from free to taken, false otherwise.
+     */
+    bool set(std::size_t index);
+
+    /**
+     * @brief Mark the seat at an index as free.
+     *
+     * @param index Seat index.
+     * @return True if the bit changed from taken to free, false otherwise.
+     */
+    bool reset(std::size_t index);
+
+    /**
+     * @brief Mark a set of seats as taken, all or nothing.
+     *
+     * See setMasks.
+     *
+     * @param indices Seat indices to claim; must be in range and distinct.
+     * @return True if every seat was claimed, false otherwise.
+     */
+    bool setAll(const std::vector<std::size_t>& indices);
+
+    /**
+     * @brief Mark a set of seats as free.
+     *
+     * @param indices Seat indices to release.
+     * @return True if every seat was taken and is now free, false otherwise.
+     */
+    bool resetAll(const std::vector<std::size_t>& indices);
+
+    /**
+     * @brief Add a seat to the masks of a seat set, kept in ascending word order.
+     *
+     * @param index Seat index.
+     * @param masks The seat set so far.
+     * @return False if the index is out of range or already in the set.
+     */
+    bool addToMasks(std::size_t index, Masks& masks) const;
+
+    /**
+     * @brief Mark a set of seats as taken, all or nothing.
+     *
+     * Each affected word is claimed with a compare-and-swap, in ascending word
+     * order. If any seat is already taken, the words claimed so far are
+     * released again and nothing is left set.
+     *
+     * @param masks The seats, from addToMasks.
+     * @return True if every seat was claimed, false otherwise.
+     */
+    bool setMasks(const Masks& masks);
+
+    /**
+     * @brief Mark a set of seats as free.
+     *
+     * @param masks The seats, from addToMasks.
+     * @return True if every seat was taken and is now free, false otherwise.
+     */
+    bool resetMasks(const Masks& masks);
+
+    /**
+     * @brief Mark a set of taken seats as free, all or nothing.
+     *
+     * The mirror of setMasks: each affected word is cleared with a
+     * compare-and-swap only while all its seats are taken, in ascending word
+     * order. If any seat is already free, the words cleared so far are set
+     * again and nothing is left cleared, so of two callers clearing the same
+     * seats exactly one succeeds.
+     *
+     * @param masks The seats, from addToMasks.
+     * @return True if every seat was taken and is now free, false otherwise.
+     */
+    bool resetMasksIfTaken(const Masks& masks);
+
+    /**
+     * @brief Number of taken seats.
+     */
+    std::size_t count() const;
+
+    /**
+     * @brief Number of free seats.
+     */
+    std::size_t countFree() const;
+
+    /**
+     * @brief Call a visitor with the index of every free seat, in index order.
+     *
+     * @param visit Callable taking a std::size_t seat index.
+     */
+    template <typename Visitor>
+    void forEachFree(Visitor&& visit) const
+    {
+        for (std::size_t w = 0; w < mWords.size(); ++w)
+        {
+            std::uint64_t freeBits = ~mWords[w].load(std::memory_order_acquire);
+            for (; freeBits; freeBits &= freeBits - 1)
+            {
+                visit(w * kWordBits + bits::countTrailingZeros(freeBits));
+            }
+        }
+    }
+
+    /**
+     * @brief Call a visitor with every maximal run of free seats in a range.
+     *
+     * Runs are found a word at a time: the start and end of each run are
+     * located with a count-trailing-zeros, so the cost is one step per word
+     * plus one per run, not one per seat.
+     *
+     * @param begin First seat index of the range.
+     * @param end One past the last seat index of the range; at most size().
+     * @param visit Callable taking the run's (begin, end) seat indices.
+     */
+    template <typename Visitor>
+    void forEachFreeRun(std::size_t begin, std::size_t end, Visitor&& visit) const
+    {
+        std::size_t runBegin = end; // No run open
+        for (std::size_t w = begin / kWordBits; w * kWordBits < end; ++w)
+        {
+            const std::size_t base = w * kWordBits;
+            std::uint64_t freeBits = ~mWords[w].load(std::memory_order_acquire);
+            if (base < begin)
+                freeBits &= ~std::uint64_t{0} << (begin - base);
+            if (end - base < kWordBits)
+                freeBits &= (std::uint64_t{1} << (end - base)) - 1;
+
+            std::size_t bit = 0;
+            while (true)
+            {
+                if (runBegin == end)
+                {
+                    const std::uint64_t free = freeBits >> bit;
+                    if (!free)
+                        break;
+                    bit += bits::countTrailingZeros(free);
+                    runBegin = base + bit;
+                }
+                const std::uint64_t taken = ~freeBits >> bit;
+                if (!taken)
+                    break; // The run goes on into the next word
+                bit += bits::countTrailingZeros(taken);
+                visit(runBegin, base + bit);
+                runBegin = end;
+            }
+        }
+        if (runBegin != end)
+            visit(runBegin, end);
+    }
+
+private:
+    Words mWords; /**< Occupancy words, bit set = taken. */
+};
+
+/*----------------------------------------------------*/
+template <typename Words>
+BasicSeatBitmap<Words>::BasicSeatBitmap(std::size_t size):
+mWords(size)
+{
+    for (std::size_t w = 0; w < mWords.size(); ++w)
+    {
+        mWords[w].store(0, std::memory_order_relaxed);
+    }
+    // Padding bits past the last seat are permanently "taken"
+    if (const std::size_t tail = size % kWordBits; tail != 0)
+    {
+        mWords[mWords.size() - 1].store(~std::uint64_t{0} << tail, std::memory_order_relaxed);
+    }
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+std::size_t BasicSeatBitmap<Words>::size() const
+{
+    return mWords.seats();
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+bool BasicSeatBitmap<Words>::test(std::size_t index) const
+{
+    if (index >= size())
+        return false;
+    return (mWords[index / kWordBits].load(std::memory_order_acquire) >> (index % kWordBits)) & 1u;
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+bool BasicSeatBitmap<Words>::set(std::size_t index)
+{
+    if (index >= size())
+        return false;
+
+    const std::uint64_t mask = std::uint64_t{1} << (index % kWordBits);
+    const std::uint64_t previous = mWords[index / kWordBits].fetch_or(mask, std::memory_order_acq_rel);
+    return !(previous & mask); //False if already taken
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+bool BasicSeatBitmap<Words>::reset(std::size_t index)
+{
+    if (index >= size())
+        return false;
+
+    const std::uint64_t mask = std::uint64_t{1} << (index % kWordBits);
+    const std::uint64_t previous = mWords[index / kWordBits].fetch_and(~mask, std::memory_order_acq_rel);
+    return previous & mask; //False if already free
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+bool BasicSeatBitmap<Words>::addToMasks(std::size_t index, Masks& masks) const
+{
+    if (index >= size())
+        return false;
+
+    const std::size_t word = index / kWordBits;
+    const std::uint64_t bit = std::uint64_t{1} << (index % kWordBits);
+    const auto position = std::lower_bound(masks.begin(), masks.end(), word,
+                                           [](const WordMask& mask, std::size_t w) { return mask.word < w; });
+    if (position == masks.end() || position->word != word)
+    {
+        masks.insert(position, WordMask{word, bit});
+        return true;
+    }
+    if (position->mask & bit)
+        return false; //Repeated seat
+    position->mask |= bit;
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+bool BasicSeatBitmap<Words>::setAll(const std::vector<std::size_t>& indices)
+{
+    Masks masks;
+    for (const auto index : indices)
+    {
+        if (!addToMasks(index, masks))
+            return false;
+    }
+    return setMasks(masks);
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+bool BasicSeatBitmap<Words>::resetAll(const std::vector<std::size_t>& indices)
+{
+    Masks masks;
+    for (const auto index : indices)
+    {
+        if (!addToMasks(index, masks))
+            return false;
+    }
+    return resetMasks(masks);
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+bool BasicSeatBitmap<Words>::setMasks(const Masks& masks)
+{
+    for (auto claim = masks.begin(); claim != masks.end(); ++claim)
+    {
+        auto& word = mWords[claim->word];
+        std::uint64_t current = word.load(std::memory_order_acquire);
+        bool claimed = false;
+        while (!(current & claim->mask))
+        {
+            // Retries only when other bits of the word changed underneath us
+            if (word.compare_exchange_weak(current, current | claim->mask,
+                                           std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                claimed = true;
+                break;
+            }
+        }
+
+        if (!claimed)
+        {
+            // Conflict: give back the words claimed so far
+            for (auto claimedMask = masks.begin(); claimedMask != claim; ++claimedMask)
+            {
+                mWords[claimedMask->word].fetch_and(~claimedMask->mask, std::memory_order_acq_rel);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+bool BasicSeatBitmap<Words>::resetMasks(const Masks& masks)
+{
+    bool allTaken = true;
+    for (const auto& [wordIndex, mask] : masks)
+    {
+        const std::uint64_t previous = mWords[wordIndex].fetch_and(~mask, std::memory_order_acq_rel);
+        allTaken = allTaken && (previous & mask) == mask;
+    }
+    return allTaken;
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+bool BasicSeatBitmap<Words>::resetMasksIfTaken(const Masks& masks)
+{
+    for (auto release = masks.begin(); release != masks.end(); ++release)
+    {
+        auto& word = mWords[release->word];
+        std::uint64_t current = word.load(std::memory_order_acquire);
+        bool released = false;
+        while ((current & release->mask) == release->mask)
+        {
+            if (word.compare_exchange_weak(current, current & ~release->mask,
+                                           std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                released = true;
+                break;
+            }
+        }
+
+        if (!released)
+        {
+            // A seat is free: take back the words cleared so far
+            for (auto releasedMask = masks.begin(); releasedMask != release; ++releasedMask)
+            {
+                mWords[releasedMask->word].fetch_or(releasedMask->mask, std::memory_order_acq_rel);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+std::size_t BasicSeatBitmap<Words>::count() const
+{
+    return size() - countFree();
+}
+
+/*----------------------------------------------------*/
+template <typename Words>
+std::size_t BasicSeatBitmap<Words>::countFree() const
+{
+    std::size_t freeSeats = 0;
+    for (std::size_t w = 0; w < mWords.size(); ++w)
+    {
+        freeSeats += bits::popcount(~mWords[w].load(std::memory_order_acquire));
+    }
+    return freeSeats;
+}
+
+/**
+ * @brief Seat bitmap with its words on the heap, for any number of seats.
+ */
+using SeatBitmap = BasicSeatBitmap<HeapSeatWords>;
+
+/**
+ * @brief Seat bitmap with its words in place, for at most Capacity seats.
+ */
+template <std::size_t Capacity>
+using FixedSeatBitmap = BasicSeatBitmap<InlineSeatWords<bits::wordCount(Capacity)>>;
+
+extern template class BasicSeatBitmap<HeapSeatWords>;
+
+#endif /* SEAT_BITMAP_HPP */
@@ -0,0 +1,577 @@
+/**
+ * @file seat_inventory.hpp
+ * @brief Booking state of the seats of a shared SeatLayout.
+ * @author Gebremedhin Abreha
+ */
+#ifndef SEAT_INVENTORY_HPP
+#define SEAT_INVENTORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "seat.hpp"
+#include "seat_bitmap.hpp"
+#include "seat_layout.hpp"
+
+/**
+ * @class BasicSeatInventory
+ * @brief Free, held and booked state of every seat of a layout.
+ *
+ * The inventory owns only two bitmaps with a bit per seat (taken and held)
+ * and refers to the layout it indexes; everything else about the seats is
+ * in the shared layout. Seats are claimed lock-free with compare-and-swap
+ * on the bitmap words. A seat set is grouped into per-word masks once and
+ * applied to both bitmaps.
+ *
+ * The number of free seats is kept in a counter updated by every booking,
+ * hold and release, so it is read without looking at the bitmaps. The
+ * inventory can also report those changes to a shared counter, which then
+ * sums the free seats of several inventories (e.g. every theater showing a
+ * movie).
+ *
+ * Holding and releasing change both bitmaps, one after the other; in
+ * between, a seat would read as booked. Those two-step changes are counted
+ * in mTransitions, and getSeats and getBookedSeats (which checkpoints and
+ * replica snapshots record) retry until they read the bitmaps with no
+ * such change in flight, so a held seat is never recorded as sold.
+ *
+ * Confirming or releasing a hold first clears its held bits, all or
+ * nothing; that is what claims the hold, so of two callers ending the same
+ * hold exactly one succeeds and a stale release never frees seats booked
+ * after the hold ended.
+ *
+ * SeatInventory keeps its bitmaps on the heap and fits any layout;
+ * FixedSeatInventory keeps them in place, for FixedTheater.
+ *
+ * @tparam Bitmap SeatBitmap or FixedSeatBitmap.
+ */
+template <typename Bitmap>
+class BasicSeatInventory {
+public:
+    /**
+     * @brief Constructor for an inventory with every seat free.
+     *
+     * @param layout The seats; must not be null.
+     */
+    explicit BasicSeatInventory(std::shared_ptr<const SeatLayout> layout);
+
+    /**
+     * @brief Copy constructor; the copy is not attached to any counter.
+     */
+    BasicSeatInventory(const BasicSeatInventory& other);
+
+    /**
+     * @brief Copy the seat state of another inventory.
+     *
+     * This inventory stays attached to its counter, if any, and the counter
+     * is adjusted to the new number of free seats.
+     */
+    BasicSeatInventory& operator=(const BasicSeatInventory& other);
+
+    /**
+     * @brief Get the layout the inventory indexes.
+     */
+    const std::shared_ptr<const SeatLayout>& getLayout() const;
+
+    /**
+     * @brief Book a seat by its ID.
+     *
+     * @param id The ID of the seat to be booked.
+     * @return True if the seat was booked successfully, false otherwise.
+     */
+    bool bookSeat(const int& id);
+
+    /**
+     * @brief Book a set of seats, all or nothing.
+     *
+     * @param ids The IDs of the seats to be booked.
+     * @return True if all seats were booked, false if any seat is unknown,
+     *         repeated or already taken (then none is booked).
+     */
+    bool bookSeats(const std::vector<int>& ids);
+
+    /**
+     * @brief Hold a set of free seats, all or nothing.
+     *
+     * @param ids The IDs of the seats to be held.
+     * @return True if all seats were held, false otherwise.
+     */
+    bool holdSeats(const std::vector<int>& ids);
+
+    /**
+     * @brief Turn held seats into booked seats.
+     *
+     * @param ids The IDs of held seats.
+     * @return True if all seats were held and are now booked, false otherwise.
+     */
+    bool confirmSeats(const std::vector<int>& ids);
+
+    /**
+     * @brief Release held seats back to free.
+     *
+     * @param ids The IDs of held seats.
+     * @return True if all seats were held and are now free, false otherwise.
+     */
+    bool releaseSeats(const std::vector<int>& ids);
+
+    /**
+     * @brief Free booked seats again, undoing a booking that could not be logged.
+     *
+     * @param ids The IDs of seats booked by the caller, not held.
+     * @return True if every seat was taken and is now free, false otherwise.
+     */
+    bool cancelSeats(const std::vector<int>& ids);
+
+    /**
+     * @brief Get the state of a seat by its ID.
+     *
+     * @param id The ID of the seat.
+     * @return The seat state; unknown seats are reported as Booked.
+     */
+    SeatState getSeatState(const int& id) const;
+
+    /**
+     * @brief Get all seats in layout order.
+     *
+     * @return The seats; isBooked is true for booked (not held) seats.
+     */
+    std::vector<Seat> getSeats() const;
+
+    /**
+     * @brief Get the IDs of the booked (not held) seats.
+     */
+    std::vector<int> getBookedSeats() const;
+
+    /**
+     * @brief Get the IDs of the free seats.
+     */
+    std::vector<int> getAvailableSeats() const;
+
+    /**
+     * @brief Append the IDs of the free seats to a caller's vector.
+     *
+     * @param seatIds Receives the IDs; it allocates only if its capacity is
+     *                too small.
+     */
+    void appendAvailableSeats(std::vector<int>& seatIds) const;
+
+    /**
+     * @brief Get the number of free seats, in constant time.
+     */
+    std::size_t getAvailableSeatCount() const;
+
+    /**
+     * @brief Report changes of the number of free seats to a shared counter.
+     *
+     * The seats free at the moment of attaching are added to the counter,
+     * and every later booking, hold or release adjusts it too. A booking
+     * racing with the attach is counted exactly once. Updates reach the
+     * counter just after the seats change, so it may briefly lag.
+     *
+     * @param counter The counter; must not be null.
+     * @return False if the inventory is already attached to a counter.
+     */
+    bool attachAvailabilityCounter(std::shared_ptr<std::atomic<std::int64_t>> counter);
+
+    /**
+     * @brief Find adjacent free seats for a party in the best row.
+     *
+     * See SeatLayout::findBestAvailable. The seats are not claimed.
+     *
+     * @param partySize The number of adjacent seats wanted.
+     * @return The seat IDs in position order, or an empty vector if no row
+     *         has that many adjacent free seats.
+     */
+    std::vector<int> findBestAvailable(std::size_t partySize) const;
+
+    /**
+     * @brief Get the seat number of a seat by its ID.
+     *
+     * @param id The ID of the seat.
+     * @return The seat number, or an empty string if the seat does not exist.
+     */
+    std::string getSeatNumber(const int& id) const;
+
+private:
+    using Masks = typename Bitmap::Masks; /**< Bits of a seat set, word by word. */
+
+    /**
+     * @brief Group seat IDs into bitmap word masks.
+     *
+     * @param ids The IDs of the seats.
+     * @param masks Receives the bits of the seats.
+     * @return False if a seat is unknown or repeated.
+     */
+    bool toMasks(const std::vector<int>& ids, Masks& masks) const;
+
+    /**
+     * @brief Clear the held bits of a seat set, all or nothing.
+     *
+     * @param ids The IDs of the seats.
+     * @param masks Receives the bits of the seats.
+     * @return True if there are seats and this call ended the hold of every
+     *         one, false otherwise (then no held bit is left cleared).
+     */
+    bool claimHeldSeats(const std::vector<int>& ids, Masks& masks);
+
+    /**
+     * @brief Count seats that became free (positive) or taken (negative).
+     */
+    void countFree(std::int64_t delta);
+
+    /**
+     * @brief Mark the start of a hold or release, which sets bits of both bitmaps.
+     */
+    void beginTransition();
+
+    /**
+     * @brief Mark the end of a hold or release.
+     */
+    void endTransition();
+
+    /**
+     * @brief Call a reader of both bitmaps until no hold or release overlapped it.
+     *
+     * @param read Callable reading the bitmaps; it may run more than once.
+     */
+    template <typename Reader>
+    void readStable(Reader&& read) const;
+
+    static constexpr std::uint64_t kAttached = std::uint64_t{1} << 63; /**< mAvailable flag: changes go to mAvailabilityCounter too. */
+    static constexpr std::uint64_t kTransitionStarted = std::uint64_t{1} << 32; /**< mTransitions unit counting started changes. */
+
+    std::shared_ptr<const SeatLayout> mLayout; /**< Seats indexed by the bitmaps. */
+    Bitmap mOccupancy;          /**< Taken (held or booked) bit per seat index. */
+    Bitmap mHeld;               /**< Held bit per seat index, a subset of mOccupancy. */
+    std::atomic<std::uint64_t> mAvailable; /**< Free seats, plus kAttached once attached. */
+    std::shared_ptr<std::atomic<std::int64_t>> mAvailabilityCounter; /**< Shared counter; set before kAttached. */
+    std::atomic<std::uint64_t> mTransitions; /**< Holds and releases started (high half) and in flight (low half). */
+};
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+BasicSeatInventory<Bitmap>::BasicSeatInventory(std::shared_ptr<const SeatLayout> layout):
+mLayout(std::move(layout)), mOccupancy(mLayout->size()), mHeld(mLayout->size()), mAvailable(mLayout->size()),
+mTransitions(0)
+{
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+BasicSeatInventory<Bitmap>::BasicSeatInventory(const BasicSeatInventory& other):
+mLayout(other.mLayout), mOccupancy(other.mOccupancy), mHeld(other.mHeld),
+mAvailable(other.mAvailable.load() & ~kAttached), mTransitions(0)
+{
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+BasicSeatInventory<Bitmap>& BasicSeatInventory<Bitmap>::operator=(const BasicSeatInventory& other)
+{
+    if (this != &other)
+    {
+        mLayout = other.mLayout;
+        mOccupancy = other.mOccupancy;
+        mHeld = other.mHeld;
+        const std::uint64_t available = other.mAvailable.load() & ~kAttached;
+        const std::uint64_t previous = mAvailable.load() & ~kAttached;
+        countFree(static_cast<std::int64_t>(available) - static_cast<std::int64_t>(previous));
+    }
+    return *this;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+void BasicSeatInventory<Bitmap>::countFree(std::int64_t delta)
+{
+    // The flag and the count change together, so each change is counted by
+    // the shared counter exactly when it happened after the attach
+    const std::uint64_t before = mAvailable.fetch_add(static_cast<std::uint64_t>(delta));
+    if (before & kAttached)
+        mAvailabilityCounter->fetch_add(delta);
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+void BasicSeatInventory<Bitmap>::beginTransition()
+{
+    // In flight before started: a reader that saw nothing in flight sees the start
+    mTransitions.fetch_add(kTransitionStarted + 1);
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+void BasicSeatInventory<Bitmap>::endTransition()
+{
+    mTransitions.fetch_sub(1);
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+template <typename Reader>
+void BasicSeatInventory<Bitmap>::readStable(Reader&& read) const
+{
+    while (true)
+    {
+        const std::uint64_t before = mTransitions.load();
+        if ((before & (kTransitionStarted - 1)) == 0)
+        {
+            read();
+            if (mTransitions.load() == before)
+                return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool BasicSeatInventory<Bitmap>::attachAvailabilityCounter(std::shared_ptr<std::atomic<std::int64_t>> counter)
+{
+    if (mAvailable.load() & kAttached)
+        return false;
+
+    mAvailabilityCounter = std::move(counter);
+    const std::uint64_t before = mAvailable.fetch_or(kAttached);
+    mAvailabilityCounter->fetch_add(static_cast<std::int64_t>(before & ~kAttached));
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+const std::shared_ptr<const SeatLayout>& BasicSeatInventory<Bitmap>::getLayout() const
+{
+    return mLayout;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool BasicSeatInventory<Bitmap>::bookSeat(const int& id)
+{
+    std::size_t index = 0;
+    if (!mLayout->findSeatIndex(id, index))
+        return false;
+
+    if (!mOccupancy.set(index))
+        return false; //Already booked
+
+    countFree(-1);
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool BasicSeatInventory<Bitmap>::toMasks(const std::vector<int>& ids, Masks& masks) const
+{
+    for (const auto id : ids)
+    {
+        std::size_t index = 0;
+        if (!mLayout->findSeatIndex(id, index) || !mOccupancy.addToMasks(index, masks))
+            return false;
+    }
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool BasicSeatInventory<Bitmap>::claimHeldSeats(const std::vector<int>& ids, Masks& masks)
+{
+    return !ids.empty() && toMasks(ids, masks) && mHeld.resetMasksIfTaken(masks);
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool BasicSeatInventory<Bitmap>::bookSeats(const std::vector<int>& ids)
+{
+    if (ids.size() == 1)
+        return bookSeat(ids.front()); //Single bit, no mask grouping needed
+
+    Masks masks;
+    if (!toMasks(ids, masks))
+        return false;
+
+    if (!mOccupancy.setMasks(masks))
+        return false; //A seat is taken
+
+    countFree(-static_cast<std::int64_t>(ids.size()));
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool BasicSeatInventory<Bitmap>::holdSeats(const std::vector<int>& ids)
+{
+    Masks masks;
+    if (!toMasks(ids, masks))
+        return false;
+
+    beginTransition();
+    const bool held = mOccupancy.setMasks(masks);
+    // The seats are ours now, marking them held cannot conflict
+    if (held)
+        mHeld.setMasks(masks);
+    endTransition();
+    if (!held)
+        return false;
+
+    countFree(-static_cast<std::int64_t>(ids.size()));
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool BasicSeatInventory<Bitmap>::confirmSeats(const std::vector<int>& ids)
+{
+    // A claim that fails puts back the held bits it cleared; readers must
+    // not see those seats as booked in between
+    Masks masks;
+    beginTransition();
+    const bool confirmed = claimHeldSeats(ids, masks); //Seats stay taken in mOccupancy
+    endTransition();
+    return confirmed;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool BasicSeatInventory<Bitmap>::releaseSeats(const std::vector<int>& ids)
+{
+    Masks masks;
+    beginTransition();
+    const bool released = claimHeldSeats(ids, masks);
+    // The hold was ours alone, so its seats are still taken
+    if (released)
+        mOccupancy.resetMasks(masks);
+    endTransition();
+    if (!released)
+        return false;
+
+    countFree(static_cast<std::int64_t>(ids.size()));
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool BasicSeatInventory<Bitmap>::cancelSeats(const std::vector<int>& ids)
+{
+    Masks masks;
+    if (!toMasks(ids, masks) || !mOccupancy.resetMasks(masks))
+        return false;
+
+    countFree(static_cast<std::int64_t>(ids.size()));
+    return true;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+SeatState BasicSeatInventory<Bitmap>::getSeatState(const int& id) const
+{
+    std::size_t index = 0;
+    if (!mLayout->findSeatIndex(id, index))
+        return SeatState::Booked;
+
+    if (!mOccupancy.test(index))
+        return SeatState::Free;
+    return mHeld.test(index) ? SeatState::Held : SeatState::Booked;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+std::vector<Seat> BasicSeatInventory<Bitmap>::getSeats() const
+{
+    auto seats = mLayout->getSeats();
+    readStable([&]() {
+        for (std::size_t index = 0; index < seats.size(); ++index)
+        {
+            seats[index].isBooked = mOccupancy.test(index) && !mHeld.test(index);
+        }
+    });
+    return seats;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+std::vector<int> BasicSeatInventory<Bitmap>::getBookedSeats() const
+{
+    std::vector<int> bookedSeats;
+    readStable([&]() {
+        bookedSeats.clear();
+        for (std::size_t index = 0; index < mLayout->size(); ++index)
+        {
+            if (mOccupancy.test(index) && !mHeld.test(index))
+                bookedSeats.push_back(mLayout->seatId(index));
+        }
+    });
+    return bookedSeats;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+std::vector<int> BasicSeatInventory<Bitmap>::getAvailableSeats() const
+{
+    std::vector<int> availableSeats;
+    appendAvailableSeats(availableSeats);
+    return availableSeats;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+void BasicSeatInventory<Bitmap>::appendAvailableSeats(std::vector<int>& seatIds) const
+{
+    seatIds.reserve(seatIds.size() + mOccupancy.countFree());
+
+    mOccupancy.forEachFree([&](std::size_t index) {
+        seatIds.push_back(mLayout->seatId(index));
+    });
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+std::size_t BasicSeatInventory<Bitmap>::getAvailableSeatCount() const
+{
+    return static_cast<std::size_t>(mAvailable.load(std::memory_order_relaxed) & ~kAttached);
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+std::vector<int> BasicSeatInventory<Bitmap>::findBestAvailable(std::size_t partySize) const
+{
+    std::size_t start = 0;
+    if (!mLayout->findBestAvailable(mOccupancy, partySize, start))
+        return {};
+
+    std::vector<int> seatIds(partySize);
+    for (std::size_t k = 0; k < partySize; ++k)
+    {
+        seatIds[k] = mLayout->seatId(start + k);
+    }
+    return seatIds;
+}
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+std::string BasicSeatInventory<Bitmap>::getSeatNumber(const int& id) const
+{
+    std::size_t index = 0;
+    if (!mLayout->findSeatIndex(id, index))
+        return std::string();
+    return mLayout->seatNumber(index);
+}
+
+/**
+ * @brief Seat state with its bitmaps on the heap, for any layout.
+ */
+using SeatInventory = BasicSeatInventory<SeatBitmap>;
+
+/**
+ * @brief Seat state with its bitmaps in place, for layouts of at most Capacity seats.
+ */
+template <std::size_t Capacity>
+using FixedSeatInventory = BasicSeatInventory<FixedSeatBitmap<Capacity>>;
+
+extern template class BasicSeatInventory<SeatBitmap>;
+
+#endif /* SEAT_INVENTORY_HPP */
@@ -0,0 +1,209 @@
+/**
+ * @file seat_layout.hpp
+ * @brief Immutable seat layout of an auditorium, shared by its theater and shows.
+ * @author Gebremedhin Abreha
+ */
+#ifndef SEAT_LAYOUT_HPP
+#define SEAT_LAYOUT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "seat.hpp"
+#include "seat_bitmap.hpp"
+
+/**
+ * @class SeatLayout
+ * @brief The seats of an auditorium: IDs, numbers and places, without state.
+ *
+ * Each seat gets an index in layout order, which is the bit it occupies in
+ * the occupancy bitmaps of a SeatInventory. A layout never changes once
+ * built, so one instance is shared (through std::shared_ptr) by a theater
+ * and all of its shows.
+ *
+ * Seats placed in rows are grouped at construction into runs of adjacent
+ * seats that are also adjacent in the layout, so each run is a contiguous
+ * range of the bitmap and adjacent free seats are found a word at a time.
+ * Seats of a row should therefore be listed in position order.
+ *
+ * Per seat, a layout stores as little as it can: contiguous seat IDs are
+ * computed from the first one, and seat numbers following a numbered
+ * pattern ("Seat 1", "Seat 2", ...) are computed from the seat index.
+ * Other seat numbers are kept back to back in one character arena.
+ */
+class SeatLayout {
+public:
+    /**
+     * @brief Constructor to build the layout of a list of seats.
+     *
+     * The booking state of the seats is ignored. For a duplicated ID the
+     * first seat is kept.
+     *
+     * @param seats The seats in layout order.
+     */
+    explicit SeatLayout(const std::vector<Seat>& seats);
+
+    /**
+     * @brief Get the number of seats.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Get the ID of the seat at an index.
+     */
+    int seatId(std::size_t index) const;
+
+    /**
+     * @brief Get the seat number of the seat at an index.
+     */
+    std::string seatNumber(std::size_t index) const;
+
+    /**
+     * @brief Map a seat ID to its index.
+     *
+     * @param id The ID of the seat.
+     * @param index Receives the seat index when found.
+     * @return True if the seat exists, false otherwise.
+     */
+    bool findSeatIndex(const int& id, std::size_t& index) const;
+
+    /**
+     * @brief Map seat IDs to their indices.
+     *
+     * @param ids The IDs of the seats.
+     * @param indices Receives the seat indices, in the order of ids.
+     * @return True if every seat exists, false otherwise.
+     */
+    bool findSeatIndices(const std::vector<int>& ids, std::vector<std::size_t>& indices) const;
+
+    /**
+     * @brief Get all seats in layout order, none of them booked.
+     */
+    std::vector<Seat> getSeats() const;
+
+    /**
+     * @brief Find adjacent free seats for a party in the best row.
+     *
+     * Rows are ranked by their distance from the middle row of their
+     * section, ties going to the row further back; within the first row that
+     * can seat the party, the seats closest to the row's center are chosen.
+     * A layout whose seats have no rows is treated as a single row in
+     * layout order.
+     *
+     * @param occupancy Taken bit per seat index, a SeatBitmap or FixedSeatBitmap.
+     * @param partySize The number of adjacent seats wanted.
+     * @param start Receives the index of the first seat; the party sits at
+     *              start ... start + partySize - 1.
+     * @return True if a row has that many adjacent free seats, false otherwise.
+     */
+    template <typename Bitmap>
+    bool findBestAvailable(const Bitmap& occupancy, std::size_t partySize, std::size_t& start) const;
+
+private:
+    /**
+     * @struct SeatPlace
+     * @brief Where a seat is in the auditorium.
+     */
+    struct SeatPlace {
+        int section;  /**< Section of the seat. */
+        int row;      /**< Row within the section. */
+        int position; /**< Position within the row. */
+    };
+
+    /**
+     * @struct SeatRun
+     * @brief Seats of one row at consecutive positions and layout indices.
+     */
+    struct SeatRun {
+        std::size_t begin; /**< Seat index of the first seat. */
+        std::size_t end;   /**< Seat index one past the last seat. */
+        int firstPosition; /**< Position of the first seat in its row. */
+    };
+
+    /**
+     * @struct SeatRow
+     * @brief A row of seats as a range of mSeatRuns.
+     */
+    struct SeatRow {
+        std::size_t firstRun; /**< Index of the row's first run. */
+        std::size_t endRun;   /**< Index one past the row's last run. */
+        double center;        /**< Middle position of the row. */
+    };
+
+    /**
+     * @brief Group the seats into rows and runs, best row first.
+     *
+     * @param places The place of each seat, by seat index.
+     */
+    void buildRows(std::vector<SeatPlace> places);
+
+    /**
+     * @brief Switch to computed seat numbers if they follow a numbered pattern.
+     *
+     * The pattern is a common prefix followed by consecutive decimal
+     * numbers, the number of seat index 0 first.
+     */
+    void computeNumbersIfNumbered();
+
+    std::size_t mSeatCount;     /**< Number of seats. */
+    int mFirstSeatId;           /**< ID of the seat at index 0, 0 if there are no seats. */
+    std::vector<int> mSeatIds;  /**< Seat IDs in layout order; empty when IDs are contiguous. */
+    std::string mNumberChars;   /**< Seat numbers back to back; empty when numbers are computed. */
+    std::vector<std::uint32_t> mNumberEnds; /**< End of each seat number in mNumberChars; empty when computed. */
+    std::string mNumberPrefix;  /**< Prefix of computed seat numbers. */
+    long long mFirstNumber;     /**< Number of seat index 0 when numbers are computed. */
+    bool mComputedNumbers;      /**< True if seat numbers are mNumberPrefix + (mFirstNumber + index). */
+    std::vector<SeatPlace> mSeatPlaces; /**< Place per seat index; empty if no seat has a row. */
+    std::vector<SeatRun> mSeatRuns; /**< Runs of adjacent seats, grouped by row. */
+    std::vector<SeatRow> mSeatRows; /**< Rows, best first. */
+    std::unordered_map<int, std::size_t> mSeatIndex; /**< Seat ID -> seat index, empty when IDs are contiguous. */
+    bool mContiguousSeatIds;    /**< True if seat IDs are mFirstSeatId, mFirstSeatId + 1, ... */
+};
+
+/*----------------------------------------------------*/
+template <typename Bitmap>
+bool SeatLayout::findBestAvailable(const Bitmap& occupancy, std::size_t partySize, std::size_t& start) const
+{
+    if (partySize == 0)
+        return false;
+
+    for (const auto& row : mSeatRows)
+    {
+        bool found = false;
+        double bestDistance = 0;
+
+        for (std::size_t r = row.firstRun; r < row.endRun; ++r)
+        {
+            const auto& run = mSeatRuns[r];
+            if (run.end - run.begin < partySize)
+                continue;
+
+            // Seat index at which the party would sit centered in the row
+            const double ideal = row.center - static_cast<double>(partySize - 1) / 2 - run.firstPosition + run.begin;
+
+            occupancy.forEachFreeRun(run.begin, run.end, [&](std::size_t begin, std::size_t end) {
+                if (end - begin < partySize)
+                    return;
+                const double candidate = std::min(std::max(std::round(ideal), static_cast<double>(begin)),
+                                                  static_cast<double>(end - partySize));
+                const double distance = std::abs(candidate - ideal);
+                if (!found || distance < bestDistance)
+                {
+                    found = true;
+                    start = static_cast<std::size_t>(candidate);
+                    bestDistance = distance;
+                }
+            });
+        }
+
+        if (found)
+            return true;
+    }
+    return false;
+}
+
+#endif /* SEAT_LAYOUT_HPP */
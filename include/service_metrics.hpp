@@ -0,0 +1,241 @@
+/**
+ * @file service_metrics.hpp
+ * @brief Operation metrics of MovieBookingService: latency, lock wait and conflict counters.
+ * @author Gebremedhin Abreha
+ */
+#ifndef SERVICE_METRICS_HPP
+#define SERVICE_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "latency_histogram.hpp"
+
+/**
+ * @class ServiceMetrics
+ * @brief Low-overhead metrics, recorded per thread and aggregated on read.
+ *
+ * Each recording thread writes to its own shard of relaxed atomic counters
+ * and ConcurrentLatencyHistograms, allocated the first time the thread
+ * records. Recording therefore touches no shared cache line and takes no
+ * lock; all the summing is done by snapshot(), so nothing is paid for
+ * aggregation unless somebody reads the metrics. Threads beyond kShards
+ * share shards.
+ */
+class ServiceMetrics {
+public:
+
+    /**
+     * @enum Operation
+     * @brief Timed public operations of the service.
+     */
+    enum class Operation : std::size_t {
+        AddMovie, AddTheater, AddMovies, AddTheaters, LoadCatalogImage, AddShow, AddShows,
+        GetAllMovies, GetTheatersForMovie, GetShowsForMovie, GetShowsForTheater,
+        GetAvailableSeats, GetAvailableSeatCount, GetMovieAvailableSeatCount, GetMoviesWithAvailability, FindBestAvailable, GetAvailableShowSeats, FindBestAvailableForShow, FindShow,
+        BookSeats, BookShowSeats, BookBatch, HoldSeats, HoldShowSeats, ConfirmHold, ReleaseHold, ExpireHolds, Checkpoint,
+        IsValidMovie, IsMovieShownInTheater, GetMovieName, GetTheaterName,
+        GetReplicationSnapshot, ReadReplicationLog, LoadReplicationSnapshot, ApplyReplicationRecords,
+        Count
+    };
+
+    /**
+     * @enum Lock
+     * @brief Service locks whose acquisition wait is timed.
+     */
+    enum class Lock : std::size_t {
+        Writer,     /**< Catalog writers. */
+        Hold,       /**< Hold table and timers. */
+        Checkpoint, /**< Checkpoints. */
+        Count
+    };
+
+    /**
+     * @enum Counter
+     * @brief Event counters.
+     */
+    enum class Counter : std::size_t {
+        SeatConflicts, /**< Bookings or holds refused because a requested seat was taken or unknown. */
+        HoldsExpired,  /**< Holds released because their time to live passed. */
+        LogRecords,    /**< Records appended to the write-ahead log. */
+        Checkpoints,   /**< Checkpoints written. */
+        Count
+    };
+
+    static constexpr std::size_t kOperations = static_cast<std::size_t>(Operation::Count); /**< Number of operations. */
+    static constexpr std::size_t kLocks = static_cast<std::size_t>(Lock::Count);           /**< Number of locks. */
+    static constexpr std::size_t kCounters = static_cast<std::size_t>(Counter::Count);     /**< Number of counters. */
+    static constexpr std::size_t kShards = 64; /**< Per-thread shards. */
+
+    /**
+     * @enum Format
+     * @brief Output formats of format().
+     */
+    enum class Format {
+        Text, /**< Aligned human-readable tables. */
+        Json  /**< A single JSON object. */
+    };
+
+    /**
+     * @struct OperationStats
+     * @brief Aggregated statistics of one operation.
+     */
+    struct OperationStats {
+        std::uint64_t calls = 0;    /**< Completed calls. */
+        std::uint64_t failures = 0; /**< Calls that returned failure or threw. */
+        LatencyHistogram latency;   /**< Call latency in nanoseconds. */
+    };
+
+    /**
+     * @struct Snapshot
+     * @brief Metrics summed over every shard at one time.
+     */
+    struct Snapshot {
+        std::array<OperationStats, kOperations> operations; /**< Statistics per operation. */
+        std::array<LatencyHistogram, kLocks> lockWaits;      /**< Lock wait in nanoseconds per lock. */
+        std::array<std::uint64_t, kCounters> counters{};     /**< Value per counter. */
+    };
+
+    /**
+     * @class Call
+     * @brief Times one call of an operation, from construction to destruction.
+     *
+     * A call is counted as failed if fail() was called or if it ends by an
+     * exception.
+     */
+    class Call {
+    public:
+        Call(ServiceMetrics& metrics, Operation operation);
+        ~Call();
+
+        Call(const Call&) = delete;
+        Call& operator=(const Call&) = delete;
+
+        /**
+         * @brief Mark the call as failed.
+         */
+        void fail() { mFailed = true; }
+
+        /**
+         * @brief Mark the call as failed unless result is true.
+         *
+         * @param result The result of the call.
+         * @return result, so a return statement can pass it through.
+         */
+        bool succeeded(bool result) { mFailed = mFailed || !result; return result; }
+
+    private:
+        ServiceMetrics& mMetrics;
+        Operation mOperation;
+        std::chrono::steady_clock::time_point mStart;
+        int mExceptions;
+        bool mFailed = false;
+    };
+
+    /**
+     * @brief Constructor
+     */
+    ServiceMetrics();
+
+    /**
+     * @brief Destructor
+     */
+    ~ServiceMetrics();
+
+    ServiceMetrics(const ServiceMetrics&) = delete;
+    ServiceMetrics& operator=(const ServiceMetrics&) = delete;
+
+    /**
+     * @brief Record a completed call of an operation.
+     *
+     * @param operation The operation.
+     * @param nanos The call latency in nanoseconds.
+     * @param failed True if the call failed.
+     */
+    void recordCall(Operation operation, std::uint64_t nanos, bool failed);
+
+    /**
+     * @brief Record the time spent waiting for a lock.
+     *
+     * @param lock The lock.
+     * @param nanos The wait in nanoseconds.
+     */
+    void recordLockWait(Lock lock, std::uint64_t nanos);
+
+    /**
+     * @brief Add to an event counter.
+     *
+     * @param counter The counter.
+     * @param amount The amount to add.
+     */
+    void increment(Counter counter, std::uint64_t amount = 1);
+
+    /**
+     * @brief Lock a mutex, recording how long the acquisition waited.
+     *
+     * @param mutex The mutex to lock.
+     * @param lock The lock the wait is recorded for.
+     * @return The owning lock.
+     */
+    std::unique_lock<std::mutex> acquire(std::mutex& mutex, Lock lock);
+
+    /**
+     * @brief Sum every shard.
+     *
+     * Counters are read one by one while threads keep recording, so the
+     * snapshot may be off by the calls in flight.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Format a snapshot.
+     *
+     * @param snapshot The snapshot.
+     * @param format Text or JSON.
+     * @return The formatted snapshot; latencies are in microseconds.
+     */
+    static std::string format(const Snapshot& snapshot, Format format);
+
+    /**
+     * @brief Name of an operation, as used in dumps.
+     */
+    static const char* name(Operation operation);
+
+    /**
+     * @brief Name of a lock, as used in dumps.
+     */
+    static const char* name(Lock lock);
+
+    /**
+     * @brief Name of a counter, as used in dumps.
+     */
+    static const char* name(Counter counter);
+
+private:
+    /**
+     * @struct Shard
+     * @brief Metrics recorded by the threads mapped to one shard.
+     */
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, kOperations> failures{}; /**< Failed calls per operation. */
+        std::array<ConcurrentLatencyHistogram, kOperations> latency;    /**< Call latency (and count) per operation. */
+        std::array<ConcurrentLatencyHistogram, kLocks> lockWaits;       /**< Lock wait per lock. */
+        std::array<std::atomic<std::uint64_t>, kCounters> counters{};   /**< Value per counter. */
+    };
+
+    /**
+     * @brief The calling thread's shard, allocated on first use.
+     */
+    Shard& localShard();
+
+    std::array<std::atomic<Shard*>, kShards> mShards{}; /**< Shards, null until first used. */
+};
+
+#endif /* SERVICE_METRICS_HPP */
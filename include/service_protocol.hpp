@@ -0,0 +1,131 @@
+/**
+ * @file service_protocol.hpp
+ * @brief Text protocol exposing MovieBookingService to BookingServer clients.
+ * @author Gebremedhin Abreha
+ */
+#ifndef SERVICE_PROTOCOL_HPP
+#define SERVICE_PROTOCOL_HPP
+
+#include <string>
+#include <string_view>
+
+class MovieBookingService;
+
+/**
+ * @class ServiceProtocol
+ * @brief Parses one request line, calls the service and formats the response.
+ *
+ * Requests are a command followed by space-separated arguments; names run
+ * to the end of the line. Responses start with OK, followed by the result,
+ * or ERR followed by the reason. Lists are space-separated, shows are
+ * id,theaterId,movieId,startTime and booleans are 1 or 0.
+ *
+ *     PING                               OK
+ *     ADD_MOVIE <id> <name>              OK
+ *     ADD_THEATER <id> <seats> <name>    OK            seats 0..N-1 named "Seat 1".."Seat N"
+ *     ADD_SHOW <id> <theater> <movie> <startTime>   OK
+ *     LOAD_CATALOG <path>                OK <count>    line-delimited catalog (CatalogLoader), see below
+ *     LOAD_IMAGE <path>                  OK            binary catalog image, see below
+ *     MOVIES                             OK <movieIds>
+ *     MOVIES_AVAILABLE                   OK <movieIds>
+ *     THEATERS <movie>                   OK <theaterIds>
+ *     SHOWS_FOR_MOVIE <movie>            OK <shows>
+ *     SHOWS_FOR_THEATER <theater>        OK <shows>
+ *     SEATS <theater>                    OK <seatIds>
+ *     SEAT_COUNT <theater>               OK <count>
+ *     MOVIE_SEAT_COUNT <movie>           OK <count>
+ *     BEST <theater> <partySize>         OK <seatIds>
+ *     SHOW_SEATS <show>                  OK <seatIds>
+ *     SHOW_BEST <show> <partySize>       OK <seatIds>
+ *     SHOW <show>                        OK <show>
+ *     BOOK <theater> <seatIds>           OK
+ *     BOOK_SHOW <show> <seatIds>         OK
+ *     BOOK_BATCH {<requestId> <theater> <seat,seat,...>}...
+ *                                        OK {<requestId>:BOOKED|CONFLICT:<seats>|UNKNOWN_THEATER|NO_SEATS}...
+ *     HOLD <theater> <ttlMs> <seatIds>   OK <holdId>
+ *     HOLD_SHOW <show> <ttlMs> <seatIds> OK <holdId>
+ *     CONFIRM <holdId>                   OK
+ *     RELEASE <holdId>                   OK
+ *     EXPIRE                             OK <count>
+ *     CHECKPOINT                         OK
+ *     IS_MOVIE <movie>                   OK 1|0
+ *     SHOWN_IN <theater> <movie>         OK 1|0
+ *     MOVIE_NAME <movie>                 OK <name>
+ *     THEATER_NAME <theater>             OK <name>
+ *     EVENT_SEQUENCE                     OK <sequence>
+ *     REPL_SEQUENCE                      OK <logId> <sequence>             | ERR replication off
+ *     REPL_SNAPSHOT                      OK <logId> <sequence> <records>
+ *     REPL_PULL <logId> <after> <max>    OK <sequence> <records>           | ERR lapped
+ *     METRICS                            OK <metrics as JSON>
+ *
+ * The REPL_ commands serve read replicas of a primary that enabled
+ * replication (see BookingReplica): records are hex-encoded log records and
+ * REPL_PULL answers the primary's sequence before the read, then up to max
+ * records following after.
+ *
+ * LOAD_CATALOG and LOAD_IMAGE read files of the server, so any client could
+ * make it open any path it can read; they answer "ERR file loads disabled"
+ * unless Options::allowFileLoads is set. ADD_THEATER with more seats than
+ * Options::maxTheaterSeats is answered "ERR bad arguments".
+ *
+ * BookingServer itself answers QUIT by closing the connection.
+ */
+class ServiceProtocol {
+public:
+    static constexpr int kDefaultMaxTheaterSeats = 100000; /**< Default of Options::maxTheaterSeats. */
+
+    /**
+     * @struct Options
+     * @brief What clients are allowed to ask for.
+     */
+    struct Options {
+        bool allowFileLoads = false;                    /**< Serve LOAD_CATALOG and LOAD_IMAGE. */
+        int maxTheaterSeats = kDefaultMaxTheaterSeats;  /**< Most seats ADD_THEATER accepts. */
+    };
+
+    /**
+     * @brief Constructor, with the default options
+     *
+     * @param service The service requests go to; must outlive the protocol.
+     */
+    explicit ServiceProtocol(MovieBookingService& service);
+
+    /**
+     * @brief Constructor
+     *
+     * @param service The service requests go to; must outlive the protocol.
+     * @param options What clients are allowed to ask for.
+     */
+    ServiceProtocol(MovieBookingService& service, Options options);
+
+    /**
+     * @brief Handle one request; usable as a BookingServer::Handler.
+     *
+     * @param request The request line.
+     * @param response Receives the response line.
+     */
+    void handle(std::string_view request, std::string& response) const;
+
+    /**
+     * @brief Check if a command name is known.
+     */
+    static bool isCommand(std::string_view command);
+
+    /**
+     * @brief Append a log record in hex, as REPL_ responses carry it.
+     */
+    static void encodeRecord(std::string_view record, std::string& output);
+
+    /**
+     * @brief Decode a hex-encoded log record.
+     *
+     * @return False if the text is not valid hex.
+     */
+    static bool decodeRecord(std::string_view text, std::string& record);
+
+private:
+    MovieBookingService& mService; /**< Service requests go to. */
+    Options mOptions;              /**< What clients are allowed to ask for. */
+};
+
+#endif /* SERVICE_PROTOCOL_HPP */
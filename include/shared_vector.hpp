@@ -0,0 +1,211 @@
+/**
+ * @file shared_vector.hpp
+ * @brief Append-only vector whose copies share storage.
+ * @author Gebremedhin Abreha
+ */
+#ifndef SHARED_VECTOR_HPP
+#define SHARED_VECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SharedVector
+ * @brief Append-only sequence whose copies share storage, so a copy is O(1).
+ *
+ * Elements live in chunks that double in size and never move; the first is
+ * held inline, so a short vector is a single allocation. A copy shares
+ * the chunks and sees the first size() elements. Appending to the copy that
+ * ends where the storage ends writes in place in O(1) amortized, and other
+ * copies go on seeing their own prefix. Appending to a copy that another
+ * copy appended past first gives it storage of its own, in O(n).
+ *
+ * One thread at a time may append through the copies of a vector. Other
+ * threads may read a copy handed to them with release/acquire ordering, as
+ * the catalog snapshots are, while appends go on.
+ */
+template <typename T>
+class SharedVector {
+    struct Storage;
+
+public:
+    /**
+     * @class const_iterator
+     * @brief Iterates the elements of a copy in the order they were added.
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag; /**< Forward only. */
+        using value_type = T;                                /**< Element type. */
+        using difference_type = std::ptrdiff_t;              /**< Distance between positions. */
+        using pointer = const T*;                            /**< Pointer to an element. */
+        using reference = const T&;                          /**< Reference to an element. */
+
+        const_iterator(const Storage* storage, std::size_t position) : mStorage(storage), mPosition(position) { }
+
+        reference operator*() const { return mStorage->at(mPosition); }
+        pointer operator->() const { return &mStorage->at(mPosition); }
+        const_iterator& operator++() { ++mPosition; return *this; }
+        const_iterator operator++(int) { const_iterator previous = *this; ++mPosition; return previous; }
+        bool operator==(const const_iterator& other) const { return mPosition == other.mPosition; }
+        bool operator!=(const const_iterator& other) const { return mPosition != other.mPosition; }
+
+    private:
+        const Storage* mStorage; /**< Storage of the iterated copy. */
+        std::size_t mPosition;   /**< Position of the current element. */
+    };
+
+    /**
+     * @brief Append an element to this copy.
+     *
+     * @param value The element.
+     */
+    void push_back(T value)
+    {
+        if (!isLatest())
+            detach();
+        mStorage->append(std::move(value));
+        ++mSize;
+    }
+
+    /**
+     * @brief Check if no other copy appended past this one, so appending
+     *        writes in place.
+     */
+    bool isLatest() const { return mStorage != nullptr && mStorage->size == mSize; }
+
+    /**
+     * @brief Get an element by position.
+     *
+     * Positions past size() hold what other copies appended; they may be
+     * read once the appending copy was handed over.
+     */
+    const T& operator[](std::size_t position) const { return mStorage->at(position); }
+
+    /**
+     * @brief Append the elements of this copy to a caller's vector, a chunk
+     *        at a time.
+     *
+     * @param values Receives the elements; it allocates only if its capacity
+     *               is too small.
+     */
+    void appendTo(std::vector<T>& values) const
+    {
+        values.reserve(values.size() + mSize);
+        for (std::size_t position = 0, chunk = 0; position < mSize; ++chunk)
+        {
+            const T* first = mStorage->chunk(chunk);
+            const std::size_t count = std::min(Storage::kFirstChunk << chunk, mSize - position);
+            values.insert(values.end(), first, first + count);
+            position += count;
+        }
+    }
+
+    /**
+     * @brief Last element of this copy.
+     */
+    const T& back() const { return mStorage->at(mSize - 1); }
+
+    /**
+     * @brief Number of elements this copy sees.
+     */
+    std::size_t size() const { return mSize; }
+
+    /**
+     * @brief True if this copy sees no elements.
+     */
+    bool empty() const { return mSize == 0; }
+
+    const_iterator begin() const { return const_iterator(mStorage.get(), 0); }   /**< First element. */
+    const_iterator end() const { return const_iterator(mStorage.get(), mSize); } /**< Past the last element. */
+
+private:
+    /**
+     * @struct Storage
+     * @brief Chunks shared by the copies; chunk c holds kFirstChunk << c elements.
+     */
+    struct Storage {
+        static constexpr std::size_t kFirstChunk = 16; /**< Elements in the first chunk. */
+        static constexpr std::size_t kChunks = 32;     /**< Chunks, enough for 2^36 elements. */
+        using Chunks = std::array<std::unique_ptr<T[]>, kChunks>; /**< Chunks past the first; entry 0 is unused. */
+
+        /**
+         * @brief Element at a position, which must have been appended.
+         */
+        T& at(std::size_t position)
+        {
+            if (position < kFirstChunk)
+                return first[position];
+            const std::size_t index = chunkOf(position);
+            return (*rest)[index][position - kFirstChunk * ((std::size_t{1} << index) - 1)];
+        }
+
+        /**
+         * @brief Element at a position, which must have been appended.
+         */
+        const T& at(std::size_t position) const
+        {
+            return const_cast<Storage*>(this)->at(position);
+        }
+
+        /**
+         * @brief First element of a chunk.
+         */
+        const T* chunk(std::size_t index) const
+        {
+            return index == 0 ? first.data() : (*rest)[index].get();
+        }
+
+        /**
+         * @brief Append an element past the last one.
+         */
+        void append(T value)
+        {
+            if (size >= kFirstChunk)
+            {
+                if (!rest)
+                    rest = std::make_unique<Chunks>();
+                auto& chunk = (*rest)[chunkOf(size)];
+                if (!chunk)
+                    chunk = std::make_unique<T[]>(kFirstChunk << chunkOf(size));
+            }
+            at(size) = std::move(value);
+            ++size;
+        }
+
+        /**
+         * @brief Chunk holding a position.
+         */
+        static std::size_t chunkOf(std::size_t position)
+        {
+            return 63 - static_cast<std::size_t>(__builtin_clzll(position / kFirstChunk + 1));
+        }
+
+        std::array<T, kFirstChunk> first; /**< The first chunk. */
+        std::unique_ptr<Chunks> rest;     /**< The later chunks, allocated once the first is full. */
+        std::size_t size = 0;             /**< Elements appended by any copy. */
+    };
+
+    /**
+     * @brief Give this copy storage of its own, holding its elements.
+     */
+    void detach()
+    {
+        auto storage = std::make_shared<Storage>();
+        for (std::size_t position = 0; position < mSize; ++position)
+        {
+            storage->append(mStorage->at(position));
+        }
+        mStorage = std::move(storage);
+    }
+
+    std::shared_ptr<Storage> mStorage; /**< Storage shared with other copies; null until the first append. */
+    std::size_t mSize = 0;             /**< Elements this copy sees. */
+};
+
+#endif /* SHARED_VECTOR_HPP */
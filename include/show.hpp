@@ -0,0 +1,68 @@
+/**
+ * @file show.hpp
+ * @brief Represents a showtime: one screening of a movie in a theater.
+ * @author Gebremedhin Abreha
+ */
+#ifndef SHOW_HPP
+#define SHOW_HPP
+
+#include <cstdint>
+#include <memory>
+#include "seat_layout.hpp"
+#include "seat_inventory.hpp"
+
+/**
+ * @struct ShowInfo
+ * @brief What is shown where and when.
+ */
+struct ShowInfo {
+    int id;                /**< Unique identifier for the show. */
+    int theaterId;         /**< Theater the show is screened in. */
+    int movieId;           /**< Movie shown. */
+    std::int64_t startTime; /**< Start time in seconds since the Unix epoch. */
+};
+
+/**
+ * @class Show
+ * @brief A showtime with its own seat state over its theater's layout.
+ *
+ * Seats are sold per show. A show shares the immutable SeatLayout of its
+ * theater and only owns a SeatInventory, i.e. two bits per seat plus a
+ * small fixed overhead, so thousands of shows cost kilobytes.
+ */
+class Show {
+public:
+    /**
+     * @brief Constructor for a show with every seat free.
+     *
+     * @param info The ID, theater, movie and start time of the show.
+     * @param layout The seat layout of the show's theater.
+     */
+    Show(const ShowInfo& info, std::shared_ptr<const SeatLayout> layout);
+
+    /**
+     * @brief Get the ID, theater, movie and start time of the show.
+     */
+    const ShowInfo& getInfo() const;
+
+    /**
+     * @brief Get the ID of the show.
+     */
+    int getId() const;
+
+    /**
+     * @brief Get the seat state of the show.
+     */
+    SeatInventory& getSeats();
+
+    /**
+     * @brief Get the seat state of the show.
+     */
+    const SeatInventory& getSeats() const;
+
+private:
+    ShowInfo mInfo;        /**< ID, theater, movie and start time. */
+    SeatInventory mSeats;  /**< Seat state of this show only. */
+};
+
+#endif /* SHOW_HPP */
@@ -1,36 +1,38 @@
 /**
  * @file theater.hpp
- * @brief Represents a theater with an ID, name, and seats.
+ * @brief Theaters: the TheaterBase interface and the heap-backed Theater.
  * @author Gebremedhin Abreha
  */
 #ifndef THEATER_HPP
 #define THEATER_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory>
 #include "seat.hpp"
+#include "seat_layout.hpp"
+#include "seat_inventory.hpp"
 
 /**
- * @class Theater
- * @brief Represents a theater with an ID, name, and seats.
+ * @class TheaterBase
+ * @brief A theater with an ID and name, whatever keeps its seat state.
  *
- * The Theater class provides methods for managing seats in a theater.
+ * MovieBookingService works on this interface. Theater keeps its seat state
+ * in a SeatInventory on the heap and fits any number of seats; FixedTheater
+ * keeps it in place for a compile-time seat capacity. Both share their
+ * seats' immutable SeatLayout with the theater's shows. The name is
+ * interned in NamePool::shared().
  */
-class Theater {
+class TheaterBase {
 public:
     /**
-     * @brief Constructor to initialize the theater with an ID, name and seats
-     *
-     * @param id The unique identifier for the theater.
-     * @param name The name of the theater.
-     * @param seats A vector of Seat objects representing seats in the theater.
-     */
-    Theater(const int& id, const std::string& name, const std::vector<Seat>& seats);
-    
-    /**
-     * @brief Destructor for the Movie class.
+     * @brief Destructor for the TheaterBase class.
      */
-    virtual ~Theater () = default;
+    virtual ~TheaterBase () = default;
     
     /**
      * @brief Book a seat in the theater by its ID.
@@ -38,14 +40,139 @@ public:
      * @param id The ID of the seat to be booked.
      * @return True if the seat was booked successfully, false otherwise.
      */
-    virtual bool bookSeat(const int& id);
+    virtual bool bookSeat(const int& id) = 0;
+
+    /**
+     * @brief Book a set of seats in the theater, all or nothing.
+     *
+     * The seats are claimed atomically without a lock: either every seat is
+     * booked, or none of them is (unknown, repeated or already booked seats
+     * fail the whole request).
+     *
+     * @param ids The IDs of the seats to be booked.
+     * @return True if all seats were booked, false otherwise.
+     */
+    virtual bool bookSeats(const std::vector<int>& ids) = 0;
+
+    /**
+     * @brief Hold a set of free seats, all or nothing.
+     *
+     * Held seats are not available for booking or holding until they are
+     * confirmed or released.
+     *
+     * @param ids The IDs of the seats to be held.
+     * @return True if all seats were held, false otherwise.
+     */
+    virtual bool holdSeats(const std::vector<int>& ids) = 0;
+
+    /**
+     * @brief Turn held seats into booked seats.
+     *
+     * Of concurrent calls confirming or releasing the same held seat,
+     * exactly one succeeds.
+     *
+     * @param ids The IDs of held seats.
+     * @return True if all seats were held and are now booked, false otherwise.
+     */
+    virtual bool confirmSeats(const std::vector<int>& ids) = 0;
+
+    /**
+     * @brief Release held seats back to free.
+     *
+     * Of concurrent calls confirming or releasing the same held seat,
+     * exactly one succeeds; a release that loses never frees a seat.
+     *
+     * @param ids The IDs of held seats.
+     * @return True if all seats were held and are now free, false otherwise.
+     */
+    virtual bool releaseSeats(const std::vector<int>& ids) = 0;
+
+    /**
+     * @brief Free booked seats again, undoing a booking that could not be logged.
+     *
+     * @param ids The IDs of seats booked by the caller, not held.
+     * @return True if every seat was booked and is now free, false otherwise.
+     */
+    virtual bool cancelSeats(const std::vector<int>& ids) = 0;
+
+    /**
+     * @brief Get the state of a seat by its ID.
+     *
+     * @param id The ID of the seat.
+     * @return The seat state; unknown seats are reported as Booked.
+     */
+    virtual SeatState getSeatState(const int& id) const = 0;
+
+    /**
+     * @brief Get all seats of the theater in layout order.
+     *
+     * @return The seats; isBooked is true for booked (not held) seats.
+     */
+    virtual std::vector<Seat> getSeats() const = 0;
     
     /**
      * @brief Get a vector of available seat IDs in the theater.
      *
      * @return A vector of integers representing the available seat IDs.
      */
-    virtual std::vector<int> getAvailableSeats() const;
+    virtual std::vector<int> getAvailableSeats() const = 0;
+
+    /**
+     * @brief Append the available seat IDs to a caller's vector.
+     *
+     * @param seatIds Receives the seat IDs; it allocates only if its
+     *                capacity is too small.
+     */
+    virtual void appendAvailableSeats(std::vector<int>& seatIds) const = 0;
+
+    /**
+     * @brief Get the number of available seats in the theater.
+     *
+     * Read from a counter kept up to date by bookings, holds and releases.
+     *
+     * @return The number of seats that are neither booked nor held.
+     */
+    virtual std::size_t getAvailableSeatCount() const = 0;
+
+    /**
+     * @brief Find adjacent free seats for a party in the best row.
+     *
+     * Rows are ranked by their distance from the middle row of their
+     * section, ties going to the row further back; within the first row that
+     * can seat the party, the seats closest to the row's center are chosen.
+     * A theater whose seats have no rows is treated as a single row in
+     * layout order. The seats are not claimed; book or hold them next.
+     *
+     * @param partySize The number of adjacent seats wanted.
+     * @return The seat IDs in position order, or an empty vector if no row
+     *         has that many adjacent free seats.
+     */
+    virtual std::vector<int> findBestAvailable(std::size_t partySize) const = 0;
+
+    /**
+     * @brief Get the seat number of a seat by its ID.
+     *
+     * @param id The ID of the seat.
+     * @return The seat number, or an empty string if the seat does not exist.
+     */
+    virtual std::string getSeatNumber(const int& id) const = 0;
+
+    /**
+     * @brief Get the seat layout of the theater.
+     *
+     * @return The layout; shows in this theater share it.
+     */
+    virtual std::shared_ptr<const SeatLayout> getLayout() const = 0;
+
+    /**
+     * @brief Report changes of the theater's available seats to a shared counter.
+     *
+     * See SeatInventory::attachAvailabilityCounter.
+     *
+     * @param counter The counter; must not be null.
+     * @return False if the theater is already attached to a counter.
+     */
+    virtual bool attachAvailabilityCounter(std::shared_ptr<std::atomic<std::int64_t>> counter) = 0;
     
     /**
      * @brief Get the name of the theater.
@@ -53,6 +180,13 @@ public:
      * @return The name of the theater as a string.
      */
     virtual std::string getName() const;
+
+    /**
+     * @brief Get the name of the theater without copying it.
+     *
+     * @return A view of the interned name, valid until the process exits.
+     */
+    std::string_view getNameView() const;
     
     /**
      * @brief Get the ID of the theater.
@@ -83,14 +217,72 @@ public:
      * @param rhs The theater to compare with.
      * @return True if the theater have the same ID, false otherwise.
      */
-    virtual bool operator == (const Theater &rhs) const;
+    virtual bool operator == (const TheaterBase &rhs) const;
 
 protected:
+    /**
+     * @brief Constructor to initialize the theater with an ID and name
+     *
+     * @param id The unique identifier for the theater.
+     * @param name The name of the theater.
+     */
+    TheaterBase(const int& id, std::string_view name);
+
     int mId;                    /**< Unique identifier for the theater. */
-    std::string mName;          /**< Name of the theater. */
-    std::vector<Seat> mSeats;   /**< Vector of seats in the theater. */
+    std::string_view mName;     /**< Name of the theater, interned. */
     bool mIsAllocated;          /**< Flag indicating if a movie is allocated to the theater. */
 
 };
 
+/**
+ * @class Theater
+ * @brief Represents a theater with an ID, name, and seats.
+ *
+ * The Theater class provides methods for managing seats in a theater.
+ * The seats themselves are an immutable SeatLayout, which the theater's
+ * shows share; the theater's own seat state is a SeatInventory, two
+ * word-packed bitmaps indexed by the seat's position in the layout.
+ */
+class Theater : public TheaterBase {
+public:
+    /**
+     * @brief Constructor to initialize the theater with an ID, name and seats
+     *
+     * @param id The unique identifier for the theater.
+     * @param name The name of the theater.
+     * @param seats A vector of Seat objects representing seats in the theater.
+     */
+    Theater(const int& id, std::string_view name, const std::vector<Seat>& seats);
+
+    /**
+     * @brief Constructor to initialize the theater with an existing layout
+     *
+     * Every seat starts free.
+     *
+     * @param id The unique identifier for the theater.
+     * @param name The name of the theater.
+     * @param layout The seats of the theater, possibly shared with other theaters.
+     */
+    Theater(const int& id, std::string_view name, std::shared_ptr<const SeatLayout> layout);
+
+    bool bookSeat(const int& id) override;
+    bool bookSeats(const std::vector<int>& ids) override;
+    bool holdSeats(const std::vector<int>& ids) override;
+    bool confirmSeats(const std::vector<int>& ids) override;
+    bool releaseSeats(const std::vector<int>& ids) override;
+    bool cancelSeats(const std::vector<int>& ids) override;
+    SeatState getSeatState(const int& id) const override;
+    std::vector<Seat> getSeats() const override;
+    std::vector<int> getAvailableSeats() const override;
+    void appendAvailableSeats(std::vector<int>& seatIds) const override;
+    std::size_t getAvailableSeatCount() const override;
+    std::vector<int> findBestAvailable(std::size_t partySize) const override;
+    std::string getSeatNumber(const int& id) const override;
+    std::shared_ptr<const SeatLayout> getLayout() const override;
+    bool attachAvailabilityCounter(std::shared_ptr<std::atomic<std::int64_t>> counter) override;
+
+protected:
+    SeatInventory mSeats;       /**< Seat state over the theater's layout. */
+};
+
 #endif /* THEATER_HPP */
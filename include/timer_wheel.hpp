@@ -0,0 +1,94 @@
+/**
+ * @file timer_wheel.hpp
+ * @brief Hierarchical timing wheel for expiring seat holds.
+ * @author Gebremedhin Abreha
+ */
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel keyed by integer ticks.
+ *
+ * Four levels of 256 slots cover 2^32 ticks. A timer lives in the lowest
+ * level whose span covers its remaining delay and is cascaded one level
+ * down each time that level's slot comes due, so scheduling is O(1) and
+ * advancing costs O(1) amortized per timer. Stretches of ticks in which no
+ * lower level holds a timer are skipped in one step. Cancelled timers
+ * are not removed; callers ignore IDs that are no longer live when they fire.
+ */
+class TimerWheel {
+public:
+    using TimerId = std::uint64_t; /**< Caller-chosen timer identifier. */
+
+    /**
+     * @brief Constructor
+     *
+     * @param now The current tick.
+     */
+    explicit TimerWheel(std::uint64_t now = 0);
+
+    /**
+     * @brief Schedule a timer.
+     *
+     * @param id The timer identifier reported on expiry.
+     * @param expiry The tick at which the timer fires; past ticks fire on
+     *               the next advance.
+     */
+    void schedule(TimerId id, std::uint64_t expiry);
+
+    /**
+     * @brief Advance the wheel and collect the timers that fired.
+     *
+     * @param now The new current tick; ticks in the past are ignored.
+     * @param expired Receives the IDs of timers with expiry <= now.
+     */
+    void advance(std::uint64_t now, std::vector<TimerId>& expired);
+
+    /**
+     * @brief Get the current tick.
+     */
+    std::uint64_t now() const;
+
+    /**
+     * @brief Number of scheduled timers, fired ones excluded.
+     */
+    std::size_t size() const;
+
+private:
+    static constexpr std::size_t kLevels = 4;        /**< Wheel levels. */
+    static constexpr std::size_t kSlotBits = 8;      /**< log2 of slots per level. */
+    static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits; /**< Slots per level. */
+
+    /**
+     * @brief A scheduled timer.
+     */
+    struct Entry {
+        TimerId id;           /**< Timer identifier. */
+        std::uint64_t expiry; /**< Tick at which the timer fires. */
+    };
+
+    using Slot = std::vector<Entry>;
+
+    /**
+     * @brief Put an entry in the slot matching its remaining delay.
+     */
+    void place(const Entry& entry);
+
+    /**
+     * @brief Re-place every entry of one slot of a level.
+     */
+    void cascade(std::size_t level, std::size_t slot);
+
+    std::uint64_t mNow;                                   /**< Current tick. */
+    std::size_t mSize;                                    /**< Scheduled timers. */
+    std::array<std::size_t, kLevels> mLevelSize{};        /**< Timers per level. */
+    std::array<std::array<Slot, kSlots>, kLevels> mWheel; /**< Slots per level. */
+};
+
+#endif /* TIMER_WHEEL_HPP */
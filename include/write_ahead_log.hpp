@@ -0,0 +1,155 @@
+/**
+ * @file write_ahead_log.hpp
+ * @brief Append-only write-ahead log with group commit.
+ * @author Gebremedhin Abreha
+ */
+#ifndef WRITE_AHEAD_LOG_HPP
+#define WRITE_AHEAD_LOG_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+/**
+ * @class WriteAheadLog
+ * @brief Durable, append-only log of opaque records.
+ *
+ * Each record is framed as [length][checksum][payload]. append() returns only
+ * once the record is on stable storage. Concurrent appenders share fsyncs
+ * (group commit): the first waiting appender becomes the leader, writes every
+ * queued record with one write and one fdatasync, and wakes the others;
+ * records queued while it syncs form the next batch. After a failed write
+ * the log is unusable and every append throws, since the durability of the
+ * failed batch is unknown.
+ *
+ * @note Can throw std::system_error on I/O failure
+ */
+class WriteAheadLog {
+public:
+    /**
+     * @brief Constructor, opens (or creates) the log for appending.
+     *
+     * @param path Path of the log file.
+     */
+    explicit WriteAheadLog(const std::string& path);
+
+    /**
+     * @brief Destructor, closes the log file.
+     */
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Append a record and wait until it is durable.
+     *
+     * @param record The record payload.
+     * @return The record's sequence number, starting at 1 for this instance.
+     */
+    std::uint64_t append(const std::string& record);
+
+    /**
+     * @brief Read back the records of a previous run.
+     *
+     * Visits the records of a log left behind by an interrupted rotate(),
+     * then those of the current log, and cuts a torn tail off the current log
+     * so new records are appended after the last intact one. Call before the
+     * first append.
+     *
+     * @param visit Callable invoked with each record payload.
+     * @return The number of records read.
+     */
+    std::size_t recover(const std::function<void(const std::string&)>& visit);
+
+    /**
+     * @brief Move the current log aside and start an empty one.
+     *
+     * Every record appended before the call is durable in the file moved to
+     * rotatedPath(); records appended afterwards go to the new log.
+     */
+    void rotate();
+
+    /**
+     * @brief Delete the log moved aside by rotate(), if any.
+     */
+    void removeRotated();
+
+    /**
+     * @brief Check if a log moved aside by rotate() exists.
+     */
+    bool hasRotated() const;
+
+    /**
+     * @brief Path of the log file.
+     */
+    const std::string& path() const;
+
+    /**
+     * @brief Path the log is moved to by rotate().
+     */
+    std::string rotatedPath() const;
+
+    /**
+     * @brief Number of fdatasync calls issued so far.
+     */
+    std::uint64_t syncCount() const;
+
+    /**
+     * @brief Read every intact record of a log file, in order.
+     *
+     * Reading stops at the first torn or corrupt record, which is what a crash
+     * in the middle of a write leaves behind. A missing file has no records.
+     *
+     * @param path Path of the log file.
+     * @param visit Callable invoked with each record payload.
+     * @param validSize Receives the size in bytes of the intact prefix, if not null.
+     * @return The number of records read.
+     */
+    static std::size_t readRecords(const std::string& path, const std::function<void(const std::string&)>& visit,
+                                   std::size_t* validSize = nullptr);
+
+    /**
+     * @brief Atomically replace a file with the given records, durably.
+     *
+     * The records are written to a temporary file that is synced and renamed
+     * over path, so readers see either the old or the new content.
+     *
+     * @param path Path of the file to replace.
+     * @param records Callable that emits records through the given sink.
+     */
+    static void writeRecords(const std::string& path,
+                             const std::function<void(const std::function<void(const std::string&)>&)>& records);
+
+private:
+    /**
+     * @brief Append the framing of a record to a buffer.
+     */
+    static void frame(const std::string& record, std::string& buffer);
+
+    /**
+     * @brief Write a buffer to a descriptor and sync it.
+     */
+    static void writeAndSync(int fd, const std::string& buffer);
+
+    /**
+     * @brief Open the log file for appending.
+     */
+    void open();
+
+    std::string mPath;             /**< Path of the log file. */
+    int mFd;                       /**< Log file descriptor. */
+
+    mutable std::mutex mMutex;     /**< Guards the members below. */
+    std::condition_variable mSynced; /**< Signalled when a batch is durable. */
+    std::string mPending;          /**< Framed records waiting for the next batch. */
+    std::uint64_t mLastSequence;   /**< Sequence number of the last appended record. */
+    std::uint64_t mDurableSequence; /**< Sequence number up to which records are durable. */
+    std::uint64_t mSyncCount;      /**< Number of fdatasync calls. */
+    bool mFlushing;                /**< True while a leader writes a batch. */
+    bool mFailed;                  /**< True once a batch failed; the log refuses further appends. */
+};
+
+#endif /* WRITE_AHEAD_LOG_HPP */
@@ -9,11 +9,16 @@
 #include <string>
 #include <sstream>
 #include <limits>
+#include <fstream>
+#include <stdexcept>
 
 #include "movie_booking_service.hpp"
+#include "catalog_loader.hpp"
 #include "theater.hpp"
+#include "fixed_theater.hpp"
 #include "movie.hpp"
 #include "seat.hpp"
+#include "seat_layout.hpp"
 
 /**
  * @brief Main function to run the movie booking service CLI.
@@ -33,40 +38,62 @@ int main(int argc, const char * argv[]) {
     //Add more movies as needed
 
 
-    const int seatCapacity = 20; //Number of seats for each theater
-    std::vector<Seat> seats;
+    const int seatCapacity = StandardTheater::kCapacity; //Number of seats for each theater
 
     //Initialize seats
-    for (int i = 0; i < seatCapacity; ++i)
-    {
-            Seat seat;
-            seat.id = i;
-            seat.seatNumber = "Seat " + std::to_string(i + 1);
-            seat.isBooked = false;
-            seats.push_back(seat);
-    }
-
-    std::vector<std::unique_ptr<Theater>> theaters;
-    theaters.emplace_back(std::make_unique<Theater>(1, "Theater01", seats));
-    theaters.emplace_back(std::make_unique<Theater>(2, "Theater02", seats));
-    theaters.emplace_back(std::make_unique<Theater>(3, "Theater03", seats));
-    theaters.emplace_back(std::make_unique<Theater>(4, "Theater04", seats));
-    theaters.emplace_back(std::make_unique<Theater>(5, "Theater05", seats));
-    theaters.emplace_back(std::make_unique<Theater>(6, "Theater06", seats));
-    theaters.emplace_back(std::make_unique<Theater>(7, "Theater07", seats));
+    const std::vector<Seat> seats = numberedSeats(seatCapacity);
+
+    // Every theater has the same seats, so they share one layout; at the
+    // standard size the seat state fits inline in a StandardTheater
+    const auto layout = std::make_shared<const SeatLayout>(seats);
+
+    std::vector<std::unique_ptr<TheaterBase>> theaters;
+    theaters.emplace_back(std::make_unique<StandardTheater>(1, "Theater01", layout));
+    theaters.emplace_back(std::make_unique<StandardTheater>(2, "Theater02", layout));
+    theaters.emplace_back(std::make_unique<StandardTheater>(3, "Theater03", layout));
+    theaters.emplace_back(std::make_unique<StandardTheater>(4, "Theater04", layout));
+    theaters.emplace_back(std::make_unique<StandardTheater>(5, "Theater05", layout));
+    theaters.emplace_back(std::make_unique<StandardTheater>(6, "Theater06", layout));
+    theaters.emplace_back(std::make_unique<StandardTheater>(7, "Theater07", layout));
     //Add more movies as needed
 
     MovieBookingService bookingService;
 
-
-    for (auto& movie : movies)
+    // A catalog given on the command line replaces the built-in one
+    if (argc > 1)
     {
-        bookingService.addMovie(std::move(movie));
+        const std::string catalogPath = argv[1];
+        if (catalogPath.size() > 4 && catalogPath.compare(catalogPath.size() - 4, 4, ".csv") == 0)
+        {
+            std::ifstream catalogFile(catalogPath);
+            try
+            {
+                if (!catalogFile || CatalogLoader::load(catalogFile, bookingService) == 0)
+                    throw std::invalid_argument("empty catalog");
+            }
+            catch (const std::invalid_argument& e)
+            {
+                std::cerr << "Cannot load catalog " << catalogPath << ": " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (!bookingService.loadCatalogImage(catalogPath))
+        {
+            std::cerr << "Cannot load catalog image " << catalogPath << std::endl;
+            return 1;
+        }
     }
-
-    for (auto& theater : theaters)
+    else
     {
-        bookingService.addTheater(std::move(theater));
+        for (auto& movie : movies)
+        {
+            bookingService.addMovie(std::move(movie));
+        }
+
+        for (auto& theater : theaters)
+        {
+            bookingService.addTheater(std::move(theater));
+        }
     }
 
     int selectedMovieId = -1;
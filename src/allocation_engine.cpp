@@ -0,0 +1,111 @@
+/**
+ * @file allocation_engine.cpp
+ * @brief Implementation for AllocationEngine class
+ * @author Gebremedhin Abreha
+ */
+
+#include "allocation_engine.hpp"
+
+/*----------------------------------------------------*/
+void AllocationEngine::addMovie(int movieId)
+{
+    mMovieIds.push_back(movieId);
+}
+
+/*----------------------------------------------------*/
+void AllocationEngine::addTheater(int theaterId)
+{
+    mTheaterIds.push_back(theaterId);
+}
+
+/*----------------------------------------------------*/
+bool AllocationEngine::allocate(int movieId, int theaterId)
+{
+    if (!mTheaterMovies.emplace(theaterId, movieId).second)
+        return false;
+
+    // Appends in place; copies of the engine keep their shorter list
+    SharedVector<int> theaterIds;
+    if (const auto* allocated = mMovieTheaters.find(movieId))
+        theaterIds = *allocated;
+    theaterIds.push_back(theaterId);
+    mMovieTheaters.assign(movieId, std::move(theaterIds));
+    return true;
+}
+
+/*----------------------------------------------------*/
+void AllocationEngine::skipAllocated()
+{
+    while (mNextFreeTheater < mTheaterIds.size() && isTheaterAllocated(mTheaterIds[mNextFreeTheater]))
+        ++mNextFreeTheater;
+    while (mNextWaitingMovie < mMovieIds.size() && isMovieAllocated(mMovieIds[mNextWaitingMovie]))
+        ++mNextWaitingMovie;
+}
+
+/*----------------------------------------------------*/
+std::optional<AllocationEngine::Allocation> AllocationEngine::allocateNext()
+{
+    skipAllocated();
+    if (mNextFreeTheater == mTheaterIds.size() || mNextWaitingMovie == mMovieIds.size())
+        return std::nullopt;
+
+    const Allocation allocation{mMovieIds[mNextWaitingMovie++], mTheaterIds[mNextFreeTheater++]};
+    allocate(allocation.first, allocation.second);
+    return allocation;
+}
+
+/*----------------------------------------------------*/
+std::optional<AllocationEngine::Allocation> AllocationEngine::fillNext(std::mt19937& random)
+{
+    skipAllocated();
+    if (mNextFreeTheater == mTheaterIds.size() || mMovieIds.empty())
+        return std::nullopt;
+
+    std::uniform_int_distribution<std::size_t> pick(0, mMovieIds.size() - 1);
+    const Allocation allocation{mMovieIds[pick(random)], mTheaterIds[mNextFreeTheater++]};
+    allocate(allocation.first, allocation.second);
+    return allocation;
+}
+
+/*----------------------------------------------------*/
+std::vector<int> AllocationEngine::getTheaters(int movieId) const
+{
+    std::vector<int> theaterIds;
+    appendTheaters(movieId, theaterIds);
+    return theaterIds;
+}
+
+/*----------------------------------------------------*/
+void AllocationEngine::appendTheaters(int movieId, std::vector<int>& theaterIds) const
+{
+    if (const auto* allocated = mMovieTheaters.find(movieId))
+        allocated->appendTo(theaterIds);
+}
+
+/*----------------------------------------------------*/
+std::optional<int> AllocationEngine::getMovie(int theaterId) const
+{
+    if (const auto* movieId = mTheaterMovies.find(theaterId))
+        return *movieId;
+    return std::nullopt;
+}
+
+/*----------------------------------------------------*/
+bool AllocationEngine::isShownIn(int theaterId, int movieId) const
+{
+    const auto* shown = mTheaterMovies.find(theaterId);
+    return shown != nullptr && *shown == movieId;
+}
+
+/*----------------------------------------------------*/
+bool AllocationEngine::isMovieAllocated(int movieId) const
+{
+    return mMovieTheaters.contains(movieId);
+}
+
+/*----------------------------------------------------*/
+bool AllocationEngine::isTheaterAllocated(int theaterId) const
+{
+    return mTheaterMovies.contains(theaterId);
+}
+/*-------------------END-------------------------------*/
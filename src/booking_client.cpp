@@ -0,0 +1,208 @@
+/**
+ * @file booking_client.cpp
+ * @brief Implementation for BookingClient class
+ * @author Gebremedhin Abreha
+ */
+
+#include "booking_client.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Throw the current errno as a std::system_error.
+ */
+[[noreturn]] void throwErrno(const std::string& what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/**
+ * @brief Connect a new socket, closing it on failure.
+ */
+int connectSocket(int family, const sockaddr* address, socklen_t length, const std::string& what)
+{
+    const int fd = ::socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throwErrno("socket");
+    if (::connect(fd, address, length) != 0)
+    {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "connect " + what);
+    }
+    return fd;
+}
+
+/**
+ * @brief Connect over TCP, without delaying small requests.
+ */
+int connectTcp(const std::string& host, std::uint16_t port)
+{
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1)
+        throw std::system_error(EINVAL, std::generic_category(), "address " + host);
+
+    const int fd = connectSocket(AF_INET, reinterpret_cast<const sockaddr*>(&address), sizeof(address),
+                                 host + ":" + std::to_string(port));
+    const int noDelay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return fd;
+}
+
+/**
+ * @brief Connect to a Unix socket.
+ */
+int connectUnix(const std::string& path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::system_error(ENAMETOOLONG, std::generic_category(), "socket path");
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return connectSocket(AF_UNIX, reinterpret_cast<const sockaddr*>(&address), sizeof(address), path);
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+BookingClient::BookingClient(const std::string& host, std::uint16_t port):
+BookingClient(connectTcp(host, port))
+{
+}
+
+/*----------------------------------------------------*/
+BookingClient::BookingClient(const std::string& unixPath):
+BookingClient(connectUnix(unixPath))
+{
+}
+
+/*----------------------------------------------------*/
+BookingClient::BookingClient(int fd):
+mFd(fd)
+{
+}
+
+/*----------------------------------------------------*/
+BookingClient BookingClient::connect(const std::string& address)
+{
+    const auto colon = address.rfind(':');
+    if (address.find('/') != std::string::npos || colon == std::string::npos)
+        return BookingClient(address);
+    return BookingClient(address.substr(0, colon), static_cast<std::uint16_t>(std::stoi(address.substr(colon + 1))));
+}
+
+/*----------------------------------------------------*/
+BookingClient::~BookingClient()
+{
+    if (mFd >= 0)
+        ::close(mFd);
+}
+
+/*----------------------------------------------------*/
+BookingClient::BookingClient(BookingClient&& other) noexcept:
+mFd(std::exchange(other.mFd, -1)),
+mOutput(std::move(other.mOutput)),
+mInput(std::move(other.mInput)),
+mConsumed(other.mConsumed)
+{
+}
+
+/*----------------------------------------------------*/
+BookingClient& BookingClient::operator=(BookingClient&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (mFd >= 0)
+            ::close(mFd);
+        mFd = std::exchange(other.mFd, -1);
+        mOutput = std::move(other.mOutput);
+        mInput = std::move(other.mInput);
+        mConsumed = other.mConsumed;
+    }
+    return *this;
+}
+
+/*----------------------------------------------------*/
+std::string BookingClient::call(std::string_view request)
+{
+    send(request);
+    return receive();
+}
+
+/*----------------------------------------------------*/
+void BookingClient::send(std::string_view request)
+{
+    mOutput.append(request.data(), request.size());
+    mOutput += '\n';
+}
+
+/*----------------------------------------------------*/
+void BookingClient::flush()
+{
+    std::size_t sent = 0;
+    while (sent < mOutput.size())
+    {
+        const ssize_t count = ::send(mFd, mOutput.data() + sent, mOutput.size() - sent, MSG_NOSIGNAL);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throwErrno("send");
+        }
+        sent += static_cast<std::size_t>(count);
+    }
+    mOutput.clear();
+}
+
+/*----------------------------------------------------*/
+std::string BookingClient::receive()
+{
+    flush();
+    while (true)
+    {
+        const auto end = mInput.find('\n', mConsumed);
+        if (end != std::string::npos)
+        {
+            std::string response = mInput.substr(mConsumed, end - mConsumed);
+            mConsumed = end + 1;
+            if (mConsumed == mInput.size())
+            {
+                mInput.clear();
+                mConsumed = 0;
+            }
+            return response;
+        }
+
+        // Drop what was returned before reading more
+        mInput.erase(0, mConsumed);
+        mConsumed = 0;
+
+        char buffer[1 << 14];
+        const ssize_t count = ::recv(mFd, buffer, sizeof(buffer), 0);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throwErrno("recv");
+        }
+        if (count == 0)
+            throw std::runtime_error("Connection closed by the server");
+        mInput.append(buffer, static_cast<std::size_t>(count));
+    }
+}
+/*-------------------END-------------------------------*/
@@ -0,0 +1,159 @@
+/**
+ * @file booking_pipeline.cpp
+ * @brief Implementation for BookingPipeline class
+ * @author Gebremedhin Abreha
+ */
+
+#include "booking_pipeline.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/*----------------------------------------------------*/
+BookingPipeline::BookingPipeline(MovieBookingService& service, std::size_t shards, bool pinWorkers):
+mService(service)
+{
+    if (shards == 0)
+        shards = std::max(1u, std::thread::hardware_concurrency());
+
+    mShards.reserve(shards);
+    for (std::size_t i = 0; i < shards; ++i)
+    {
+        mShards.push_back(std::make_unique<Shard>());
+    }
+    for (std::size_t i = 0; i < shards; ++i)
+    {
+        Shard& shard = *mShards[i];
+        shard.worker = std::thread([this, &shard]() { run(shard); });
+#ifdef __linux__
+        if (pinWorkers)
+        {
+            // Best effort: a worker that cannot be pinned still runs
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(i % std::max(1u, std::thread::hardware_concurrency()), &cpus);
+            pthread_setaffinity_np(shard.worker.native_handle(), sizeof(cpus), &cpus);
+        }
+#else
+        (void)pinWorkers;
+#endif
+    }
+}
+
+/*----------------------------------------------------*/
+BookingPipeline::~BookingPipeline()
+{
+    mStopping = true;
+    for (auto& shard : mShards)
+    {
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+        }
+        shard->wake.notify_one();
+    }
+    for (auto& shard : mShards)
+    {
+        shard->worker.join();
+    }
+}
+
+/*----------------------------------------------------*/
+std::future<BookingPipeline::Result> BookingPipeline::submit(MovieBookingService::BookingRequest request)
+{
+    Shard& shard = *mShards[shardOf(request.theaterId)];
+    auto* queued = new Request{std::move(request), std::promise<Result>(), nullptr};
+    auto result = queued->promise.get_future();
+
+    queued->next = shard.head.load(std::memory_order_relaxed);
+    while (!shard.head.compare_exchange_weak(queued->next, queued))
+    {
+    }
+
+    // Seen asleep after the push: the worker may have missed it, wake it
+    if (shard.sleeping.load())
+    {
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+        }
+        shard.wake.notify_one();
+    }
+    return result;
+}
+
+/*----------------------------------------------------*/
+std::size_t BookingPipeline::shardCount() const
+{
+    return mShards.size();
+}
+
+/*----------------------------------------------------*/
+std::size_t BookingPipeline::shardOf(int theaterId) const
+{
+    return static_cast<std::uint32_t>(theaterId) % mShards.size();
+}
+
+/*----------------------------------------------------*/
+void BookingPipeline::run(Shard& shard)
+{
+    while (true)
+    {
+        // Read the flag first: requests queued before the stop are then
+        // visible to the exchange below
+        const bool stopping = mStopping;
+        if (Request* newest = shard.head.exchange(nullptr))
+        {
+            process(newest);
+            continue;
+        }
+        if (stopping)
+            return; // The queue was empty after the stop was requested
+
+        // Announce the sleep before checking the queue a last time, so a
+        // request pushed meanwhile either is seen here or sees the flag
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        shard.sleeping = true;
+        shard.wake.wait(lock, [this, &shard]() { return shard.head.load() != nullptr || mStopping; });
+        shard.sleeping = false;
+    }
+}
+
+/*----------------------------------------------------*/
+void BookingPipeline::process(Request* newest)
+{
+    // The queue is newest first; book in the order requests were queued
+    std::vector<std::unique_ptr<Request>> requests;
+    for (Request* request = newest; request != nullptr; request = request->next)
+    {
+        requests.emplace_back(request);
+    }
+    std::vector<MovieBookingService::BookingRequest> batch;
+    batch.reserve(requests.size());
+    for (auto itr = requests.rbegin(); itr != requests.rend(); ++itr)
+    {
+        batch.push_back(std::move((*itr)->booking));
+    }
+
+    try
+    {
+        auto results = mService.bookBatch(batch);
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            requests[requests.size() - 1 - i]->promise.set_value(std::move(results[i]));
+        }
+    }
+    catch (...)
+    {
+        for (auto& request : requests)
+        {
+            request->promise.set_exception(std::current_exception());
+        }
+    }
+}
+/*-------------------END-------------------------------*/
@@ -0,0 +1,238 @@
+/**
+ * @file booking_replica.cpp
+ * @brief Implementation for BookingReplica class
+ * @author Gebremedhin Abreha
+ */
+
+#include "booking_replica.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Commands answered from the copy; everything else writes.
+ */
+const std::unordered_set<std::string_view>& readCommands()
+{
+    static const std::unordered_set<std::string_view> commands = {
+        "MOVIES", "MOVIES_AVAILABLE", "THEATERS", "SHOWS_FOR_MOVIE", "SHOWS_FOR_THEATER", "SEATS",
+        "SEAT_COUNT", "MOVIE_SEAT_COUNT", "BEST", "SHOW_SEATS", "SHOW_BEST", "SHOW", "IS_MOVIE",
+        "SHOWN_IN", "MOVIE_NAME", "THEATER_NAME", "METRICS",
+    };
+    return commands;
+}
+
+/**
+ * @brief Split a response at spaces.
+ */
+std::vector<std::string_view> split(std::string_view text)
+{
+    std::vector<std::string_view> words;
+    while (!text.empty())
+    {
+        const auto end = std::min(text.find(' '), text.size());
+        if (end > 0)
+            words.push_back(text.substr(0, end));
+        text.remove_prefix(std::min(end + 1, text.size()));
+    }
+    return words;
+}
+
+/**
+ * @brief Parse a whole token as a sequence number or ID.
+ */
+std::uint64_t parseNumber(std::string_view token)
+{
+    std::uint64_t value = 0;
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (token.empty() || result.ec != std::errc() || result.ptr != token.data() + token.size())
+        throw std::runtime_error("Malformed replication response");
+    return value;
+}
+
+/**
+ * @brief Decode the records of a REPL_ response, from a given word on.
+ */
+std::vector<std::string> decodeRecords(const std::vector<std::string_view>& words, std::size_t first)
+{
+    std::vector<std::string> records(words.size() - std::min(first, words.size()));
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        if (!ServiceProtocol::decodeRecord(words[first + i], records[i]))
+            throw std::runtime_error("Malformed replication record");
+    }
+    return records;
+}
+
+/**
+ * @brief Current steady clock time in nanoseconds.
+ */
+std::int64_t steadyNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+BookingReplica::BookingReplica(Options options):
+mOptions(std::move(options))
+{
+    if (mOptions.batchRecords == 0)
+        throw std::invalid_argument("A replica pulls at least one record at a time");
+    mFollower = std::thread([this]() { follow(); });
+}
+
+/*----------------------------------------------------*/
+BookingReplica::~BookingReplica()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mProgress.notify_all();
+    mFollower.join();
+}
+
+/*----------------------------------------------------*/
+void BookingReplica::handle(std::string_view request, std::string& response) const
+{
+    const auto words = split(request);
+    const std::string_view command = words.empty() ? std::string_view() : words.front();
+    if (command == "PING")
+    {
+        mProtocol.handle(request, response);
+    }
+    else if (command == "REPLICA_STATUS")
+    {
+        response += words.size() == 1 ? "OK " + std::to_string(appliedSequence()) + (isFresh() ? " 1" : " 0")
+                                      : std::string("ERR bad arguments");
+    }
+    else if (readCommands().count(command) == 0)
+    {
+        response += ServiceProtocol::isCommand(command) ? "ERR read-only replica" : "ERR unknown command";
+    }
+    else if (!isFresh())
+    {
+        response += "ERR stale replica";
+    }
+    else
+    {
+        mProtocol.handle(request, response);
+    }
+}
+
+/*----------------------------------------------------*/
+std::uint64_t BookingReplica::appliedSequence() const
+{
+    return mApplied.load(std::memory_order_acquire);
+}
+
+/*----------------------------------------------------*/
+bool BookingReplica::isFresh() const
+{
+    const std::int64_t caughtUpAt = mCaughtUpAt.load(std::memory_order_acquire);
+    return caughtUpAt != 0 && steadyNow() - caughtUpAt <= std::chrono::nanoseconds(mOptions.maxStaleness).count();
+}
+
+/*----------------------------------------------------*/
+bool BookingReplica::waitForSequence(std::uint64_t sequence, std::chrono::milliseconds timeout) const
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mProgress.wait_for(lock, timeout, [this, sequence]() {
+        return mApplied.load(std::memory_order_acquire) >= sequence;
+    });
+}
+
+/*----------------------------------------------------*/
+const MovieBookingService& BookingReplica::service() const
+{
+    return mService;
+}
+
+/*----------------------------------------------------*/
+void BookingReplica::follow()
+{
+    std::optional<BookingClient> primary;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mStopping)
+    {
+        lock.unlock();
+        bool more = false;
+        try
+        {
+            if (!primary)
+                primary.emplace(BookingClient::connect(mOptions.primary));
+            if (mLogId == 0)
+                loadSnapshot(*primary);
+            more = pull(*primary);
+        }
+        catch (const std::exception&)
+        {
+            // Reconnect on the next round; reads turn stale meanwhile
+            primary.reset();
+        }
+        lock.lock();
+        if (!more)
+            mProgress.wait_for(lock, mOptions.pollInterval, [this]() { return mStopping; });
+    }
+}
+
+/*----------------------------------------------------*/
+void BookingReplica::loadSnapshot(BookingClient& primary)
+{
+    const std::string response = primary.call("REPL_SNAPSHOT");
+    const auto words = split(response);
+    if (words.size() < 3 || words[0] != "OK")
+        throw std::runtime_error("Snapshot refused: " + response);
+
+    const std::uint64_t logId = parseNumber(words[1]);
+    const std::uint64_t sequence = parseNumber(words[2]);
+    mService.loadReplicationSnapshot(decodeRecords(words, 3));
+    mLogId = logId;
+    advance(sequence, false);
+}
+
+/*----------------------------------------------------*/
+bool BookingReplica::pull(BookingClient& primary)
+{
+    const std::uint64_t applied = mApplied.load(std::memory_order_relaxed);
+    const std::string response = primary.call("REPL_PULL " + std::to_string(mLogId) + " " + std::to_string(applied) +
+                                              " " + std::to_string(mOptions.batchRecords));
+    if (response == "ERR lapped")
+    {
+        mLogId = 0; // Start over from a snapshot
+        return true;
+    }
+    const auto words = split(response);
+    if (words.size() < 2 || words[0] != "OK")
+        throw std::runtime_error("Pull refused: " + response);
+
+    const std::uint64_t primarySequence = parseNumber(words[1]);
+    const auto records = decodeRecords(words, 2);
+    mService.applyReplicationRecords(records);
+    advance(applied + records.size(), applied + records.size() >= primarySequence);
+    return records.size() == mOptions.batchRecords;
+}
+
+/*----------------------------------------------------*/
+void BookingReplica::advance(std::uint64_t sequence, bool caughtUp)
+{
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mApplied.store(sequence, std::memory_order_release);
+        if (caughtUp)
+            mCaughtUpAt.store(steadyNow(), std::memory_order_release);
+    }
+    mProgress.notify_all();
+}
+/*-------------------END-------------------------------*/
@@ -0,0 +1,505 @@
+/**
+ * @file booking_router.cpp
+ * @brief Implementation for BookingRouter class
+ * @author Gebremedhin Abreha
+ */
+
+#include "booking_router.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+/**
+ * @enum Route
+ * @brief How a command is routed and its answers combined.
+ */
+enum class Route {
+    Ping,        /**< Answered by the router. */
+    Theater,     /**< To the owner of the theater in the first argument. */
+    AddShow,     /**< To the owner of the show's theater; the show's shard is remembered. */
+    Show,        /**< To the shard holding the show in the first argument. */
+    Hold,        /**< Like Theater or Show, and the hold ID in the answer is made global. */
+    HoldId,      /**< To the shard encoded in the hold ID. */
+    Batch,       /**< Split per theater owner. */
+    AllOk,       /**< To every shard; OK if every shard said OK. */
+    Sum,         /**< To every shard; the counts are added. */
+    Union,       /**< To every shard; the ID lists are merged. */
+    AnyTrue,     /**< To every shard; 1 if any shard said 1. */
+    First,       /**< To every shard; the first OK answer. */
+    Shows,       /**< To every shard; the shows are merged by start time. */
+    Metrics,     /**< To every shard; the JSON objects are listed. */
+    Unsupported  /**< Per instance; not routed. */
+};
+
+/**
+ * @brief Route of every command by name.
+ */
+const std::unordered_map<std::string_view, Route>& routes()
+{
+    static const std::unordered_map<std::string_view, Route> table = {
+        {"PING", Route::Ping},
+        {"ADD_THEATER", Route::Theater},
+        {"SEATS", Route::Theater},
+        {"SEAT_COUNT", Route::Theater},
+        {"BEST", Route::Theater},
+        {"BOOK", Route::Theater},
+        {"SHOWS_FOR_THEATER", Route::Theater},
+        {"THEATER_NAME", Route::Theater},
+        {"SHOWN_IN", Route::Theater},
+        {"ADD_SHOW", Route::AddShow},
+        {"SHOW", Route::Show},
+        {"SHOW_SEATS", Route::Show},
+        {"SHOW_BEST", Route::Show},
+        {"BOOK_SHOW", Route::Show},
+        {"HOLD", Route::Hold},
+        {"HOLD_SHOW", Route::Hold},
+        {"CONFIRM", Route::HoldId},
+        {"RELEASE", Route::HoldId},
+        {"BOOK_BATCH", Route::Batch},
+        {"ADD_MOVIE", Route::AllOk},
+        {"CHECKPOINT", Route::AllOk},
+        {"EXPIRE", Route::Sum},
+        {"MOVIE_SEAT_COUNT", Route::Sum},
+        {"MOVIES", Route::Union},
+        {"MOVIES_AVAILABLE", Route::Union},
+        {"THEATERS", Route::Union},
+        {"IS_MOVIE", Route::AnyTrue},
+        {"MOVIE_NAME", Route::First},
+        {"SHOWS_FOR_MOVIE", Route::Shows},
+        {"METRICS", Route::Metrics},
+        {"LOAD_CATALOG", Route::Unsupported},
+        {"LOAD_IMAGE", Route::Unsupported},
+        {"EVENT_SEQUENCE", Route::Unsupported},
+        {"REPL_SEQUENCE", Route::Unsupported},
+        {"REPL_SNAPSHOT", Route::Unsupported},
+        {"REPL_PULL", Route::Unsupported},
+    };
+    return table;
+}
+
+/**
+ * @brief Split a line at spaces.
+ */
+std::vector<std::string_view> split(std::string_view text)
+{
+    std::vector<std::string_view> words;
+    while (!text.empty())
+    {
+        const auto begin = text.find_first_not_of(' ');
+        if (begin == std::string_view::npos)
+            break;
+        text.remove_prefix(begin);
+        const auto end = std::min(text.find(' '), text.size());
+        words.push_back(text.substr(0, end));
+        text.remove_prefix(end);
+    }
+    return words;
+}
+
+/**
+ * @brief Parse a whole token as a number.
+ */
+template <typename T>
+bool parse(std::string_view token, T& value)
+{
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    return !token.empty() && result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+/**
+ * @brief Check if a response reports success.
+ */
+bool isOk(std::string_view response)
+{
+    return response == "OK" || response.substr(0, 3) == "OK ";
+}
+
+/**
+ * @brief The result after "OK ".
+ */
+std::string_view payload(std::string_view response)
+{
+    return response.size() > 3 ? response.substr(3) : std::string_view();
+}
+
+/**
+ * @brief The first error among responses, or an empty string.
+ */
+std::string firstError(const std::vector<std::string>& responses)
+{
+    for (const auto& response : responses)
+    {
+        if (!isOk(response))
+            return response;
+    }
+    return {};
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+BookingRouter::BookingRouter(std::vector<std::string> shards, std::size_t virtualNodes):
+mRing(shards.size(), virtualNodes)
+{
+    if (shards.size() > kMaxShards)
+        throw std::invalid_argument("Too many shards for the hold ID encoding");
+    for (auto& address : shards)
+    {
+        mBackends.push_back(std::make_unique<Backend>());
+        mBackends.back()->address = std::move(address);
+    }
+}
+
+/*----------------------------------------------------*/
+std::size_t BookingRouter::shardOf(int theaterId) const
+{
+    return mRing.shardOf(theaterId);
+}
+
+/*----------------------------------------------------*/
+std::size_t BookingRouter::shardCount() const
+{
+    return mBackends.size();
+}
+
+/*----------------------------------------------------*/
+void BookingRouter::handle(std::string_view request, std::string& response)
+{
+    const auto words = split(request);
+    const auto route = words.empty() ? routes().end() : routes().find(words[0]);
+    if (route == routes().end())
+    {
+        response += "ERR unknown command";
+        return;
+    }
+    const std::string_view command = words[0];
+
+    int id = 0;
+    const bool hasId = words.size() > 1 && parse(words[1], id);
+    switch (route->second)
+    {
+    case Route::Ping:
+        response += "OK";
+        return;
+
+    case Route::Theater:
+    case Route::AddShow:
+    case Route::Show:
+    case Route::Hold:
+    {
+        int theaterId = 0;
+        if (!hasId || (route->second == Route::AddShow && (words.size() < 3 || !parse(words[2], theaterId))))
+            break;
+
+        std::size_t shard = 0;
+        if (route->second == Route::AddShow)
+            shard = shardOf(theaterId);
+        else if (route->second == Route::Show || command == "HOLD_SHOW")
+            shard = locateShow(id).value_or(0); // An unknown show gets the answer any shard gives
+        else
+            shard = shardOf(id);
+
+        std::string answer = forward(shard, request);
+        if (route->second == Route::AddShow && isOk(answer))
+        {
+            const std::lock_guard<std::mutex> lock(mShowMutex);
+            mShowShards[id] = shard;
+        }
+        std::uint64_t holdId = 0;
+        if (route->second == Route::Hold && isOk(answer) && parse(payload(answer), holdId))
+        {
+            if (holdId > kMaxShardHoldId)
+            {
+                // It cannot be named through the router, so nobody could confirm or release it
+                forward(shard, "RELEASE " + std::to_string(holdId));
+                answer = "ERR hold ID out of range";
+            }
+            else
+            {
+                answer = "OK " + std::to_string((static_cast<std::uint64_t>(shard) << kHoldShardShift) | holdId);
+            }
+        }
+        response += answer;
+        return;
+    }
+
+    case Route::HoldId:
+    {
+        std::uint64_t holdId = 0;
+        if (words.size() != 2 || !parse(words[1], holdId))
+            break;
+        const auto shard = static_cast<std::size_t>(holdId >> kHoldShardShift);
+        if (shard >= shardCount())
+        {
+            response += "ERR unknown hold";
+            return;
+        }
+        response += forward(shard, std::string(command) + " " + std::to_string(holdId & kMaxShardHoldId));
+        return;
+    }
+
+    case Route::Batch:
+        bookBatch(request.substr(request.find(command) + command.size()), response);
+        return;
+
+    case Route::Unsupported:
+        response += "ERR not supported by the router";
+        return;
+
+    default:
+    {
+        // Every other command goes to all shards
+        const auto answers = broadcast(request);
+        const auto error = firstError(answers);
+        const bool anyOk = std::any_of(answers.begin(), answers.end(), [](const std::string& answer) {
+            return isOk(answer);
+        });
+
+        switch (route->second)
+        {
+        case Route::AllOk:
+            response += error.empty() ? "OK" : error;
+            return;
+
+        case Route::Sum:
+        {
+            std::uint64_t total = 0;
+            for (const auto& answer : answers)
+            {
+                std::uint64_t count = 0;
+                parse(payload(answer), count);
+                total += count;
+            }
+            response += error.empty() ? "OK " + std::to_string(total) : error;
+            return;
+        }
+
+        case Route::Union:
+        {
+            std::set<long long> ids;
+            for (const auto& answer : answers)
+            {
+                for (const auto word : isOk(answer) ? split(payload(answer)) : std::vector<std::string_view>())
+                {
+                    long long value = 0;
+                    if (parse(word, value))
+                        ids.insert(value);
+                }
+            }
+            if (!anyOk)
+            {
+                response += error;
+                return;
+            }
+            response += "OK";
+            for (const auto value : ids)
+                response += " " + std::to_string(value);
+            return;
+        }
+
+        case Route::AnyTrue:
+            if (!anyOk)
+                response += error;
+            else if (std::find(answers.begin(), answers.end(), "OK 1") != answers.end())
+                response += "OK 1";
+            else
+                response += "OK 0";
+            return;
+
+        case Route::First:
+        {
+            const auto itr = std::find_if(answers.begin(), answers.end(), [](const std::string& answer) {
+                return isOk(answer);
+            });
+            response += itr != answers.end() ? *itr : error;
+            return;
+        }
+
+        case Route::Shows:
+        {
+            // Shows are id,theaterId,movieId,startTime; order them by start time like one instance does
+            std::vector<std::tuple<long long, int, std::string_view>> shows;
+            for (const auto& answer : answers)
+            {
+                for (const auto show : isOk(answer) ? split(payload(answer)) : std::vector<std::string_view>())
+                {
+                    int showId = 0;
+                    long long startTime = 0;
+                    const auto comma = show.find(',');
+                    parse(show.substr(0, comma), showId);
+                    parse(show.substr(show.rfind(',') + 1), startTime);
+                    shows.emplace_back(startTime, showId, show);
+                }
+            }
+            if (!anyOk)
+            {
+                response += error;
+                return;
+            }
+            std::sort(shows.begin(), shows.end());
+            response += "OK";
+            for (const auto& show : shows)
+                response.append(" ").append(std::get<2>(show));
+            return;
+        }
+
+        case Route::Metrics:
+            if (!error.empty())
+            {
+                response += error;
+                return;
+            }
+            response += "OK [";
+            for (std::size_t i = 0; i < answers.size(); ++i)
+                response.append(i == 0 ? "" : ",").append(payload(answers[i]));
+            response += "]";
+            return;
+
+        default:
+            break;
+        }
+    }
+    }
+    response += "ERR bad arguments";
+}
+
+/*----------------------------------------------------*/
+std::vector<std::string> BookingRouter::send(const Requests& requests)
+{
+    // Send everything before reading anything, so the shards work in parallel
+    std::vector<BookingClient> clients;
+    clients.reserve(requests.size());
+    for (const auto& [shard, request] : requests)
+    {
+        Backend& backend = *mBackends[shard];
+        std::unique_lock<std::mutex> lock(backend.mutex);
+        if (!backend.idle.empty())
+        {
+            clients.push_back(std::move(backend.idle.back()));
+            backend.idle.pop_back();
+            lock.unlock();
+        }
+        else
+        {
+            lock.unlock();
+            clients.push_back(BookingClient::connect(backend.address));
+        }
+        clients.back().send(request);
+        clients.back().flush();
+    }
+
+    std::vector<std::string> responses;
+    responses.reserve(requests.size());
+    for (auto& client : clients)
+        responses.push_back(client.receive());
+
+    // Only connections that answered go back to the pool
+    for (std::size_t i = 0; i < requests.size(); ++i)
+    {
+        Backend& backend = *mBackends[requests[i].first];
+        const std::lock_guard<std::mutex> lock(backend.mutex);
+        backend.idle.push_back(std::move(clients[i]));
+    }
+    return responses;
+}
+
+/*----------------------------------------------------*/
+std::string BookingRouter::forward(std::size_t shard, std::string_view request)
+{
+    return std::move(send({{shard, std::string(request)}}).front());
+}
+
+/*----------------------------------------------------*/
+std::vector<std::string> BookingRouter::broadcast(std::string_view request)
+{
+    Requests requests;
+    requests.reserve(shardCount());
+    for (std::size_t shard = 0; shard < shardCount(); ++shard)
+        requests.emplace_back(shard, std::string(request));
+    return send(requests);
+}
+
+/*----------------------------------------------------*/
+std::optional<std::size_t> BookingRouter::locateShow(int showId)
+{
+    {
+        const std::lock_guard<std::mutex> lock(mShowMutex);
+        const auto itr = mShowShards.find(showId);
+        if (itr != mShowShards.end())
+            return itr->second;
+    }
+
+    // Added through another router, or before a restart
+    const auto answers = broadcast("SHOW " + std::to_string(showId));
+    for (std::size_t shard = 0; shard < answers.size(); ++shard)
+    {
+        if (isOk(answers[shard]))
+        {
+            const std::lock_guard<std::mutex> lock(mShowMutex);
+            mShowShards[showId] = shard;
+            return shard;
+        }
+    }
+    return std::nullopt;
+}
+
+/*----------------------------------------------------*/
+void BookingRouter::bookBatch(std::string_view arguments, std::string& response)
+{
+    // Arguments are (requestId, theaterId, seats) triples
+    const auto words = split(arguments);
+    if (words.empty() || words.size() % 3 != 0)
+    {
+        response += "ERR bad arguments";
+        return;
+    }
+
+    std::vector<std::string> lines(shardCount());
+    std::vector<std::vector<std::size_t>> positions(shardCount()); // Batch positions per shard
+    for (std::size_t i = 0; i < words.size(); i += 3)
+    {
+        int theaterId = 0;
+        if (!parse(words[i + 1], theaterId))
+        {
+            response += "ERR bad arguments";
+            return;
+        }
+        const std::size_t shard = shardOf(theaterId);
+        std::string& line = lines[shard];
+        line.append(line.empty() ? "BOOK_BATCH" : "").append(" ").append(words[i]);
+        line.append(" ").append(words[i + 1]).append(" ").append(words[i + 2]);
+        positions[shard].push_back(i / 3);
+    }
+
+    Requests requests;
+    for (std::size_t shard = 0; shard < shardCount(); ++shard)
+    {
+        if (!lines[shard].empty())
+            requests.emplace_back(shard, std::move(lines[shard]));
+    }
+    const auto answers = send(requests);
+
+    std::vector<std::string_view> results(words.size() / 3);
+    for (std::size_t i = 0; i < answers.size(); ++i)
+    {
+        const auto& shardPositions = positions[requests[i].first];
+        const auto shardResults = split(payload(answers[i]));
+        if (!isOk(answers[i]) || shardResults.size() != shardPositions.size())
+        {
+            response += isOk(answers[i]) ? "ERR bad shard response" : answers[i];
+            return;
+        }
+        for (std::size_t j = 0; j < shardPositions.size(); ++j)
+            results[shardPositions[j]] = shardResults[j];
+    }
+
+    response += "OK";
+    for (const auto result : results)
+        response.append(" ").append(result);
+}
+/*-------------------END-------------------------------*/
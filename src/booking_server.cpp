@@ -0,0 +1,389 @@
+/**
+ * @file booking_server.cpp
+ * @brief Implementation for BookingServer class
+ * @author Gebremedhin Abreha
+ */
+
+#include "booking_server.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <system_error>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t kReadChunk = 1 << 16; /**< Bytes read per readiness event. */
+constexpr int kMaxEvents = 64;              /**< Events taken per epoll_wait. */
+constexpr std::chrono::milliseconds kAcceptBackoff{100}; /**< Accept pause when out of descriptors. */
+
+/**
+ * @brief Throw the current errno as a std::system_error.
+ */
+[[noreturn]] void throwErrno(const std::string& what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/**
+ * @brief Register a descriptor with an epoll instance.
+ */
+void addWatch(int epollFd, int fd, std::uint32_t events)
+{
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        throwErrno("epoll_ctl");
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+BookingServer::BookingServer(Handler handler, Options options):
+mHandler(std::move(handler)),
+mOptions(std::move(options))
+{
+    try
+    {
+        listen();
+        for (std::size_t i = 0; i < std::max<std::size_t>(1, mOptions.threads); ++i)
+        {
+            auto loop = std::make_unique<Loop>();
+            loop->epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+            if (loop->epollFd < 0)
+                throwErrno("epoll_create1");
+            loop->wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (loop->wakeFd < 0)
+            {
+                ::close(loop->epollFd);
+                throwErrno("eventfd");
+            }
+            mLoops.push_back(std::move(loop));
+            addWatch(mLoops.back()->epollFd, mLoops.back()->wakeFd, EPOLLIN);
+            addWatch(mLoops.back()->epollFd, mListenFd, EPOLLIN | EPOLLEXCLUSIVE);
+        }
+    }
+    catch (...)
+    {
+        closeSockets();
+        throw;
+    }
+
+    for (auto& loop : mLoops)
+    {
+        loop->thread = std::thread([this, &loop = *loop]() { run(loop); });
+    }
+}
+
+/*----------------------------------------------------*/
+BookingServer::~BookingServer()
+{
+    mStopping = true;
+    for (auto& loop : mLoops)
+    {
+        const std::uint64_t one = 1;
+        (void)!::write(loop->wakeFd, &one, sizeof(one));
+    }
+    for (auto& loop : mLoops)
+    {
+        loop->thread.join();
+    }
+    closeSockets();
+}
+
+/*----------------------------------------------------*/
+std::uint16_t BookingServer::port() const
+{
+    return mPort;
+}
+
+/*----------------------------------------------------*/
+std::size_t BookingServer::connectionCount() const
+{
+    return mConnections;
+}
+
+/*----------------------------------------------------*/
+void BookingServer::listen()
+{
+    if (!mOptions.unixPath.empty())
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (mOptions.unixPath.size() >= sizeof(address.sun_path))
+            throw std::system_error(ENAMETOOLONG, std::generic_category(), "socket path");
+        std::memcpy(address.sun_path, mOptions.unixPath.c_str(), mOptions.unixPath.size() + 1);
+
+        mListenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (mListenFd < 0)
+            throwErrno("socket");
+        ::unlink(mOptions.unixPath.c_str()); // Left over by a server that did not stop cleanly
+        if (::bind(mListenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+            throwErrno("bind " + mOptions.unixPath);
+    }
+    else
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(mOptions.port);
+        if (::inet_pton(AF_INET, mOptions.host.c_str(), &address.sin_addr) != 1)
+            throw std::system_error(EINVAL, std::generic_category(), "address " + mOptions.host);
+
+        mListenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (mListenFd < 0)
+            throwErrno("socket");
+        const int reuse = 1;
+        ::setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (::bind(mListenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+            throwErrno("bind " + mOptions.host + ":" + std::to_string(mOptions.port));
+
+        socklen_t length = sizeof(address);
+        ::getsockname(mListenFd, reinterpret_cast<sockaddr*>(&address), &length);
+        mPort = ntohs(address.sin_port);
+    }
+    if (::listen(mListenFd, SOMAXCONN) != 0)
+        throwErrno("listen");
+}
+
+/*----------------------------------------------------*/
+void BookingServer::closeSockets()
+{
+    for (auto& loop : mLoops)
+    {
+        ::close(loop->wakeFd);
+        ::close(loop->epollFd);
+    }
+    mLoops.clear();
+    if (mListenFd >= 0)
+    {
+        ::close(mListenFd);
+        mListenFd = -1;
+        if (!mOptions.unixPath.empty())
+            ::unlink(mOptions.unixPath.c_str());
+    }
+}
+
+/*----------------------------------------------------*/
+void BookingServer::run(Loop& loop)
+{
+    epoll_event events[kMaxEvents];
+    while (!mStopping)
+    {
+        int timeout = -1;
+        if (!loop.accepting)
+        {
+            const auto wait = loop.acceptPausedUntil - std::chrono::steady_clock::now();
+            if (wait <= wait.zero())
+                resumeAccepting(loop);
+            else
+                timeout = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(wait).count());
+        }
+
+        const int count = ::epoll_wait(loop.epollFd, events, kMaxEvents, timeout);
+        for (int i = 0; i < count; ++i)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == loop.wakeFd)
+                continue; // Stopping; checked by the loop condition
+            if (fd == mListenFd)
+            {
+                accept(loop);
+                continue;
+            }
+
+            auto itr = loop.connections.find(fd);
+            if (itr == loop.connections.end())
+                continue; // Closed earlier in this batch
+            Connection& connection = *itr->second;
+
+            bool open = (events[i].events & EPOLLERR) == 0;
+            if (open && (events[i].events & (EPOLLIN | EPOLLHUP)) != 0)
+                open = receive(connection);
+            if (open)
+                open = flush(connection);
+
+            if (!open || (connection.closing && connection.output.empty()))
+                close(loop, fd);
+            else
+                watch(loop, connection);
+        }
+    }
+
+    while (!loop.connections.empty())
+    {
+        close(loop, loop.connections.begin()->first);
+    }
+}
+
+/*----------------------------------------------------*/
+void BookingServer::accept(Loop& loop)
+{
+    while (true)
+    {
+        const int fd = ::accept4(mListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO)
+                continue; // Interrupted, or that connection is gone; try the next one
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+                pauseAccepting(loop); // The listening socket stays readable, so waiting on it would spin
+            return;
+        }
+
+        if (mOptions.unixPath.empty())
+        {
+            // Responses are small and pipelined; do not hold them back
+            const int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->events = EPOLLIN;
+        epoll_event event{};
+        event.events = connection->events;
+        event.data.fd = fd;
+        if (::epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            ::close(fd);
+            continue;
+        }
+        loop.connections.emplace(fd, std::move(connection));
+        ++mConnections;
+    }
+}
+
+/*----------------------------------------------------*/
+void BookingServer::pauseAccepting(Loop& loop)
+{
+    ::epoll_ctl(loop.epollFd, EPOLL_CTL_DEL, mListenFd, nullptr);
+    loop.accepting = false;
+    loop.acceptPausedUntil = std::chrono::steady_clock::now() + kAcceptBackoff;
+}
+
+/*----------------------------------------------------*/
+void BookingServer::resumeAccepting(Loop& loop)
+{
+    // EPOLLEXCLUSIVE cannot be modified, so the socket was removed and is added back
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLEXCLUSIVE;
+    event.data.fd = mListenFd;
+    if (::epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, mListenFd, &event) == 0)
+        loop.accepting = true;
+    else
+        loop.acceptPausedUntil = std::chrono::steady_clock::now() + kAcceptBackoff;
+}
+
+/*----------------------------------------------------*/
+bool BookingServer::receive(Connection& connection)
+{
+    if (connection.closing)
+        return true;
+
+    // One read per event keeps a busy client from starving the others
+    char buffer[kReadChunk];
+    const ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+    if (received < 0)
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    if (received == 0)
+        connection.closing = true; // The client is done sending; answer what it sent
+    connection.input.append(buffer, static_cast<std::size_t>(received));
+
+    std::size_t begin = 0;
+    for (std::size_t end; (end = connection.input.find('\n', begin)) != std::string::npos; begin = end + 1)
+    {
+        std::string_view request(connection.input.data() + begin, end - begin);
+        if (!request.empty() && request.back() == '\r')
+            request.remove_suffix(1);
+
+        if (request == "QUIT" || request.size() > mOptions.maxRequestBytes)
+        {
+            connection.output += request == "QUIT" ? "OK\n" : "ERR request too long\n";
+            connection.closing = true;
+            begin = connection.input.size();
+            break;
+        }
+        const std::size_t responseStart = connection.output.size();
+        try
+        {
+            mHandler(request, connection.output);
+        }
+        catch (const std::exception& e)
+        {
+            connection.output.resize(responseStart);
+            connection.output += "ERR ";
+            connection.output += e.what();
+        }
+        connection.output += '\n';
+    }
+    connection.input.erase(0, begin);
+
+    if (connection.input.size() > mOptions.maxRequestBytes)
+    {
+        connection.output += "ERR request too long\n";
+        connection.input.clear();
+        connection.closing = true;
+    }
+    return true;
+}
+
+/*----------------------------------------------------*/
+bool BookingServer::flush(Connection& connection)
+{
+    while (connection.sent < connection.output.size())
+    {
+        const ssize_t sent = ::send(connection.fd, connection.output.data() + connection.sent,
+                                    connection.output.size() - connection.sent, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection.sent += static_cast<std::size_t>(sent);
+    }
+    connection.output.clear();
+    connection.sent = 0;
+    return true;
+}
+
+/*----------------------------------------------------*/
+void BookingServer::watch(Loop& loop, Connection& connection)
+{
+    const std::size_t pending = connection.output.size() - connection.sent;
+    std::uint32_t events = 0;
+    if (!connection.closing && pending < mOptions.maxPendingBytes)
+        events |= EPOLLIN;
+    if (pending > 0)
+        events |= EPOLLOUT;
+
+    if (events != connection.events)
+    {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = connection.fd;
+        ::epoll_ctl(loop.epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = events;
+    }
+}
+
+/*----------------------------------------------------*/
+void BookingServer::close(Loop& loop, int fd)
+{
+    ::epoll_ctl(loop.epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    loop.connections.erase(fd);
+    --mConnections;
+}
+/*-------------------END-------------------------------*/
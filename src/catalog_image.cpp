@@ -0,0 +1,282 @@
+/**
+ * @file catalog_image.cpp
+ * @brief Implementation for CatalogImage and CatalogImageWriter classes
+ * @author Gebremedhin Abreha
+ */
+
+#include "catalog_image.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace catalog_format;
+
+namespace {
+
+constexpr std::uint64_t kAlignment = 8; /**< Alignment of every table. */
+
+/**
+ * @brief Round an offset up to the table alignment.
+ */
+std::uint64_t align(std::uint64_t offset)
+{
+    return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+/**
+ * @brief Check that a table of count entries at offset lies inside the file.
+ */
+bool fits(std::uint64_t offset, std::uint64_t count, std::uint64_t entrySize, std::uint64_t fileSize)
+{
+    if (offset > fileSize || offset % kAlignment != 0)
+        return false;
+    return count <= (fileSize - offset) / entrySize;
+}
+
+/**
+ * @brief Append a table to the image buffer at an aligned offset.
+ */
+template <typename T>
+std::uint64_t appendTable(std::string& buffer, const std::vector<T>& table)
+{
+    buffer.resize(align(buffer.size()), '\0');
+    const std::uint64_t offset = buffer.size();
+    buffer.append(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+    return offset;
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+CatalogImage::CatalogImage(const std::string& path):
+mData(nullptr), mSize(0), mHeader(nullptr)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "stat " + path);
+    }
+    if (static_cast<std::uint64_t>(status.st_size) < sizeof(Header))
+    {
+        ::close(fd);
+        throw std::runtime_error("Catalog image too small: " + path);
+    }
+
+    mSize = static_cast<std::size_t>(status.st_size);
+    void* mapping = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        throw std::system_error(error, std::generic_category(), "mmap " + path);
+
+    mData = static_cast<const char*>(mapping);
+    mHeader = reinterpret_cast<const Header*>(mData);
+
+    const Header& header = *mHeader;
+    const bool valid = header.magic == kMagic && header.version == kVersion &&
+                       fits(header.moviesOffset, header.movieCount, sizeof(MovieRecord), mSize) &&
+                       fits(header.theatersOffset, header.theaterCount, sizeof(TheaterRecord), mSize) &&
+                       fits(header.seatsOffset, header.seatCount, sizeof(SeatRecord), mSize) &&
+                       fits(header.allocationsOffset, header.allocationCount, sizeof(AllocationRecord), mSize) &&
+                       fits(header.stringsOffset, header.stringsSize, 1, mSize);
+    if (!valid || !validRecords())
+    {
+        ::munmap(mapping, mSize);
+        throw std::runtime_error("Invalid catalog image: " + path);
+    }
+}
+
+/*----------------------------------------------------*/
+bool CatalogImage::validString(const StringRef& ref) const
+{
+    return ref.offset <= mHeader->stringsSize && ref.length <= mHeader->stringsSize - ref.offset;
+}
+
+/*----------------------------------------------------*/
+bool CatalogImage::validRecords() const
+{
+    // Checked once here, so the accessors read records without bounds checks
+    const MovieRecord* movies = table<MovieRecord>(mHeader->moviesOffset);
+    for (std::size_t i = 0; i < mHeader->movieCount; ++i)
+    {
+        if (!validString(movies[i].name))
+            return false;
+    }
+    const TheaterRecord* theaters = table<TheaterRecord>(mHeader->theatersOffset);
+    for (std::size_t i = 0; i < mHeader->theaterCount; ++i)
+    {
+        const TheaterRecord& record = theaters[i];
+        if (!validString(record.name) || record.firstSeat > mHeader->seatCount ||
+            record.seatCount > mHeader->seatCount - record.firstSeat)
+            return false;
+    }
+    const SeatRecord* seats = table<SeatRecord>(mHeader->seatsOffset);
+    for (std::size_t i = 0; i < mHeader->seatCount; ++i)
+    {
+        if (!validString(seats[i].seatNumber))
+            return false;
+    }
+    return true;
+}
+
+/*----------------------------------------------------*/
+CatalogImage::~CatalogImage()
+{
+    ::munmap(const_cast<char*>(mData), mSize);
+}
+
+/*----------------------------------------------------*/
+std::size_t CatalogImage::movieCount() const
+{
+    return mHeader->movieCount;
+}
+
+/*----------------------------------------------------*/
+CatalogImage::MovieView CatalogImage::movie(std::size_t index) const
+{
+    const MovieRecord& record = table<MovieRecord>(mHeader->moviesOffset)[index];
+    return MovieView{record.id, string(record.name)};
+}
+
+/*----------------------------------------------------*/
+std::size_t CatalogImage::theaterCount() const
+{
+    return mHeader->theaterCount;
+}
+
+/*----------------------------------------------------*/
+CatalogImage::TheaterView CatalogImage::theater(std::size_t index) const
+{
+    const TheaterRecord& record = table<TheaterRecord>(mHeader->theatersOffset)[index];
+    return TheaterView{record.id, string(record.name),
+                       table<SeatRecord>(mHeader->seatsOffset) + record.firstSeat, record.seatCount};
+}
+
+/*----------------------------------------------------*/
+std::size_t CatalogImage::allocationCount() const
+{
+    return mHeader->allocationCount;
+}
+
+/*----------------------------------------------------*/
+const AllocationRecord& CatalogImage::allocation(std::size_t index) const
+{
+    return table<AllocationRecord>(mHeader->allocationsOffset)[index];
+}
+
+/*----------------------------------------------------*/
+std::string_view CatalogImage::string(const StringRef& ref) const
+{
+    return std::string_view(mData + mHeader->stringsOffset + ref.offset, ref.length);
+}
+
+/*----------------------------------------------------*/
+std::vector<Seat> CatalogImage::seats(const TheaterView& theater) const
+{
+    std::vector<Seat> seats(theater.seatCount);
+    for (std::size_t i = 0; i < theater.seatCount; ++i)
+    {
+        seats[i].id = theater.seats[i].id;
+        seats[i].seatNumber = std::string(string(theater.seats[i].seatNumber));
+        seats[i].isBooked = theater.seats[i].isBooked != 0;
+        seats[i].section = theater.seats[i].section;
+        seats[i].row = theater.seats[i].row;
+        seats[i].position = theater.seats[i].position;
+    }
+    return seats;
+}
+
+/*----------------------------------------------------*/
+void CatalogImageWriter::addMovie(int id, const std::string& name)
+{
+    mMovies.push_back(MovieRecord{id, intern(name)});
+}
+
+/*----------------------------------------------------*/
+void CatalogImageWriter::addTheater(int id, const std::string& name, const std::vector<Seat>& seats)
+{
+    std::vector<SeatRecord> layout;
+    std::vector<std::uint32_t> key;
+    layout.reserve(seats.size());
+    key.reserve(seats.size() * 7);
+    for (const auto& seat : seats)
+    {
+        const SeatRecord record{seat.id, intern(seat.seatNumber), seat.isBooked ? 1u : 0u,
+                                seat.section, seat.row, seat.position};
+        layout.push_back(record);
+        key.insert(key.end(), {static_cast<std::uint32_t>(record.id), record.seatNumber.offset,
+                               record.seatNumber.length, record.isBooked, static_cast<std::uint32_t>(record.section),
+                               static_cast<std::uint32_t>(record.row), static_cast<std::uint32_t>(record.position)});
+    }
+
+    // Theaters with identical seats share one layout
+    auto [itr, added] = mLayoutIndex.emplace(std::move(key), static_cast<std::uint32_t>(mSeats.size()));
+    if (added)
+        mSeats.insert(mSeats.end(), layout.begin(), layout.end());
+
+    mTheaters.push_back(TheaterRecord{id, intern(name), itr->second, static_cast<std::uint32_t>(seats.size())});
+}
+
+/*----------------------------------------------------*/
+void CatalogImageWriter::addAllocation(int movieId, int theaterId)
+{
+    mAllocations.push_back(AllocationRecord{movieId, theaterId});
+}
+
+/*----------------------------------------------------*/
+StringRef CatalogImageWriter::intern(const std::string& value)
+{
+    auto [itr, added] = mStringIndex.emplace(value, StringRef{static_cast<std::uint32_t>(mStrings.size()),
+                                                              static_cast<std::uint32_t>(value.size())});
+    if (added)
+        mStrings.append(value);
+    return itr->second;
+}
+
+/*----------------------------------------------------*/
+void CatalogImageWriter::write(const std::string& path) const
+{
+    Header header{};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.movieCount = static_cast<std::uint32_t>(mMovies.size());
+    header.theaterCount = static_cast<std::uint32_t>(mTheaters.size());
+    header.seatCount = static_cast<std::uint32_t>(mSeats.size());
+    header.allocationCount = static_cast<std::uint32_t>(mAllocations.size());
+
+    std::string buffer(sizeof(Header), '\0');
+    header.moviesOffset = appendTable(buffer, mMovies);
+    header.theatersOffset = appendTable(buffer, mTheaters);
+    header.seatsOffset = appendTable(buffer, mSeats);
+    header.allocationsOffset = appendTable(buffer, mAllocations);
+    header.stringsOffset = appendTable(buffer, std::vector<char>(mStrings.begin(), mStrings.end()));
+    header.stringsSize = mStrings.size();
+    std::memcpy(&buffer[0], &header, sizeof(Header));
+
+    // Write aside and rename, so an open image is never seen half written
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!file.flush())
+            throw std::runtime_error("Failed to write catalog image: " + temporaryPath);
+    }
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        throw std::system_error(errno, std::generic_category(), "rename " + temporaryPath);
+}
+/*-------------------END-------------------------------*/
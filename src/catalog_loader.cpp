@@ -0,0 +1,175 @@
+/**
+ * @file catalog_loader.cpp
+ * @brief Implementation for CatalogLoader class
+ * @author Gebremedhin Abreha
+ */
+
+#include "catalog_loader.hpp"
+#include "movie_booking_service.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * @brief Split a line at commas.
+ */
+void split(const std::string& line, std::vector<std::string>& fields)
+{
+    fields.clear();
+    std::size_t start = 0;
+    while (true)
+    {
+        const auto comma = line.find(',', start);
+        fields.push_back(line.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+        if (comma == std::string::npos)
+            break;
+        start = comma + 1;
+    }
+}
+
+/**
+ * @brief Parse a whole field as an integer.
+ */
+int toInt(const std::string& field, std::size_t lineNumber)
+{
+    std::size_t end = 0;
+    int value = 0;
+    try
+    {
+        value = std::stoi(field, &end);
+    }
+    catch (const std::logic_error&)
+    {
+        end = 0;
+    }
+    if (end == 0 || end != field.size())
+        throw std::invalid_argument("Catalog line " + std::to_string(lineNumber) + ": invalid number '" + field + "'");
+    return value;
+}
+
+/**
+ * @brief Seats of a named layout, and the SeatLayout built from them once used.
+ */
+struct ParsedLayout {
+    std::vector<Seat> seats;                  /**< Seats in layout order. */
+    std::shared_ptr<const SeatLayout> layout; /**< Built for the first theater; reset when seats change. */
+};
+
+/**
+ * @brief Parse a catalog, passing each theater its parsed layout.
+ */
+template <typename OnTheater>
+std::size_t parseLines(std::istream& input, const CatalogLoader::MovieSink& onMovie, OnTheater&& onTheater)
+{
+    std::unordered_map<std::string, ParsedLayout> layouts;
+    std::vector<std::string> fields;
+    std::string line;
+    std::size_t lineNumber = 0;
+    std::size_t count = 0;
+
+    const auto fail = [&lineNumber](const std::string& message) {
+        throw std::invalid_argument("Catalog line " + std::to_string(lineNumber) + ": " + message);
+    };
+
+    while (std::getline(input, line))
+    {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        split(line, fields);
+        const std::string& kind = fields[0];
+
+        if (kind == "movie" && fields.size() == 3)
+        {
+            onMovie(toInt(fields[1], lineNumber), fields[2]);
+            ++count;
+        }
+        else if (kind == "theater" && fields.size() == 4)
+        {
+            auto layout = layouts.find(fields[3]);
+            if (layout == layouts.end())
+                fail("unknown layout '" + fields[3] + "'");
+            onTheater(toInt(fields[1], lineNumber), fields[2], layout->second);
+            ++count;
+        }
+        else if (kind == "layout" && (fields.size() == 3 || fields.size() == 4))
+        {
+            const int seatCount = toInt(fields[2], lineNumber);
+            if (seatCount < 0)
+                fail("negative seat count");
+            const int seatsPerRow = fields.size() == 4 ? toInt(fields[3], lineNumber) : 0;
+            if (seatsPerRow < 0)
+                fail("negative row size");
+            auto& parsed = layouts[fields[1]];
+            parsed.layout.reset();
+            parsed.seats = numberedSeats(seatCount, seatsPerRow);
+        }
+        else if (kind == "seat" && (fields.size() == 4 || fields.size() == 7))
+        {
+            Seat seat{toInt(fields[2], lineNumber), fields[3], false};
+            if (fields.size() == 7)
+            {
+                seat.section = toInt(fields[4], lineNumber);
+                seat.row = toInt(fields[5], lineNumber);
+                seat.position = toInt(fields[6], lineNumber);
+                if (seat.row < 0)
+                    fail("negative row");
+            }
+            auto& parsed = layouts[fields[1]];
+            parsed.layout.reset();
+            parsed.seats.push_back(seat);
+        }
+        else
+        {
+            fail("unrecognized entry '" + line + "'");
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+std::size_t CatalogLoader::parse(std::istream& input, const MovieSink& onMovie, const TheaterSink& onTheater)
+{
+    return parseLines(input, onMovie, [&onTheater](int id, const std::string& name, ParsedLayout& parsed) {
+        onTheater(id, name, parsed.seats);
+    });
+}
+
+/*----------------------------------------------------*/
+std::size_t CatalogLoader::parse(std::istream& input, const MovieSink& onMovie, const LayoutTheaterSink& onTheater)
+{
+    return parseLines(input, onMovie, [&onTheater](int id, const std::string& name, ParsedLayout& parsed) {
+        // Theaters of one layout share a single SeatLayout
+        if (!parsed.layout)
+            parsed.layout = std::make_shared<const SeatLayout>(parsed.seats);
+        onTheater(id, name, parsed.layout);
+    });
+}
+
+/*----------------------------------------------------*/
+std::size_t CatalogLoader::load(std::istream& input, MovieBookingService& service)
+{
+    std::vector<std::unique_ptr<Movie>> movies;
+    std::vector<std::unique_ptr<TheaterBase>> theaters;
+
+    parse(input,
+          [&movies](int id, const std::string& name) {
+              movies.push_back(std::make_unique<Movie>(id, name));
+          },
+          LayoutTheaterSink([&theaters](int id, const std::string& name, const std::shared_ptr<const SeatLayout>& layout) {
+              theaters.push_back(std::make_unique<Theater>(id, name, layout));
+          }));
+
+    // Movies first, so the theater batch allocates them all in one pass
+    const std::size_t added = service.addMovies(std::move(movies));
+    return added + service.addTheaters(std::move(theaters));
+}
+/*-------------------END-------------------------------*/
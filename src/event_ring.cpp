@@ -0,0 +1,158 @@
+/**
+ * @file event_ring.cpp
+ * @brief Implementation for EventRing and EventSubscription classes
+ * @author Gebremedhin Abreha
+ */
+
+#include "event_ring.hpp"
+
+#include <algorithm>
+#include <thread>
+
+/*----------------------------------------------------*/
+EventRing::EventRing(std::size_t capacity):
+mMask([capacity]() {
+    std::size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+    return size - 1;
+}()),
+mSlots(std::make_unique<Slot[]>(mMask + 1))
+{
+}
+
+/*----------------------------------------------------*/
+std::uint64_t EventRing::claim(std::size_t count)
+{
+    return mNext.fetch_add(count, std::memory_order_relaxed);
+}
+
+/*----------------------------------------------------*/
+void EventRing::commit(const ServiceEvent& event)
+{
+    Slot& slot = mSlots[event.sequence & mMask];
+
+    // The slot's previous lap must be complete before it is overwritten
+    const std::uint64_t previous = event.sequence > mMask ? committed(event.sequence - mMask - 1) : 0;
+    while (slot.state.load(std::memory_order_acquire) != previous)
+    {
+        std::this_thread::yield();
+    }
+
+    slot.state.store(committed(event.sequence) - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.type.store(event.type, std::memory_order_relaxed);
+    slot.theaterId.store(event.theaterId, std::memory_order_relaxed);
+    slot.showId.store(event.showId, std::memory_order_relaxed);
+    slot.movieId.store(event.movieId, std::memory_order_relaxed);
+    slot.seatId.store(event.seatId, std::memory_order_relaxed);
+    slot.state.store(committed(event.sequence), std::memory_order_release);
+}
+
+/*----------------------------------------------------*/
+std::uint64_t EventRing::publish(EventType type, int theaterId, int showId, int movieId, int seatId)
+{
+    const std::uint64_t sequence = claim();
+    commit(ServiceEvent{sequence, type, theaterId, showId, movieId, seatId});
+    return sequence;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t EventRing::nextSequence() const
+{
+    return mNext.load(std::memory_order_acquire);
+}
+
+/*----------------------------------------------------*/
+void EventRing::waitCommitted(std::uint64_t sequence) const
+{
+    // Older sequences share slots with these and were committed first
+    const std::uint64_t first = sequence > mMask ? sequence - mMask - 1 : 0;
+    for (std::uint64_t pending = first; pending < sequence; ++pending)
+    {
+        const Slot& slot = mSlots[pending & mMask];
+        while (slot.state.load(std::memory_order_acquire) < committed(pending))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/*----------------------------------------------------*/
+std::size_t EventRing::capacity() const
+{
+    return mMask + 1;
+}
+
+/*----------------------------------------------------*/
+EventRing::ReadStatus EventRing::read(std::uint64_t& position, std::vector<ServiceEvent>& events,
+                                      std::size_t maxEvents) const
+{
+    const std::size_t first = events.size();
+    std::uint64_t sequence = position;
+    for (; sequence - position < maxEvents; ++sequence)
+    {
+        const Slot& slot = mSlots[sequence & mMask];
+        const std::uint64_t state = slot.state.load(std::memory_order_acquire);
+        if (state < committed(sequence))
+            break; // Not committed yet: stop here to keep the order
+        if (state == committed(sequence))
+        {
+            ServiceEvent event;
+            event.sequence = sequence;
+            event.type = slot.type.load(std::memory_order_relaxed);
+            event.theaterId = slot.theaterId.load(std::memory_order_relaxed);
+            event.showId = slot.showId.load(std::memory_order_relaxed);
+            event.movieId = slot.movieId.load(std::memory_order_relaxed);
+            event.seatId = slot.seatId.load(std::memory_order_relaxed);
+
+            // Unchanged state after the copy: no producer wrote the fields meanwhile
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.state.load(std::memory_order_relaxed) == state)
+            {
+                events.push_back(event);
+                continue;
+            }
+        }
+
+        // A later lap took the slot
+        events.resize(first);
+        return ReadStatus::Lapped;
+    }
+    position = sequence;
+    return ReadStatus::Ok;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t EventRing::committed(std::uint64_t sequence)
+{
+    return 2 * sequence + 2;
+}
+
+/*----------------------------------------------------*/
+EventSubscription::EventSubscription(const EventRing& ring, std::uint64_t position):
+mRing(&ring),
+mPosition(position)
+{
+}
+
+/*----------------------------------------------------*/
+EventRing::ReadStatus EventSubscription::poll(std::vector<ServiceEvent>& events, std::size_t maxEvents)
+{
+    return mRing->read(mPosition, events, maxEvents);
+}
+
+/*----------------------------------------------------*/
+std::uint64_t EventSubscription::resync()
+{
+    mPosition = mRing->nextSequence();
+    mRing->waitCommitted(mPosition);
+    return mPosition;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t EventSubscription::position() const
+{
+    return mPosition;
+}
+/*-------------------END-------------------------------*/
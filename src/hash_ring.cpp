@@ -0,0 +1,54 @@
+/**
+ * @file hash_ring.cpp
+ * @brief Implementation for HashRing class
+ * @author Gebremedhin Abreha
+ */
+
+#include "hash_ring.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+/*----------------------------------------------------*/
+HashRing::HashRing(std::size_t shardCount, std::size_t virtualNodes):
+mShardCount(shardCount)
+{
+    if (shardCount == 0 || virtualNodes == 0)
+        throw std::invalid_argument("A hash ring needs shards and points");
+
+    mPoints.reserve(shardCount * virtualNodes);
+    for (std::size_t shard = 0; shard < shardCount; ++shard)
+    {
+        for (std::size_t point = 0; point < virtualNodes; ++point)
+        {
+            mPoints.emplace_back(hash((static_cast<std::uint64_t>(shard) << 32) | point), shard);
+        }
+    }
+    std::sort(mPoints.begin(), mPoints.end());
+}
+
+/*----------------------------------------------------*/
+std::size_t HashRing::shardOf(int key) const
+{
+    const std::uint64_t position = hash(~static_cast<std::uint64_t>(static_cast<std::uint32_t>(key)));
+    auto itr = std::lower_bound(mPoints.begin(), mPoints.end(), std::make_pair(position, std::size_t{0}));
+    if (itr == mPoints.end())
+        itr = mPoints.begin(); // Wrap around the ring
+    return itr->second;
+}
+
+/*----------------------------------------------------*/
+std::size_t HashRing::shardCount() const
+{
+    return mShardCount;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t HashRing::hash(std::uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+/*-------------------END-------------------------------*/
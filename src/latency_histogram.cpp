@@ -0,0 +1,140 @@
+/**
+ * @file latency_histogram.cpp
+ * @brief Implementation for LatencyHistogram class
+ * @author Gebremedhin Abreha
+ */
+
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/*----------------------------------------------------*/
+std::size_t LatencyHistogram::bucketOf(std::uint64_t value)
+{
+    if (value < kSubBuckets)
+        return static_cast<std::size_t>(value);
+
+    // Bucket group g covers [2^(g+3), 2^(g+4)) for g >= 1 and is split by
+    // the kSubBucketBits bits below the leading one
+    const std::size_t msb = 63 - static_cast<std::size_t>(__builtin_clzll(value));
+    const std::size_t shift = msb - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + static_cast<std::size_t>((value >> shift) & (kSubBuckets - 1));
+}
+
+/*----------------------------------------------------*/
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t bucket)
+{
+    if (bucket < kSubBuckets)
+        return bucket;
+
+    const std::size_t shift = bucket / kSubBuckets - 1;
+    const std::uint64_t lower = (kSubBuckets + bucket % kSubBuckets) << shift;
+    return lower + ((std::uint64_t{1} << shift) - 1);
+}
+
+/*----------------------------------------------------*/
+void LatencyHistogram::record(std::uint64_t value)
+{
+    ++mBuckets[bucketOf(value)];
+    ++mCount;
+    mSum += value;
+    mMin = std::min(mMin, value);
+    mMax = std::max(mMax, value);
+}
+
+/*----------------------------------------------------*/
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (std::size_t i = 0; i < kBuckets; ++i)
+    {
+        mBuckets[i] += other.mBuckets[i];
+    }
+    mCount += other.mCount;
+    mSum += other.mSum;
+    mMin = std::min(mMin, other.mMin);
+    mMax = std::max(mMax, other.mMax);
+}
+
+/*----------------------------------------------------*/
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram();
+}
+
+/*----------------------------------------------------*/
+std::uint64_t LatencyHistogram::count() const
+{
+    return mCount;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t LatencyHistogram::min() const
+{
+    return mCount == 0 ? 0 : mMin;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t LatencyHistogram::max() const
+{
+    return mMax;
+}
+
+/*----------------------------------------------------*/
+double LatencyHistogram::mean() const
+{
+    return mCount == 0 ? 0.0 : static_cast<double>(mSum) / static_cast<double>(mCount);
+}
+
+/*----------------------------------------------------*/
+std::uint64_t LatencyHistogram::percentile(double quantile) const
+{
+    if (mCount == 0)
+        return 0;
+
+    // Rank of the quantile among the recorded values, 1-based
+    const double clamped = std::min(std::max(quantile, 0.0), 1.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(mCount))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i)
+    {
+        seen += mBuckets[i];
+        if (seen >= rank)
+            return std::min(std::max(bucketUpperBound(i), mMin), mMax);
+    }
+    return mMax;
+}
+
+/*----------------------------------------------------*/
+void ConcurrentLatencyHistogram::record(std::uint64_t value)
+{
+    const std::size_t bucket = std::min(LatencyHistogram::bucketOf(value), kBuckets - 1);
+    mBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(value, std::memory_order_relaxed);
+
+    // Bounds move rarely once warmed up; only then is a CAS needed
+    std::uint64_t bound = mMin.load(std::memory_order_relaxed);
+    while (value < bound && !mMin.compare_exchange_weak(bound, value, std::memory_order_relaxed))
+    {
+    }
+    bound = mMax.load(std::memory_order_relaxed);
+    while (value > bound && !mMax.compare_exchange_weak(bound, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+/*----------------------------------------------------*/
+void ConcurrentLatencyHistogram::addTo(LatencyHistogram& histogram) const
+{
+    for (std::size_t i = 0; i < kBuckets; ++i)
+    {
+        histogram.mBuckets[i] += mBuckets[i].load(std::memory_order_relaxed);
+    }
+    histogram.mCount += mCount.load(std::memory_order_relaxed);
+    histogram.mSum += mSum.load(std::memory_order_relaxed);
+    histogram.mMin = std::min(histogram.mMin, mMin.load(std::memory_order_relaxed));
+    histogram.mMax = std::max(histogram.mMax, mMax.load(std::memory_order_relaxed));
+}
+/*-------------------END-------------------------------*/
@@ -5,216 +5,1792 @@
  */
 
 #include "movie_booking_service.hpp"
+#include "catalog_image.hpp"
 
 #include <iostream>
 #include <vector>
 #include <stdexcept>
 #include <algorithm>
+#include <numeric>
 #include <random>
 #include <ctime>
+#include <cstring>
+#include <map>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Operation tags of log records.
+ */
+enum class LogOperation : std::uint8_t {
+    AddMovie = 1,   /**< Movie ID and name. */
+    AddTheater = 2, /**< Theater ID, name and seats (no longer written). */
+    Allocate = 3,   /**< Movie ID and theater ID. */
+    BookSeats = 4,  /**< Theater ID and seat IDs. */
+    AddTheaterWithLayout = 5, /**< Theater ID, name and seats with their section, row and position. */
+    AddShow = 6,        /**< Show ID, theater ID, movie ID and start time. */
+    BookShowSeats = 7   /**< Show ID and seat IDs. */
+};
+
+/**
+ * @class LogRecordWriter
+ * @brief Encodes a log record as a sequence of operations.
+ *
+ * The operations of one record are applied together on recovery, so an
+ * addition and the allocation it caused are logged with a single append.
+ */
+class LogRecordWriter {
+public:
+    void addMovie(const Movie& movie)
+    {
+        put(LogOperation::AddMovie);
+        put<std::int32_t>(movie.id);
+        putString(movie.name);
+    }
+
+    void addTheater(const TheaterBase& theater)
+    {
+        const auto seats = theater.getSeats();
+        put(LogOperation::AddTheaterWithLayout);
+        put<std::int32_t>(theater.getId());
+        putString(theater.getNameView());
+        put<std::uint32_t>(static_cast<std::uint32_t>(seats.size()));
+        for (const auto& seat : seats)
+        {
+            put<std::int32_t>(seat.id);
+            putString(seat.seatNumber);
+            put<std::uint8_t>(seat.isBooked);
+            put<std::int32_t>(seat.section);
+            put<std::int32_t>(seat.row);
+            put<std::int32_t>(seat.position);
+        }
+    }
+
+    void allocate(int movieId, int theaterId)
+    {
+        put(LogOperation::Allocate);
+        put<std::int32_t>(movieId);
+        put<std::int32_t>(theaterId);
+    }
+
+    void bookSeats(int theaterId, const std::vector<int>& seatIds)
+    {
+        put(LogOperation::BookSeats);
+        put<std::int32_t>(theaterId);
+        put<std::uint32_t>(static_cast<std::uint32_t>(seatIds.size()));
+        for (const auto seatId : seatIds)
+        {
+            put<std::int32_t>(seatId);
+        }
+    }
+
+    void addShow(const ShowInfo& show)
+    {
+        put(LogOperation::AddShow);
+        put<std::int32_t>(show.id);
+        put<std::int32_t>(show.theaterId);
+        put<std::int32_t>(show.movieId);
+        put<std::int64_t>(show.startTime);
+    }
+
+    void bookShowSeats(int showId, const std::vector<int>& seatIds)
+    {
+        put(LogOperation::BookShowSeats);
+        put<std::int32_t>(showId);
+        put<std::uint32_t>(static_cast<std::uint32_t>(seatIds.size()));
+        for (const auto seatId : seatIds)
+        {
+            put<std::int32_t>(seatId);
+        }
+    }
+
+    const std::string& data() const { return mData; }
+
+private:
+    template <typename T>
+    void put(T value)
+    {
+        mData.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(std::string_view value)
+    {
+        put<std::uint32_t>(static_cast<std::uint32_t>(value.size()));
+        mData.append(value);
+    }
+
+    std::string mData;
+};
+
+/**
+ * @class LogRecordReader
+ * @brief Decodes the fields of a log record written by LogRecordWriter.
+ *
+ * @note Can throw runtime_error exception on a malformed record
+ */
+class LogRecordReader {
+public:
+    explicit LogRecordReader(const std::string& data) : mData(data), mOffset(0) { }
+
+    bool atEnd() const { return mOffset == mData.size(); }
+
+    template <typename T>
+    T get()
+    {
+        if (mData.size() - mOffset < sizeof(T))
+            throw std::runtime_error("Truncated log record");
+        T value;
+        std::memcpy(&value, mData.data() + mOffset, sizeof(T));
+        mOffset += sizeof(T);
+        return value;
+    }
+
+    std::string getString()
+    {
+        const std::size_t size = get<std::uint32_t>();
+        if (mData.size() - mOffset < size)
+            throw std::runtime_error("Truncated log record");
+        std::string value = mData.substr(mOffset, size);
+        mOffset += size;
+        return value;
+    }
+
+private:
+    const std::string& mData;
+    std::size_t mOffset;
+};
+
+/**
+ * @brief The requested seats that are not free, repeated or unknown, in request order.
+ */
+std::vector<int> unavailableSeats(const TheaterBase& theater, const std::vector<int>& seatIds)
+{
+    std::vector<int> unavailable;
+    for (std::size_t i = 0; i < seatIds.size(); ++i)
+    {
+        const bool repeated = std::find(seatIds.begin(), seatIds.begin() + i, seatIds[i]) != seatIds.begin() + i;
+        if (repeated || theater.getSeatState(seatIds[i]) != SeatState::Free)
+            unavailable.push_back(seatIds[i]);
+    }
+    return unavailable;
+}
+
+/**
+ * @brief Replay a BookSeats operation.
+ *
+ * Seats are booked one by one: a snapshot read live may already hold some
+ * of them, and either way every seat ends booked.
+ */
+void replayBookSeats(const IdTable<std::shared_ptr<TheaterBase>>& theaters, LogRecordReader& reader)
+{
+    const int theaterId = reader.get<std::int32_t>();
+    std::vector<int> seatIds(reader.get<std::uint32_t>());
+    for (auto& seatId : seatIds)
+    {
+        seatId = reader.get<std::int32_t>();
+    }
+    if (const auto* theater = theaters.find(theaterId))
+    {
+        for (const auto seatId : seatIds)
+            (*theater)->bookSeat(seatId);
+    }
+}
+
+/**
+ * @brief Replay a BookShowSeats operation, seat by seat like replayBookSeats.
+ */
+void replayBookShowSeats(const IdTable<std::shared_ptr<Show>>& shows, LogRecordReader& reader)
+{
+    const int showId = reader.get<std::int32_t>();
+    std::vector<int> seatIds(reader.get<std::uint32_t>());
+    for (auto& seatId : seatIds)
+    {
+        seatId = reader.get<std::int32_t>();
+    }
+    if (const auto* show = shows.find(showId))
+    {
+        for (const auto seatId : seatIds)
+            (*show)->getSeats().bookSeat(seatId);
+    }
+}
+
+/**
+ * @brief Check if a record holds bookings only, which every record starting with one does.
+ */
+bool isBookingRecord(const std::string& record)
+{
+    const auto operation = record.empty() ? LogOperation{} : static_cast<LogOperation>(record[0]);
+    return operation == LogOperation::BookSeats || operation == LogOperation::BookShowSeats;
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+MovieBookingService::MovieBookingService(const std::string& logPath, std::size_t checkpointInterval):
+mLog(std::make_unique<WriteAheadLog>(logPath)),
+mCheckpointPath(logPath + ".checkpoint"),
+mCheckpointInterval(checkpointInterval)
+{
+    // Rebuild the state from the checkpoint plus the log, then publish once
+    auto recovered = std::make_shared<Catalog>();
+    std::vector<std::pair<int, int>> allocated;
+    const auto replay = [&recovered, &allocated](const std::string& record) {
+        replayRecord(*recovered, record, allocated);
+    };
+    WriteAheadLog::readRecords(mCheckpointPath, replay);
+    mRecordsSinceCheckpoint = mLog->recover(replay);
+    publish(recovered);
+    recovered->markAllocated(allocated);
+
+    // A checkpoint was interrupted: fold the log it moved aside into a new one
+    if (mLog->hasRotated())
+    {
+        const auto checkpointLock = mMetrics.acquire(mCheckpointMutex, ServiceMetrics::Lock::Checkpoint);
+        const auto writerLock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+        writeCheckpoint();
+        mLog->removeRotated();
+    }
+}
 
 /*----------------------------------------------------*/
 bool MovieBookingService::addMovie( std::unique_ptr<Movie> movie) {
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::AddMovie);
     bool result = false;
     if (!movie) {
+        call.fail();
         return false;
     }
-        
-    if (const auto& [itr, done] = mMovies.insert({movie->id, std::move(movie)}); done)
+
     {
-        result = done;
-        allocateMovieToTheaters(itr->second->id);
+        const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+        auto draft = std::make_shared<Catalog>(*catalog());
+
+        std::shared_ptr<Movie> added(std::move(movie));
+        if (draft->addMovie(added))
+        {
+            result = true;
+            const auto allocations = draft->planAllocations(nullptr);
+
+            if (logsChanges())
+            {
+                LogRecordWriter record;
+                record.addMovie(*added);
+                for (const auto& [movieId, theaterId] : allocations)
+                    record.allocate(movieId, theaterId);
+                logRecord(record.data());
+            }
+            publish(draft);
+            draft->markAllocated(allocations);
+            publishCatalogEvents(EventType::MovieAdded, {added->id}, allocations);
+        }
     }
-    return result;
+    checkpointIfDue();
+    return call.succeeded(result);
 }
 
 /*----------------------------------------------------*/
-bool MovieBookingService::addTheater( std::unique_ptr<Theater> theater) {
-    
+bool MovieBookingService::addTheater( std::unique_ptr<TheaterBase> theater) {
+
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::AddTheater);
     bool result = false;
     if (!theater) {
+        call.fail();
         return result;
     }
     int theaterId = theater->getId();
-    
-    if (const auto& [itr, done] = mTheaters.insert({theaterId, std::move(theater)}); done)
+
+    auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+    auto draft = std::make_shared<Catalog>(*catalog());
+
+    std::shared_ptr<TheaterBase> added(std::move(theater));
+    if (draft->addTheater(theaterId, added))
+    {
+        result = true;
+
+        // Waiting movies take the theater first; if there are none it shows a random movie
+        const auto allocations = draft->planAllocations(&mRandom);
+
+        if (logsChanges())
+        {
+            LogRecordWriter record;
+            record.addTheater(*added);
+            for (const auto& [movieId, allocatedTheaterId] : allocations)
+                record.allocate(movieId, allocatedTheaterId);
+            logRecord(record.data());
+        }
+        publish(draft);
+        draft->markAllocated(allocations);
+        publishCatalogEvents(EventType::TheaterAdded, {theaterId}, allocations);
+    }
+    lock.unlock();
+
+    checkpointIfDue();
+    return call.succeeded(result);
+}
+
+
+/*----------------------------------------------------*/
+std::size_t MovieBookingService::addMovies(std::vector<std::unique_ptr<Movie>> movies)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::AddMovies);
+    std::size_t added = 0;
     {
-        result = done;
-        
-        bool isMovieAllocated = false;
-        
-        for (const auto& [movieId, movie] : mMovies)
+        const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+        auto draft = std::make_shared<Catalog>(*catalog());
+        LogRecordWriter record;
+        std::vector<int> addedIds;
+
+        for (auto& movie : movies)
         {
-            if (!movie->isAllocated)
+            if (!movie) {
+                continue;
+            }
+            std::shared_ptr<Movie> candidate(std::move(movie));
+            if (draft->addMovie(candidate))
             {
-                if (allocateMovieToTheaters(movieId))
-                {
-                    isMovieAllocated = true;
-                }
+                ++added;
+                addedIds.push_back(candidate->id);
+                if (logsChanges())
+                    record.addMovie(*candidate);
             }
         }
-        // If all movies are already allocated, randomly pick one movie
-        if (!isMovieAllocated && !mMovies.empty())
+        if (added == 0) {
+            call.fail();
+            return 0;
+        }
+
+        const auto allocations = draft->planAllocations(nullptr);
+        for (const auto& [movieId, theaterId] : allocations)
+        {
+            if (logsChanges())
+                record.allocate(movieId, theaterId);
+        }
+
+        if (logsChanges())
+            logRecord(record.data());
+        publish(draft);
+        draft->markAllocated(allocations);
+        publishCatalogEvents(EventType::MovieAdded, addedIds, allocations);
+    }
+    checkpointIfDue();
+    return added;
+}
+
+/*----------------------------------------------------*/
+std::size_t MovieBookingService::addTheaters(std::vector<std::unique_ptr<TheaterBase>> theaters)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::AddTheaters);
+    std::size_t added = 0;
+    {
+        const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+        auto draft = std::make_shared<Catalog>(*catalog());
+        LogRecordWriter record;
+        std::vector<int> addedIds;
+
+        for (auto& theater : theaters)
         {
-            std::random_device rd;
-            //std::mt19937 gen(std::time(nullptr));
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<int> dist(1, mMovies.size());
-            int randomId = dist(gen);
-            
-            if (isValidMovie(randomId))
+            if (!theater) {
+                continue;
+            }
+            const int theaterId = theater->getId();
+            std::shared_ptr<TheaterBase> candidate(std::move(theater));
+            if (draft->addTheater(theaterId, candidate))
             {
-                // Allocate the randomly picked movie to the new theater
-                isMovieAllocated = allocateMovieToTheaters(randomId);
+                ++added;
+                addedIds.push_back(theaterId);
+                if (logsChanges())
+                    record.addTheater(*candidate);
             }
-            else
+        }
+        if (added == 0) {
+            call.fail();
+            return 0;
+        }
+
+        const auto allocations = draft->planAllocations(&mRandom);
+        for (const auto& [movieId, theaterId] : allocations)
+        {
+            if (logsChanges())
+                record.allocate(movieId, theaterId);
+        }
+
+        if (logsChanges())
+            logRecord(record.data());
+        publish(draft);
+        draft->markAllocated(allocations);
+        publishCatalogEvents(EventType::TheaterAdded, addedIds, allocations);
+    }
+    checkpointIfDue();
+    return added;
+}
+
+/*----------------------------------------------------*/
+bool MovieBookingService::loadCatalogImage(const std::string& path)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::LoadCatalogImage);
+    std::unique_ptr<CatalogImage> image;
+    try
+    {
+        image = std::make_unique<CatalogImage>(path);
+    }
+    catch (const std::runtime_error&)
+    {
+        call.fail();
+        return false;
+    }
+
+    {
+        const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+        auto draft = std::make_shared<Catalog>(*catalog());
+        LogRecordWriter record;
+        std::vector<int> movieIds;
+        std::vector<int> theaterIds;
+        std::vector<std::pair<int, int>> allocations;
+
+        for (std::size_t i = 0; i < image->movieCount(); ++i)
+        {
+            const auto movie = image->movie(i);
+            auto added = std::make_shared<Movie>(movie.id, movie.name);
+            if (draft->addMovie(added))
+            {
+                movieIds.push_back(movie.id);
+                if (logsChanges())
+                    record.addMovie(*added);
+            }
+        }
+        // Theaters sharing a seat range of the image share one layout
+        std::map<std::pair<const catalog_format::SeatRecord*, std::size_t>, std::shared_ptr<const SeatLayout>> layouts;
+        for (std::size_t i = 0; i < image->theaterCount(); ++i)
+        {
+            const auto theater = image->theater(i);
+            if (draft->hasTheater(theater.id))
+                continue;
+            auto& layout = layouts[{theater.seats, theater.seatCount}];
+            if (!layout)
+                layout = std::make_shared<const SeatLayout>(image->seats(theater));
+            auto added = std::make_shared<Theater>(theater.id, theater.name, layout);
+            for (std::size_t k = 0; k < theater.seatCount; ++k)
+            {
+                if (theater.seats[k].isBooked)
+                    added->bookSeat(theater.seats[k].id);
+            }
+            draft->addTheater(theater.id, added);
+            theaterIds.push_back(theater.id);
+            if (logsChanges())
+                record.addTheater(*added);
+        }
+        for (std::size_t i = 0; i < image->allocationCount(); ++i)
+        {
+            const auto& allocation = image->allocation(i);
+            if (draft->allocate(allocation.movieId, allocation.theaterId))
             {
-                throw std::invalid_argument("Movie with the specified random ID not found");
+                allocations.emplace_back(allocation.movieId, allocation.theaterId);
+                if (logsChanges())
+                    record.allocate(allocation.movieId, allocation.theaterId);
+            }
+        }
+
+        // The whole image is one log record and one snapshot
+        if (!record.data().empty())
+            logRecord(record.data());
+        publish(draft);
+        draft->markAllocated(allocations);
+        publishCatalogEvents(EventType::MovieAdded, movieIds, {});
+        publishCatalogEvents(EventType::TheaterAdded, theaterIds, allocations);
+    }
+    checkpointIfDue();
+    return true;
+}
 
+/*----------------------------------------------------*/
+bool MovieBookingService::addShow(const ShowInfo& show)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::AddShow);
+    bool result = false;
+    {
+        const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+        auto draft = std::make_shared<Catalog>(*catalog());
+
+        if (draft->addShow(show))
+        {
+            result = true;
+            if (logsChanges())
+            {
+                LogRecordWriter record;
+                record.addShow(show);
+                logRecord(record.data());
             }
-         }
+            publish(std::move(draft));
+            mEvents.publish(EventType::ShowAdded, show.theaterId, show.id, show.movieId, -1);
+        }
     }
-    return result;
+    checkpointIfDue();
+    return call.succeeded(result);
 }
 
+/*----------------------------------------------------*/
+std::size_t MovieBookingService::addShows(const std::vector<ShowInfo>& shows)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::AddShows);
+    std::size_t added = 0;
+    {
+        const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+        auto draft = std::make_shared<Catalog>(*catalog());
+        LogRecordWriter record;
+        std::vector<const ShowInfo*> addedShows;
+
+        for (const auto& show : shows)
+        {
+            if (draft->addShow(show))
+            {
+                ++added;
+                addedShows.push_back(&show);
+                if (logsChanges())
+                    record.addShow(show);
+            }
+        }
+        if (added == 0) {
+            call.fail();
+            return 0;
+        }
+
+        if (logsChanges())
+            logRecord(record.data());
+        publish(std::move(draft));
+        for (const auto* show : addedShows)
+        {
+            mEvents.publish(EventType::ShowAdded, show->theaterId, show->id, show->movieId, -1);
+        }
+    }
+    checkpointIfDue();
+    return added;
+}
 
 /*----------------------------------------------------*/
 std::vector<int> MovieBookingService::getAllMovies() const
 {
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetAllMovies);
     std::vector<int> movieIds;
-    
-    for (const auto& [id, movie]: mMovies)
-    {
-        movieIds.push_back(id);
-    }
+    const auto snapshot = catalog();
+
+    movieIds = snapshot->movies.ids();
     return movieIds;
 }
 
+/*----------------------------------------------------*/
+void MovieBookingService::getAllMovies(std::vector<int>& movieIds) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetAllMovies);
+    catalog()->movies.ids(movieIds);
+}
+
 /*----------------------------------------------------*/
 std::vector<int> MovieBookingService::getTheatersForMovie(int movieId) const
-{       
-    if (!isValidMovie(movieId))
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetTheatersForMovie);
+    const auto snapshot = catalog();
+
+    if (!snapshot->hasMovie(movieId))
     {
         throw std::invalid_argument("Movie with the specified ID not found");
     }
     // Get the list of theater IDs allocated to the movie
-    return mMovieTheaterAllocations.at(movieId);
+    return snapshot->allocations.getTheaters(movieId);
 }
 
 /*----------------------------------------------------*/
-std::vector<int> MovieBookingService::getAvailableSeats(int theaterId) const
+bool MovieBookingService::getTheatersForMovie(int movieId, std::vector<int>& theaterIds) const
 {
-    std::vector<int> availableSeats;
-    if (!isValidTheater(theaterId))
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetTheatersForMovie);
+    const auto snapshot = catalog();
+
+    theaterIds.clear();
+    if (!snapshot->hasMovie(movieId))
+    {
+        call.fail();
+        return false;
+    }
+    snapshot->allocations.appendTheaters(movieId, theaterIds);
+    return true;
+}
+
+/*----------------------------------------------------*/
+std::vector<ShowInfo> MovieBookingService::getShowsForMovie(int movieId) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetShowsForMovie);
+    const auto snapshot = catalog();
+
+    if (!snapshot->hasMovie(movieId))
     {
-        return availableSeats; // Return an empty vector for invalid theater or movie
+        throw std::invalid_argument("Movie with the specified ID not found");
     }
-    
-    if (auto itr = mTheaters.find(theaterId); itr != mTheaters.end())
+    if (const auto* showIds = snapshot->movieShows.find(movieId))
     {
-        availableSeats = itr->second->getAvailableSeats();
+        return snapshot->showInfos(*showIds);
     }
-
-    return availableSeats;
+    return {};
 }
 
-/*----------------------------------------------------------------------*/
-bool MovieBookingService::bookSeats(int theaterId, const std::vector<int>& seatIds)
+/*----------------------------------------------------*/
+std::vector<ShowInfo> MovieBookingService::getShowsForTheater(int theaterId) const
 {
-    if (!isValidTheater(theaterId) || seatIds.empty()) {
-        return false; 
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetShowsForTheater);
+    const auto snapshot = catalog();
+
+    if (!snapshot->hasTheater(theaterId))
+    {
+        throw std::invalid_argument("Theater with the specified ID not found");
     }
-    
-    std::lock_guard<std::mutex> lock(mBookingMutex);
-    
-    if (auto itr = mTheaters.find(theaterId); itr != mTheaters.end())
+    if (const auto* showIds = snapshot->theaterShows.find(theaterId))
     {
-        for (auto seatId : seatIds)
-        {
-            if (!itr->second->bookSeat(seatId)) return false;
-        }
+        return snapshot->showInfos(*showIds);
     }
-    
-    return true; // Seats booked successfully
+    return {};
 }
 
 /*----------------------------------------------------*/
-bool MovieBookingService::isValidMovie(int movieId) const
+std::vector<int> MovieBookingService::getAvailableSeats(int theaterId) const
 {
-    
-    if (mMovies.find(movieId) != mMovies.end())
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetAvailableSeats);
+    std::vector<int> availableSeats;
+    const auto snapshot = catalog();
+
+    if (const auto* theater = snapshot->theaters.find(theaterId))
     {
-        return true; 
+        availableSeats = (*theater)->getAvailableSeats();
     }
-    return false;
+    else
+    {
+        call.fail();
+    }
+
+    return availableSeats;
 }
 
 /*----------------------------------------------------*/
-bool MovieBookingService::isValidTheater(int theaterId) const
+bool MovieBookingService::getAvailableSeats(int theaterId, std::vector<int>& seatIds) const
 {
-    if (mTheaters.find(theaterId)!= mTheaters.end())
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetAvailableSeats);
+    const auto snapshot = catalog();
+
+    seatIds.clear();
+    if (const auto* theater = snapshot->theaters.find(theaterId))
     {
+        (*theater)->appendAvailableSeats(seatIds);
         return true;
     }
+    call.fail();
     return false;
 }
 
 /*----------------------------------------------------*/
-std::string MovieBookingService::getMovieName(int movieId) const
+std::size_t MovieBookingService::getAvailableSeatCount(int theaterId) const
 {
-    
-    if (auto itr = mMovies.find(movieId); itr != mMovies.end())
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetAvailableSeatCount);
+    if (const auto* theater = catalog()->theaters.find(theaterId))
     {
-        return itr->second->name; // Found a movie with the specified ID
+        return (*theater)->getAvailableSeatCount();
     }
-    throw std::invalid_argument("Movie with the specified ID not found");
+    call.fail();
+    return 0;
 }
 
 /*----------------------------------------------------*/
-std::string MovieBookingService::getTheaterName(int theaterId) const
+std::size_t MovieBookingService::getMovieAvailableSeatCount(int movieId) const
 {
-    if (auto itr = mTheaters.find(theaterId); itr != mTheaters.end())
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetMovieAvailableSeatCount);
+    if (const auto* counter = catalog()->movieAvailability.find(movieId))
     {
-        return itr->second->getName(); 
+        // Updates land just after the seats change and may briefly undershoot
+        return static_cast<std::size_t>(std::max<std::int64_t>(0, (*counter)->load(std::memory_order_relaxed)));
     }
-    throw std::invalid_argument("Theater with the specified ID not found");
+    call.fail();
+    return 0;
 }
 
 /*----------------------------------------------------*/
-bool MovieBookingService::allocateMovieToTheaters( int movieId)
+std::vector<int> MovieBookingService::getMoviesWithAvailability() const
 {
-    
-    std::lock_guard<std::mutex> lock(mBookingMutex);
+    std::vector<int> movieIds;
+    getMoviesWithAvailability(movieIds);
+    return movieIds;
+}
 
-    if (!isValidMovie(movieId)) {
-        return false;
-    }
+/*----------------------------------------------------*/
+void MovieBookingService::getMoviesWithAvailability(std::vector<int>& movieIds) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetMoviesWithAvailability);
+    const auto snapshot = catalog();
+
+    snapshot->movies.ids(movieIds);
+    movieIds.erase(std::remove_if(movieIds.begin(), movieIds.end(), [&snapshot](int movieId) {
+        return (*snapshot->movieAvailability.find(movieId))->load(std::memory_order_relaxed) <= 0;
+    }), movieIds.end());
+}
+
+/*----------------------------------------------------*/
+std::vector<int> MovieBookingService::findBestAvailable(int theaterId, int partySize) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::FindBestAvailable);
+    std::vector<int> seatIds;
+    const auto snapshot = catalog();
 
-    // Try to allocate the movie to an unallocated theater
-    for (auto& [id, theater] : mTheaters)
+    if (const auto* theater = snapshot->theaters.find(theaterId); theater != nullptr && partySize > 0)
     {
-        if (!theater->isAllocated())
-        {
-            theater->setAllocated(true);
-            mMovieTheaterAllocations[movieId].push_back(theater->getId());
-            mMovies.at(movieId)->isAllocated = true;
-            return true;
-        }
+        seatIds = (*theater)->findBestAvailable(static_cast<std::size_t>(partySize));
     }
-    return false;
-}
+    if (seatIds.empty())
+        call.fail();
 
+    return seatIds;
+}
 
-///*----------------------------------------------------*/
-bool MovieBookingService::isMovieShownInTheater(int theaterId, int movieId) const
+/*----------------------------------------------------*/
+std::vector<int> MovieBookingService::getAvailableShowSeats(int showId) const
 {
-    if (!isValidTheater(theaterId) || !isValidMovie(movieId))
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetAvailableShowSeats);
+    std::vector<int> availableSeats;
+    const auto snapshot = catalog();
+
+    if (const auto* show = snapshot->shows.find(showId))
     {
-        return false;
+        availableSeats = (*show)->getSeats().getAvailableSeats();
+    }
+    else
+    {
+        call.fail();
     }
-    const auto& allocatedTheaters = mMovieTheaterAllocations.at(movieId);
-    return std::find(allocatedTheaters.begin(), allocatedTheaters.end(), theaterId) != allocatedTheaters.end();
+
+    return availableSeats;
 }
 
-/*-------------------END---------------------------------*/
+/*----------------------------------------------------*/
+std::vector<int> MovieBookingService::findBestAvailableForShow(int showId, int partySize) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::FindBestAvailableForShow);
+    std::vector<int> seatIds;
+    const auto snapshot = catalog();
 
+    if (const auto* show = snapshot->shows.find(showId); show != nullptr && partySize > 0)
+    {
+        seatIds = (*show)->getSeats().findBestAvailable(static_cast<std::size_t>(partySize));
+    }
+    if (seatIds.empty())
+        call.fail();
+
+    return seatIds;
+}
+
+/*----------------------------------------------------*/
+std::optional<ShowInfo> MovieBookingService::findShow(int showId) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::FindShow);
+    if (const auto* show = catalog()->shows.find(showId))
+    {
+        return (*show)->getInfo();
+    }
+    call.fail();
+    return std::nullopt;
+}
+
+/*----------------------------------------------------------------------*/
+bool MovieBookingService::bookSeats(int theaterId, const std::vector<int>& seatIds)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::BookSeats);
+    if (seatIds.empty()) {
+        call.fail();
+        return false;
+    }
+
+    // Seats are claimed lock-free by the theater of the current snapshot
+    const auto snapshot = catalog();
+
+    const auto* theater = snapshot->theaters.find(theaterId);
+    if (theater == nullptr) {
+        call.fail();
+        return false;
+    }
+
+    expireHoldsIfDue();
+
+    if (!(*theater)->bookSeats(seatIds)) {
+        call.fail();
+        mMetrics.increment(ServiceMetrics::Counter::SeatConflicts);
+        return false; // No seat booked
+    }
+
+    if (logsChanges())
+    {
+        LogRecordWriter record;
+        record.bookSeats(theaterId, seatIds);
+        try
+        {
+            logRecord(record.data());
+        }
+        catch (...)
+        {
+            (*theater)->cancelSeats(seatIds); // Not durable, so not booked
+            throw;
+        }
+    }
+    commitSeatEvents(mEvents.claim(seatIds.size()), EventType::SeatBooked, theaterId, nullptr, seatIds);
+    if (logsChanges())
+        checkpointIfDue();
+    return true; // All seats booked
+}
+
+/*----------------------------------------------------------------------*/
+std::vector<MovieBookingService::BookingResult> MovieBookingService::bookBatch(const std::vector<BookingRequest>& requests)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::BookBatch);
+    std::vector<BookingResult> results(requests.size());
+
+    // Group the requests by theater, first come first served within a theater
+    std::vector<std::size_t> order(requests.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&requests](std::size_t lhs, std::size_t rhs) {
+        return requests[lhs].theaterId < requests[rhs].theaterId;
+    });
+
+    const auto snapshot = catalog();
+    expireHoldsIfDue();
+
+    LogRecordWriter record;
+    std::vector<std::pair<const TheaterBase*, std::size_t>> booked; // Theater and request of each booking
+    for (std::size_t first = 0; first < order.size();)
+    {
+        const int theaterId = requests[order[first]].theaterId;
+        const auto* theater = snapshot->theaters.find(theaterId);
+
+        std::size_t next = first;
+        for (; next < order.size() && requests[order[next]].theaterId == theaterId; ++next)
+        {
+            const auto& request = requests[order[next]];
+            auto& result = results[order[next]];
+            result.requestId = request.requestId;
+
+            if (theater == nullptr)
+            {
+                result.status = BookingStatus::UnknownTheater;
+            }
+            else if (request.seatIds.empty())
+            {
+                result.status = BookingStatus::NoSeats;
+            }
+            else if ((*theater)->bookSeats(request.seatIds))
+            {
+                result.status = BookingStatus::Booked;
+                booked.emplace_back(theater->get(), order[next]);
+                if (logsChanges())
+                    record.bookSeats(theaterId, request.seatIds);
+            }
+            else
+            {
+                result.status = BookingStatus::Conflict;
+                result.conflictingSeats = unavailableSeats(**theater, request.seatIds);
+                mMetrics.increment(ServiceMetrics::Counter::SeatConflicts);
+            }
+        }
+        first = next;
+    }
+
+    if (booked.empty())
+        call.fail();
+
+    // One log append, and so at most one sync, for the whole batch
+    if (logsChanges() && !booked.empty())
+    {
+        try
+        {
+            logRecord(record.data());
+        }
+        catch (...)
+        {
+            for (const auto& [theater, index] : booked)
+                const_cast<TheaterBase*>(theater)->cancelSeats(requests[index].seatIds); // Not durable, so not booked
+            throw;
+        }
+    }
+    for (const auto& [theater, index] : booked)
+    {
+        commitSeatEvents(mEvents.claim(requests[index].seatIds.size()), EventType::SeatBooked,
+                         requests[index].theaterId, nullptr, requests[index].seatIds);
+    }
+    if (logsChanges() && !booked.empty())
+        checkpointIfDue();
+    return results;
+}
+
+/*----------------------------------------------------------------------*/
+bool MovieBookingService::bookShowSeats(int showId, const std::vector<int>& seatIds)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::BookShowSeats);
+    if (seatIds.empty()) {
+        call.fail();
+        return false;
+    }
+
+    const auto snapshot = catalog();
+
+    const auto* show = snapshot->shows.find(showId);
+    if (show == nullptr) {
+        call.fail();
+        return false;
+    }
+
+    expireHoldsIfDue();
+
+    if (!(*show)->getSeats().bookSeats(seatIds)) {
+        call.fail();
+        mMetrics.increment(ServiceMetrics::Counter::SeatConflicts);
+        return false; // No seat booked
+    }
+
+    if (logsChanges())
+    {
+        LogRecordWriter record;
+        record.bookShowSeats(showId, seatIds);
+        try
+        {
+            logRecord(record.data());
+        }
+        catch (...)
+        {
+            (*show)->getSeats().cancelSeats(seatIds); // Not durable, so not booked
+            throw;
+        }
+    }
+    commitSeatEvents(mEvents.claim(seatIds.size()), EventType::SeatBooked, -1, show->get(), seatIds);
+    if (logsChanges())
+        checkpointIfDue();
+    return true; // All seats booked
+}
+
+/*----------------------------------------------------------------------*/
+std::optional<MovieBookingService::HoldId> MovieBookingService::holdSeats(int theaterId, const std::vector<int>& seatIds,
+                                                                          std::chrono::milliseconds ttl)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::HoldSeats);
+    if (seatIds.empty() || ttl.count() < 0) {
+        call.fail();
+        return std::nullopt;
+    }
+
+    const auto snapshot = catalog();
+
+    const auto* theater = snapshot->theaters.find(theaterId);
+    if (theater == nullptr) {
+        call.fail();
+        return std::nullopt;
+    }
+
+    expireHoldsIfDue();
+
+    if (!(*theater)->holdSeats(seatIds)) {
+        call.fail();
+        mMetrics.increment(ServiceMetrics::Counter::SeatConflicts);
+        return std::nullopt; // A seat is taken or unknown, nothing is held
+    }
+    commitSeatEvents(mEvents.claim(seatIds.size()), EventType::SeatHeld, theaterId, nullptr, seatIds);
+
+    return addHold(Hold{*theater, nullptr, seatIds}, ttl);
+}
+
+/*----------------------------------------------------------------------*/
+std::optional<MovieBookingService::HoldId> MovieBookingService::holdShowSeats(int showId, const std::vector<int>& seatIds,
+                                                                              std::chrono::milliseconds ttl)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::HoldShowSeats);
+    if (seatIds.empty() || ttl.count() < 0) {
+        call.fail();
+        return std::nullopt;
+    }
+
+    const auto snapshot = catalog();
+
+    const auto* show = snapshot->shows.find(showId);
+    if (show == nullptr) {
+        call.fail();
+        return std::nullopt;
+    }
+
+    expireHoldsIfDue();
+
+    if (!(*show)->getSeats().holdSeats(seatIds)) {
+        call.fail();
+        mMetrics.increment(ServiceMetrics::Counter::SeatConflicts);
+        return std::nullopt; // A seat is taken or unknown, nothing is held
+    }
+    commitSeatEvents(mEvents.claim(seatIds.size()), EventType::SeatHeld, -1, show->get(), seatIds);
+
+    return addHold(Hold{nullptr, *show, seatIds}, ttl);
+}
+
+/*----------------------------------------------------------------------*/
+MovieBookingService::HoldId MovieBookingService::addHold(Hold hold, std::chrono::milliseconds ttl)
+{
+    const auto lock = mMetrics.acquire(mHoldMutex, ServiceMetrics::Lock::Hold);
+
+    const HoldId holdId = mNextHoldId++;
+    mHolds.emplace(holdId, std::move(hold));
+    mHoldTimers.schedule(holdId, currentTick() + static_cast<std::uint64_t>(ttl.count()));
+    ++mActiveHolds;
+
+    return holdId;
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::commitSeatEvents(std::uint64_t first, EventType type, int theaterId, const Show* show,
+                                           const std::vector<int>& seatIds)
+{
+    ServiceEvent event;
+    event.type = type;
+    event.theaterId = theaterId;
+    if (show != nullptr)
+    {
+        event.theaterId = show->getInfo().theaterId;
+        event.showId = show->getId();
+        event.movieId = show->getInfo().movieId;
+    }
+    for (std::size_t i = 0; i < seatIds.size(); ++i)
+    {
+        event.sequence = first + i;
+        event.seatId = seatIds[i];
+        mEvents.commit(event);
+    }
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::publishCatalogEvents(EventType type, const std::vector<int>& ids,
+                                               const std::vector<std::pair<int, int>>& allocations)
+{
+    for (const int id : ids)
+    {
+        if (type == EventType::MovieAdded)
+            mEvents.publish(type, -1, -1, id, -1);
+        else
+            mEvents.publish(type, id, -1, -1, -1);
+    }
+    for (const auto& [movieId, theaterId] : allocations)
+    {
+        mEvents.publish(EventType::MovieAllocated, theaterId, -1, movieId, -1);
+    }
+}
+
+/*----------------------------------------------------------------------*/
+bool MovieBookingService::Hold::confirmSeats() const
+{
+    return show ? show->getSeats().confirmSeats(seatIds) : theater->confirmSeats(seatIds);
+}
+
+/*----------------------------------------------------------------------*/
+bool MovieBookingService::Hold::releaseSeats() const
+{
+    return show ? show->getSeats().releaseSeats(seatIds) : theater->releaseSeats(seatIds);
+}
+
+/*----------------------------------------------------------------------*/
+bool MovieBookingService::Hold::cancelSeats() const
+{
+    return show ? show->getSeats().cancelSeats(seatIds) : theater->cancelSeats(seatIds);
+}
+
+/*----------------------------------------------------------------------*/
+int MovieBookingService::Hold::theaterId() const
+{
+    return show ? show->getInfo().theaterId : theater->getId();
+}
+
+/*----------------------------------------------------------------------*/
+bool MovieBookingService::confirmHold(HoldId holdId)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::ConfirmHold);
+    Hold hold;
+    {
+        const auto lock = mMetrics.acquire(mHoldMutex, ServiceMetrics::Lock::Hold);
+
+        expireHoldsLocked(); // A hold past its time to live cannot be confirmed
+
+        auto itr = mHolds.find(holdId);
+        if (itr == mHolds.end()) {
+            call.fail();
+            return false;
+        }
+
+        hold = std::move(itr->second);
+        mHolds.erase(itr);
+        --mActiveHolds;
+    }
+
+    if (!hold.confirmSeats()) {
+        call.fail();
+        return false;
+    }
+
+    if (logsChanges())
+    {
+        // Recovery knows no holds: a confirmed hold is a booking
+        LogRecordWriter record;
+        if (hold.show)
+            record.bookShowSeats(hold.show->getId(), hold.seatIds);
+        else
+            record.bookSeats(hold.theater->getId(), hold.seatIds);
+        try
+        {
+            logRecord(record.data());
+        }
+        catch (...)
+        {
+            hold.cancelSeats(); // Not durable, so not booked; the hold is gone too
+            throw;
+        }
+    }
+    commitSeatEvents(mEvents.claim(hold.seatIds.size()), EventType::SeatBooked, hold.theaterId(), hold.show.get(),
+                     hold.seatIds);
+    if (logsChanges())
+        checkpointIfDue();
+    return true;
+}
+
+/*----------------------------------------------------------------------*/
+bool MovieBookingService::releaseHold(HoldId holdId)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::ReleaseHold);
+    const auto lock = mMetrics.acquire(mHoldMutex, ServiceMetrics::Lock::Hold);
+
+    auto itr = mHolds.find(holdId);
+    if (itr == mHolds.end()) {
+        call.fail();
+        return false;
+    }
+
+    // Sequenced before the seats are free, so a later booking's events come after
+    const Hold& hold = itr->second;
+    const std::uint64_t first = mEvents.claim(hold.seatIds.size());
+    const bool result = hold.releaseSeats();
+    commitSeatEvents(first, EventType::SeatReleased, hold.theaterId(), hold.show.get(), hold.seatIds);
+    mHolds.erase(itr);
+    --mActiveHolds;
+    return call.succeeded(result);
+}
+
+/*----------------------------------------------------------------------*/
+std::size_t MovieBookingService::expireHolds()
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::ExpireHolds);
+    const auto lock = mMetrics.acquire(mHoldMutex, ServiceMetrics::Lock::Hold);
+    return expireHoldsLocked();
+}
+
+/*----------------------------------------------------------------------*/
+std::size_t MovieBookingService::expireHoldsLocked()
+{
+    std::vector<TimerWheel::TimerId> expired;
+    mHoldTimers.advance(currentTick(), expired);
+
+    std::size_t released = 0;
+    for (const auto holdId : expired)
+    {
+        // Confirmed or released holds leave their timer behind; skip those
+        if (auto itr = mHolds.find(holdId); itr != mHolds.end())
+        {
+            const Hold& hold = itr->second;
+            const std::uint64_t first = mEvents.claim(hold.seatIds.size());
+            hold.releaseSeats();
+            commitSeatEvents(first, EventType::SeatReleased, hold.theaterId(), hold.show.get(), hold.seatIds);
+            mHolds.erase(itr);
+            --mActiveHolds;
+            ++released;
+        }
+    }
+    if (released > 0)
+        mMetrics.increment(ServiceMetrics::Counter::HoldsExpired, released);
+    return released;
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::expireHoldsIfDue()
+{
+    if (mActiveHolds.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    // Whoever already holds the lock processes expirations for us
+    std::unique_lock<std::mutex> lock(mHoldMutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        expireHoldsLocked();
+    }
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::checkpoint()
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::Checkpoint);
+    if (!mLog) {
+        return;
+    }
+
+    const auto checkpointLock = mMetrics.acquire(mCheckpointMutex, ServiceMetrics::Lock::Checkpoint);
+    rotateLog();
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::checkpointIfDue()
+{
+    if (!mLog || mRecordsSinceCheckpoint.load(std::memory_order_relaxed) < mCheckpointInterval) {
+        return;
+    }
+
+    // One checkpoint at a time; whoever is already at it covers our records
+    std::unique_lock<std::mutex> checkpointLock(mCheckpointMutex, std::try_to_lock);
+    if (checkpointLock.owns_lock() && mRecordsSinceCheckpoint >= mCheckpointInterval) {
+        rotateLog();
+    }
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::rotateLog()
+{
+    const auto writerLock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+
+    // Records from here on go to the new log and are replayed over the checkpoint
+    mLog->rotate();
+    mRecordsSinceCheckpoint = 0;
+    writeCheckpoint();
+    mLog->removeRotated();
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::writeCheckpoint() const
+{
+    const auto snapshot = catalog();
+    mMetrics.increment(ServiceMetrics::Counter::Checkpoints);
+
+    WriteAheadLog::writeRecords(mCheckpointPath, [&snapshot](const auto& sink) {
+        writeSnapshotRecords(*snapshot, sink);
+    });
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::writeSnapshotRecords(const Catalog& catalog,
+                                               const std::function<void(const std::string&)>& sink)
+{
+    for (const auto& [movieId, movie] : catalog.movies)
+    {
+        LogRecordWriter record;
+        record.addMovie(*movie);
+        sink(record.data());
+    }
+    for (const auto& [theaterId, theater] : catalog.theaters)
+    {
+        // Seat state is read live; later bookings are replayed from the log
+        LogRecordWriter record;
+        record.addTheater(*theater);
+        sink(record.data());
+    }
+    for (const auto& [movieId, movie] : catalog.movies)
+    {
+        const auto theaterIds = catalog.allocations.getTheaters(movieId);
+        if (theaterIds.empty())
+            continue;
+        LogRecordWriter record;
+        for (const auto theaterId : theaterIds)
+        {
+            record.allocate(movieId, theaterId);
+        }
+        sink(record.data());
+    }
+    for (const auto& [showId, show] : catalog.shows)
+    {
+        LogRecordWriter record;
+        record.addShow(show->getInfo());
+        if (const auto bookedSeats = show->getSeats().getBookedSeats(); !bookedSeats.empty())
+            record.bookShowSeats(showId, bookedSeats);
+        sink(record.data());
+    }
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::logRecord(const std::string& record)
+{
+    if (mLog)
+    {
+        mLog->append(record);
+        ++mRecordsSinceCheckpoint;
+        mMetrics.increment(ServiceMetrics::Counter::LogRecords);
+    }
+
+    // Shipped once durable, so a replica never applies a change the primary could lose
+    if (auto* replication = mReplication.load(std::memory_order_acquire))
+        replication->append(record);
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::replayRecord(Catalog& catalog, const std::string& record,
+                                       std::vector<std::pair<int, int>>& allocated)
+{
+    LogRecordReader reader(record);
+
+    while (!reader.atEnd())
+    {
+        const auto operation = static_cast<LogOperation>(reader.get<std::uint8_t>());
+        switch (operation)
+        {
+            case LogOperation::AddMovie:
+            {
+                const int movieId = reader.get<std::int32_t>();
+                const std::string name = reader.getString();
+                catalog.addMovie(std::make_shared<Movie>(movieId, name));
+                break;
+            }
+            case LogOperation::AddTheater:
+            case LogOperation::AddTheaterWithLayout:
+            {
+                const int theaterId = reader.get<std::int32_t>();
+                const std::string name = reader.getString();
+                std::vector<Seat> seats(reader.get<std::uint32_t>());
+                for (auto& seat : seats)
+                {
+                    seat.id = reader.get<std::int32_t>();
+                    seat.seatNumber = reader.getString();
+                    seat.isBooked = reader.get<std::uint8_t>() != 0;
+                    if (operation == LogOperation::AddTheaterWithLayout)
+                    {
+                        seat.section = reader.get<std::int32_t>();
+                        seat.row = reader.get<std::int32_t>();
+                        seat.position = reader.get<std::int32_t>();
+                    }
+                }
+                if (!catalog.hasTheater(theaterId))
+                {
+                    catalog.addTheater(theaterId, std::make_shared<Theater>(theaterId, name, seats));
+                }
+                break;
+            }
+            case LogOperation::Allocate:
+            {
+                const int movieId = reader.get<std::int32_t>();
+                const int theaterId = reader.get<std::int32_t>();
+                if (catalog.allocate(movieId, theaterId))
+                    allocated.emplace_back(movieId, theaterId);
+                break;
+            }
+            case LogOperation::BookSeats:
+                replayBookSeats(catalog.theaters, reader);
+                break;
+            case LogOperation::AddShow:
+            {
+                ShowInfo show;
+                show.id = reader.get<std::int32_t>();
+                show.theaterId = reader.get<std::int32_t>();
+                show.movieId = reader.get<std::int32_t>();
+                show.startTime = reader.get<std::int64_t>();
+                catalog.addShow(show); // Known show IDs are rejected
+                break;
+            }
+            case LogOperation::BookShowSeats:
+                replayBookShowSeats(catalog.shows, reader);
+                break;
+            default:
+                throw std::runtime_error("Unknown log record operation");
+        }
+    }
+}
+
+/*----------------------------------------------------------------------*/
+bool MovieBookingService::logsChanges() const
+{
+    return mLog != nullptr || mReplication.load(std::memory_order_acquire) != nullptr;
+}
+
+/*----------------------------------------------------------------------*/
+void MovieBookingService::replayBookings(const Catalog& catalog, const std::string& record)
+{
+    LogRecordReader reader(record);
+
+    while (!reader.atEnd())
+    {
+        switch (static_cast<LogOperation>(reader.get<std::uint8_t>()))
+        {
+            case LogOperation::BookSeats:
+                replayBookSeats(catalog.theaters, reader);
+                break;
+            case LogOperation::BookShowSeats:
+                replayBookShowSeats(catalog.shows, reader);
+                break;
+            default:
+                throw std::runtime_error("Unexpected operation in a booking record");
+        }
+    }
+}
+
+/*----------------------------------------------------------------------*/
+std::uint64_t MovieBookingService::currentTick() const
+{
+    const auto elapsed = std::chrono::steady_clock::now() - mClockStart;
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+/*----------------------------------------------------*/
+bool MovieBookingService::isValidMovie(int movieId) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::IsValidMovie);
+    return call.succeeded(catalog()->hasMovie(movieId));
+}
+
+/*----------------------------------------------------*/
+bool MovieBookingService::Catalog::hasMovie(int movieId) const
+{
+    return movies.contains(movieId);
+}
+
+/*----------------------------------------------------*/
+bool MovieBookingService::Catalog::hasTheater(int theaterId) const
+{
+    return theaters.contains(theaterId);
+}
+
+/*----------------------------------------------------*/
+bool MovieBookingService::Catalog::addShow(const ShowInfo& show)
+{
+    const auto* theater = theaters.find(show.theaterId);
+    if (theater == nullptr || !hasMovie(show.movieId) || shows.contains(show.id))
+    {
+        return false;
+    }
+
+    // One show at a time per start time in a theater
+    SharedVector<int> theaterIndex;
+    if (const auto* listed = theaterShows.find(show.theaterId))
+        theaterIndex = *listed;
+    const bool taken = std::any_of(theaterIndex.begin(), theaterIndex.end(), [this, &show](int showId) {
+        return (*shows.find(showId))->getInfo().startTime == show.startTime;
+    });
+    if (taken)
+    {
+        return false;
+    }
+
+    // The indexes grow in place; readers order them by start time
+    theaterIndex.push_back(show.id);
+    theaterShows.assign(show.theaterId, std::move(theaterIndex));
+    SharedVector<int> movieIndex;
+    if (const auto* listed = movieShows.find(show.movieId))
+        movieIndex = *listed;
+    movieIndex.push_back(show.id);
+    movieShows.assign(show.movieId, std::move(movieIndex));
+
+    // The show shares the theater's layout; only its seat state is new
+    shows.emplace(show.id, std::make_shared<Show>(show, (*theater)->getLayout()));
+    return true;
+}
+
+/*----------------------------------------------------*/
+std::vector<ShowInfo> MovieBookingService::Catalog::showInfos(const SharedVector<int>& showIds) const
+{
+    std::vector<ShowInfo> infos;
+    infos.reserve(showIds.size());
+    for (const auto showId : showIds)
+    {
+        infos.push_back((*shows.find(showId))->getInfo());
+    }
+    std::stable_sort(infos.begin(), infos.end(), [](const ShowInfo& lhs, const ShowInfo& rhs) {
+        return lhs.startTime < rhs.startTime;
+    });
+    return infos;
+}
+
+/*----------------------------------------------------*/
+std::string MovieBookingService::getMovieName(int movieId) const
+{
+    return std::string(getMovieNameView(movieId));
+}
+
+/*----------------------------------------------------*/
+std::string_view MovieBookingService::getMovieNameView(int movieId) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetMovieName);
+    const auto snapshot = catalog();
+
+    if (const auto* movie = snapshot->movies.find(movieId))
+    {
+        return (*movie)->name; // Interned, so the view outlives the snapshot
+    }
+    throw std::invalid_argument("Movie with the specified ID not found");
+}
+
+/*----------------------------------------------------*/
+std::string MovieBookingService::getTheaterName(int theaterId) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetTheaterName);
+    const auto snapshot = catalog();
+
+    if (const auto* theater = snapshot->theaters.find(theaterId))
+    {
+        return (*theater)->getName();
+    }
+    throw std::invalid_argument("Theater with the specified ID not found");
+}
+
+/*----------------------------------------------------*/
+std::string_view MovieBookingService::getTheaterNameView(int theaterId) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetTheaterName);
+    const auto snapshot = catalog();
+
+    if (const auto* theater = snapshot->theaters.find(theaterId))
+    {
+        return (*theater)->getNameView(); // Interned, so the view outlives the snapshot
+    }
+    throw std::invalid_argument("Theater with the specified ID not found");
+}
+
+/*----------------------------------------------------*/
+std::optional<std::string_view> MovieBookingService::findMovieName(int movieId) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetMovieName);
+    if (const auto* movie = catalog()->movies.find(movieId))
+    {
+        return (*movie)->name;
+    }
+    call.fail();
+    return std::nullopt;
+}
+
+/*----------------------------------------------------*/
+std::optional<std::string_view> MovieBookingService::findTheaterName(int theaterId) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetTheaterName);
+    if (const auto* theater = catalog()->theaters.find(theaterId))
+    {
+        return (*theater)->getNameView();
+    }
+    call.fail();
+    return std::nullopt;
+}
+
+/*----------------------------------------------------*/
+bool MovieBookingService::Catalog::addMovie(std::shared_ptr<Movie> movie)
+{
+    const int movieId = movie->id;
+    if (!movies.emplace(movieId, std::move(movie)).second)
+        return false;
+
+    allocations.addMovie(movieId);
+    movieAvailability.emplace(movieId, std::make_shared<std::atomic<std::int64_t>>(0));
+    return true;
+}
+
+/*----------------------------------------------------*/
+bool MovieBookingService::Catalog::addTheater(int theaterId, std::shared_ptr<TheaterBase> theater)
+{
+    if (!theaters.emplace(theaterId, std::move(theater)).second)
+        return false;
+
+    allocations.addTheater(theaterId);
+    return true;
+}
+
+/*----------------------------------------------------*/
+bool MovieBookingService::Catalog::allocate(int movieId, int theaterId)
+{
+    return hasMovie(movieId) && hasTheater(theaterId) && allocations.allocate(movieId, theaterId);
+}
+
+/*----------------------------------------------------*/
+void MovieBookingService::Catalog::markAllocated(const std::vector<std::pair<int, int>>& allocated) const
+{
+    for (const auto& [movieId, theaterId] : allocated)
+    {
+        const auto& theater = *theaters.find(theaterId);
+        theater->setAllocated(true);
+        theater->attachAvailabilityCounter(*movieAvailability.find(movieId));
+    }
+}
+
+/*----------------------------------------------------*/
+std::vector<std::pair<int, int>> MovieBookingService::Catalog::planAllocations(std::mt19937* random)
+{
+    std::vector<std::pair<int, int>> planned;
+
+    // Pair waiting movies with free theaters, both in the order they were added
+    while (const auto allocation = allocations.allocateNext())
+    {
+        planned.push_back(*allocation);
+    }
+
+    // Every movie is allocated: remaining theaters show a random one
+    if (random != nullptr)
+    {
+        while (const auto allocation = allocations.fillNext(*random))
+        {
+            planned.push_back(*allocation);
+        }
+    }
+    return planned;
+}
+
+/*----------------------------------------------------*/
+std::shared_ptr<const MovieBookingService::Catalog> MovieBookingService::catalog() const
+{
+    return std::atomic_load_explicit(&mCatalog, std::memory_order_acquire);
+}
+
+/*----------------------------------------------------*/
+void MovieBookingService::publish(std::shared_ptr<const Catalog> catalog)
+{
+    std::atomic_store_explicit(&mCatalog, std::move(catalog), std::memory_order_release);
+}
+
+///*----------------------------------------------------*/
+bool MovieBookingService::isMovieShownInTheater(int theaterId, int movieId) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::IsMovieShownInTheater);
+    const auto snapshot = catalog();
+
+    if (!snapshot->hasTheater(theaterId) || !snapshot->hasMovie(movieId))
+    {
+        call.fail();
+        return false;
+    }
+    return call.succeeded(snapshot->allocations.isShownIn(theaterId, movieId));
+}
+
+/*----------------------------------------------------*/
+std::uint64_t MovieBookingService::getEventSequence() const
+{
+    return mEvents.nextSequence();
+}
+
+/*----------------------------------------------------*/
+EventSubscription MovieBookingService::subscribe(std::uint64_t fromSequence) const
+{
+    return EventSubscription(mEvents, fromSequence);
+}
+
+/*----------------------------------------------------*/
+void MovieBookingService::enableReplication(std::size_t retainedRecords)
+{
+    // Under the writer lock, so each catalog change is either in a snapshot or in the log
+    const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+    if (mReplicationLog)
+        return;
+    mReplicationLog = std::make_unique<ReplicationLog>(retainedRecords);
+    mReplication.store(mReplicationLog.get(), std::memory_order_release);
+}
+
+/*----------------------------------------------------*/
+std::uint64_t MovieBookingService::getReplicationLogId() const
+{
+    const auto* replication = mReplication.load(std::memory_order_acquire);
+    return replication ? replication->id() : 0;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t MovieBookingService::getReplicationSequence() const
+{
+    const auto* replication = mReplication.load(std::memory_order_acquire);
+    return replication ? replication->lastSequence() : 0;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t MovieBookingService::getReplicationSnapshot(std::vector<std::string>& records)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::GetReplicationSnapshot);
+    records.clear();
+    const auto* replication = mReplication.load(std::memory_order_acquire);
+    if (replication == nullptr)
+        throw std::logic_error("Replication is not enabled");
+
+    // Catalog changes are logged and published under the writer lock, and
+    // bookings are logged after their seats change: the snapshot reflects
+    // every record up to the sequence, and maybe some after it
+    std::shared_ptr<const Catalog> snapshot;
+    std::uint64_t sequence = 0;
+    {
+        const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+        sequence = replication->lastSequence();
+        snapshot = catalog();
+    }
+    writeSnapshotRecords(*snapshot, [&records](const std::string& record) {
+        records.push_back(record);
+    });
+    return sequence;
+}
+
+/*----------------------------------------------------*/
+ReplicationLog::ReadStatus MovieBookingService::readReplicationLog(std::uint64_t logId, std::uint64_t after,
+                                                                   std::vector<std::string>& records,
+                                                                   std::size_t maxRecords) const
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::ReadReplicationLog);
+    const auto* replication = mReplication.load(std::memory_order_acquire);
+    if (replication == nullptr)
+    {
+        records.clear();
+        call.fail();
+        return ReplicationLog::ReadStatus::Lapped;
+    }
+    const auto status = replication->read(logId, after, records, maxRecords);
+    if (status != ReplicationLog::ReadStatus::Ok)
+        call.fail();
+    return status;
+}
+
+/*----------------------------------------------------*/
+void MovieBookingService::loadReplicationSnapshot(const std::vector<std::string>& records)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::LoadReplicationSnapshot);
+    auto loaded = std::make_shared<Catalog>();
+    std::vector<std::pair<int, int>> allocated;
+    for (const auto& record : records)
+    {
+        replayRecord(*loaded, record, allocated);
+    }
+
+    const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+    publish(loaded);
+    loaded->markAllocated(allocated);
+}
+
+/*----------------------------------------------------*/
+void MovieBookingService::applyReplicationRecords(const std::vector<std::string>& records)
+{
+    ServiceMetrics::Call call(mMetrics, ServiceMetrics::Operation::ApplyReplicationRecords);
+    const auto lock = mMetrics.acquire(mWriterMutex, ServiceMetrics::Lock::Writer);
+
+    // Bookings change seat state in place; the catalog is copied once, at the first catalog change
+    std::shared_ptr<Catalog> draft;
+    std::vector<std::pair<int, int>> allocated;
+    for (const auto& record : records)
+    {
+        if (draft == nullptr && isBookingRecord(record))
+        {
+            replayBookings(*catalog(), record);
+            continue;
+        }
+        if (draft == nullptr)
+            draft = std::make_shared<Catalog>(*catalog());
+        replayRecord(*draft, record, allocated);
+    }
+    if (draft != nullptr)
+    {
+        publish(draft);
+        draft->markAllocated(allocated);
+    }
+}
+
+/*----------------------------------------------------*/
+ServiceMetrics::Snapshot MovieBookingService::getMetrics() const
+{
+    return mMetrics.snapshot();
+}
+
+/*----------------------------------------------------*/
+std::string MovieBookingService::dumpMetrics(ServiceMetrics::Format format) const
+{
+    return ServiceMetrics::format(mMetrics.snapshot(), format);
+}
+
+/*-------------------END---------------------------------*/
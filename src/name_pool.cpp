@@ -0,0 +1,64 @@
+/**
+ * @file name_pool.cpp
+ * @brief Implementation for NamePool class
+ * @author Gebremedhin Abreha
+ */
+
+#include "name_pool.hpp"
+
+#include <cstring>
+
+/*----------------------------------------------------*/
+NamePool& NamePool::shared()
+{
+    // Never destroyed, so names stay valid in static destructors too
+    static NamePool* pool = new NamePool();
+    return *pool;
+}
+
+/*----------------------------------------------------*/
+std::string_view NamePool::intern(std::string_view name)
+{
+    if (name.empty())
+        return std::string_view();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (auto itr = mNames.find(name); itr != mNames.end())
+        return *itr;
+
+    const auto pooled = store(name);
+    mNames.insert(pooled);
+    return pooled;
+}
+
+/*----------------------------------------------------*/
+std::size_t NamePool::size() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNames.size();
+}
+
+/*----------------------------------------------------*/
+std::string_view NamePool::store(std::string_view name)
+{
+    // Long names get a block of their own and leave the current one open
+    if (name.size() > kBlockSize / 4)
+    {
+        mBlocks.push_back(std::make_unique<char[]>(name.size()));
+        std::memcpy(mBlocks.back().get(), name.data(), name.size());
+        return std::string_view(mBlocks.back().get(), name.size());
+    }
+
+    if (name.size() > mFreeSize)
+    {
+        mBlocks.push_back(std::make_unique<char[]>(kBlockSize));
+        mFree = mBlocks.back().get();
+        mFreeSize = kBlockSize;
+    }
+    std::memcpy(mFree, name.data(), name.size());
+    const std::string_view pooled(mFree, name.size());
+    mFree += name.size();
+    mFreeSize -= name.size();
+    return pooled;
+}
+/*-------------------END-------------------------------*/
@@ -0,0 +1,82 @@
+/**
+ * @file replication_log.cpp
+ * @brief Implementation for ReplicationLog class
+ * @author Gebremedhin Abreha
+ */
+
+#include "replication_log.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief A random, non-zero log ID.
+ */
+std::uint64_t randomId()
+{
+    std::random_device device;
+    const std::uint64_t id = (static_cast<std::uint64_t>(device()) << 32) | device();
+    return id == 0 ? 1 : id;
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+ReplicationLog::ReplicationLog(std::size_t capacity):
+mId(randomId()),
+mCapacity(capacity)
+{
+    if (capacity == 0)
+        throw std::invalid_argument("A replication log needs room for a record");
+}
+
+/*----------------------------------------------------*/
+std::uint64_t ReplicationLog::append(const std::string& record)
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+    if (mRecords.size() == mCapacity)
+        mRecords.pop_front();
+    mRecords.push_back(record);
+    return ++mLastSequence;
+}
+
+/*----------------------------------------------------*/
+ReplicationLog::ReadStatus ReplicationLog::read(std::uint64_t logId, std::uint64_t after,
+                                                std::vector<std::string>& records, std::size_t maxRecords) const
+{
+    records.clear();
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    // The oldest record kept has sequence first; a reader at first - 1 misses nothing
+    const std::uint64_t first = mLastSequence - mRecords.size() + 1;
+    if (logId != mId || after > mLastSequence || after + 1 < first)
+        return ReadStatus::Lapped;
+
+    const std::size_t begin = static_cast<std::size_t>(after + 1 - first);
+    const std::size_t end = begin + std::min(maxRecords, mRecords.size() - begin);
+    records.assign(mRecords.begin() + begin, mRecords.begin() + end);
+    return ReadStatus::Ok;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t ReplicationLog::lastSequence() const
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return mLastSequence;
+}
+
+/*----------------------------------------------------*/
+std::uint64_t ReplicationLog::id() const
+{
+    return mId;
+}
+
+/*----------------------------------------------------*/
+std::size_t ReplicationLog::capacity() const
+{
+    return mCapacity;
+}
+/*-------------------END-------------------------------*/
@@ -0,0 +1,57 @@
+/**
+ * @file seat_bitmap.cpp
+ * @brief Implementation for SeatBitmap class
+ * @author Gebremedhin Abreha
+ */
+
+#include "seat_bitmap.hpp"
+
+template class BasicSeatBitmap<HeapSeatWords>;
+
+/*----------------------------------------------------*/
+HeapSeatWords::HeapSeatWords(std::size_t seats):
+mSeats(seats), mWordCount(bits::wordCount(seats)),
+mWords(std::make_unique<std::atomic<std::uint64_t>[]>(mWordCount))
+{
+}
+
+/*----------------------------------------------------*/
+HeapSeatWords::HeapSeatWords(const HeapSeatWords& other):
+mSeats(other.mSeats), mWordCount(other.mWordCount),
+mWords(std::make_unique<std::atomic<std::uint64_t>[]>(mWordCount))
+{
+    for (std::size_t w = 0; w < mWordCount; ++w)
+    {
+        mWords[w].store(other.mWords[w].load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+/*----------------------------------------------------*/
+HeapSeatWords::HeapSeatWords(HeapSeatWords&& other) noexcept:
+mSeats(other.mSeats), mWordCount(other.mWordCount), mWords(std::move(other.mWords))
+{
+    other.mSeats = 0;
+    other.mWordCount = 0;
+}
+
+/*----------------------------------------------------*/
+HeapSeatWords& HeapSeatWords::operator=(const HeapSeatWords& other)
+{
+    if (this != &other)
+    {
+        *this = HeapSeatWords(other);
+    }
+    return *this;
+}
+
+/*----------------------------------------------------*/
+HeapSeatWords& HeapSeatWords::operator=(HeapSeatWords&& other) noexcept
+{
+    mSeats = other.mSeats;
+    mWordCount = other.mWordCount;
+    mWords = std::move(other.mWords);
+    other.mSeats = 0;
+    other.mWordCount = 0;
+    return *this;
+}
+/*-------------------END-------------------------------*/
@@ -0,0 +1,10 @@
+/**
+ * @file seat_inventory.cpp
+ * @brief Implementation for SeatInventory class
+ * @author Gebremedhin Abreha
+ */
+
+#include "seat_inventory.hpp"
+
+template class BasicSeatInventory<SeatBitmap>;
+/*-------------------END-------------------------------*/
@@ -0,0 +1,267 @@
+/**
+ * @file seat_layout.cpp
+ * @brief Implementation for SeatLayout class
+ * @author Gebremedhin Abreha
+ */
+
+#include "seat_layout.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <string_view>
+#include <tuple>
+
+/*----------------------------------------------------*/
+SeatLayout::SeatLayout(const std::vector<Seat>& seats):
+mSeatCount(0), mFirstSeatId(0), mFirstNumber(0), mComputedNumbers(false), mContiguousSeatIds(true)
+{
+    mSeatIds.reserve(seats.size());
+    mNumberEnds.reserve(seats.size());
+    mSeatIndex.reserve(seats.size());
+
+    std::vector<SeatPlace> places;
+    places.reserve(seats.size());
+    for (const auto& seat: seats)
+    {
+        // Keep the first seat for a duplicated ID, as the linear lookup did
+        if (!mSeatIndex.emplace(seat.id, mSeatIds.size()).second)
+            continue;
+
+        if (!mSeatIds.empty() && seat.id != mSeatIds.back() + 1)
+            mContiguousSeatIds = false;
+
+        mSeatIds.push_back(seat.id);
+        mNumberChars.append(seat.seatNumber);
+        mNumberEnds.push_back(static_cast<std::uint32_t>(mNumberChars.size()));
+        places.push_back(SeatPlace{seat.section, seat.row, seat.position});
+    }
+    mSeatCount = mSeatIds.size();
+    if (!mSeatIds.empty())
+        mFirstSeatId = mSeatIds.front();
+    buildRows(std::move(places));
+    computeNumbersIfNumbered();
+
+    // Contiguous IDs are resolved arithmetically, neither the IDs nor the
+    // hash map are needed
+    if (mContiguousSeatIds)
+    {
+        std::vector<int>().swap(mSeatIds);
+        std::unordered_map<int, std::size_t>().swap(mSeatIndex);
+    }
+}
+
+/*----------------------------------------------------*/
+void SeatLayout::computeNumbersIfNumbered()
+{
+    if (mSeatCount == 0)
+        return;
+
+    // Split the first seat number into a prefix and a decimal number
+    const std::string_view first(mNumberChars.data(), mNumberEnds[0]);
+    std::size_t digits = first.size();
+    while (digits > 0 && std::isdigit(static_cast<unsigned char>(first[digits - 1])))
+        --digits;
+    const std::string_view prefix = first.substr(0, digits);
+    const std::string_view number = first.substr(digits);
+
+    // Leading zeros would not survive the round trip through a number
+    if (number.empty() || number.size() > 15 || (number.size() > 1 && number[0] == '0'))
+        return;
+    long long value = 0;
+    std::from_chars(number.data(), number.data() + number.size(), value);
+
+    char buffer[24];
+    std::uint32_t begin = 0;
+    for (std::size_t index = 0; index < mSeatCount; ++index)
+    {
+        const std::string_view seatNumber(mNumberChars.data() + begin, mNumberEnds[index] - begin);
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value + static_cast<long long>(index));
+        const std::string_view expected(buffer, static_cast<std::size_t>(result.ptr - buffer));
+        if (seatNumber.size() != prefix.size() + expected.size() ||
+            seatNumber.substr(0, prefix.size()) != prefix || seatNumber.substr(prefix.size()) != expected)
+            return;
+        begin = mNumberEnds[index];
+    }
+
+    mNumberPrefix = std::string(prefix);
+    mFirstNumber = value;
+    mComputedNumbers = true;
+    std::string().swap(mNumberChars);
+    std::vector<std::uint32_t>().swap(mNumberEnds);
+}
+
+/*----------------------------------------------------*/
+void SeatLayout::buildRows(std::vector<SeatPlace> places)
+{
+    const bool hasRows = std::any_of(places.begin(), places.end(), [](const SeatPlace& place) {
+        return place.row != Seat::kNoRow;
+    });
+    if (!hasRows)
+    {
+        // No layout given: the whole theater is one row in layout order
+        if (!places.empty())
+        {
+            mSeatRuns.push_back(SeatRun{0, places.size(), 0});
+            mSeatRows.push_back(SeatRow{0, 1, static_cast<double>(places.size() - 1) / 2});
+        }
+        return;
+    }
+
+    // Seats of each row in position order; seats without a row are left out
+    std::vector<std::size_t> order;
+    std::map<int, std::pair<int, int>> sectionRows; // Section -> lowest and highest row
+    for (std::size_t index = 0; index < places.size(); ++index)
+    {
+        const auto& place = places[index];
+        if (place.row == Seat::kNoRow)
+            continue;
+        order.push_back(index);
+        auto [itr, added] = sectionRows.emplace(place.section, std::make_pair(place.row, place.row));
+        itr->second.first = std::min(itr->second.first, place.row);
+        itr->second.second = std::max(itr->second.second, place.row);
+    }
+    std::sort(order.begin(), order.end(), [&places](std::size_t lhs, std::size_t rhs) {
+        return std::tie(places[lhs].section, places[lhs].row, places[lhs].position, lhs) <
+               std::tie(places[rhs].section, places[rhs].row, places[rhs].position, rhs);
+    });
+
+    struct RankedRow {
+        SeatRow row;
+        double distance; // From the middle row of the section
+        int section;
+        int number;
+    };
+    std::vector<RankedRow> rows;
+
+    for (std::size_t first = 0; first < order.size();)
+    {
+        const auto& head = places[order[first]];
+        std::size_t last = first;
+        while (last + 1 < order.size() && places[order[last + 1]].section == head.section &&
+               places[order[last + 1]].row == head.row)
+            ++last;
+
+        const std::size_t firstRun = mSeatRuns.size();
+        for (std::size_t k = first; k <= last; ++k)
+        {
+            const std::size_t index = order[k];
+            const bool extends = k > first && index == order[k - 1] + 1 &&
+                                 places[index].position == places[order[k - 1]].position + 1;
+            if (extends)
+                mSeatRuns.back().end = index + 1;
+            else
+                mSeatRuns.push_back(SeatRun{index, index + 1, places[index].position});
+        }
+
+        const auto& [lowest, highest] = sectionRows.at(head.section);
+        const double center = (static_cast<double>(head.position) + places[order[last]].position) / 2;
+        rows.push_back(RankedRow{SeatRow{firstRun, mSeatRuns.size(), center},
+                                 std::abs(head.row - (static_cast<double>(lowest) + highest) / 2),
+                                 head.section, head.row});
+        first = last + 1;
+    }
+
+    // Middle rows first; between two rows as close, the one further back
+    std::stable_sort(rows.begin(), rows.end(), [](const RankedRow& lhs, const RankedRow& rhs) {
+        return std::make_tuple(lhs.distance, lhs.section, -lhs.number) <
+               std::make_tuple(rhs.distance, rhs.section, -rhs.number);
+    });
+    mSeatRows.reserve(rows.size());
+    for (const auto& ranked : rows)
+    {
+        mSeatRows.push_back(ranked.row);
+    }
+    mSeatPlaces = std::move(places);
+}
+
+/*----------------------------------------------------*/
+std::size_t SeatLayout::size() const
+{
+    return mSeatCount;
+}
+
+/*----------------------------------------------------*/
+int SeatLayout::seatId(std::size_t index) const
+{
+    if (mContiguousSeatIds)
+        return mFirstSeatId + static_cast<int>(index);
+    return mSeatIds[index];
+}
+
+/*----------------------------------------------------*/
+std::string SeatLayout::seatNumber(std::size_t index) const
+{
+    if (mComputedNumbers)
+    {
+        char buffer[24];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), mFirstNumber + static_cast<long long>(index));
+        std::string number;
+        number.reserve(mNumberPrefix.size() + static_cast<std::size_t>(result.ptr - buffer));
+        number.append(mNumberPrefix).append(buffer, result.ptr);
+        return number;
+    }
+
+    const std::uint32_t begin = index == 0 ? 0 : mNumberEnds[index - 1];
+    return mNumberChars.substr(begin, mNumberEnds[index] - begin);
+}
+
+/*----------------------------------------------------*/
+bool SeatLayout::findSeatIndex(const int& id, std::size_t& index) const
+{
+    if (mContiguousSeatIds)
+    {
+        const long long offset = static_cast<long long>(id) - mFirstSeatId;
+        if (offset < 0 || static_cast<std::size_t>(offset) >= mSeatCount)
+            return false;
+        index = static_cast<std::size_t>(offset);
+        return true;
+    }
+
+    if (auto itr = mSeatIndex.find(id); itr != mSeatIndex.end())
+    {
+        index = itr->second;
+        return true;
+    }
+    return false;
+}
+
+/*----------------------------------------------------*/
+bool SeatLayout::findSeatIndices(const std::vector<int>& ids, std::vector<std::size_t>& indices) const
+{
+    indices.clear();
+    indices.reserve(ids.size());
+
+    for (const auto id : ids)
+    {
+        std::size_t index = 0;
+        if (!findSeatIndex(id, index))
+            return false;
+        indices.push_back(index);
+    }
+    return true;
+}
+
+/*----------------------------------------------------*/
+std::vector<Seat> SeatLayout::getSeats() const
+{
+    std::vector<Seat> seats(mSeatCount);
+    for (std::size_t index = 0; index < mSeatCount; ++index)
+    {
+        seats[index].id = seatId(index);
+        seats[index].seatNumber = seatNumber(index);
+        seats[index].isBooked = false;
+        if (!mSeatPlaces.empty())
+        {
+            seats[index].section = mSeatPlaces[index].section;
+            seats[index].row = mSeatPlaces[index].row;
+            seats[index].position = mSeatPlaces[index].position;
+        }
+    }
+    return seats;
+}
+
+/*-------------------END-------------------------------*/
@@ -0,0 +1,277 @@
+/**
+ * @file service_metrics.cpp
+ * @brief Implementation for ServiceMetrics class
+ * @author Gebremedhin Abreha
+ */
+
+#include "service_metrics.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+const char* const kOperationNames[ServiceMetrics::kOperations] = {
+    "addMovie", "addTheater", "addMovies", "addTheaters", "loadCatalogImage", "addShow", "addShows",
+    "getAllMovies", "getTheatersForMovie", "getShowsForMovie", "getShowsForTheater",
+    "getAvailableSeats", "getAvailableSeatCount", "getMovieAvailableSeatCount", "getMoviesWithAvailability",
+    "findBestAvailable", "getAvailableShowSeats", "findBestAvailableForShow", "findShow",
+    "bookSeats", "bookShowSeats", "bookBatch", "holdSeats", "holdShowSeats", "confirmHold", "releaseHold", "expireHolds", "checkpoint",
+    "isValidMovie", "isMovieShownInTheater", "getMovieName", "getTheaterName",
+    "getReplicationSnapshot", "readReplicationLog", "loadReplicationSnapshot", "applyReplicationRecords"
+};
+
+const char* const kLockNames[ServiceMetrics::kLocks] = {"writer", "hold", "checkpoint"};
+
+const char* const kCounterNames[ServiceMetrics::kCounters] = {
+    "seatConflicts", "holdsExpired", "logRecords", "checkpoints"
+};
+
+/**
+ * @brief Shard index of the calling thread; threads are numbered as they first record.
+ */
+std::size_t threadShardIndex()
+{
+    static std::atomic<std::size_t> nextThread{0};
+    thread_local const std::size_t index = nextThread.fetch_add(1, std::memory_order_relaxed) % ServiceMetrics::kShards;
+    return index;
+}
+
+/**
+ * @brief Nanoseconds elapsed since start.
+ */
+std::uint64_t elapsedNanos(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+/**
+ * @brief Format nanoseconds as microseconds.
+ */
+std::string micros(double nanos)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << nanos / 1000.0;
+    return out.str();
+}
+
+/**
+ * @brief Append the latency fields of a histogram as JSON members.
+ */
+void jsonLatency(std::ostringstream& out, const LatencyHistogram& histogram)
+{
+    out << "\"mean_us\":" << micros(histogram.mean())
+        << ",\"p50_us\":" << micros(static_cast<double>(histogram.percentile(0.5)))
+        << ",\"p99_us\":" << micros(static_cast<double>(histogram.percentile(0.99)))
+        << ",\"p999_us\":" << micros(static_cast<double>(histogram.percentile(0.999)))
+        << ",\"max_us\":" << micros(static_cast<double>(histogram.max()));
+}
+
+/**
+ * @brief Append the latency columns of a histogram as text.
+ */
+void textLatency(std::ostringstream& out, const LatencyHistogram& histogram)
+{
+    out << std::setw(10) << micros(histogram.mean())
+        << std::setw(10) << micros(static_cast<double>(histogram.percentile(0.5)))
+        << std::setw(10) << micros(static_cast<double>(histogram.percentile(0.99)))
+        << std::setw(10) << micros(static_cast<double>(histogram.percentile(0.999)))
+        << std::setw(10) << micros(static_cast<double>(histogram.max()));
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+ServiceMetrics::Call::Call(ServiceMetrics& metrics, Operation operation):
+mMetrics(metrics), mOperation(operation), mStart(std::chrono::steady_clock::now()),
+mExceptions(std::uncaught_exceptions())
+{
+}
+
+/*----------------------------------------------------*/
+ServiceMetrics::Call::~Call()
+{
+    // Leaving by an exception counts as a failure
+    const bool failed = mFailed || std::uncaught_exceptions() > mExceptions;
+    mMetrics.recordCall(mOperation, elapsedNanos(mStart), failed);
+}
+
+/*----------------------------------------------------*/
+ServiceMetrics::ServiceMetrics() = default;
+
+/*----------------------------------------------------*/
+ServiceMetrics::~ServiceMetrics()
+{
+    for (auto& shard : mShards)
+    {
+        delete shard.load(std::memory_order_acquire);
+    }
+}
+
+/*----------------------------------------------------*/
+ServiceMetrics::Shard& ServiceMetrics::localShard()
+{
+    auto& slot = mShards[threadShardIndex()];
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard == nullptr)
+    {
+        // Threads sharing the slot may race to create it; one of them wins
+        auto created = std::make_unique<Shard>();
+        if (slot.compare_exchange_strong(shard, created.get(), std::memory_order_acq_rel))
+            shard = created.release();
+    }
+    return *shard;
+}
+
+/*----------------------------------------------------*/
+void ServiceMetrics::recordCall(Operation operation, std::uint64_t nanos, bool failed)
+{
+    auto& shard = localShard();
+    const auto index = static_cast<std::size_t>(operation);
+    shard.latency[index].record(nanos);
+    if (failed)
+        shard.failures[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+/*----------------------------------------------------*/
+void ServiceMetrics::recordLockWait(Lock lock, std::uint64_t nanos)
+{
+    localShard().lockWaits[static_cast<std::size_t>(lock)].record(nanos);
+}
+
+/*----------------------------------------------------*/
+void ServiceMetrics::increment(Counter counter, std::uint64_t amount)
+{
+    localShard().counters[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+/*----------------------------------------------------*/
+std::unique_lock<std::mutex> ServiceMetrics::acquire(std::mutex& mutex, Lock lock)
+{
+    // An uncontended lock is not worth two clock reads
+    std::unique_lock<std::mutex> owner(mutex, std::try_to_lock);
+    if (owner.owns_lock())
+    {
+        recordLockWait(lock, 0);
+        return owner;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    owner.lock();
+    recordLockWait(lock, elapsedNanos(start));
+    return owner;
+}
+
+/*----------------------------------------------------*/
+ServiceMetrics::Snapshot ServiceMetrics::snapshot() const
+{
+    Snapshot result;
+    for (const auto& slot : mShards)
+    {
+        const Shard* shard = slot.load(std::memory_order_acquire);
+        if (shard == nullptr)
+            continue;
+
+        for (std::size_t i = 0; i < kOperations; ++i)
+        {
+            shard->latency[i].addTo(result.operations[i].latency);
+            result.operations[i].failures += shard->failures[i].load(std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < kLocks; ++i)
+        {
+            shard->lockWaits[i].addTo(result.lockWaits[i]);
+        }
+        for (std::size_t i = 0; i < kCounters; ++i)
+        {
+            result.counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+        }
+    }
+    for (auto& operation : result.operations)
+    {
+        operation.calls = operation.latency.count();
+    }
+    return result;
+}
+
+/*----------------------------------------------------*/
+std::string ServiceMetrics::format(const Snapshot& snapshot, Format format)
+{
+    std::ostringstream out;
+
+    if (format == Format::Json)
+    {
+        out << "{\"operations\":{";
+        for (std::size_t i = 0; i < kOperations; ++i)
+        {
+            const auto& operation = snapshot.operations[i];
+            out << (i ? "," : "") << "\"" << kOperationNames[i] << "\":{\"calls\":" << operation.calls
+                << ",\"failures\":" << operation.failures << ",";
+            jsonLatency(out, operation.latency);
+            out << "}";
+        }
+        out << "},\"lockWaits\":{";
+        for (std::size_t i = 0; i < kLocks; ++i)
+        {
+            out << (i ? "," : "") << "\"" << kLockNames[i] << "\":{\"acquisitions\":" << snapshot.lockWaits[i].count() << ",";
+            jsonLatency(out, snapshot.lockWaits[i]);
+            out << "}";
+        }
+        out << "},\"counters\":{";
+        for (std::size_t i = 0; i < kCounters; ++i)
+        {
+            out << (i ? "," : "") << "\"" << kCounterNames[i] << "\":" << snapshot.counters[i];
+        }
+        out << "}}";
+        return out.str();
+    }
+
+    out << std::left << std::setw(24) << "operation" << std::right << std::setw(12) << "calls" << std::setw(10) << "failures"
+        << std::setw(10) << "mean us" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+        << std::setw(10) << "p99.9 us" << std::setw(10) << "max us" << "\n";
+    for (std::size_t i = 0; i < kOperations; ++i)
+    {
+        const auto& operation = snapshot.operations[i];
+        out << std::left << std::setw(24) << kOperationNames[i] << std::right
+            << std::setw(12) << operation.calls << std::setw(10) << operation.failures;
+        textLatency(out, operation.latency);
+        out << "\n";
+    }
+
+    out << "\n" << std::left << std::setw(24) << "lock wait" << std::right << std::setw(12) << "acquired" << std::setw(10) << ""
+        << std::setw(10) << "mean us" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+        << std::setw(10) << "p99.9 us" << std::setw(10) << "max us" << "\n";
+    for (std::size_t i = 0; i < kLocks; ++i)
+    {
+        out << std::left << std::setw(24) << kLockNames[i] << std::right
+            << std::setw(12) << snapshot.lockWaits[i].count() << std::setw(10) << "";
+        textLatency(out, snapshot.lockWaits[i]);
+        out << "\n";
+    }
+
+    out << "\n";
+    for (std::size_t i = 0; i < kCounters; ++i)
+    {
+        out << std::left << std::setw(24) << kCounterNames[i] << std::right << std::setw(12) << snapshot.counters[i] << "\n";
+    }
+    return out.str();
+}
+
+/*----------------------------------------------------*/
+const char* ServiceMetrics::name(Operation operation)
+{
+    return kOperationNames[static_cast<std::size_t>(operation)];
+}
+
+/*----------------------------------------------------*/
+const char* ServiceMetrics::name(Lock lock)
+{
+    return kLockNames[static_cast<std::size_t>(lock)];
+}
+
+/*----------------------------------------------------*/
+const char* ServiceMetrics::name(Counter counter)
+{
+    return kCounterNames[static_cast<std::size_t>(counter)];
+}
+/*-------------------END-------------------------------*/
@@ -0,0 +1,612 @@
+/**
+ * @file service_protocol.cpp
+ * @brief Implementation for ServiceProtocol class
+ * @author Gebremedhin Abreha
+ */
+
+#include "service_protocol.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog_loader.hpp"
+#include "movie_booking_service.hpp"
+
+namespace {
+
+/**
+ * @class Arguments
+ * @brief Space-separated arguments of a request, consumed front to back.
+ */
+class Arguments {
+public:
+    explicit Arguments(std::string_view text) : mText(text) { }
+
+    /**
+     * @brief Take the next token; empty at the end.
+     */
+    std::string_view next()
+    {
+        skipSpaces();
+        const auto end = std::min(mText.find(' '), mText.size());
+        const auto token = mText.substr(0, end);
+        mText.remove_prefix(end);
+        return token;
+    }
+
+    /**
+     * @brief Take the next token as a number.
+     */
+    template <typename T>
+    bool next(T& value)
+    {
+        const auto token = next();
+        const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        return !token.empty() && result.ec == std::errc() && result.ptr == token.data() + token.size();
+    }
+
+    /**
+     * @brief Take every remaining token as an integer; false if there is none.
+     */
+    bool ints(std::vector<int>& values)
+    {
+        while (!done())
+        {
+            int value;
+            if (!next(value))
+                return false;
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
+
+    /**
+     * @brief Take the rest of the line, e.g. a name.
+     */
+    std::string_view rest()
+    {
+        skipSpaces();
+        const auto text = mText;
+        mText = {};
+        return text;
+    }
+
+    /**
+     * @brief Check if every argument was taken.
+     */
+    bool done()
+    {
+        skipSpaces();
+        return mText.empty();
+    }
+
+private:
+    void skipSpaces()
+    {
+        while (!mText.empty() && mText.front() == ' ')
+            mText.remove_prefix(1);
+    }
+
+    std::string_view mText;
+};
+
+/**
+ * @brief Parse a comma-separated list of integers.
+ */
+bool parseList(std::string_view text, std::vector<int>& values)
+{
+    while (!text.empty())
+    {
+        const auto end = std::min(text.find(','), text.size());
+        int value;
+        const auto result = std::from_chars(text.data(), text.data() + end, value);
+        if (end == 0 || result.ec != std::errc() || result.ptr != text.data() + end)
+            return false;
+        values.push_back(value);
+        text.remove_prefix(std::min(end + 1, text.size()));
+    }
+    return !values.empty();
+}
+
+/**
+ * @brief Append " <value>" for each value.
+ */
+template <typename Values>
+void appendList(std::string& response, const Values& values)
+{
+    for (const auto value : values)
+    {
+        response += ' ';
+        response += std::to_string(value);
+    }
+}
+
+/**
+ * @brief Append the shows as id,theaterId,movieId,startTime.
+ */
+void appendShows(std::string& response, const std::vector<ShowInfo>& shows)
+{
+    for (const auto& show : shows)
+    {
+        response += ' ';
+        response += std::to_string(show.id) + ',' + std::to_string(show.theaterId) + ',' +
+                    std::to_string(show.movieId) + ',' + std::to_string(show.startTime);
+    }
+}
+
+/**
+ * @brief "OK" if succeeded, otherwise "ERR <reason>".
+ */
+void status(std::string& response, bool succeeded, const char* reason)
+{
+    if (succeeded)
+    {
+        response += "OK";
+    }
+    else
+    {
+        response += "ERR ";
+        response += reason;
+    }
+}
+
+/**
+ * @brief Name of a batch booking status on the wire.
+ */
+const char* statusName(MovieBookingService::BookingStatus status)
+{
+    switch (status)
+    {
+    case MovieBookingService::BookingStatus::Booked:
+        return "BOOKED";
+    case MovieBookingService::BookingStatus::Conflict:
+        return "CONFLICT";
+    case MovieBookingService::BookingStatus::UnknownTheater:
+        return "UNKNOWN_THEATER";
+    case MovieBookingService::BookingStatus::NoSeats:
+        break;
+    }
+    return "NO_SEATS";
+}
+
+/**
+ * @brief Handles one command; returns false if its arguments are malformed.
+ */
+using Options = ServiceProtocol::Options;
+using Command = bool (*)(MovieBookingService& service, const Options& options, Arguments& args, std::string& response);
+
+/**
+ * @brief Every command by name.
+ */
+const std::unordered_map<std::string_view, Command>& commands()
+{
+    static const std::unordered_map<std::string_view, Command> table = {
+        {"PING", [](MovieBookingService&, const Options&, Arguments& args, std::string& response) {
+            response += "OK";
+            return args.done();
+        }},
+        {"ADD_MOVIE", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int id;
+            if (!args.next(id))
+                return false;
+            const auto name = args.rest();
+            if (name.empty())
+                return false;
+            status(response, service.addMovie(std::make_unique<Movie>(id, name)), "rejected");
+            return true;
+        }},
+        {"ADD_THEATER", [](MovieBookingService& service, const Options& options, Arguments& args,
+                           std::string& response) {
+            int id;
+            int seatCount;
+            if (!args.next(id) || !args.next(seatCount) || seatCount <= 0 || seatCount > options.maxTheaterSeats)
+                return false;
+            const auto name = args.rest();
+            if (name.empty())
+                return false;
+            status(response, service.addTheater(std::make_unique<Theater>(id, name, numberedSeats(seatCount))),
+                   "rejected");
+            return true;
+        }},
+        {"ADD_SHOW", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            ShowInfo show;
+            if (!args.next(show.id) || !args.next(show.theaterId) || !args.next(show.movieId) ||
+                !args.next(show.startTime) || !args.done())
+                return false;
+            status(response, service.addShow(show), "rejected");
+            return true;
+        }},
+        {"LOAD_CATALOG", [](MovieBookingService& service, const Options& options, Arguments& args,
+                            std::string& response) {
+            const std::string path(args.rest());
+            if (!options.allowFileLoads)
+            {
+                status(response, false, "file loads disabled");
+                return true;
+            }
+            std::ifstream input(path);
+            if (path.empty() || !input)
+                return false;
+            response += "OK " + std::to_string(CatalogLoader::load(input, service));
+            return true;
+        }},
+        {"LOAD_IMAGE", [](MovieBookingService& service, const Options& options, Arguments& args,
+                          std::string& response) {
+            const std::string path(args.rest());
+            if (!options.allowFileLoads)
+            {
+                status(response, false, "file loads disabled");
+                return true;
+            }
+            if (path.empty())
+                return false;
+            status(response, service.loadCatalogImage(path), "cannot load image");
+            return true;
+        }},
+        {"MOVIES", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            response += "OK";
+            appendList(response, service.getAllMovies());
+            return args.done();
+        }},
+        {"MOVIES_AVAILABLE", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            response += "OK";
+            appendList(response, service.getMoviesWithAvailability());
+            return args.done();
+        }},
+        {"THEATERS", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int movieId;
+            std::vector<int> theaterIds;
+            if (!args.next(movieId) || !args.done())
+                return false;
+            status(response, service.getTheatersForMovie(movieId, theaterIds), "unknown movie");
+            appendList(response, theaterIds);
+            return true;
+        }},
+        {"SHOWS_FOR_MOVIE", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int movieId;
+            if (!args.next(movieId) || !args.done())
+                return false;
+            const auto shows = service.getShowsForMovie(movieId);
+            response += "OK";
+            appendShows(response, shows);
+            return true;
+        }},
+        {"SHOWS_FOR_THEATER", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int theaterId;
+            if (!args.next(theaterId) || !args.done())
+                return false;
+            const auto shows = service.getShowsForTheater(theaterId);
+            response += "OK";
+            appendShows(response, shows);
+            return true;
+        }},
+        {"SEATS", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int theaterId;
+            std::vector<int> seatIds;
+            if (!args.next(theaterId) || !args.done())
+                return false;
+            status(response, service.getAvailableSeats(theaterId, seatIds), "unknown theater");
+            appendList(response, seatIds);
+            return true;
+        }},
+        {"SEAT_COUNT", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int theaterId;
+            if (!args.next(theaterId) || !args.done())
+                return false;
+            response += "OK " + std::to_string(service.getAvailableSeatCount(theaterId));
+            return true;
+        }},
+        {"MOVIE_SEAT_COUNT", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int movieId;
+            if (!args.next(movieId) || !args.done())
+                return false;
+            response += "OK " + std::to_string(service.getMovieAvailableSeatCount(movieId));
+            return true;
+        }},
+        {"BEST", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int theaterId;
+            int partySize;
+            if (!args.next(theaterId) || !args.next(partySize) || !args.done())
+                return false;
+            response += "OK";
+            appendList(response, service.findBestAvailable(theaterId, partySize));
+            return true;
+        }},
+        {"SHOW_SEATS", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int showId;
+            if (!args.next(showId) || !args.done())
+                return false;
+            response += "OK";
+            appendList(response, service.getAvailableShowSeats(showId));
+            return true;
+        }},
+        {"SHOW_BEST", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int showId;
+            int partySize;
+            if (!args.next(showId) || !args.next(partySize) || !args.done())
+                return false;
+            response += "OK";
+            appendList(response, service.findBestAvailableForShow(showId, partySize));
+            return true;
+        }},
+        {"SHOW", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int showId;
+            if (!args.next(showId) || !args.done())
+                return false;
+            const auto show = service.findShow(showId);
+            status(response, show.has_value(), "unknown show");
+            if (show)
+                appendShows(response, {*show});
+            return true;
+        }},
+        {"BOOK", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int theaterId;
+            std::vector<int> seatIds;
+            if (!args.next(theaterId) || !args.ints(seatIds))
+                return false;
+            status(response, service.bookSeats(theaterId, seatIds), "unavailable");
+            return true;
+        }},
+        {"BOOK_SHOW", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int showId;
+            std::vector<int> seatIds;
+            if (!args.next(showId) || !args.ints(seatIds))
+                return false;
+            status(response, service.bookShowSeats(showId, seatIds), "unavailable");
+            return true;
+        }},
+        {"BOOK_BATCH", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            std::vector<MovieBookingService::BookingRequest> requests;
+            while (!args.done())
+            {
+                MovieBookingService::BookingRequest request;
+                if (!args.next(request.requestId) || !args.next(request.theaterId) ||
+                    !parseList(args.next(), request.seatIds))
+                    return false;
+                requests.push_back(std::move(request));
+            }
+            if (requests.empty())
+                return false;
+
+            response += "OK";
+            for (const auto& result : service.bookBatch(requests))
+            {
+                response += ' ' + std::to_string(result.requestId) + ':' + statusName(result.status);
+                for (std::size_t i = 0; i < result.conflictingSeats.size(); ++i)
+                {
+                    response += (i == 0 ? ':' : ',') + std::to_string(result.conflictingSeats[i]);
+                }
+            }
+            return true;
+        }},
+        {"HOLD", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int theaterId;
+            std::int64_t ttl;
+            std::vector<int> seatIds;
+            if (!args.next(theaterId) || !args.next(ttl) || !args.ints(seatIds))
+                return false;
+            const auto holdId = service.holdSeats(theaterId, seatIds, std::chrono::milliseconds(ttl));
+            status(response, holdId.has_value(), "unavailable");
+            if (holdId)
+                response += ' ' + std::to_string(*holdId);
+            return true;
+        }},
+        {"HOLD_SHOW", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int showId;
+            std::int64_t ttl;
+            std::vector<int> seatIds;
+            if (!args.next(showId) || !args.next(ttl) || !args.ints(seatIds))
+                return false;
+            const auto holdId = service.holdShowSeats(showId, seatIds, std::chrono::milliseconds(ttl));
+            status(response, holdId.has_value(), "unavailable");
+            if (holdId)
+                response += ' ' + std::to_string(*holdId);
+            return true;
+        }},
+        {"CONFIRM", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            MovieBookingService::HoldId holdId;
+            if (!args.next(holdId) || !args.done())
+                return false;
+            status(response, service.confirmHold(holdId), "unknown hold");
+            return true;
+        }},
+        {"RELEASE", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            MovieBookingService::HoldId holdId;
+            if (!args.next(holdId) || !args.done())
+                return false;
+            status(response, service.releaseHold(holdId), "unknown hold");
+            return true;
+        }},
+        {"EXPIRE", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            if (!args.done())
+                return false;
+            response += "OK " + std::to_string(service.expireHolds());
+            return true;
+        }},
+        {"CHECKPOINT", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            if (!args.done())
+                return false;
+            service.checkpoint();
+            response += "OK";
+            return true;
+        }},
+        {"IS_MOVIE", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int movieId;
+            if (!args.next(movieId) || !args.done())
+                return false;
+            response += service.isValidMovie(movieId) ? "OK 1" : "OK 0";
+            return true;
+        }},
+        {"SHOWN_IN", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int theaterId;
+            int movieId;
+            if (!args.next(theaterId) || !args.next(movieId) || !args.done())
+                return false;
+            response += service.isMovieShownInTheater(theaterId, movieId) ? "OK 1" : "OK 0";
+            return true;
+        }},
+        {"MOVIE_NAME", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int movieId;
+            if (!args.next(movieId) || !args.done())
+                return false;
+            const auto name = service.findMovieName(movieId);
+            status(response, name.has_value(), "unknown movie");
+            if (name)
+                response.append(" ").append(*name);
+            return true;
+        }},
+        {"THEATER_NAME", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            int theaterId;
+            if (!args.next(theaterId) || !args.done())
+                return false;
+            const auto name = service.findTheaterName(theaterId);
+            status(response, name.has_value(), "unknown theater");
+            if (name)
+                response.append(" ").append(*name);
+            return true;
+        }},
+        {"EVENT_SEQUENCE", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            response += "OK " + std::to_string(service.getEventSequence());
+            return args.done();
+        }},
+        {"REPL_SEQUENCE", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            if (!args.done())
+                return false;
+            const auto logId = service.getReplicationLogId();
+            status(response, logId != 0, "replication off");
+            if (logId != 0)
+                response += ' ' + std::to_string(logId) + ' ' + std::to_string(service.getReplicationSequence());
+            return true;
+        }},
+        {"REPL_SNAPSHOT", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            if (!args.done())
+                return false;
+            std::vector<std::string> records;
+            const auto sequence = service.getReplicationSnapshot(records);
+            response += "OK " + std::to_string(service.getReplicationLogId()) + ' ' + std::to_string(sequence);
+            for (const auto& record : records)
+            {
+                response += ' ';
+                ServiceProtocol::encodeRecord(record, response);
+            }
+            return true;
+        }},
+        {"REPL_PULL", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            std::uint64_t logId;
+            std::uint64_t after;
+            std::size_t maxRecords;
+            if (!args.next(logId) || !args.next(after) || !args.next(maxRecords) || !args.done())
+                return false;
+
+            // Sampled first, so a replica that applied what it got is at least this current
+            const auto sequence = service.getReplicationSequence();
+            std::vector<std::string> records;
+            const auto read = service.readReplicationLog(logId, after, records, maxRecords);
+            status(response, read == ReplicationLog::ReadStatus::Ok, "lapped");
+            if (read != ReplicationLog::ReadStatus::Ok)
+                return true;
+            response += ' ' + std::to_string(sequence);
+            for (const auto& record : records)
+            {
+                response += ' ';
+                ServiceProtocol::encodeRecord(record, response);
+            }
+            return true;
+        }},
+        {"METRICS", [](MovieBookingService& service, const Options&, Arguments& args, std::string& response) {
+            auto metrics = service.dumpMetrics(ServiceMetrics::Format::Json);
+            std::replace(metrics.begin(), metrics.end(), '\n', ' ');
+            response += "OK " + metrics;
+            return args.done();
+        }},
+    };
+    return table;
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+ServiceProtocol::ServiceProtocol(MovieBookingService& service):
+ServiceProtocol(service, Options())
+{
+}
+
+/*----------------------------------------------------*/
+ServiceProtocol::ServiceProtocol(MovieBookingService& service, Options options):
+mService(service), mOptions(options)
+{
+}
+
+/*----------------------------------------------------*/
+bool ServiceProtocol::isCommand(std::string_view command)
+{
+    return commands().count(command) != 0;
+}
+
+/*----------------------------------------------------*/
+void ServiceProtocol::encodeRecord(std::string_view record, std::string& output)
+{
+    static constexpr char kDigits[] = "0123456789abcdef";
+    for (const char c : record)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        output += kDigits[byte >> 4];
+        output += kDigits[byte & 0xf];
+    }
+}
+
+/*----------------------------------------------------*/
+bool ServiceProtocol::decodeRecord(std::string_view text, std::string& record)
+{
+    const auto digit = [](char c) {
+        return c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+    };
+    record.clear();
+    if (text.size() % 2 != 0)
+        return false;
+    for (std::size_t i = 0; i < text.size(); i += 2)
+    {
+        const int high = digit(text[i]);
+        const int low = digit(text[i + 1]);
+        if (high < 0 || low < 0)
+            return false;
+        record += static_cast<char>((high << 4) | low);
+    }
+    return true;
+}
+
+/*----------------------------------------------------*/
+void ServiceProtocol::handle(std::string_view request, std::string& response) const
+{
+    Arguments args(request);
+    const auto itr = commands().find(args.next());
+    if (itr == commands().end())
+    {
+        response += "ERR unknown command";
+        return;
+    }
+
+    const std::size_t start = response.size();
+    try
+    {
+        if (!itr->second(mService, mOptions, args, response))
+        {
+            response.resize(start);
+            response += "ERR bad arguments";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        response.resize(start);
+        response += "ERR ";
+        response += e.what();
+    }
+}
+/*-------------------END-------------------------------*/
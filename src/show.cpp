@@ -0,0 +1,38 @@
+/**
+ * @file show.cpp
+ * @brief Implementation for Show class
+ * @author Gebremedhin Abreha
+ */
+
+#include "show.hpp"
+
+/*----------------------------------------------------*/
+Show::Show(const ShowInfo& info, std::shared_ptr<const SeatLayout> layout):
+mInfo(info), mSeats(std::move(layout))
+{
+}
+
+/*----------------------------------------------------*/
+const ShowInfo& Show::getInfo() const
+{
+    return mInfo;
+}
+
+/*----------------------------------------------------*/
+int Show::getId() const
+{
+    return mInfo.id;
+}
+
+/*----------------------------------------------------*/
+SeatInventory& Show::getSeats()
+{
+    return mSeats;
+}
+
+/*----------------------------------------------------*/
+const SeatInventory& Show::getSeats() const
+{
+    return mSeats;
+}
+/*-------------------END-------------------------------*/
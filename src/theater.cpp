@@ -5,77 +5,155 @@
  */
 
 #include "theater.hpp"
+#include "name_pool.hpp"
 
 /*----------------------------------------------------*/
-Theater::Theater (const int& id, const std::string& name, const std::vector<Seat>& seats):
-mId(id), mName(name), mSeats(seats), mIsAllocated(false)
+TheaterBase::TheaterBase (const int& id, std::string_view name):
+mId(id), mName(NamePool::shared().intern(name)), mIsAllocated(false)
 {
 }
 
 /*----------------------------------------------------*/
-bool Theater::bookSeat(const int& seatId)
+Theater::Theater (const int& id, std::string_view name, const std::vector<Seat>& seats):
+TheaterBase(id, name), mSeats(std::make_shared<const SeatLayout>(seats))
 {
-    for (auto& seat: mSeats)
+    for (const auto& seat: seats)
     {
-        if (seat.id == seatId)
-        {
-            if (seat.isBooked)
-                return false; //Already booked
-            else
-            {
-                seat.isBooked = true;
-                return true;
-            }
-        }
+        if (seat.isBooked)
+            mSeats.bookSeat(seat.id);
     }
-    
-    return false;
+}
+
+/*----------------------------------------------------*/
+Theater::Theater (const int& id, std::string_view name, std::shared_ptr<const SeatLayout> layout):
+TheaterBase(id, name), mSeats(std::move(layout))
+{
+}
+
+/*----------------------------------------------------*/
+bool Theater::bookSeat(const int& seatId)
+{
+    return mSeats.bookSeat(seatId);
+}
+
+/*----------------------------------------------------*/
+bool Theater::bookSeats(const std::vector<int>& ids)
+{
+    return mSeats.bookSeats(ids);
+}
+
+/*----------------------------------------------------*/
+bool Theater::holdSeats(const std::vector<int>& ids)
+{
+    return mSeats.holdSeats(ids);
+}
+
+/*----------------------------------------------------*/
+bool Theater::confirmSeats(const std::vector<int>& ids)
+{
+    return mSeats.confirmSeats(ids);
+}
+
+/*----------------------------------------------------*/
+bool Theater::releaseSeats(const std::vector<int>& ids)
+{
+    return mSeats.releaseSeats(ids);
+}
+
+/*----------------------------------------------------*/
+bool Theater::cancelSeats(const std::vector<int>& ids)
+{
+    return mSeats.cancelSeats(ids);
+}
+
+/*----------------------------------------------------*/
+SeatState Theater::getSeatState(const int& id) const
+{
+    return mSeats.getSeatState(id);
+}
+
+/*----------------------------------------------------*/
+std::vector<Seat> Theater::getSeats() const
+{
+    return mSeats.getSeats();
 }
 
 /*----------------------------------------------------*/
 std::vector<int> Theater::getAvailableSeats() const
 {
-    std::vector<int> availableSeats;
+    return mSeats.getAvailableSeats();
+}
+
+/*----------------------------------------------------*/
+void Theater::appendAvailableSeats(std::vector<int>& seatIds) const
+{
+    mSeats.appendAvailableSeats(seatIds);
+}
+
+/*----------------------------------------------------*/
+std::size_t Theater::getAvailableSeatCount() const
+{
+    return mSeats.getAvailableSeatCount();
+}
+
+/*----------------------------------------------------*/
+std::vector<int> Theater::findBestAvailable(std::size_t partySize) const
+{
+    return mSeats.findBestAvailable(partySize);
+}
+
+/*----------------------------------------------------*/
+std::string Theater::getSeatNumber(const int& id) const
+{
+    return mSeats.getSeatNumber(id);
+}
+
+/*----------------------------------------------------*/
+std::shared_ptr<const SeatLayout> Theater::getLayout() const
+{
+    return mSeats.getLayout();
+}
+
+/*----------------------------------------------------*/
+bool Theater::attachAvailabilityCounter(std::shared_ptr<std::atomic<std::int64_t>> counter)
+{
+    return mSeats.attachAvailabilityCounter(std::move(counter));
+}
+
+/*----------------------------------------------------*/
+std::string TheaterBase::getName() const
+{
+    return std::string(mName);
     
-    for (const auto& seat: mSeats)
-    {
-        if(!seat.isBooked)
-        {
-            availableSeats.push_back(seat.id);
-        }
-    }
-        
-    return availableSeats;
 }
 
 /*----------------------------------------------------*/
-std::string Theater::getName() const
+std::string_view TheaterBase::getNameView() const
 {
     return mName;
-    
 }
 
 /*----------------------------------------------------*/
-int Theater::getId() const
+int TheaterBase::getId() const
 {
     return mId;
     
 }
 
 /*----------------------------------------------------*/
-void Theater::setAllocated (bool value)
+void TheaterBase::setAllocated (bool value)
 {
     mIsAllocated = value;
 }
 
 /*----------------------------------------------------*/
-bool Theater::isAllocated () const
+bool TheaterBase::isAllocated () const
 {
     return mIsAllocated;
 }
 
 /*----------------------------------------------------*/
-bool Theater::operator == (const Theater &rhs) const
+bool TheaterBase::operator == (const TheaterBase &rhs) const
 {
     if (mId == rhs.mId)
         return true;
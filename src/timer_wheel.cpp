@@ -0,0 +1,122 @@
+/**
+ * @file timer_wheel.cpp
+ * @brief Implementation for TimerWheel class
+ * @author Gebremedhin Abreha
+ */
+
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+
+/*----------------------------------------------------*/
+TimerWheel::TimerWheel(std::uint64_t now):
+mNow(now), mSize(0)
+{
+}
+
+/*----------------------------------------------------*/
+void TimerWheel::schedule(TimerId id, std::uint64_t expiry)
+{
+    // The slot of the current tick has already been processed
+    place({id, std::max(expiry, mNow + 1)});
+    ++mSize;
+}
+
+/*----------------------------------------------------*/
+void TimerWheel::place(const Entry& entry)
+{
+    const std::uint64_t delay = entry.expiry > mNow ? entry.expiry - mNow : 0;
+
+    for (std::size_t level = 0; level < kLevels; ++level)
+    {
+        const std::size_t shift = level * kSlotBits;
+        if (delay < (std::uint64_t{1} << (shift + kSlotBits)))
+        {
+            mWheel[level][(entry.expiry >> shift) & (kSlots - 1)].push_back(entry);
+            ++mLevelSize[level];
+            return;
+        }
+    }
+
+    // Beyond the wheel's span: park in the farthest top slot, re-placed on cascade
+    const std::size_t shift = (kLevels - 1) * kSlotBits;
+    mWheel[kLevels - 1][((mNow >> shift) - 1) & (kSlots - 1)].push_back(entry);
+    ++mLevelSize[kLevels - 1];
+}
+
+/*----------------------------------------------------*/
+void TimerWheel::cascade(std::size_t level, std::size_t slot)
+{
+    Slot entries;
+    entries.swap(mWheel[level][slot]);
+    mLevelSize[level] -= entries.size();
+    for (const auto& entry : entries)
+    {
+        place(entry);
+    }
+}
+
+/*----------------------------------------------------*/
+void TimerWheel::advance(std::uint64_t now, std::vector<TimerId>& expired)
+{
+    while (mNow < now)
+    {
+        if (mSize == 0)
+        {
+            mNow = now; // Nothing scheduled, skip the idle ticks
+            return;
+        }
+
+        // With the lower levels empty, nothing happens before the next
+        // boundary of the lowest occupied level
+        std::size_t occupied = 0;
+        while (occupied + 1 < kLevels && mLevelSize[occupied] == 0)
+            ++occupied;
+        if (occupied > 0)
+        {
+            const std::uint64_t span = std::uint64_t{1} << (occupied * kSlotBits);
+            mNow = std::min(now - 1, mNow | (span - 1));
+        }
+
+        ++mNow;
+
+        // On a level's wrap-around, pull the current slot of the level above down
+        for (std::size_t level = 1; level < kLevels; ++level)
+        {
+            const std::size_t shift = level * kSlotBits;
+            if ((mNow & ((std::uint64_t{1} << shift) - 1)) != 0)
+                break;
+            cascade(level, (mNow >> shift) & (kSlots - 1));
+        }
+
+        Slot& due = mWheel[0][mNow & (kSlots - 1)];
+        std::size_t kept = 0;
+        for (auto& entry : due)
+        {
+            if (entry.expiry <= mNow)
+            {
+                expired.push_back(entry.id);
+                --mSize;
+                --mLevelSize[0];
+            }
+            else
+            {
+                due[kept++] = entry; // Not due yet
+            }
+        }
+        due.resize(kept);
+    }
+}
+
+/*----------------------------------------------------*/
+std::uint64_t TimerWheel::now() const
+{
+    return mNow;
+}
+
+/*----------------------------------------------------*/
+std::size_t TimerWheel::size() const
+{
+    return mSize;
+}
+/*-------------------END-------------------------------*/
@@ -0,0 +1,299 @@
+/**
+ * @file write_ahead_log.cpp
+ * @brief Implementation for WriteAheadLog class
+ * @author Gebremedhin Abreha
+ */
+
+#include "write_ahead_log.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t kHeaderSize = 2 * sizeof(std::uint32_t); /**< Length + checksum. */
+
+/**
+ * @brief FNV-1a checksum of a record payload.
+ */
+std::uint32_t checksum(const char* data, std::size_t size)
+{
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Throw the current errno as a std::system_error.
+ */
+[[noreturn]] void throwErrno(const std::string& what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/**
+ * @brief Sync the directory containing a path, so renames are durable.
+ */
+void syncDirectory(const std::string& path)
+{
+    const auto slash = path.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+
+    const int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0)
+        throwErrno("open " + directory);
+    ::fsync(fd);
+    ::close(fd);
+}
+
+} // namespace
+
+/*----------------------------------------------------*/
+WriteAheadLog::WriteAheadLog(const std::string& path):
+mPath(path), mFd(-1), mLastSequence(0), mDurableSequence(0), mSyncCount(0), mFlushing(false), mFailed(false)
+{
+    open();
+}
+
+/*----------------------------------------------------*/
+WriteAheadLog::~WriteAheadLog()
+{
+    if (mFd >= 0)
+        ::close(mFd);
+}
+
+/*----------------------------------------------------*/
+void WriteAheadLog::open()
+{
+    mFd = ::open(mPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (mFd < 0)
+        throwErrno("open " + mPath);
+}
+
+/*----------------------------------------------------*/
+void WriteAheadLog::frame(const std::string& record, std::string& buffer)
+{
+    const std::uint32_t header[2] = {static_cast<std::uint32_t>(record.size()),
+                                     checksum(record.data(), record.size())};
+    buffer.append(reinterpret_cast<const char*>(header), kHeaderSize);
+    buffer.append(record);
+}
+
+/*----------------------------------------------------*/
+void WriteAheadLog::writeAndSync(int fd, const std::string& buffer)
+{
+    std::size_t written = 0;
+    while (written < buffer.size())
+    {
+        const ssize_t result = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throwErrno("write log");
+        }
+        written += static_cast<std::size_t>(result);
+    }
+
+    if (::fdatasync(fd) != 0)
+        throwErrno("fdatasync log");
+}
+
+/*----------------------------------------------------*/
+std::uint64_t WriteAheadLog::append(const std::string& record)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    const std::uint64_t sequence = ++mLastSequence;
+    frame(record, mPending);
+
+    while (mDurableSequence < sequence)
+    {
+        if (mFailed)
+            throw std::system_error(EIO, std::generic_category(), "log failed");
+
+        if (mFlushing)
+        {
+            // A leader is syncing an earlier batch; ours goes in the next one
+            mSynced.wait(lock);
+            continue;
+        }
+
+        // Become the leader: write everything queued so far in one batch
+        mFlushing = true;
+        std::string batch;
+        batch.swap(mPending);
+        const std::uint64_t batchEnd = mLastSequence;
+
+        lock.unlock();
+        try
+        {
+            writeAndSync(mFd, batch);
+        }
+        catch (...)
+        {
+            lock.lock();
+            mFlushing = false;
+            mFailed = true;
+            mSynced.notify_all();
+            throw;
+        }
+        lock.lock();
+
+        mDurableSequence = batchEnd;
+        ++mSyncCount;
+        mFlushing = false;
+        mSynced.notify_all();
+    }
+    return sequence;
+}
+
+/*----------------------------------------------------*/
+std::size_t WriteAheadLog::recover(const std::function<void(const std::string&)>& visit)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::size_t count = readRecords(rotatedPath(), visit);
+
+    std::size_t validSize = 0;
+    count += readRecords(mPath, visit, &validSize);
+    if (::ftruncate(mFd, static_cast<off_t>(validSize)) != 0 || ::fdatasync(mFd) != 0)
+        throwErrno("truncate " + mPath);
+
+    return count;
+}
+
+/*----------------------------------------------------*/
+void WriteAheadLog::rotate()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mSynced.wait(lock, [this]() { return !mFlushing; });
+
+    if (!mPending.empty())
+    {
+        writeAndSync(mFd, mPending);
+        mPending.clear();
+        mDurableSequence = mLastSequence;
+        ++mSyncCount;
+        mSynced.notify_all();
+    }
+
+    ::close(mFd);
+    mFd = -1;
+    if (std::rename(mPath.c_str(), rotatedPath().c_str()) != 0)
+        throwErrno("rename " + mPath);
+    open();
+    syncDirectory(mPath);
+}
+
+/*----------------------------------------------------*/
+void WriteAheadLog::removeRotated()
+{
+    if (::unlink(rotatedPath().c_str()) != 0 && errno != ENOENT)
+        throwErrno("unlink " + rotatedPath());
+    syncDirectory(mPath);
+}
+
+/*----------------------------------------------------*/
+bool WriteAheadLog::hasRotated() const
+{
+    return ::access(rotatedPath().c_str(), F_OK) == 0;
+}
+
+/*----------------------------------------------------*/
+const std::string& WriteAheadLog::path() const
+{
+    return mPath;
+}
+
+/*----------------------------------------------------*/
+std::string WriteAheadLog::rotatedPath() const
+{
+    return mPath + ".old";
+}
+
+/*----------------------------------------------------*/
+std::uint64_t WriteAheadLog::syncCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mSyncCount;
+}
+
+/*----------------------------------------------------*/
+std::size_t WriteAheadLog::readRecords(const std::string& path, const std::function<void(const std::string&)>& visit,
+                                      std::size_t* validSize)
+{
+    if (validSize)
+        *validSize = 0;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return 0;
+
+    const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::size_t count = 0;
+    std::size_t offset = 0;
+    while (content.size() - offset >= kHeaderSize)
+    {
+        std::uint32_t header[2];
+        std::memcpy(header, content.data() + offset, kHeaderSize);
+        const std::size_t size = header[0];
+
+        if (content.size() - offset - kHeaderSize < size)
+            break; // Torn tail
+        const char* payload = content.data() + offset + kHeaderSize;
+        if (checksum(payload, size) != header[1])
+            break; // Corrupt record
+
+        visit(std::string(payload, size));
+        offset += kHeaderSize + size;
+        ++count;
+    }
+
+    if (validSize)
+        *validSize = offset;
+    return count;
+}
+
+/*----------------------------------------------------*/
+void WriteAheadLog::writeRecords(const std::string& path,
+                                 const std::function<void(const std::function<void(const std::string&)>&)>& records)
+{
+    const std::string temporaryPath = path + ".tmp";
+    const int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throwErrno("open " + temporaryPath);
+
+    try
+    {
+        std::string buffer;
+        records([&](const std::string& record) {
+            frame(record, buffer);
+        });
+        writeAndSync(fd, buffer);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        ::unlink(temporaryPath.c_str());
+        throw;
+    }
+    ::close(fd);
+
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        throwErrno("rename " + temporaryPath);
+    syncDirectory(path);
+}
+/*-------------------END-------------------------------*/
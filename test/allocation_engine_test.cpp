@@ -0,0 +1,103 @@
+/**
+ * @file allocation_engine_test.cpp
+ * @brief Test for AllocationEngine class and the allocations of MovieBookingService
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "allocation_engine.hpp"
+#include "movie_booking_service.hpp"
+#include "movie.hpp"
+#include "theater.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+/*------------------------------------------------------*/
+// Test case for waiting movies and free theaters being paired in the order added
+TEST(AllocationEngineTest, PairsInOrderAdded) {
+    AllocationEngine engine;
+    engine.addTheater(7);
+    engine.addTheater(3);
+    engine.addMovie(2);
+    engine.addMovie(1);
+    engine.addMovie(5);
+
+    EXPECT_EQ(engine.allocateNext(), AllocationEngine::Allocation(2, 7));
+    EXPECT_EQ(engine.allocateNext(), AllocationEngine::Allocation(1, 3));
+    EXPECT_FALSE(engine.allocateNext().has_value()); // Movie 5 waits for a theater
+
+    engine.addTheater(9);
+    EXPECT_EQ(engine.allocateNext(), AllocationEngine::Allocation(5, 9));
+
+    EXPECT_TRUE(engine.isShownIn(3, 1));
+    EXPECT_FALSE(engine.isShownIn(3, 2));
+    EXPECT_EQ(engine.getMovie(9), 5);
+    EXPECT_FALSE(engine.getMovie(4).has_value());
+    EXPECT_EQ(engine.getTheaters(2), (std::vector<int>{7}));
+    EXPECT_TRUE(engine.getTheaters(8).empty());
+}
+
+/*------------------------------------------------------*/
+// Test case for explicit allocations leaving the queues
+TEST(AllocationEngineTest, ExplicitAllocationSkipsQueues) {
+    AllocationEngine engine;
+    engine.addTheater(1);
+    engine.addTheater(2);
+    engine.addMovie(10);
+    engine.addMovie(20);
+
+    EXPECT_TRUE(engine.allocate(10, 1));
+    EXPECT_FALSE(engine.allocate(20, 1)); // Theater 1 shows a movie already
+    EXPECT_TRUE(engine.isMovieAllocated(10));
+    EXPECT_TRUE(engine.isTheaterAllocated(1));
+
+    EXPECT_EQ(engine.allocateNext(), AllocationEngine::Allocation(20, 2));
+    EXPECT_FALSE(engine.allocateNext().has_value());
+}
+
+/*------------------------------------------------------*/
+// Test case for free theaters being filled with random movies
+TEST(AllocationEngineTest, FillsFreeTheaters) {
+    AllocationEngine engine;
+    std::mt19937 random(1);
+    engine.addTheater(1);
+    EXPECT_FALSE(engine.fillNext(random).has_value()); // No movies
+
+    engine.addMovie(10);
+    engine.addMovie(20);
+    ASSERT_TRUE(engine.allocateNext().has_value());
+    engine.addTheater(2);
+    engine.addTheater(3);
+
+    std::size_t filled = 0;
+    while (const auto allocation = engine.fillNext(random))
+    {
+        EXPECT_TRUE(allocation->first == 10 || allocation->first == 20);
+        ++filled;
+    }
+    EXPECT_EQ(filled, 2u);
+    EXPECT_EQ(engine.getTheaters(10).size() + engine.getTheaters(20).size(), 3u);
+}
+
+/*------------------------------------------------------*/
+// Test case for the service allocating through the engine
+TEST(AllocationEngineTest, ServiceAllocatesEveryTheater) {
+    const std::vector<Seat> seats{Seat{0, "Seat 1", false}};
+    MovieBookingService service;
+
+    // Movies with IDs far from 1..n used to break the random pick
+    service.addMovie(std::make_unique<Movie>(100, "Movie100"));
+    service.addMovie(std::make_unique<Movie>(200, "Movie200"));
+    EXPECT_TRUE(service.getTheatersForMovie(100).empty());
+
+    for (int id = 1; id <= 5; ++id)
+    {
+        EXPECT_TRUE(service.addTheater(std::make_unique<Theater>(id, "Theater", seats)));
+    }
+    EXPECT_EQ(service.getTheatersForMovie(100).front(), 1);
+    EXPECT_EQ(service.getTheatersForMovie(200).front(), 2);
+    EXPECT_EQ(service.getTheatersForMovie(100).size() + service.getTheatersForMovie(200).size(), 5u);
+    EXPECT_TRUE(service.isMovieShownInTheater(1, 100));
+    EXPECT_FALSE(service.isMovieShownInTheater(1, 200));
+}
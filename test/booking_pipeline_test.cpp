@@ -0,0 +1,104 @@
+/**
+ * @file booking_pipeline_test.cpp
+ * @brief Test for BookingPipeline class
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "booking_pipeline.hpp"
+#include "movie_booking_service.hpp"
+#include "test_service.hpp"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Status = MovieBookingService::BookingStatus;
+
+} // namespace
+
+/*------------------------------------------------------*/
+// Test case for futures completing with each booking's result
+TEST(BookingPipelineTest, CompletesFutures) {
+    auto service = makeService({1}, 4, 8, 0);
+    BookingPipeline pipeline(*service, 2);
+    EXPECT_EQ(pipeline.shardCount(), 2u);
+    EXPECT_EQ(pipeline.shardOf(3), pipeline.shardOf(1));
+
+    auto first = pipeline.submit({1, 3, {0, 1}});
+    auto second = pipeline.submit({2, 3, {1, 2}}); // Queued after the first by this thread
+    auto other = pipeline.submit({3, 2, {1, 2}});
+    auto unknown = pipeline.submit({4, 9, {0}});
+
+    EXPECT_EQ(first.get().status, Status::Booked);
+    const auto conflict = second.get();
+    EXPECT_EQ(conflict.requestId, 2u);
+    EXPECT_EQ(conflict.status, Status::Conflict);
+    EXPECT_EQ(conflict.conflictingSeats, (std::vector<int>{1}));
+    EXPECT_EQ(other.get().status, Status::Booked);
+    EXPECT_EQ(unknown.get().status, Status::UnknownTheater);
+    EXPECT_EQ(service->getAvailableSeats(3), (std::vector<int>{2, 3, 4, 5, 6, 7}));
+}
+
+/*------------------------------------------------------*/
+// Test case for many submitting threads: every seat is sold exactly once
+TEST(BookingPipelineTest, ConcurrentSubmittersNoOverbooking) {
+    const int theaters = 6;
+    const int seats = 200;
+    const int clients = 4;
+    auto service = makeService({1}, theaters, seats, 0);
+    std::atomic<int> booked{0};
+    {
+        BookingPipeline pipeline(*service, 3, true);
+        std::vector<std::thread> threads;
+        for (int c = 0; c < clients; ++c)
+        {
+            threads.emplace_back([&pipeline, &booked, c]() {
+                std::vector<std::future<BookingPipeline::Result>> results;
+                for (int i = 0; i < theaters * seats; ++i)
+                {
+                    // Every client wants every seat, starting at different places
+                    const int k = (i + c * 97) % (theaters * seats);
+                    results.push_back(pipeline.submit({static_cast<std::uint64_t>(i), k % theaters, {k / theaters}}));
+                }
+                for (auto& result : results)
+                {
+                    if (result.get().status == Status::Booked)
+                        ++booked;
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    EXPECT_EQ(booked.load(), theaters * seats);
+    for (int id = 0; id < theaters; ++id)
+    {
+        EXPECT_TRUE(service->getAvailableSeats(id).empty());
+    }
+}
+
+/*------------------------------------------------------*/
+// Test case for the destructor booking what is still queued
+TEST(BookingPipelineTest, DestructorDrainsQueues) {
+    auto service = makeService({1}, 2, 64, 0);
+    std::vector<std::future<BookingPipeline::Result>> results;
+    {
+        BookingPipeline pipeline(*service, 1);
+        for (int seat = 0; seat < 64; ++seat)
+        {
+            results.push_back(pipeline.submit({static_cast<std::uint64_t>(seat), seat % 2, {seat}}));
+        }
+    }
+    for (auto& result : results)
+    {
+        ASSERT_EQ(result.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+        EXPECT_EQ(result.get().status, Status::Booked);
+    }
+    EXPECT_EQ(service->getAvailableSeats(0).size(), 32u);
+}
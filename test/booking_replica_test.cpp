@@ -0,0 +1,192 @@
+/**
+ * @file booking_replica_test.cpp
+ * @brief Test for ReplicationLog and BookingReplica classes and service replication
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "booking_replica.hpp"
+#include "booking_server.hpp"
+#include "movie_booking_service.hpp"
+#include "replication_log.hpp"
+#include "service_protocol.hpp"
+#include "test_service.hpp"
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief A replicating primary behind a server on a Unix socket.
+ */
+class BookingReplicaTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        mPrimary.enableReplication(8);
+        BookingServer::Options options;
+        options.unixPath = "/tmp/booking_replica_test_" + std::to_string(::getpid()) + ".sock";
+        mServer = std::make_unique<BookingServer>([this](std::string_view request, std::string& response) {
+            mProtocol.handle(request, response);
+        }, options);
+        mReplicaOptions.primary = options.unixPath;
+    }
+
+    std::string read(const BookingReplica& replica, std::string_view request) const
+    {
+        std::string response;
+        replica.handle(request, response);
+        return response;
+    }
+
+    MovieBookingService mPrimary;
+    ServiceProtocol mProtocol{mPrimary};
+    std::unique_ptr<BookingServer> mServer;
+    BookingReplica::Options mReplicaOptions;
+};
+
+} // namespace
+
+/*------------------------------------------------------*/
+// Test case for numbering, reading after a position and being lapped
+TEST(ReplicationLogTest, ReadsAfterPositionUntilLapped) {
+    ReplicationLog log(3);
+    std::vector<std::string> records;
+    EXPECT_EQ(log.read(log.id(), 0, records, 10), ReplicationLog::ReadStatus::Ok);
+    EXPECT_TRUE(records.empty());
+
+    for (const char* record : {"a", "b", "c", "d"})
+        log.append(record);
+    EXPECT_EQ(log.lastSequence(), 4u);
+
+    EXPECT_EQ(log.read(log.id(), 1, records, 10), ReplicationLog::ReadStatus::Ok);
+    EXPECT_EQ(records, (std::vector<std::string>{"b", "c", "d"}));
+    EXPECT_EQ(log.read(log.id(), 2, records, 1), ReplicationLog::ReadStatus::Ok);
+    EXPECT_EQ(records, (std::vector<std::string>{"c"}));
+    EXPECT_EQ(log.read(log.id(), 4, records, 10), ReplicationLog::ReadStatus::Ok);
+    EXPECT_TRUE(records.empty());
+
+    EXPECT_EQ(log.read(log.id(), 0, records, 10), ReplicationLog::ReadStatus::Lapped); // "a" is gone
+    EXPECT_EQ(log.read(log.id(), 5, records, 10), ReplicationLog::ReadStatus::Lapped); // Not there yet
+    EXPECT_EQ(log.read(log.id() + 1, 3, records, 10), ReplicationLog::ReadStatus::Lapped); // Another log
+    EXPECT_THROW(ReplicationLog(0), std::invalid_argument);
+}
+
+/*------------------------------------------------------*/
+// Test case for a snapshot plus the records after it reproducing the primary
+TEST(ServiceReplicationTest, SnapshotAndRecordsReproducePrimary) {
+    MovieBookingService primary;
+    std::vector<std::string> records;
+    EXPECT_EQ(primary.readReplicationLog(0, 0, records, 10), ReplicationLog::ReadStatus::Lapped);
+    EXPECT_THROW(primary.getReplicationSnapshot(records), std::logic_error);
+
+    primary.addMovie(std::make_unique<Movie>(1, "Movie01"));
+    primary.addTheater(makeTheater(1, 10));
+    primary.bookSeats(1, {0, 1});
+    primary.enableReplication();
+    EXPECT_EQ(primary.getReplicationSequence(), 0u);
+
+    MovieBookingService replica;
+    const auto sequence = primary.getReplicationSnapshot(records);
+    EXPECT_EQ(sequence, 0u);
+    replica.loadReplicationSnapshot(records);
+    EXPECT_EQ(replica.getAvailableSeats(1), primary.getAvailableSeats(1));
+    EXPECT_EQ(replica.getTheatersForMovie(1), primary.getTheatersForMovie(1));
+
+    // Changes after the snapshot: catalog changes and bookings, a confirmed hold among them
+    primary.addTheater(makeTheater(2, 5));
+    primary.addShow(ShowInfo{7, 2, 1, 1700000000});
+    primary.bookSeats(2, {3});
+    primary.bookShowSeats(7, {0, 4});
+    const auto hold = primary.holdSeats(1, {5, 6}, std::chrono::minutes(1));
+    ASSERT_TRUE(hold.has_value());
+    EXPECT_TRUE(primary.confirmHold(*hold));
+    primary.holdSeats(1, {8}, std::chrono::minutes(1)); // Not replicated
+    EXPECT_EQ(primary.getReplicationSequence(), 5u);
+
+    EXPECT_EQ(primary.readReplicationLog(primary.getReplicationLogId(), sequence, records, 2),
+              ReplicationLog::ReadStatus::Ok);
+    EXPECT_EQ(records.size(), 2u);
+    replica.applyReplicationRecords(records);
+    EXPECT_EQ(primary.readReplicationLog(primary.getReplicationLogId(), sequence + 2, records, 100),
+              ReplicationLog::ReadStatus::Ok);
+    EXPECT_EQ(records.size(), 3u);
+    replica.applyReplicationRecords(records);
+
+    EXPECT_EQ(replica.getAvailableSeats(1), (std::vector<int>{2, 3, 4, 7, 8, 9}));
+    EXPECT_EQ(replica.getAvailableSeats(2), primary.getAvailableSeats(2));
+    EXPECT_EQ(replica.getAvailableShowSeats(7), primary.getAvailableShowSeats(7));
+    EXPECT_EQ(replica.getMovieAvailableSeatCount(1), primary.getMovieAvailableSeatCount(1) + 1); // Seat 8 is held
+    EXPECT_TRUE(replica.findShow(7).has_value());
+
+    // Applying what a snapshot already reflects is harmless
+    replica.applyReplicationRecords(records);
+    EXPECT_EQ(replica.getAvailableSeats(2), primary.getAvailableSeats(2));
+}
+
+/*------------------------------------------------------*/
+// Test case for a replica following a primary over the network
+TEST_F(BookingReplicaTest, FollowsPrimaryAndServesReads) {
+    mPrimary.addMovie(std::make_unique<Movie>(1, "Movie01"));
+    mPrimary.addTheater(makeTheater(1, 10));
+
+    BookingReplica replica(mReplicaOptions);
+    ASSERT_TRUE(replica.waitForSequence(mPrimary.getReplicationSequence(), std::chrono::seconds(10)));
+
+    mPrimary.bookSeats(1, {2, 3});
+    ASSERT_TRUE(replica.waitForSequence(mPrimary.getReplicationSequence(), std::chrono::seconds(10)));
+    EXPECT_EQ(replica.service().getAvailableSeatCount(1), 8u);
+
+    // Fresh once a pull finds nothing newer
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!replica.isFresh() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(read(replica, "SEATS 1"), "OK 0 1 4 5 6 7 8 9");
+    EXPECT_EQ(read(replica, "THEATERS 1"), "OK 1");
+    EXPECT_EQ(read(replica, "PING"), "OK");
+    EXPECT_EQ(read(replica, "REPLICA_STATUS"), "OK " + std::to_string(mPrimary.getReplicationSequence()) + " 1");
+    EXPECT_EQ(read(replica, "BOOK 1 0"), "ERR read-only replica");
+    EXPECT_EQ(read(replica, "FLY 1"), "ERR unknown command");
+    EXPECT_EQ(mPrimary.getAvailableSeatCount(1), 8u);
+}
+
+/*------------------------------------------------------*/
+// Test case for a lapped replica starting over from a snapshot
+TEST_F(BookingReplicaTest, LappedReplicaLoadsSnapshot) {
+    mPrimary.addMovie(std::make_unique<Movie>(1, "Movie01"));
+    mPrimary.addTheater(makeTheater(1, 40));
+
+    mReplicaOptions.pollInterval = std::chrono::milliseconds(100);
+    BookingReplica replica(mReplicaOptions);
+    ASSERT_TRUE(replica.waitForSequence(mPrimary.getReplicationSequence(), std::chrono::seconds(10)));
+
+    // More records than the primary keeps, between two pulls
+    for (int seat = 0; seat < 30; ++seat)
+        mPrimary.bookSeats(1, {seat});
+    ASSERT_TRUE(replica.waitForSequence(mPrimary.getReplicationSequence(), std::chrono::seconds(10)));
+    EXPECT_EQ(replica.service().getAvailableSeats(1), mPrimary.getAvailableSeats(1));
+}
+
+/*------------------------------------------------------*/
+// Test case for refusing reads once the primary is gone
+TEST_F(BookingReplicaTest, StaleReplicaRefusesReads) {
+    mPrimary.addMovie(std::make_unique<Movie>(1, "Movie01"));
+    mReplicaOptions.maxStaleness = std::chrono::milliseconds(50);
+    BookingReplica replica(mReplicaOptions);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!replica.isFresh() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(read(replica, "MOVIES"), "OK 1");
+
+    mServer.reset();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(read(replica, "MOVIES"), "ERR stale replica");
+    EXPECT_EQ(read(replica, "REPLICA_STATUS"), "OK 1 0");
+}
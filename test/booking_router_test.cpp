@@ -0,0 +1,348 @@
+/**
+ * @file booking_router_test.cpp
+ * @brief Test for HashRing and BookingRouter classes
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "booking_client.hpp"
+#include "booking_router.hpp"
+#include "booking_server.hpp"
+#include "hash_ring.hpp"
+#include "movie_booking_service.hpp"
+#include "service_protocol.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Unix socket path for a shard of this test process.
+ */
+std::string shardPath(std::size_t shard)
+{
+    return "/tmp/booking_router_test_" + std::to_string(::getpid()) + "_" + std::to_string(shard) + ".sock";
+}
+
+/**
+ * @brief Join IDs the way the protocol lists them.
+ */
+std::string okList(const std::vector<int>& ids)
+{
+    std::string list = "OK";
+    for (const int id : ids)
+        list += " " + std::to_string(id);
+    return list;
+}
+
+/**
+ * @brief Three services behind servers on Unix sockets, and a router over them.
+ */
+class BookingRouterTest : public ::testing::Test {
+protected:
+    static constexpr std::size_t kShards = 3;
+
+    void SetUp() override
+    {
+        std::vector<std::string> addresses;
+        for (std::size_t shard = 0; shard < kShards; ++shard)
+        {
+            mServices.push_back(std::make_unique<MovieBookingService>());
+            mProtocols.push_back(std::make_unique<ServiceProtocol>(*mServices.back()));
+            BookingServer::Options options;
+            options.unixPath = shardPath(shard);
+            const ServiceProtocol& protocol = *mProtocols.back();
+            mServers.push_back(std::make_unique<BookingServer>([&protocol](std::string_view request, std::string& response) {
+                protocol.handle(request, response);
+            }, options));
+            addresses.push_back(options.unixPath);
+        }
+        mRouter = std::make_unique<BookingRouter>(addresses);
+    }
+
+    std::string call(std::string_view request)
+    {
+        std::string response;
+        mRouter->handle(request, response);
+        return response;
+    }
+
+    std::vector<std::unique_ptr<MovieBookingService>> mServices;
+    std::vector<std::unique_ptr<ServiceProtocol>> mProtocols;
+    std::vector<std::unique_ptr<BookingServer>> mServers;
+    std::unique_ptr<BookingRouter> mRouter;
+};
+
+} // namespace
+
+/*------------------------------------------------------*/
+// Test case for keys spreading evenly over the shards
+TEST(HashRingTest, SpreadsKeysEvenly) {
+    const HashRing ring(4);
+    std::vector<int> counts(4, 0);
+    for (int key = 0; key < 20000; ++key)
+        ++counts[ring.shardOf(key)];
+
+    for (const int count : counts)
+    {
+        EXPECT_GT(count, 20000 / 4 * 7 / 10);
+        EXPECT_LT(count, 20000 / 4 * 13 / 10);
+    }
+    EXPECT_THROW(HashRing(0), std::invalid_argument);
+}
+
+/*------------------------------------------------------*/
+// Test case for adding a shard: only keys moving to it change owner
+TEST(HashRingTest, AddingShardMovesFewKeys) {
+    const HashRing four(4);
+    const HashRing five(5);
+    const HashRing again(4);
+    int moved = 0;
+    for (int key = 0; key < 20000; ++key)
+    {
+        ASSERT_EQ(four.shardOf(key), again.shardOf(key));
+        if (four.shardOf(key) != five.shardOf(key))
+        {
+            ASSERT_EQ(five.shardOf(key), 4u);
+            ++moved;
+        }
+    }
+    EXPECT_GT(moved, 20000 / 5 * 7 / 10);
+    EXPECT_LT(moved, 20000 / 5 * 13 / 10);
+}
+
+/*------------------------------------------------------*/
+// Test case for theaters living on their owner shard only, and merged queries
+TEST_F(BookingRouterTest, PartitionsTheatersAndMergesQueries) {
+    EXPECT_EQ(call("PING"), "OK");
+    EXPECT_EQ(call("ADD_MOVIE 1 Movie01"), "OK");
+    EXPECT_EQ(call("ADD_MOVIE 2 Movie02"), "OK");
+    EXPECT_EQ(call("ADD_MOVIE 2 Again"), "ERR rejected");
+    for (int theater = 1; theater <= 12; ++theater)
+        ASSERT_EQ(call("ADD_THEATER " + std::to_string(theater) + " 10 Theater"), "OK");
+
+    std::set<std::size_t> used;
+    for (int theater = 1; theater <= 12; ++theater)
+    {
+        const std::size_t owner = mRouter->shardOf(theater);
+        used.insert(owner);
+        for (std::size_t shard = 0; shard < kShards; ++shard)
+            EXPECT_EQ(mServices[shard]->getAvailableSeatCount(theater), shard == owner ? 10u : 0u);
+    }
+    EXPECT_GT(used.size(), 1u);
+
+    EXPECT_EQ(call("BOOK 7 0 1"), "OK");
+    EXPECT_EQ(call("BOOK 7 1"), "ERR unavailable");
+    EXPECT_EQ(call("SEAT_COUNT 7"), "OK 8");
+    EXPECT_EQ(mServices[mRouter->shardOf(7)]->getAvailableSeatCount(7), 8u);
+
+    EXPECT_EQ(call("MOVIES"), "OK 1 2");
+    for (const int movie : {1, 2})
+    {
+        std::vector<int> theaters;
+        std::size_t seats = 0;
+        for (const auto& service : mServices)
+        {
+            const auto shardTheaters = service->getTheatersForMovie(movie);
+            theaters.insert(theaters.end(), shardTheaters.begin(), shardTheaters.end());
+            seats += service->getMovieAvailableSeatCount(movie);
+        }
+        std::sort(theaters.begin(), theaters.end());
+        EXPECT_EQ(call("THEATERS " + std::to_string(movie)), okList(theaters));
+        EXPECT_EQ(call("MOVIE_SEAT_COUNT " + std::to_string(movie)), "OK " + std::to_string(seats));
+    }
+    EXPECT_EQ(call("IS_MOVIE 2"), "OK 1");
+    EXPECT_EQ(call("IS_MOVIE 3"), "OK 0");
+    EXPECT_EQ(call("MOVIE_NAME 1"), "OK Movie01");
+    EXPECT_EQ(call("THEATERS 3"), "ERR unknown movie");
+    EXPECT_EQ(call("LOAD_CATALOG /tmp/catalog.csv"), "ERR not supported by the router");
+    EXPECT_EQ(call("BOOK x 1"), "ERR bad arguments");
+    EXPECT_EQ(call("FLY 1"), "ERR unknown command");
+}
+
+/*------------------------------------------------------*/
+// Test case for shows following their theater and merging by start time
+TEST_F(BookingRouterTest, RoutesShowsAndMergesByStartTime) {
+    call("ADD_MOVIE 1 Movie01");
+    for (int theater = 1; theater <= 6; ++theater)
+        call("ADD_THEATER " + std::to_string(theater) + " 10 Theater");
+
+    const int movieTheater = mServices[mRouter->shardOf(1)]->getTheatersForMovie(1).front();
+    for (int theater = 1; theater <= 6; ++theater)
+    {
+        if (!mServices[mRouter->shardOf(theater)]->isMovieShownInTheater(theater, 1))
+            continue;
+        const int show = theater * 10;
+        ASSERT_EQ(call("ADD_SHOW " + std::to_string(show) + " " + std::to_string(theater) + " 1 " +
+                       std::to_string(2000 - theater)), "OK");
+    }
+
+    // Later theaters start earlier, so the merged list runs backwards
+    std::vector<std::string> shows;
+    for (int theater = 6; theater >= 1; --theater)
+    {
+        if (mServices[mRouter->shardOf(theater)]->isMovieShownInTheater(theater, 1))
+            shows.push_back(std::to_string(theater * 10) + "," + std::to_string(theater) + ",1," +
+                            std::to_string(2000 - theater));
+    }
+    std::string expected = "OK";
+    for (const auto& show : shows)
+        expected += " " + show;
+    EXPECT_EQ(call("SHOWS_FOR_MOVIE 1"), expected);
+
+    const std::string show = std::to_string(movieTheater * 10);
+    EXPECT_EQ(call("BOOK_SHOW " + show + " 3"), "OK");
+    EXPECT_EQ(call("SHOW_SEATS " + show), "OK 0 1 2 4 5 6 7 8 9");
+
+    // A router that did not see the show added asks the shards
+    BookingRouter other({shardPath(0), shardPath(1), shardPath(2)});
+    std::string response;
+    other.handle("BOOK_SHOW " + show + " 3", response);
+    EXPECT_EQ(response, "ERR unavailable");
+    response.clear();
+    other.handle("SHOW 999", response);
+    EXPECT_EQ(response, "ERR unknown show");
+}
+
+/*------------------------------------------------------*/
+// Test case for hold IDs unique across shards and batches split per shard
+TEST_F(BookingRouterTest, EncodesHoldsAndSplitsBatches) {
+    call("ADD_MOVIE 1 Movie01");
+    std::vector<int> theaters;
+    for (int theater = 1; theater <= 12 && theaters.size() < 2; ++theater)
+    {
+        if (theaters.empty() || mRouter->shardOf(theater) != mRouter->shardOf(theaters.front()))
+            theaters.push_back(theater);
+        call("ADD_THEATER " + std::to_string(theater) + " 10 Theater");
+    }
+    ASSERT_EQ(theaters.size(), 2u);
+    const std::string first = std::to_string(theaters[0]);
+    const std::string second = std::to_string(theaters[1]);
+
+    // Each shard numbers its holds from 1; the router's IDs still differ
+    const std::string hold1 = call("HOLD " + first + " 60000 0 1");
+    const std::string hold2 = call("HOLD " + second + " 60000 0 1");
+    ASSERT_EQ(hold1.substr(0, 3), "OK ");
+    ASSERT_EQ(hold2.substr(0, 3), "OK ");
+    EXPECT_NE(hold1, hold2);
+    const auto shardBits = [](std::size_t shard) {
+        return std::to_string((static_cast<std::uint64_t>(shard) << BookingRouter::kHoldShardShift) | 1);
+    };
+    EXPECT_EQ(hold1, "OK " + shardBits(mRouter->shardOf(theaters[0])));
+    EXPECT_EQ(hold2, "OK " + shardBits(mRouter->shardOf(theaters[1])));
+    EXPECT_EQ(call("CONFIRM " + shardBits(mRouter->shardCount())), "ERR unknown hold");
+    EXPECT_EQ(call("CONFIRM " + hold1.substr(3)), "OK");
+    EXPECT_EQ(call("RELEASE " + hold2.substr(3)), "OK");
+    EXPECT_EQ(call("RELEASE " + hold1.substr(3)), "ERR unknown hold");
+    EXPECT_EQ(call("SEATS " + first), "OK 2 3 4 5 6 7 8 9");
+    EXPECT_EQ(call("SEAT_COUNT " + second), "OK 10");
+
+    EXPECT_EQ(call("BOOK_BATCH 7 " + second + " 0 8 " + first + " 0 9 " + second + " 0,1 10 " + first + " 2"),
+              "OK 7:BOOKED 8:CONFLICT:0 9:CONFLICT:0 10:BOOKED");
+    EXPECT_EQ(call("BOOK_BATCH 7 " + second), "ERR bad arguments");
+}
+
+/*------------------------------------------------------*/
+// Test case for shards running as separate processes
+TEST(BookingRouterProcessTest, RoutesToShardProcesses) {
+    constexpr std::size_t kShards = 2;
+    std::vector<pid_t> children;
+    std::vector<std::string> addresses;
+    for (std::size_t shard = 0; shard < kShards; ++shard)
+    {
+        addresses.push_back(shardPath(10 + shard));
+        const pid_t pid = ::fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0)
+        {
+            // Child: serve until SIGTERM, then leave without running the parent's cleanup
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGTERM);
+            pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+            try
+            {
+                MovieBookingService service;
+                const ServiceProtocol protocol(service);
+                BookingServer::Options options;
+                options.unixPath = addresses.back();
+                BookingServer server([&protocol](std::string_view request, std::string& response) {
+                    protocol.handle(request, response);
+                }, options);
+                int signal = 0;
+                sigwait(&signals, &signal);
+            }
+            catch (...)
+            {
+                ::_exit(1);
+            }
+            ::_exit(0);
+        }
+        children.push_back(pid);
+    }
+
+    // Wait for the children to listen
+    for (const auto& address : addresses)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            try
+            {
+                BookingClient(address).call("PING");
+                break;
+            }
+            catch (const std::exception&)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+    }
+
+    {
+        BookingRouter router(addresses);
+        BookingServer::Options options;
+        options.unixPath = shardPath(0);
+        BookingServer front([&router](std::string_view request, std::string& response) {
+            router.handle(request, response);
+        }, options);
+
+        BookingClient client(options.unixPath);
+        EXPECT_EQ(client.call("ADD_MOVIE 1 Movie01"), "OK");
+        std::size_t seats = 0;
+        for (int theater = 1; theater <= 8; ++theater)
+        {
+            EXPECT_EQ(client.call("ADD_THEATER " + std::to_string(theater) + " 5 Theater"), "OK");
+            EXPECT_EQ(client.call("BOOK " + std::to_string(theater) + " 0"), "OK");
+            seats += 4;
+        }
+        EXPECT_EQ(client.call("SEAT_COUNT 3"), "OK 4");
+        EXPECT_EQ(client.call("BOOK 3 0"), "ERR unavailable");
+        EXPECT_EQ(client.call("MOVIES"), "OK 1");
+
+        // Each shard gave the movie its own theaters, so all theaters show it
+        EXPECT_EQ(client.call("THEATERS 1"), "OK 1 2 3 4 5 6 7 8");
+        EXPECT_EQ(client.call("MOVIE_SEAT_COUNT 1"), "OK " + std::to_string(seats));
+    }
+
+    for (const pid_t pid : children)
+    {
+        ::kill(pid, SIGTERM);
+        int status = 0;
+        ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+}
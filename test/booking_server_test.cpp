@@ -0,0 +1,267 @@
+/**
+ * @file booking_server_test.cpp
+ * @brief Test for BookingServer, BookingClient and ServiceProtocol classes
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "booking_client.hpp"
+#include "booking_server.hpp"
+#include "movie_booking_service.hpp"
+#include "service_protocol.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief A service behind a server on a loopback port.
+ */
+class BookingServerTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        BookingServer::Options options;
+        options.threads = 2;
+        mServer = std::make_unique<BookingServer>([this](std::string_view request, std::string& response) {
+            mProtocol.handle(request, response);
+        }, options);
+    }
+
+    BookingClient connect() const
+    {
+        return BookingClient("127.0.0.1", mServer->port());
+    }
+
+    MovieBookingService mService;
+    ServiceProtocol mProtocol{mService};
+    std::unique_ptr<BookingServer> mServer;
+};
+
+} // namespace
+
+/*------------------------------------------------------*/
+// Test case for the protocol on its own: results and errors
+TEST(ServiceProtocolTest, FormatsResultsAndErrors) {
+    MovieBookingService service;
+    const ServiceProtocol protocol(service);
+    const auto handle = [&protocol](std::string_view request) {
+        std::string response;
+        protocol.handle(request, response);
+        return response;
+    };
+
+    EXPECT_EQ(handle("ADD_MOVIE 1 The Long Night"), "OK");
+    EXPECT_EQ(handle("ADD_MOVIE 1 Again"), "ERR rejected");
+    EXPECT_EQ(handle("ADD_THEATER 5 4 Hall Five"), "OK");
+    EXPECT_EQ(handle("MOVIE_NAME 1"), "OK The Long Night");
+    EXPECT_EQ(handle("THEATER_NAME 5"), "OK Hall Five");
+    EXPECT_EQ(handle("THEATERS 1"), "OK 5");
+    EXPECT_EQ(handle("THEATERS 2"), "ERR unknown movie");
+    EXPECT_EQ(handle("BOOK 5 0 1"), "OK");
+    EXPECT_EQ(handle("BOOK 5 1"), "ERR unavailable");
+    EXPECT_EQ(handle("SEATS 5"), "OK 2 3");
+    EXPECT_EQ(handle("BOOK_BATCH 7 5 2 8 5 2,3 9 6 0"), "OK 7:BOOKED 8:CONFLICT:2 9:UNKNOWN_THEATER");
+    EXPECT_EQ(handle("SEAT_COUNT 5"), "OK 1");
+    EXPECT_EQ(handle("SHOWN_IN 5 1"), "OK 1");
+    EXPECT_EQ(handle("ADD_SHOW 3 5 1 1700000000"), "OK");
+    EXPECT_EQ(handle("SHOWS_FOR_THEATER 5"), "OK 3,5,1,1700000000");
+    EXPECT_EQ(handle("SHOW 3"), "OK 3,5,1,1700000000");
+    EXPECT_EQ(handle("SHOW 4"), "ERR unknown show");
+    EXPECT_EQ(handle("SHOWS_FOR_MOVIE 4"), "ERR Movie with the specified ID not found");
+    EXPECT_EQ(handle("HOLD_SHOW 3 60000 0 1"), "OK 1");
+    EXPECT_EQ(handle("SHOW_SEATS 3"), "OK 2 3");
+    EXPECT_EQ(handle("CONFIRM 1"), "OK");
+    EXPECT_EQ(handle("RELEASE 1"), "ERR unknown hold");
+
+    EXPECT_EQ(handle("BOOK 5"), "ERR bad arguments");
+    EXPECT_EQ(handle("BOOK x 1"), "ERR bad arguments");
+    EXPECT_EQ(handle("PING extra"), "ERR bad arguments");
+    EXPECT_EQ(handle("FLY 1"), "ERR unknown command");
+}
+
+/*------------------------------------------------------*/
+// Test case for file loads and theater sizes being limited by the options
+TEST(ServiceProtocolTest, EnforcesOptions) {
+    MovieBookingService service;
+    const ServiceProtocol defaults(service);
+    ServiceProtocol::Options options;
+    options.allowFileLoads = true;
+    options.maxTheaterSeats = 10;
+    const ServiceProtocol limited(service, options);
+    const auto handle = [](const ServiceProtocol& protocol, std::string_view request) {
+        std::string response;
+        protocol.handle(request, response);
+        return response;
+    };
+
+    EXPECT_EQ(handle(defaults, "LOAD_CATALOG /etc/passwd"), "ERR file loads disabled");
+    EXPECT_EQ(handle(defaults, "LOAD_IMAGE /etc/passwd"), "ERR file loads disabled");
+    EXPECT_EQ(handle(limited, "LOAD_IMAGE /nonexistent.img"), "ERR cannot load image");
+
+    EXPECT_EQ(handle(defaults, "ADD_THEATER 1 2000000000 Huge"), "ERR bad arguments");
+    EXPECT_EQ(handle(limited, "ADD_THEATER 1 11 Big"), "ERR bad arguments");
+    EXPECT_EQ(handle(limited, "ADD_THEATER 1 10 Small"), "OK");
+}
+
+/*------------------------------------------------------*/
+// Test case for requests over a loopback connection
+TEST_F(BookingServerTest, ServesRequests) {
+    auto client = connect();
+    EXPECT_EQ(client.call("PING"), "OK");
+    EXPECT_EQ(client.call("ADD_MOVIE 1 Movie01"), "OK");
+    EXPECT_EQ(client.call("ADD_THEATER 1 10 Theater01"), "OK");
+    EXPECT_EQ(client.call("MOVIES"), "OK 1");
+    EXPECT_EQ(client.call("HOLD 1 60000 3 4\r"), "OK 1"); // A CR before the newline is ignored
+    EXPECT_EQ(client.call("RELEASE 1"), "OK");
+    std::string best = "OK";
+    for (const int seat : mService.findBestAvailable(1, 2))
+        best += " " + std::to_string(seat);
+    EXPECT_EQ(client.call("BEST 1 2"), best);
+    EXPECT_EQ(client.call("QUIT"), "OK");
+    EXPECT_THROW(client.call("PING"), std::runtime_error);
+}
+
+/*------------------------------------------------------*/
+// Test case for pipelined requests answered in order on one connection
+TEST_F(BookingServerTest, PipelinedRequestsAnsweredInOrder) {
+    auto client = connect();
+    client.call("ADD_MOVIE 1 Movie01");
+    client.call("ADD_THEATER 1 500 Theater01");
+
+    for (int seat = 0; seat < 500; ++seat)
+    {
+        client.send("BOOK 1 " + std::to_string(seat));
+        client.send("SEAT_COUNT 1");
+    }
+    client.send("BOOK 1 0");
+    for (int seat = 0; seat < 500; ++seat)
+    {
+        ASSERT_EQ(client.receive(), "OK");
+        ASSERT_EQ(client.receive(), "OK " + std::to_string(499 - seat));
+    }
+    EXPECT_EQ(client.receive(), "ERR unavailable");
+}
+
+/*------------------------------------------------------*/
+// Test case for many connections booking the same seats: each sold once
+TEST_F(BookingServerTest, ConcurrentClientsNoOverbooking) {
+    auto setup = connect();
+    setup.call("ADD_MOVIE 1 Movie01");
+    setup.call("ADD_THEATER 1 200 Theater01");
+
+    std::atomic<int> booked{0};
+    std::vector<std::thread> threads;
+    for (int c = 0; c < 6; ++c)
+    {
+        threads.emplace_back([this, &booked]() {
+            auto client = connect();
+            for (int seat = 0; seat < 200; ++seat)
+            {
+                client.send("BOOK 1 " + std::to_string(seat));
+            }
+            for (int seat = 0; seat < 200; ++seat)
+            {
+                if (client.receive() == "OK")
+                    ++booked;
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(booked.load(), 200);
+    EXPECT_EQ(setup.call("SEATS 1"), "OK");
+}
+
+/*------------------------------------------------------*/
+// Test case for a request longer than the limit closing the connection
+TEST_F(BookingServerTest, OversizedRequestClosesConnection) {
+    auto client = connect();
+    EXPECT_EQ(client.call("BOOK 1 " + std::string(80000, '1')), "ERR request too long");
+    EXPECT_THROW(client.receive(), std::runtime_error);
+    EXPECT_EQ(connect().call("PING"), "OK"); // The server carries on
+}
+
+/*------------------------------------------------------*/
+// Test case for running out of descriptors pausing accepts instead of spinning
+TEST_F(BookingServerTest, OutOfDescriptorsBacksOff) {
+    // Queue connections the server cannot accept: no descriptor is left for them
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(mServer->port());
+    ::inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    std::vector<int> sockets;
+    rlimit saved{};
+    ASSERT_EQ(::getrlimit(RLIMIT_NOFILE, &saved), 0);
+    for (int i = 0; i < 4; ++i)
+    {
+        sockets.push_back(::socket(AF_INET, SOCK_STREAM, 0));
+    }
+    const int lowestFree = ::dup(0);
+    ::close(lowestFree);
+    rlimit exhausted = saved;
+    exhausted.rlim_cur = static_cast<rlim_t>(lowestFree);
+    ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &exhausted), 0);
+    for (int fd : sockets)
+    {
+        EXPECT_EQ(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    }
+
+    // Both loops stay mostly idle while the connections wait
+    rusage before{};
+    rusage after{};
+    ::getrusage(RUSAGE_SELF, &before);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    ::getrusage(RUSAGE_SELF, &after);
+    const auto cpuMicros = [](const rusage& usage) {
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000L +
+               usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+    };
+    EXPECT_EQ(mServer->connectionCount(), 0u);
+    ::setrlimit(RLIMIT_NOFILE, &saved);
+    EXPECT_LT(cpuMicros(after) - cpuMicros(before), 150000L);
+
+    // Once descriptors are free again the queued connections are accepted
+    for (int i = 0; i < 100 && mServer->connectionCount() < sockets.size(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(mServer->connectionCount(), sockets.size());
+    for (int fd : sockets)
+    {
+        ::close(fd);
+    }
+}
+
+/*------------------------------------------------------*/
+// Test case for serving on a Unix socket
+TEST(BookingServerUnixTest, ServesOnUnixSocket) {
+    MovieBookingService service;
+    const ServiceProtocol protocol(service);
+    BookingServer::Options options;
+    options.unixPath = "/tmp/booking_server_test_" + std::to_string(::getpid()) + ".sock";
+    {
+        BookingServer server([&protocol](std::string_view request, std::string& response) {
+            protocol.handle(request, response);
+        }, options);
+        EXPECT_EQ(server.port(), 0);
+
+        BookingClient client(options.unixPath);
+        EXPECT_EQ(client.call("ADD_MOVIE 4 Movie04"), "OK");
+        EXPECT_EQ(client.call("IS_MOVIE 4"), "OK 1");
+    }
+    EXPECT_NE(::access(options.unixPath.c_str(), F_OK), 0); // Removed on stop
+}
@@ -0,0 +1,134 @@
+/**
+ * @file catalog_image_test.cpp
+ * @brief Test for CatalogImage and loading a MovieBookingService from an image
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "catalog_image.hpp"
+#include "movie_booking_service.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*------------------------------------------------------*/
+// Test case for writing an image and reading it back through the mapping
+TEST(CatalogImageTest, WriteAndMapRoundTrip) {
+    const std::string path = ::testing::TempDir() + "catalog_round_trip.img";
+
+    auto booked = numberedSeats(3);
+    booked[1].isBooked = true;
+    booked[2].section = 1;
+    booked[2].row = 4;
+    booked[2].position = 7;
+
+    CatalogImageWriter writer;
+    writer.addMovie(1, "Movie01");
+    writer.addMovie(2, "Movie02");
+    writer.addTheater(10, "Theater10", numberedSeats(5));
+    writer.addTheater(11, "Theater11", numberedSeats(5));
+    writer.addTheater(12, "Theater12", booked);
+    writer.addAllocation(1, 10);
+    writer.addAllocation(2, 11);
+    writer.write(path);
+
+    const CatalogImage image(path);
+    ASSERT_EQ(image.movieCount(), 2u);
+    EXPECT_EQ(image.movie(1).id, 2);
+    EXPECT_EQ(image.movie(1).name, "Movie02");
+
+    ASSERT_EQ(image.theaterCount(), 3u);
+    const auto first = image.theater(0);
+    const auto second = image.theater(1);
+    EXPECT_EQ(second.name, "Theater11");
+    EXPECT_EQ(second.seatCount, 5u);
+    EXPECT_EQ(first.seats, second.seats); // Identical layouts are stored once
+
+    const auto seats = image.seats(image.theater(2));
+    ASSERT_EQ(seats.size(), 3u);
+    EXPECT_EQ(seats[2].seatNumber, "Seat 3");
+    EXPECT_TRUE(seats[1].isBooked);
+    EXPECT_FALSE(seats[0].isBooked);
+    EXPECT_EQ(seats[0].row, Seat::kNoRow);
+    EXPECT_EQ(seats[2].section, 1);
+    EXPECT_EQ(seats[2].row, 4);
+    EXPECT_EQ(seats[2].position, 7);
+
+    ASSERT_EQ(image.allocationCount(), 2u);
+    EXPECT_EQ(image.allocation(1).movieId, 2);
+    EXPECT_EQ(image.allocation(1).theaterId, 11);
+
+    std::remove(path.c_str());
+}
+
+/*------------------------------------------------------*/
+// Test case for rejecting files that are not catalog images
+TEST(CatalogImageTest, RejectsInvalidImage) {
+    const std::string path = ::testing::TempDir() + "catalog_invalid.img";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << std::string(256, 'x');
+    }
+
+    EXPECT_THROW(CatalogImage image(path), std::runtime_error);
+    EXPECT_THROW(CatalogImage image(path + ".missing"), std::runtime_error);
+
+    MovieBookingService service;
+    EXPECT_FALSE(service.loadCatalogImage(path));
+
+    // A theater whose seat range runs past the seat table is caught on open
+    CatalogImageWriter writer;
+    writer.addTheater(1, "Theater01", numberedSeats(4));
+    writer.write(path);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        catalog_format::Header header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        catalog_format::TheaterRecord record{};
+        file.seekg(static_cast<std::streamoff>(header.theatersOffset));
+        file.read(reinterpret_cast<char*>(&record), sizeof(record));
+        record.seatCount = 5;
+        file.seekp(static_cast<std::streamoff>(header.theatersOffset));
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    EXPECT_THROW(CatalogImage image(path), std::runtime_error);
+    EXPECT_FALSE(service.loadCatalogImage(path));
+    EXPECT_FALSE(service.findTheaterName(1).has_value());
+
+    std::remove(path.c_str());
+}
+
+/*------------------------------------------------------*/
+// Test case for serving a catalog loaded from an image
+TEST(CatalogImageTest, ServiceLoadsImage) {
+    const std::string path = ::testing::TempDir() + "catalog_service.img";
+
+    auto layout = numberedSeats(4);
+    layout[3].isBooked = true;
+
+    CatalogImageWriter writer;
+    writer.addMovie(1, "Movie01");
+    writer.addMovie(2, "Movie02");
+    writer.addTheater(1, "Theater01", layout);
+    writer.addTheater(2, "Theater02", layout);
+    writer.addAllocation(1, 1);
+    writer.addAllocation(2, 2);
+    writer.write(path);
+
+    MovieBookingService service;
+    ASSERT_TRUE(service.loadCatalogImage(path));
+    std::remove(path.c_str());
+
+    EXPECT_EQ(service.getAllMovies(), (std::vector<int>{1, 2}));
+    EXPECT_EQ(service.getMovieName(2), "Movie02");
+    EXPECT_EQ(service.getTheaterName(1), "Theater01");
+    EXPECT_TRUE(service.isMovieShownInTheater(2, 2));
+    EXPECT_FALSE(service.isMovieShownInTheater(1, 2));
+    EXPECT_EQ(service.getAvailableSeats(1), (std::vector<int>{0, 1, 2}));
+
+    // Theaters sharing a layout in the image have their own seat state
+    EXPECT_TRUE(service.bookSeats(1, {0, 1}));
+    EXPECT_FALSE(service.bookSeats(1, {1}));
+    EXPECT_EQ(service.getAvailableSeats(2), (std::vector<int>{0, 1, 2}));
+}
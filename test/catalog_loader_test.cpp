@@ -0,0 +1,158 @@
+/**
+ * @file catalog_loader_test.cpp
+ * @brief Test for CatalogLoader and the bulk MovieBookingService API
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "catalog_loader.hpp"
+#include "movie_booking_service.hpp"
+#include "theater.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*------------------------------------------------------*/
+// Test case for parsing every entry kind of a catalog file
+TEST(CatalogLoaderTest, ParsesEntries) {
+    std::istringstream input(
+        "# sample catalog\n"
+        "movie,1,Movie01\n"
+        "layout,small,3\n"
+        "seat,vip,100,A1\r\n"
+        "seat,vip,101,A2\n"
+        "\n"
+        "theater,7,Theater07,small\n"
+        "theater,8,Theater08,vip\n");
+
+    std::vector<std::string> movies;
+    std::vector<std::vector<Seat>> layouts;
+    const auto count = CatalogLoader::parse(input,
+        [&](int id, const std::string& name) { movies.push_back(std::to_string(id) + name); },
+        [&](int, const std::string&, const std::vector<Seat>& seats) { layouts.push_back(seats); });
+
+    EXPECT_EQ(count, 3u);
+    EXPECT_EQ(movies, (std::vector<std::string>{"1Movie01"}));
+    ASSERT_EQ(layouts.size(), 2u);
+    ASSERT_EQ(layouts[0].size(), 3u);
+    EXPECT_EQ(layouts[0][2].seatNumber, "Seat 3");
+    ASSERT_EQ(layouts[1].size(), 2u);
+    EXPECT_EQ(layouts[1][1].id, 101);
+    EXPECT_EQ(layouts[1][1].seatNumber, "A2");
+}
+
+/*------------------------------------------------------*/
+// Test case for theaters of one layout sharing a single SeatLayout
+TEST(CatalogLoaderTest, TheatersShareLayout) {
+    std::istringstream input(
+        "layout,standard,20,10\n"
+        "theater,1,Theater01,standard\n"
+        "theater,2,Theater02,standard\n"
+        "seat,standard,20,Seat 21\n"
+        "theater,3,Theater03,standard\n");
+
+    std::vector<std::unique_ptr<TheaterBase>> theaters;
+    CatalogLoader::parse(input, [](int, const std::string&) {},
+        CatalogLoader::LayoutTheaterSink([&](int id, const std::string& name, const std::shared_ptr<const SeatLayout>& layout) {
+            theaters.push_back(std::make_unique<Theater>(id, name, layout));
+        }));
+
+    ASSERT_EQ(theaters.size(), 3u);
+    EXPECT_EQ(theaters[0]->getLayout(), theaters[1]->getLayout());
+    EXPECT_EQ(theaters[0]->getLayout()->size(), 20u);
+    // A seat added after the first theaters gives later theaters a new layout
+    EXPECT_NE(theaters[2]->getLayout(), theaters[0]->getLayout());
+    EXPECT_EQ(theaters[2]->getLayout()->size(), 21u);
+
+    // Seat state stays per theater
+    EXPECT_TRUE(theaters[0]->bookSeat(0));
+    EXPECT_EQ(theaters[1]->getSeatState(0), SeatState::Free);
+}
+
+/*------------------------------------------------------*/
+// Test case for reporting malformed lines
+TEST(CatalogLoaderTest, RejectsMalformedLines) {
+    const auto noMovie = [](int, const std::string&) {};
+    const auto noTheater = [](int, const std::string&, const std::vector<Seat>&) {};
+
+    for (const char* text : {"movie,x,Movie01\n", "theater,1,Theater01,missing\n", "screen,1\n", "movie,1\n"})
+    {
+        std::istringstream input(text);
+        EXPECT_THROW(CatalogLoader::parse(input, noMovie, noTheater), std::invalid_argument) << text;
+    }
+}
+
+/*------------------------------------------------------*/
+// Test case for loading a catalog through the bulk API
+TEST(CatalogLoaderTest, LoadsServiceInBulk) {
+    std::ostringstream text;
+    text << "layout,standard,20\n";
+    for (int id = 1; id <= 3; ++id)
+        text << "movie," << id << ",Movie0" << id << "\n";
+    for (int id = 1; id <= 1000; ++id)
+        text << "theater," << id << ",Theater" << id << ",standard\n";
+
+    std::istringstream input(text.str());
+    MovieBookingService service;
+    EXPECT_EQ(CatalogLoader::load(input, service), 1003u);
+
+    // Movies get the first theaters in ID order; every theater shows a movie
+    EXPECT_EQ(service.getTheatersForMovie(1).front(), 1);
+    EXPECT_EQ(service.getTheatersForMovie(2).front(), 2);
+    EXPECT_EQ(service.getTheatersForMovie(3).front(), 3);
+    std::size_t allocated = 0;
+    for (const auto movieId : service.getAllMovies())
+        allocated += service.getTheatersForMovie(movieId).size();
+    EXPECT_EQ(allocated, 1000u);
+
+    EXPECT_EQ(service.getAvailableSeats(1000).size(), 20u);
+    EXPECT_TRUE(service.bookSeats(1000, {0, 19}));
+}
+
+/*------------------------------------------------------*/
+// Test case for bulk additions skipping null entries and known IDs
+TEST(CatalogLoaderTest, BulkAddSkipsDuplicates) {
+    const std::vector<Seat> seats{Seat{0, "Seat 1", false}};
+    MovieBookingService service;
+
+    std::vector<std::unique_ptr<TheaterBase>> theaters;
+    theaters.push_back(std::make_unique<Theater>(1, "Theater01", seats));
+    theaters.push_back(nullptr);
+    theaters.push_back(std::make_unique<Theater>(1, "Duplicate", seats));
+    EXPECT_EQ(service.addTheaters(std::move(theaters)), 1u);
+    EXPECT_EQ(service.getTheaterName(1), "Theater01");
+
+    // A movie added after the theater takes the free theater, as addMovie would
+    std::vector<std::unique_ptr<Movie>> movies;
+    movies.push_back(std::make_unique<Movie>(5, "Movie05"));
+    movies.push_back(std::make_unique<Movie>(5, "Duplicate"));
+    EXPECT_EQ(service.addMovies(std::move(movies)), 1u);
+    EXPECT_TRUE(service.isMovieShownInTheater(1, 5));
+    EXPECT_EQ(service.addMovies({}), 0u);
+}
+
+/*------------------------------------------------------*/
+// Test case for layouts in rows and seats with explicit places
+TEST(CatalogLoaderTest, LoadsSeatPlaces) {
+    std::istringstream input(
+        "movie,1,Movie01\n"
+        "layout,hall,12,4\n"
+        "seat,box,1,B1,2,0,0\n"
+        "seat,box,2,B2,2,0,1\n"
+        "theater,1,Theater01,hall\n"
+        "theater,2,Theater02,box\n");
+
+    MovieBookingService service;
+    EXPECT_EQ(CatalogLoader::load(input, service), 3u);
+
+    // Three rows of four: the middle row is seats 4-7
+    EXPECT_EQ(service.findBestAvailable(1, 2), (std::vector<int>{5, 6}));
+    EXPECT_EQ(service.findBestAvailable(1, 4), (std::vector<int>{4, 5, 6, 7}));
+    EXPECT_TRUE(service.findBestAvailable(1, 5).empty());
+    EXPECT_EQ(service.findBestAvailable(2, 2), (std::vector<int>{1, 2}));
+    EXPECT_TRUE(service.findBestAvailable(3, 1).empty());
+
+    std::istringstream negative("seat,box,1,B1,0,-2,0\n");
+    EXPECT_THROW(CatalogLoader::load(negative, service), std::invalid_argument);
+}
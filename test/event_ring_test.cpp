@@ -0,0 +1,283 @@
+/**
+ * @file event_ring_test.cpp
+ * @brief Test for EventRing class and the events of MovieBookingService
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "event_ring.hpp"
+#include "movie_booking_service.hpp"
+#include "movie.hpp"
+#include "theater.hpp"
+#include "test_service.hpp"
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Status = EventRing::ReadStatus;
+
+/**
+ * @brief Free seats of theater 1 as mirrored from events, resyncing from a snapshot when lapped.
+ */
+class SeatMirror {
+public:
+    SeatMirror(const MovieBookingService& service, std::uint64_t from):
+    mService(service), mSubscription(service.subscribe(from))
+    {
+        mFree = snapshot();
+    }
+
+    /** Apply what was published since the last call; returns true if it had to resync. */
+    bool update()
+    {
+        std::vector<ServiceEvent> events;
+        bool resynced = false;
+        if (mSubscription.poll(events) == Status::Lapped)
+        {
+            mSubscription.resync();
+            mFree = snapshot();
+            mSubscription.poll(events);
+            resynced = true;
+        }
+        for (const auto& event : events)
+        {
+            if (event.type == EventType::SeatReleased)
+                mFree.insert(event.seatId);
+            else if (event.type == EventType::SeatBooked || event.type == EventType::SeatHeld)
+                mFree.erase(event.seatId);
+        }
+        return resynced;
+    }
+
+    std::set<int> snapshot() const
+    {
+        const auto seats = mService.getAvailableSeats(1);
+        return std::set<int>(seats.begin(), seats.end());
+    }
+
+    const std::set<int>& free() const { return mFree; }
+
+private:
+    const MovieBookingService& mService;
+    EventSubscription mSubscription;
+    std::set<int> mFree;
+};
+
+} // namespace
+
+/*------------------------------------------------------*/
+// Test case for reading in order and detecting a lapped reader
+TEST(EventRingTest, ReadsInOrderAndDetectsLap) {
+    EventRing ring(3);
+    EXPECT_EQ(ring.capacity(), 4u);
+
+    for (int seat = 0; seat < 3; ++seat)
+    {
+        EXPECT_EQ(ring.publish(EventType::SeatBooked, 1, -1, -1, seat), static_cast<std::uint64_t>(seat));
+    }
+    std::vector<ServiceEvent> events;
+    std::uint64_t position = 0;
+    EXPECT_EQ(ring.read(position, events, 2), Status::Ok);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[1].sequence, 1u);
+    EXPECT_EQ(events[1].seatId, 1);
+    EXPECT_EQ(position, 2u);
+
+    // Six more events overwrite sequence 2
+    for (int seat = 3; seat < 9; ++seat)
+    {
+        ring.publish(EventType::SeatHeld, 1, -1, -1, seat);
+    }
+    events.clear();
+    EXPECT_EQ(ring.read(position, events, SIZE_MAX), Status::Lapped);
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(position, 2u);
+
+    EventSubscription subscription(ring, position);
+    EXPECT_EQ(subscription.poll(events), Status::Lapped);
+    EXPECT_EQ(subscription.resync(), 9u);
+    ring.publish(EventType::SeatReleased, 1, -1, -1, 4);
+    EXPECT_EQ(subscription.poll(events), Status::Ok);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, EventType::SeatReleased);
+    EXPECT_EQ(events[0].sequence, 9u);
+    EXPECT_EQ(subscription.position(), 10u);
+}
+
+/*------------------------------------------------------*/
+// Test case for readers stopping at a claimed but uncommitted sequence
+TEST(EventRingTest, StopsAtUncommittedSequence) {
+    EventRing ring(8);
+    const std::uint64_t first = ring.claim(2);
+    ring.publish(EventType::MovieAdded, -1, -1, 5, -1);
+
+    std::vector<ServiceEvent> events;
+    std::uint64_t position = 0;
+    EXPECT_EQ(ring.read(position, events, SIZE_MAX), Status::Ok);
+    EXPECT_TRUE(events.empty());
+
+    ring.commit(ServiceEvent{first + 1, EventType::SeatBooked, 1, -1, -1, 3});
+    ring.commit(ServiceEvent{first, EventType::SeatBooked, 1, -1, -1, 2});
+    ring.waitCommitted(ring.nextSequence());
+    EXPECT_EQ(ring.read(position, events, SIZE_MAX), Status::Ok);
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].seatId, 2);
+    EXPECT_EQ(events[1].seatId, 3);
+    EXPECT_EQ(events[2].movieId, 5);
+}
+
+/*------------------------------------------------------*/
+// Test case for concurrent producers: no gaps, each producer's events in order
+TEST(EventRingTest, ConcurrentProducersGapFree) {
+    const int producers = 4;
+    const int perProducer = 10000;
+    EventRing ring(producers * perProducer);
+
+    std::vector<ServiceEvent> events;
+    std::atomic<bool> done{false};
+    std::thread reader([&]() {
+        std::uint64_t position = 0;
+        while (!done || position < ring.nextSequence())
+        {
+            ASSERT_EQ(ring.read(position, events, 128), Status::Ok);
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < perProducer; ++i)
+            {
+                ring.publish(EventType::SeatBooked, p, -1, -1, i);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    done = true;
+    reader.join();
+
+    ASSERT_EQ(events.size(), static_cast<std::size_t>(producers * perProducer));
+    std::vector<int> next(producers, 0);
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        EXPECT_EQ(events[i].sequence, i);
+        EXPECT_EQ(events[i].seatId, next[events[i].theaterId]++);
+    }
+}
+
+/*------------------------------------------------------*/
+// Test case for the service publishing seat and catalog changes
+TEST(MovieBookingServiceEvents, PublishesSeatAndCatalogChanges) {
+    MovieBookingService service;
+    auto subscription = service.subscribe(service.getEventSequence());
+    std::vector<Seat> seats(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        seats[i].id = i;
+        seats[i].seatNumber = "A" + std::to_string(i);
+        seats[i].isBooked = false;
+    }
+    service.addMovie(std::make_unique<Movie>(7, "Movie07"));
+    service.addTheater(std::make_unique<Theater>(3, "Theater03", seats));
+    ASSERT_TRUE(service.addShow(ShowInfo{11, 3, 7, 1700000000}));
+    ASSERT_TRUE(service.bookSeats(3, {0, 1}));
+    const auto hold = service.holdSeats(3, {2}, std::chrono::minutes(5));
+    ASSERT_TRUE(hold.has_value());
+    ASSERT_TRUE(service.releaseHold(*hold));
+    ASSERT_TRUE(service.bookShowSeats(11, {3}));
+    EXPECT_FALSE(service.bookSeats(3, {1})); // Failed calls publish nothing
+
+    std::vector<ServiceEvent> events;
+    ASSERT_EQ(subscription.poll(events), Status::Ok);
+    ASSERT_EQ(events.size(), 9u);
+    EXPECT_EQ(events[0].type, EventType::MovieAdded);
+    EXPECT_EQ(events[0].movieId, 7);
+    EXPECT_EQ(events[1].type, EventType::TheaterAdded);
+    EXPECT_EQ(events[1].theaterId, 3);
+    EXPECT_EQ(events[2].type, EventType::MovieAllocated);
+    EXPECT_EQ(events[2].movieId, 7);
+    EXPECT_EQ(events[2].theaterId, 3);
+    EXPECT_EQ(events[3].type, EventType::ShowAdded);
+    EXPECT_EQ(events[3].showId, 11);
+    EXPECT_EQ(events[4].type, EventType::SeatBooked);
+    EXPECT_EQ(events[5].seatId, 1);
+    EXPECT_EQ(events[6].type, EventType::SeatHeld);
+    EXPECT_EQ(events[7].type, EventType::SeatReleased);
+    EXPECT_EQ(events[7].seatId, 2);
+    EXPECT_EQ(events[8].type, EventType::SeatBooked);
+    EXPECT_EQ(events[8].showId, 11);
+    EXPECT_EQ(events[8].movieId, 7);
+    EXPECT_EQ(events[8].theaterId, 3);
+    EXPECT_EQ(subscription.position(), service.getEventSequence());
+}
+
+/*------------------------------------------------------*/
+// Test case for a lapped subscriber recovering from a snapshot
+TEST(MovieBookingServiceEvents, LappedSubscriberResyncs) {
+    auto service = makeService({1}, 1, 16);
+    SeatMirror mirror(*service, service->getEventSequence());
+
+    // More changes than the ring keeps
+    for (std::size_t i = 0; i < MovieBookingService::kEventCapacity; ++i)
+    {
+        const auto hold = service->holdSeats(1, {static_cast<int>(i % 16)}, std::chrono::minutes(5));
+        ASSERT_TRUE(hold.has_value());
+        service->releaseHold(*hold);
+    }
+    ASSERT_TRUE(service->bookSeats(1, {4, 5}));
+    EXPECT_TRUE(mirror.update());
+    ASSERT_TRUE(service->bookSeats(1, {6}));
+    EXPECT_FALSE(mirror.update());
+    EXPECT_EQ(mirror.free(), mirror.snapshot());
+    EXPECT_EQ(mirror.free().size(), 13u);
+}
+
+/*------------------------------------------------------*/
+// Test case for a subscriber mirroring seats that change concurrently
+TEST(MovieBookingServiceEvents, MirrorConvergesUnderConcurrency) {
+    const int seatCount = 64;
+    auto service = makeService({1}, 1, seatCount);
+    SeatMirror mirror(*service, service->getEventSequence());
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&service, t]() {
+            for (int i = 0; i < 5000; ++i)
+            {
+                const int seat = (i * 7 + t * 13) % seatCount;
+                if (i % 97 == 0)
+                {
+                    service->bookSeats(1, {seat});
+                }
+                else if (const auto hold = service->holdSeats(1, {seat}, std::chrono::minutes(5)))
+                {
+                    service->releaseHold(*hold);
+                }
+            }
+        });
+    }
+    std::thread subscriber([&mirror, &done]() {
+        while (!done)
+        {
+            mirror.update();
+        }
+    });
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    done = true;
+    subscriber.join();
+
+    mirror.update();
+    EXPECT_EQ(mirror.free(), mirror.snapshot());
+}
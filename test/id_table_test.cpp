@@ -0,0 +1,118 @@
+/**
+ * @file id_table_test.cpp
+ * @brief Test for IdTable class
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "id_table.hpp"
+
+#include <string>
+#include <vector>
+
+/*------------------------------------------------------*/
+// Test case for adding, finding and rejecting known IDs
+TEST(IdTableTest, EmplaceAndFind) {
+    IdTable<std::string> table;
+    EXPECT_EQ(table.find(1), nullptr);
+    EXPECT_TRUE(table.empty());
+
+    EXPECT_TRUE(table.emplace(1, "one").second);
+    EXPECT_TRUE(table.emplace(-7, "minus seven").second);
+    const auto [value, added] = table.emplace(1, "uno");
+    EXPECT_FALSE(added);
+    EXPECT_EQ(*value, "one");
+
+    ASSERT_NE(table.find(-7), nullptr);
+    EXPECT_EQ(*table.find(-7), "minus seven");
+    EXPECT_TRUE(table.contains(1));
+    EXPECT_FALSE(table.contains(2));
+    EXPECT_EQ(table.size(), 2u);
+
+    EXPECT_EQ(table.assign(2, "two"), "two");
+    EXPECT_EQ(*table.find(2), "two");
+    EXPECT_EQ(table.size(), 3u);
+}
+
+/*------------------------------------------------------*/
+// Test case for growing past many index sizes with scattered IDs
+TEST(IdTableTest, GrowsAndKeepsInsertionOrder) {
+    IdTable<int> table;
+    std::vector<int> added;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const int id = (i * 7919) % 100003 - 50000;
+        if (table.emplace(id, i).second)
+            added.push_back(id);
+    }
+    ASSERT_EQ(table.size(), added.size());
+
+    std::size_t position = 0;
+    for (const auto& [id, value] : table)
+    {
+        EXPECT_EQ(id, added[position]);
+        EXPECT_EQ(*table.find(id), value);
+        ++position;
+    }
+    EXPECT_FALSE(table.contains(60000));
+}
+
+/*------------------------------------------------------*/
+// Test case for IDs being listed in ascending order
+TEST(IdTableTest, ListsIdsInOrder) {
+    IdTable<int> ascending;
+    IdTable<int> shuffled;
+    for (const int id : {3, 5, 9})
+        ascending.emplace(id, 0);
+    for (const int id : {9, 3, 5})
+        shuffled.emplace(id, 0);
+
+    EXPECT_EQ(ascending.ids(), (std::vector<int>{3, 5, 9}));
+    EXPECT_EQ(shuffled.ids(), (std::vector<int>{3, 5, 9}));
+
+    // Copies are independent
+    IdTable<int> copy = shuffled;
+    copy.emplace(1, 0);
+    EXPECT_EQ(shuffled.size(), 3u);
+    EXPECT_EQ(copy.ids(), (std::vector<int>{1, 3, 5, 9}));
+}
+
+/*------------------------------------------------------*/
+// Test case for copies keeping the entries and values they were made with
+TEST(IdTableTest, CopiesSeeTheirOwnVersion) {
+    IdTable<std::string> original;
+    original.emplace(1, "one");
+    original.emplace(2, "two");
+
+    // The copy writes past the original in the shared storage
+    IdTable<std::string> copy = original;
+    copy.assign(1, "uno");
+    for (int id = 3; id < 100; ++id)
+        copy.emplace(id, std::to_string(id));
+    copy.assign(2, "dos");
+
+    EXPECT_EQ(*original.find(1), "one");
+    EXPECT_EQ(*original.find(2), "two");
+    EXPECT_FALSE(original.contains(3));
+    EXPECT_EQ(original.ids(), (std::vector<int>{1, 2}));
+    EXPECT_EQ(*copy.find(1), "uno");
+    EXPECT_EQ(*copy.find(2), "dos");
+    EXPECT_EQ(copy.size(), 99u);
+
+    // Each ID is listed once, with its latest value
+    std::vector<std::string> values;
+    for (const auto& entry : copy)
+        values.push_back(entry.second);
+    EXPECT_EQ(values.size(), 99u);
+    EXPECT_EQ(values.front(), "uno");
+    EXPECT_EQ(values.back(), "dos");
+
+    // Writing to the original now gives it storage of its own
+    original.assign(2, "deux");
+    original.emplace(3, "trois");
+    EXPECT_EQ(*original.find(2), "deux");
+    EXPECT_EQ(*original.find(3), "trois");
+    EXPECT_FALSE(original.contains(4));
+    EXPECT_EQ(*copy.find(2), "dos");
+    EXPECT_EQ(*copy.find(3), "3");
+    EXPECT_EQ(copy.ids().size(), 99u);
+}
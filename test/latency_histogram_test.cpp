@@ -0,0 +1,72 @@
+/**
+ * @file latency_histogram_test.cpp
+ * @brief Test for LatencyHistogram class
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "latency_histogram.hpp"
+
+#include <cstdint>
+
+/*------------------------------------------------------*/
+// Test case for small values, which are recorded exactly
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.percentile(0.5), 0u);
+
+    for (std::uint64_t value = 1; value <= 10; ++value)
+    {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.count(), 10u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_EQ(histogram.max(), 10u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 5.5);
+    EXPECT_EQ(histogram.percentile(0.5), 5u);
+    EXPECT_EQ(histogram.percentile(0.9), 9u);
+    EXPECT_EQ(histogram.percentile(1.0), 10u);
+}
+
+/*------------------------------------------------------*/
+// Test case for percentiles of large values staying within the bucket error
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError) {
+    LatencyHistogram histogram;
+    for (std::uint64_t value = 1; value <= 100000; ++value)
+    {
+        histogram.record(value * 1000);
+    }
+
+    for (const double quantile : {0.5, 0.99, 0.999})
+    {
+        const double expected = quantile * 100000 * 1000;
+        const double reported = static_cast<double>(histogram.percentile(quantile));
+        EXPECT_GE(reported, expected) << "quantile " << quantile;
+        EXPECT_LE(reported, expected * (1.0 + 1.0 / 16)) << "quantile " << quantile;
+    }
+    EXPECT_EQ(histogram.percentile(1.0), 100000u * 1000);
+}
+
+/*------------------------------------------------------*/
+// Test case for merging per-thread histograms and resetting
+TEST(LatencyHistogramTest, MergeAndReset) {
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (int i = 0; i < 99; ++i)
+    {
+        fast.record(100);
+    }
+    slow.record(UINT64_MAX);
+
+    fast.merge(slow);
+    EXPECT_EQ(fast.count(), 100u);
+    EXPECT_EQ(fast.min(), 100u);
+    EXPECT_EQ(fast.max(), UINT64_MAX);
+    EXPECT_LE(fast.percentile(0.99), 103u);
+    EXPECT_EQ(fast.percentile(0.999), UINT64_MAX);
+
+    fast.reset();
+    EXPECT_EQ(fast.count(), 0u);
+    EXPECT_EQ(fast.min(), 0u);
+    EXPECT_EQ(fast.max(), 0u);
+}
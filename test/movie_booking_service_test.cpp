@@ -8,9 +8,13 @@
 #include "movie_booking_service.hpp"
 #include "movie.hpp"
 #include "theater.hpp"
+#include "fixed_theater.hpp"
 #include "seat.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 using ::testing::Return;
 using ::testing::_;
@@ -22,6 +26,7 @@ public:
         : Theater(id, name, seats) {}
 
     MOCK_METHOD(bool, bookSeat, (const int& id), (override));
+    MOCK_METHOD(bool, bookSeats, (const std::vector<int>& ids), (override));
     MOCK_METHOD(std::vector<int>, getAvailableSeats, (), (const, override));
     MOCK_METHOD(std::string, getName, (), (const, override));
     MOCK_METHOD(int, getId, (), (const, override));
@@ -53,14 +58,7 @@ protected:
         mMovies_.emplace_back(std::make_unique<Movie>(0, "Movie00"));
         mMovies_.emplace_back(std::make_unique<Movie>(1, "Movie01"));
 
-        for (int i = 0; i < mSeatCapacity; ++i)
-        {
-            Seat seat;
-            seat.id = i;
-            seat.seatNumber = "Seat " + std::to_string(i + 1);
-            seat.isBooked = false;
-            mSeats.push_back(seat);
-        }
+        mSeats = numberedSeats(mSeatCapacity);
 
         // Populate sample theaters
         mTheaterMocks_.emplace_back(std::make_unique<TheaterMock>(0, "Theater00", mSeats));
@@ -170,25 +168,19 @@ TEST_F(MovieBookingServiceFixture, BookSeats) {
     int theaterIdToTest = 0;
 
     ::testing::InSequence s;
-    // Expectations for the mock theater
-    EXPECT_CALL(*mTheaterMocks[theaterIdToTest], bookSeat(0)).WillOnce(::testing::Return(true));
-    EXPECT_CALL(*mTheaterMocks[theaterIdToTest], bookSeat(1)).WillOnce(::testing::Return(true));
-    EXPECT_CALL(*mTheaterMocks[theaterIdToTest], bookSeat(2)).WillOnce(::testing::Return(true));
+    // Expectations for the mock theater: the whole seat set is booked in one call
+    EXPECT_CALL(*mTheaterMocks[theaterIdToTest], bookSeats(seatIds)).WillOnce(::testing::Return(true));
+    EXPECT_CALL(*mTheaterMocks[theaterIdToTest], bookSeats(seatIds)).WillOnce(::testing::Return(false)); // A seat is taken
+    EXPECT_CALL(*mTheaterMocks[theaterIdToTest], bookSeat(_)).Times(0);
 
     bool result = mServicePtr->bookSeats(0, seatIds); // Assuming theaterId 0 and movieId 0
 
     EXPECT_TRUE(result); // Expecting successful booking of seats
 
-    ::testing::InSequence s2;
-    // Expectations for the mock theater
-    EXPECT_CALL(*mTheaterMocks[theaterIdToTest], bookSeat(0)).WillOnce(::testing::Return(true));
-    EXPECT_CALL(*mTheaterMocks[theaterIdToTest], bookSeat(1)).WillOnce(::testing::Return(true));
-    EXPECT_CALL(*mTheaterMocks[theaterIdToTest], bookSeat(2)).WillOnce(::testing::Return(false)); // One seat booking fails
-
-    // Book seats again (this time one seat fails)
+    // Book seats again (this time the theater rejects the set)
     result = mServicePtr->bookSeats(0, seatIds);
 
-    EXPECT_FALSE(result); // Expecting one seat booking to fail
+    EXPECT_FALSE(result); // Expecting the booking to fail as a whole
 }
 
 /*------------------------------------------------------*/
@@ -258,3 +250,192 @@ TEST_F(MovieBookingServiceFixture, IsValidMovie_InvalidMovieId) {
     EXPECT_FALSE(mServicePtr->isValidMovie(nonExistingMovieId));
 }
 
+
+/*------------------------------------------------------*/
+// Test case for catalog reads racing with catalog writes
+TEST(MovieBookingServiceConcurrency, ReadsSeeConsistentSnapshots) {
+    MovieBookingService service;
+    const auto seats = numberedSeats(4);
+
+    const int catalogSize = 200;
+    std::atomic<bool> writing{true};
+
+    std::thread writer([&]() {
+        for (int id = 1; id <= catalogSize; ++id)
+        {
+            service.addMovie(std::make_unique<Movie>(id, "Movie" + std::to_string(id)));
+            service.addTheater(std::make_unique<Theater>(id, "Theater" + std::to_string(id), seats));
+        }
+        writing = false;
+    });
+
+    std::size_t lastMovieCount = 0;
+    while (writing)
+    {
+        auto movieIds = service.getAllMovies();
+        EXPECT_GE(movieIds.size(), lastMovieCount); // Snapshots only grow
+        EXPECT_TRUE(std::is_sorted(movieIds.begin(), movieIds.end()));
+        lastMovieCount = movieIds.size();
+
+        for (auto movieId : movieIds)
+        {
+            EXPECT_FALSE(service.getMovieName(movieId).empty());
+        }
+    }
+    writer.join();
+
+    EXPECT_EQ(service.getAllMovies().size(), static_cast<std::size_t>(catalogSize));
+    EXPECT_TRUE(service.isMovieShownInTheater(1, 1));
+    EXPECT_TRUE(service.bookSeats(1, {0, 1}));
+    EXPECT_EQ(service.getAvailableSeats(1), (std::vector<int>{2, 3}));
+}
+
+/*------------------------------------------------------*/
+// Test case for a booking batch reporting each request's outcome
+TEST(MovieBookingServiceBatch, BookBatchPerRequestResults) {
+    MovieBookingService service;
+    const auto seats = numberedSeats(6);
+    service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+    service.addTheater(std::make_unique<Theater>(1, "Theater01", seats));
+    service.addTheater(std::make_unique<Theater>(2, "Theater02", seats));
+    ASSERT_TRUE(service.holdSeats(2, {5}, std::chrono::minutes(5)).has_value());
+
+    using Status = MovieBookingService::BookingStatus;
+    const auto results = service.bookBatch({
+        {10, 2, {0, 1}},
+        {11, 1, {0, 1}},
+        {12, 2, {1, 2}},    // Seat 1 went to request 10
+        {13, 9, {0}},       // Unknown theater
+        {14, 1, {2, 3, 2}}, // Repeated seat
+        {15, 1, {}},
+        {16, 2, {4, 5, 7}}, // Seat 5 is held, seat 7 does not exist
+        {17, 1, {2, 3}},
+    });
+
+    ASSERT_EQ(results.size(), 8u);
+    const std::vector<Status> expected{Status::Booked, Status::Booked, Status::Conflict, Status::UnknownTheater,
+                                       Status::Conflict, Status::NoSeats, Status::Conflict, Status::Booked};
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        EXPECT_EQ(results[i].requestId, 10 + i);
+        EXPECT_EQ(results[i].status, expected[i]) << "request " << results[i].requestId;
+    }
+    EXPECT_EQ(results[2].conflictingSeats, (std::vector<int>{1}));
+    EXPECT_EQ(results[4].conflictingSeats, (std::vector<int>{2}));
+    EXPECT_EQ(results[6].conflictingSeats, (std::vector<int>{5, 7}));
+    EXPECT_TRUE(results[0].conflictingSeats.empty());
+
+    EXPECT_EQ(service.getAvailableSeats(1), (std::vector<int>{4, 5}));
+    EXPECT_EQ(service.getAvailableSeats(2), (std::vector<int>{2, 3, 4}));
+    EXPECT_TRUE(service.bookBatch({}).empty());
+}
+
+/*------------------------------------------------------*/
+// Test case for availability counters following bookings, holds and allocations
+TEST(MovieBookingServiceAvailability, CountersFollowSeatChanges) {
+    MovieBookingService service;
+    auto seats = numberedSeats(5);
+    seats[4].isBooked = true;
+    // The theaters exist before the movies, so they are allocated afterwards
+    service.addTheater(std::make_unique<Theater>(1, "Theater01", seats));
+    service.addTheater(std::make_unique<Theater>(2, "Theater02", seats));
+    service.bookSeats(2, {0});
+    service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+    service.addMovie(std::make_unique<Movie>(2, "Movie02"));
+    service.addMovie(std::make_unique<Movie>(3, "Movie03")); // No theater left
+
+    EXPECT_EQ(service.getAvailableSeatCount(1), 4u);
+    EXPECT_EQ(service.getAvailableSeatCount(2), 3u);
+    EXPECT_EQ(service.getMovieAvailableSeatCount(1), 4u);
+    EXPECT_EQ(service.getMovieAvailableSeatCount(2), 3u);
+    EXPECT_EQ(service.getMovieAvailableSeatCount(3), 0u);
+    EXPECT_EQ(service.getMoviesWithAvailability(), (std::vector<int>{1, 2}));
+
+    const auto hold = service.holdSeats(1, {0, 1}, std::chrono::minutes(5));
+    ASSERT_TRUE(hold.has_value());
+    EXPECT_EQ(service.getMovieAvailableSeatCount(1), 2u);
+    EXPECT_TRUE(service.releaseHold(*hold));
+    EXPECT_EQ(service.getMovieAvailableSeatCount(1), 4u);
+
+    EXPECT_TRUE(service.bookSeats(2, {1, 2, 3}));
+    service.bookBatch({{1, 1, {0, 1}}, {2, 1, {2}}});
+    EXPECT_EQ(service.getAvailableSeatCount(2), 0u);
+    EXPECT_EQ(service.getMovieAvailableSeatCount(1), 1u);
+    EXPECT_EQ(service.getMoviesWithAvailability(), (std::vector<int>{1}));
+    EXPECT_EQ(service.getAvailableSeatCount(9), 0u);
+    EXPECT_EQ(service.getMovieAvailableSeatCount(9), 0u);
+
+    // A new theater is given to a movie and counted for it
+    service.addTheater(std::make_unique<Theater>(3, "Theater03", seats));
+    std::size_t total = 0;
+    for (int movieId = 1; movieId <= 3; ++movieId)
+        total += service.getMovieAvailableSeatCount(movieId);
+    EXPECT_EQ(total, 5u);
+}
+
+/*------------------------------------------------------*/
+// Test case for holding, confirming, releasing and expiring seat holds
+TEST(MovieBookingServiceHolds, HoldConfirmReleaseExpire) {
+    MovieBookingService service;
+    const auto seats = numberedSeats(6);
+    service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+    service.addTheater(std::make_unique<Theater>(1, "Theater01", seats));
+
+    auto hold = service.holdSeats(1, {0, 1}, std::chrono::minutes(5));
+    ASSERT_TRUE(hold.has_value());
+    EXPECT_FALSE(service.holdSeats(1, {1, 2}, std::chrono::minutes(5)).has_value()); // Seat 1 is held
+    EXPECT_FALSE(service.bookSeats(1, {0}));
+    EXPECT_EQ(service.getAvailableSeats(1), (std::vector<int>{2, 3, 4, 5}));
+
+    EXPECT_TRUE(service.confirmHold(*hold));
+    EXPECT_FALSE(service.confirmHold(*hold)); // Already confirmed
+    EXPECT_FALSE(service.releaseHold(*hold));
+    EXPECT_EQ(service.getAvailableSeats(1), (std::vector<int>{2, 3, 4, 5}));
+
+    auto released = service.holdSeats(1, {2, 3}, std::chrono::minutes(5));
+    ASSERT_TRUE(released.has_value());
+    EXPECT_TRUE(service.releaseHold(*released));
+    EXPECT_EQ(service.getAvailableSeats(1), (std::vector<int>{2, 3, 4, 5}));
+
+    auto expiring = service.holdSeats(1, {4, 5}, std::chrono::milliseconds(1));
+    ASSERT_TRUE(expiring.has_value());
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(service.expireHolds(), 1u);
+    EXPECT_FALSE(service.confirmHold(*expiring));
+    EXPECT_TRUE(service.bookSeats(1, {4, 5}));
+    EXPECT_EQ(service.getAvailableSeats(1), (std::vector<int>{2, 3}));
+}
+
+/*------------------------------------------------------*/
+// Test case for fixed-capacity theaters served alongside polymorphic ones
+TEST(MovieBookingServiceFixedTheater, MixesWithTheater) {
+    MovieBookingService service;
+    auto seats = numberedSeats(20);
+    seats[19].isBooked = true;
+    service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+    service.addTheater(std::make_unique<StandardTheater>(1, "Theater01", seats));
+    service.addTheater(std::make_unique<Theater>(2, "Theater02", seats));
+    EXPECT_EQ(service.getTheaterName(1), "Theater01");
+    EXPECT_EQ(service.getAvailableSeatCount(1), 19u);
+    EXPECT_EQ(service.getMovieAvailableSeatCount(1), 38u);
+
+    EXPECT_TRUE(service.bookSeats(1, {0, 1}));
+    EXPECT_FALSE(service.bookSeats(1, {1, 2}));
+    const auto hold = service.holdSeats(1, {2, 3}, std::chrono::minutes(5));
+    ASSERT_TRUE(hold.has_value());
+    EXPECT_EQ(service.getMovieAvailableSeatCount(1), 34u);
+    EXPECT_TRUE(service.confirmHold(*hold));
+
+    const auto results = service.bookBatch({{1, 1, {4, 5}}, {2, 2, {4, 5}}, {3, 1, {5, 6}}});
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].status, MovieBookingService::BookingStatus::Booked);
+    EXPECT_EQ(results[1].status, MovieBookingService::BookingStatus::Booked);
+    EXPECT_EQ(results[2].conflictingSeats, (std::vector<int>{5}));
+    EXPECT_EQ(service.getAvailableSeatCount(1), 13u);
+    EXPECT_EQ(service.getMovieAvailableSeatCount(1), 30u);
+    EXPECT_EQ(service.findBestAvailable(1, 3), (std::vector<int>{9, 10, 11}));
+
+    // Shows of a fixed theater share its layout and start with every seat free
+    ASSERT_TRUE(service.addShow({1, 1, 1, 0}));
+    EXPECT_EQ(service.getAvailableShowSeats(1).size(), 20u);
+}
@@ -0,0 +1,68 @@
+/**
+ * @file name_pool_test.cpp
+ * @brief Test for NamePool class and the interned names of movies and theaters
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "name_pool.hpp"
+#include "movie_booking_service.hpp"
+#include "movie.hpp"
+#include "theater.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/*------------------------------------------------------*/
+// Test case for equal names sharing one pooled copy
+TEST(NamePoolTest, InternsEqualNamesOnce) {
+    NamePool pool;
+    std::string name = "Screen 1";
+    const auto first = pool.intern(name);
+    name[7] = '2';
+    const auto second = pool.intern(name);
+
+    EXPECT_EQ(first, "Screen 1"); // Not affected by changes to the original
+    EXPECT_EQ(second, "Screen 2");
+    EXPECT_EQ(pool.intern("Screen 1").data(), first.data());
+    EXPECT_TRUE(pool.intern("").empty());
+    EXPECT_EQ(pool.size(), 2u);
+}
+
+/*------------------------------------------------------*/
+// Test case for pooled names staying valid as the pool grows
+TEST(NamePoolTest, NamesStayValid) {
+    NamePool pool;
+    const auto longName = pool.intern(std::string(5000, 'x'));
+    std::vector<std::string_view> names;
+    for (int i = 0; i < 2000; ++i)
+    {
+        names.push_back(pool.intern("Movie" + std::to_string(i)));
+    }
+
+    EXPECT_EQ(longName, std::string(5000, 'x'));
+    for (int i = 0; i < 2000; ++i)
+    {
+        EXPECT_EQ(names[i], "Movie" + std::to_string(i));
+    }
+}
+
+/*------------------------------------------------------*/
+// Test case for movies, theaters and the service sharing interned names
+TEST(NamePoolTest, ServiceNameViews) {
+    const std::vector<Seat> seats{Seat{0, "Seat 1", false}};
+    auto movie = std::make_unique<Movie>(1, std::string("Movie01"));
+    auto theater = std::make_unique<Theater>(7, std::string("Theater07"), seats);
+    EXPECT_EQ(movie->name.data(), NamePool::shared().intern("Movie01").data());
+    EXPECT_EQ(theater->getNameView().data(), Theater(8, "Theater07", seats).getNameView().data());
+
+    MovieBookingService service;
+    service.addMovie(std::move(movie));
+    service.addTheater(std::move(theater));
+
+    EXPECT_EQ(service.getMovieNameView(1), "Movie01");
+    EXPECT_EQ(service.getTheaterNameView(7), "Theater07");
+    EXPECT_EQ(service.getMovieName(1), "Movie01");
+    EXPECT_THROW(service.getMovieNameView(2), std::invalid_argument);
+    EXPECT_THROW(service.getTheaterNameView(8), std::invalid_argument);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file query_buffers_test.cpp
+ * @brief Test for the allocation-free, non-throwing queries of MovieBookingService
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "movie_booking_service.hpp"
+#include "test_service.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+
+std::atomic<std::size_t> gAllocations{0}; /**< Calls of the global operator new. */
+
+} // namespace
+
+// Count every allocation of this test binary (built on its own); the tests compare counts
+void* operator new(std::size_t size)
+{
+    ++gAllocations;
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+/*------------------------------------------------------*/
+// Test case for the buffer overloads returning what the vector overloads return
+TEST(QueryBuffersTest, MatchVectorOverloads) {
+    auto service = makeService({2, 1}, 4, 10);
+    ASSERT_TRUE(service->bookSeats(3, {1, 4}));
+
+    std::vector<int> ids{99};
+    service->getAllMovies(ids);
+    EXPECT_EQ(ids, service->getAllMovies());
+    EXPECT_EQ(ids, (std::vector<int>{1, 2}));
+
+    EXPECT_TRUE(service->getTheatersForMovie(2, ids));
+    EXPECT_EQ(ids, service->getTheatersForMovie(2));
+    EXPECT_FALSE(service->getTheatersForMovie(7, ids)); // No exception
+    EXPECT_TRUE(ids.empty());
+
+    EXPECT_TRUE(service->getAvailableSeats(3, ids));
+    EXPECT_EQ(ids, service->getAvailableSeats(3));
+    EXPECT_FALSE(service->getAvailableSeats(9, ids));
+    EXPECT_TRUE(ids.empty());
+
+    EXPECT_EQ(service->findMovieName(1), std::optional<std::string_view>("Movie01"));
+    EXPECT_EQ(service->findTheaterName(4), std::optional<std::string_view>("Theater04"));
+    EXPECT_FALSE(service->findMovieName(3).has_value());
+    EXPECT_FALSE(service->findTheaterName(5).has_value());
+}
+
+/*------------------------------------------------------*/
+// Test case for browse queries not allocating once the buffer is big enough
+TEST(QueryBuffersTest, NoAllocationWithWarmBuffer) {
+    auto service = makeService({2, 1}, 4, 10);
+    std::vector<int> ids;
+    ids.reserve(16);
+
+    // First calls may set up per-thread metrics
+    service->getAllMovies(ids);
+    service->getTheatersForMovie(1, ids);
+    service->getAvailableSeats(1, ids);
+    service->findMovieName(1);
+
+    const std::size_t before = gAllocations;
+    for (int round = 0; round < 100; ++round)
+    {
+        service->getAllMovies(ids);
+        service->getTheatersForMovie(1, ids);
+        service->getTheatersForMovie(9, ids);
+        service->getAvailableSeats(round % 4 + 1, ids);
+        service->getAvailableSeats(9, ids);
+        service->findMovieName(round % 3);
+        service->findTheaterName(round % 6);
+    }
+    EXPECT_EQ(gAllocations - before, 0u);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file service_metrics_test.cpp
+ * @brief Test for ServiceMetrics class and the metrics of MovieBookingService
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "service_metrics.hpp"
+#include "movie_booking_service.hpp"
+#include "movie.hpp"
+#include "theater.hpp"
+#include "seat.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*------------------------------------------------------*/
+// Test case for counts recorded on many threads being summed on read
+TEST(ServiceMetricsTest, SumsShardsOfAllThreads) {
+    ServiceMetrics metrics;
+    constexpr int kThreads = 8;
+    constexpr int kCalls = 1000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&metrics]() {
+            for (int i = 0; i < kCalls; ++i)
+            {
+                metrics.recordCall(ServiceMetrics::Operation::BookSeats, 1000, i % 4 == 0);
+                metrics.increment(ServiceMetrics::Counter::SeatConflicts);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const auto snapshot = metrics.snapshot();
+    const auto& bookings = snapshot.operations[static_cast<std::size_t>(ServiceMetrics::Operation::BookSeats)];
+    EXPECT_EQ(bookings.calls, static_cast<std::uint64_t>(kThreads * kCalls));
+    EXPECT_EQ(bookings.failures, static_cast<std::uint64_t>(kThreads * kCalls / 4));
+    EXPECT_EQ(bookings.latency.max(), 1000u);
+    EXPECT_EQ(snapshot.counters[static_cast<std::size_t>(ServiceMetrics::Counter::SeatConflicts)],
+              static_cast<std::uint64_t>(kThreads * kCalls));
+    EXPECT_EQ(snapshot.operations[static_cast<std::size_t>(ServiceMetrics::Operation::AddMovie)].calls, 0u);
+}
+
+/*------------------------------------------------------*/
+// Test case for calls ending by an exception being counted as failures
+TEST(ServiceMetricsTest, CallFailsOnException) {
+    ServiceMetrics metrics;
+    {
+        ServiceMetrics::Call call(metrics, ServiceMetrics::Operation::GetMovieName);
+        EXPECT_TRUE(call.succeeded(true));
+    }
+    try
+    {
+        ServiceMetrics::Call call(metrics, ServiceMetrics::Operation::GetMovieName);
+        throw std::invalid_argument("unknown movie");
+    }
+    catch (const std::invalid_argument&)
+    {
+    }
+
+    const auto snapshot = metrics.snapshot();
+    const auto& stats = snapshot.operations[static_cast<std::size_t>(ServiceMetrics::Operation::GetMovieName)];
+    EXPECT_EQ(stats.calls, 2u);
+    EXPECT_EQ(stats.failures, 1u);
+}
+
+/*------------------------------------------------------*/
+// Test case for the service recording calls, seat conflicts and lock waits
+TEST(ServiceMetricsTest, ServiceRecordsCallsAndConflicts) {
+    MovieBookingService service;
+    ASSERT_TRUE(service.addMovie(std::make_unique<Movie>(1, "Movie01")));
+    ASSERT_TRUE(service.addTheater(std::make_unique<Theater>(1, "Theater01", numberedSeats(20))));
+
+    EXPECT_TRUE(service.bookSeats(1, {1, 2}));
+    EXPECT_FALSE(service.bookSeats(1, {2, 3})); // Seat 2 is taken
+    EXPECT_FALSE(service.bookSeats(7, {1}));    // Unknown theater
+    EXPECT_THROW(service.getTheatersForMovie(9), std::invalid_argument);
+
+    const auto snapshot = service.getMetrics();
+    const auto& bookings = snapshot.operations[static_cast<std::size_t>(ServiceMetrics::Operation::BookSeats)];
+    EXPECT_EQ(bookings.calls, 3u);
+    EXPECT_EQ(bookings.failures, 2u);
+    EXPECT_EQ(snapshot.counters[static_cast<std::size_t>(ServiceMetrics::Counter::SeatConflicts)], 1u);
+
+    const auto& lookups = snapshot.operations[static_cast<std::size_t>(ServiceMetrics::Operation::GetTheatersForMovie)];
+    EXPECT_EQ(lookups.calls, 1u);
+    EXPECT_EQ(lookups.failures, 1u);
+
+    EXPECT_EQ(snapshot.lockWaits[static_cast<std::size_t>(ServiceMetrics::Lock::Writer)].count(), 2u);
+}
+
+/*------------------------------------------------------*/
+// Test case for text and JSON dumps naming every operation
+TEST(ServiceMetricsTest, DumpsTextAndJson) {
+    MovieBookingService service;
+    service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+
+    const std::string text = service.dumpMetrics();
+    const std::string json = service.dumpMetrics(ServiceMetrics::Format::Json);
+    for (std::size_t i = 0; i < ServiceMetrics::kOperations; ++i)
+    {
+        const std::string name = ServiceMetrics::name(static_cast<ServiceMetrics::Operation>(i));
+        EXPECT_NE(text.find(name), std::string::npos) << name;
+        EXPECT_NE(json.find("\"" + name + "\":{\"calls\":"), std::string::npos) << name;
+    }
+    EXPECT_NE(json.find("\"addMovie\":{\"calls\":1,\"failures\":0,"), std::string::npos);
+    EXPECT_NE(json.find("\"lockWaits\":{\"writer\":{\"acquisitions\":1,"), std::string::npos);
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+}
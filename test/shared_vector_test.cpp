@@ -0,0 +1,50 @@
+/**
+ * @file shared_vector_test.cpp
+ * @brief Test for SharedVector class
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "shared_vector.hpp"
+
+#include <vector>
+
+/*------------------------------------------------------*/
+// Test case for appending across many chunks and reading in order
+TEST(SharedVectorTest, AppendsAcrossChunks) {
+    SharedVector<int> values;
+    EXPECT_TRUE(values.empty());
+    for (int i = 0; i < 10000; ++i)
+        values.push_back(i * 3);
+
+    ASSERT_EQ(values.size(), 10000u);
+    EXPECT_EQ(values.back(), 29997);
+    int expected = 0;
+    for (const int value : values)
+    {
+        EXPECT_EQ(value, expected);
+        expected += 3;
+    }
+    EXPECT_EQ(values[4711], 4711 * 3);
+}
+
+/*------------------------------------------------------*/
+// Test case for copies sharing storage and seeing their own prefix
+TEST(SharedVectorTest, CopiesSeeTheirOwnPrefix) {
+    SharedVector<int> original;
+    original.push_back(1);
+    original.push_back(2);
+
+    SharedVector<int> copy = original;
+    EXPECT_TRUE(copy.isLatest());
+    copy.push_back(3);
+    EXPECT_TRUE(copy.isLatest());
+    EXPECT_FALSE(original.isLatest());
+    EXPECT_EQ(std::vector<int>(original.begin(), original.end()), (std::vector<int>{1, 2}));
+    EXPECT_EQ(original[2], 3); // Shared storage, past the original's end
+
+    // The original can no longer append in place; it detaches
+    original.push_back(4);
+    EXPECT_TRUE(original.isLatest());
+    EXPECT_EQ(std::vector<int>(original.begin(), original.end()), (std::vector<int>{1, 2, 4}));
+    EXPECT_EQ(std::vector<int>(copy.begin(), copy.end()), (std::vector<int>{1, 2, 3}));
+}
@@ -0,0 +1,139 @@
+/**
+ * @file show_test.cpp
+ * @brief Test for Show class and showtimes in MovieBookingService
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "show.hpp"
+#include "theater.hpp"
+#include "movie_booking_service.hpp"
+#include "seat.hpp"
+#include "test_service.hpp"
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr std::int64_t kEvening = 1760641200; // 2025-10-16 19:00 UTC
+constexpr std::int64_t kLate = kEvening + 3 * 3600;
+
+} // namespace
+
+/*------------------------------------------------------*/
+// Test case for shows sharing their theater's layout but not its seat state
+TEST(ShowTest, SharesLayoutNotSeatState) {
+    Theater theater(1, "Theater01", numberedSeats(20));
+    Show evening(ShowInfo{1, 1, 1, kEvening}, theater.getLayout());
+    Show late(ShowInfo{2, 1, 1, kLate}, theater.getLayout());
+
+    EXPECT_EQ(evening.getSeats().getLayout(), theater.getLayout());
+    EXPECT_EQ(late.getSeats().getLayout(), theater.getLayout());
+
+    EXPECT_TRUE(evening.getSeats().bookSeats({3, 4}));
+    EXPECT_FALSE(evening.getSeats().bookSeats({4}));
+    EXPECT_TRUE(late.getSeats().bookSeats({4}));
+
+    EXPECT_EQ(evening.getSeats().getAvailableSeatCount(), 18u);
+    EXPECT_EQ(late.getSeats().getAvailableSeatCount(), 19u);
+    EXPECT_EQ(theater.getAvailableSeatCount(), 20u);
+    EXPECT_EQ(evening.getSeats().getBookedSeats(), (std::vector<int>{3, 4}));
+    EXPECT_EQ(late.getSeats().getSeatNumber(4), "Seat 5");
+}
+
+/*------------------------------------------------------*/
+// Test case for adding shows and listing them by start time
+TEST(ServiceShowTest, AddsAndListsShows) {
+    auto service = makeService({1, 2}, 2, 20);
+
+    EXPECT_TRUE(service->addShow(ShowInfo{10, 1, 1, kLate}));
+    EXPECT_TRUE(service->addShow(ShowInfo{11, 1, 2, kEvening}));
+    EXPECT_TRUE(service->addShow(ShowInfo{12, 2, 1, kEvening}));
+
+    EXPECT_FALSE(service->addShow(ShowInfo{10, 2, 1, kLate}));    // Known show ID
+    EXPECT_FALSE(service->addShow(ShowInfo{13, 3, 1, kLate}));    // Unknown theater
+    EXPECT_FALSE(service->addShow(ShowInfo{13, 1, 3, kLate}));    // Unknown movie
+    EXPECT_FALSE(service->addShow(ShowInfo{13, 1, 1, kEvening})); // Theater 1 is busy
+
+    const auto movieShows = service->getShowsForMovie(1);
+    ASSERT_EQ(movieShows.size(), 2u);
+    EXPECT_EQ(movieShows[0].id, 12);
+    EXPECT_EQ(movieShows[1].id, 10);
+
+    const auto theaterShows = service->getShowsForTheater(1);
+    ASSERT_EQ(theaterShows.size(), 2u);
+    EXPECT_EQ(theaterShows[0].id, 11);
+    EXPECT_EQ(theaterShows[0].movieId, 2);
+    EXPECT_EQ(theaterShows[1].id, 10);
+
+    EXPECT_TRUE(service->getShowsForTheater(2).size() == 1u);
+    EXPECT_THROW(service->getShowsForMovie(9), std::invalid_argument);
+    EXPECT_THROW(service->getShowsForTheater(9), std::invalid_argument);
+}
+
+/*------------------------------------------------------*/
+// Test case for a week of shows added in one batch
+TEST(ServiceShowTest, AddsShowsInBatch) {
+    auto service = makeService({1, 2}, 2, 20);
+
+    std::vector<ShowInfo> week;
+    int showId = 100;
+    for (int day = 0; day < 7; ++day)
+    {
+        for (int theaterId = 1; theaterId <= 2; ++theaterId)
+        {
+            week.push_back(ShowInfo{showId++, theaterId, theaterId, kEvening + day * 86400});
+            week.push_back(ShowInfo{showId++, theaterId, theaterId, kLate + day * 86400});
+        }
+    }
+    week.push_back(ShowInfo{100, 1, 1, kEvening}); // Repeated, skipped
+
+    EXPECT_EQ(service->addShows(week), 28u);
+    EXPECT_EQ(service->getShowsForMovie(2).size(), 14u);
+    EXPECT_EQ(service->addShows({}), 0u);
+}
+
+/*------------------------------------------------------*/
+// Test case for seats being sold separately per show
+TEST(ServiceShowTest, BooksSeatsPerShow) {
+    auto service = makeService({1, 2}, 2, 20);
+    ASSERT_TRUE(service->addShow(ShowInfo{10, 1, 1, kEvening}));
+    ASSERT_TRUE(service->addShow(ShowInfo{11, 1, 1, kLate}));
+
+    EXPECT_TRUE(service->bookShowSeats(10, {0, 1}));
+    EXPECT_FALSE(service->bookShowSeats(10, {1, 2})); // Seat 1 is taken for 7pm
+    EXPECT_TRUE(service->bookShowSeats(11, {1, 2}));  // but free at 10pm
+    EXPECT_FALSE(service->bookShowSeats(12, {0}));    // Unknown show
+    EXPECT_FALSE(service->bookShowSeats(10, {}));
+
+    EXPECT_EQ(service->getAvailableShowSeats(10).size(), 18u);
+    EXPECT_EQ(service->getAvailableShowSeats(11).size(), 18u);
+    EXPECT_TRUE(service->getAvailableShowSeats(12).empty());
+    EXPECT_EQ(service->getAvailableSeats(1).size(), 20u);
+
+    EXPECT_EQ(service->findBestAvailableForShow(10, 2).size(), 2u);
+    EXPECT_TRUE(service->findBestAvailableForShow(10, 21).empty());
+}
+
+/*------------------------------------------------------*/
+// Test case for holding, confirming and releasing show seats
+TEST(ServiceShowTest, HoldsShowSeats) {
+    auto service = makeService({1, 2}, 2, 20);
+    ASSERT_TRUE(service->addShow(ShowInfo{10, 1, 1, kEvening}));
+
+    const auto confirmed = service->holdShowSeats(10, {5, 6}, std::chrono::minutes(5));
+    ASSERT_TRUE(confirmed.has_value());
+    EXPECT_FALSE(service->bookShowSeats(10, {6}));
+    EXPECT_TRUE(service->confirmHold(*confirmed));
+
+    const auto released = service->holdShowSeats(10, {7}, std::chrono::minutes(5));
+    ASSERT_TRUE(released.has_value());
+    EXPECT_TRUE(service->releaseHold(*released));
+
+    EXPECT_FALSE(service->holdShowSeats(10, {5}, std::chrono::minutes(5)).has_value());
+    EXPECT_FALSE(service->holdShowSeats(12, {5}, std::chrono::minutes(5)).has_value());
+    EXPECT_EQ(service->getAvailableShowSeats(10).size(), 18u);
+    EXPECT_EQ(service->getAvailableSeats(1).size(), 20u);
+}
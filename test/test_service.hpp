@@ -0,0 +1,48 @@
+/**
+ * @file test_service.hpp
+ * @brief Theaters and services built the same way by the tests and benchmarks.
+ * @author Gebremedhin Abreha
+ */
+#ifndef TEST_SERVICE_HPP
+#define TEST_SERVICE_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "movie_booking_service.hpp"
+#include "movie.hpp"
+#include "seat.hpp"
+#include "theater.hpp"
+
+/**
+ * @brief Make a theater with seats 0..seatCount-1, named "Theater01" for ID 1.
+ */
+inline std::unique_ptr<TheaterBase> makeTheater(int id, int seatCount)
+{
+    return std::make_unique<Theater>(id, "Theater" + std::string(id < 10 ? "0" : "") + std::to_string(id),
+                                     numberedSeats(seatCount));
+}
+
+/**
+ * @brief Service with movies added in the given order, then theaters
+ *        firstTheaterId..firstTheaterId+theaterCount-1 of seatCount seats.
+ *
+ * Movies are named "Movie01" for ID 1. Waiting movies take the theaters in
+ * order; theaters left over show a random movie.
+ */
+inline std::unique_ptr<MovieBookingService> makeService(const std::vector<int>& movieIds, int theaterCount,
+                                                        int seatCount, int firstTheaterId = 1)
+{
+    auto service = std::make_unique<MovieBookingService>();
+    for (const int id : movieIds)
+    {
+        service->addMovie(std::make_unique<Movie>(id, "Movie" + std::string(id < 10 ? "0" : "") + std::to_string(id)));
+    }
+    for (int id = firstTheaterId; id < firstTheaterId + theaterCount; ++id)
+    {
+        service->addTheater(makeTheater(id, seatCount));
+    }
+    return service;
+}
+
+#endif /* TEST_SERVICE_HPP */
@@ -0,0 +1,519 @@
+/**
+ * @file theater_test.cpp
+ * @brief Test for Theater class and its seat occupancy bitmap
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "theater.hpp"
+#include "fixed_theater.hpp"
+#include "seat.hpp"
+#include "seat_bitmap.hpp"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Numbered seats whose IDs start at firstId and advance by step.
+ */
+std::vector<Seat> makeSeats(int firstId, int count, int step = 1)
+{
+    auto seats = numberedSeats(count);
+    for (int i = 0; i < count; ++i)
+    {
+        seats[i].id = firstId + i * step;
+    }
+    return seats;
+}
+
+/**
+ * @brief Rows of seatsPerRow seats, row-major; seat IDs count from 0.
+ */
+std::vector<Seat> makeRows(int rows, int seatsPerRow)
+{
+    return numberedSeats(rows * seatsPerRow, seatsPerRow);
+}
+
+} // namespace
+
+/*------------------------------------------------------*/
+// Test case for SeatBitmap set/reset and counting across word boundaries
+TEST(SeatBitmapTest, SetResetAndCount) {
+    SeatBitmap bitmap(130);
+
+    EXPECT_EQ(bitmap.countFree(), 130u);
+    EXPECT_TRUE(bitmap.set(0));
+    EXPECT_TRUE(bitmap.set(64));
+    EXPECT_TRUE(bitmap.set(129));
+    EXPECT_FALSE(bitmap.set(64));   // Already taken
+    EXPECT_FALSE(bitmap.set(130));  // Out of range
+
+    EXPECT_EQ(bitmap.count(), 3u);
+    EXPECT_EQ(bitmap.countFree(), 127u);
+
+    EXPECT_TRUE(bitmap.reset(64));
+    EXPECT_FALSE(bitmap.reset(64));
+    EXPECT_FALSE(bitmap.test(64));
+    EXPECT_TRUE(bitmap.test(129));
+
+    std::vector<std::size_t> freeIndices;
+    bitmap.forEachFree([&](std::size_t index) { freeIndices.push_back(index); });
+    EXPECT_EQ(freeIndices.size(), 128u);
+    EXPECT_EQ(freeIndices.front(), 1u);
+    EXPECT_EQ(freeIndices.back(), 128u);
+}
+
+/*------------------------------------------------------*/
+// Test case for heap and inline bitmap words claiming seat sets all or nothing alike
+TEST(SeatBitmapTest, SetAllRollsBackOnConflict) {
+    const auto check = [](auto bitmap) {
+        EXPECT_TRUE(bitmap.set(70));
+        EXPECT_FALSE(bitmap.setAll({129, 3, 70})); // Words 0 and 2 are claimed before word 1 conflicts
+        EXPECT_EQ(bitmap.count(), 1u);
+        EXPECT_FALSE(bitmap.setAll({3, 3}));
+        EXPECT_TRUE(bitmap.setAll({129, 3, 65}));
+        EXPECT_EQ(bitmap.count(), 4u);
+        EXPECT_TRUE(bitmap.resetAll({3, 65}));
+        EXPECT_FALSE(bitmap.resetAll({3}));
+        EXPECT_EQ(bitmap.countFree(), 128u);
+    };
+    check(SeatBitmap(130));
+    check(FixedSeatBitmap<192>(130));
+    EXPECT_THROW(FixedSeatBitmap<128>(130), std::invalid_argument);
+}
+
+/*------------------------------------------------------*/
+// Test case for clearing a seat set only when every seat of it is taken
+TEST(SeatBitmapTest, ResetMasksIfTakenRollsBack) {
+    SeatBitmap bitmap(130);
+    SeatBitmap::Masks masks;
+    for (const std::size_t index : {3, 70, 129})
+    {
+        ASSERT_TRUE(bitmap.addToMasks(index, masks));
+    }
+
+    EXPECT_TRUE(bitmap.setAll({3, 129}));
+    EXPECT_FALSE(bitmap.resetMasksIfTaken(masks)); // Word 0 is cleared before word 1 is found free
+    EXPECT_TRUE(bitmap.test(3));
+    EXPECT_TRUE(bitmap.test(129));
+
+    EXPECT_TRUE(bitmap.set(70));
+    EXPECT_TRUE(bitmap.resetMasksIfTaken(masks));
+    EXPECT_FALSE(bitmap.resetMasksIfTaken(masks)); // A second claim of the same seats fails
+    EXPECT_EQ(bitmap.countFree(), 130u);
+}
+
+/*------------------------------------------------------*/
+// Test case for booking seats with contiguous seat IDs
+TEST(TheaterTest, BookSeatContiguousIds) {
+    Theater theater(1, "Theater01", makeSeats(0, 100));
+
+    EXPECT_TRUE(theater.bookSeat(0));
+    EXPECT_TRUE(theater.bookSeat(99));
+    EXPECT_FALSE(theater.bookSeat(99));  // Already booked
+    EXPECT_FALSE(theater.bookSeat(100)); // Unknown seat
+    EXPECT_FALSE(theater.bookSeat(-1));
+
+    EXPECT_EQ(theater.getAvailableSeatCount(), 98u);
+    auto available = theater.getAvailableSeats();
+    ASSERT_EQ(available.size(), 98u);
+    EXPECT_EQ(available.front(), 1);
+    EXPECT_EQ(available.back(), 98);
+}
+
+/*------------------------------------------------------*/
+// Test case for booking seats with sparse seat IDs and pre-booked seats
+TEST(TheaterTest, BookSeatSparseIds) {
+    auto seats = makeSeats(10, 5, 10); // 10, 20, 30, 40, 50
+    seats[2].isBooked = true;
+    Theater theater(1, "Theater01", seats);
+
+    EXPECT_EQ(theater.getAvailableSeats(), (std::vector<int>{10, 20, 40, 50}));
+    EXPECT_FALSE(theater.bookSeat(30));
+    EXPECT_FALSE(theater.bookSeat(15));
+    EXPECT_TRUE(theater.bookSeat(50));
+    EXPECT_EQ(theater.getAvailableSeats(), (std::vector<int>{10, 20, 40}));
+    EXPECT_EQ(theater.getSeatNumber(20), "Seat 2");
+    EXPECT_EQ(theater.getSeatNumber(15), "");
+}
+
+/*------------------------------------------------------*/
+// Test case for seat numbers that are computed or kept in the layout
+TEST(TheaterTest, SeatNumbersComputedOrStored) {
+    // "Seat 1", "Seat 2", ... follow a pattern and are computed
+    const SeatLayout numbered(makeSeats(100, 12));
+    EXPECT_EQ(numbered.seatNumber(0), "Seat 1");
+    EXPECT_EQ(numbered.seatNumber(11), "Seat 12");
+    EXPECT_EQ(numbered.seatId(11), 111);
+
+    // Row labels and zero-padded numbers are kept as given
+    auto seats = makeSeats(0, 4, 3);
+    seats[0].seatNumber = "A9";
+    seats[1].seatNumber = "A10";
+    seats[2].seatNumber = "B1";
+    seats[3].seatNumber = "";
+    const SeatLayout labeled(seats);
+    EXPECT_EQ(labeled.seatNumber(0), "A9");
+    EXPECT_EQ(labeled.seatNumber(1), "A10");
+    EXPECT_EQ(labeled.seatNumber(2), "B1");
+    EXPECT_EQ(labeled.seatNumber(3), "");
+    EXPECT_EQ(labeled.seatId(3), 9);
+
+    auto padded = makeSeats(0, 2);
+    padded[0].seatNumber = "07";
+    padded[1].seatNumber = "08";
+    EXPECT_EQ(SeatLayout(padded).seatNumber(1), "08");
+
+    const auto roundTrip = labeled.getSeats();
+    ASSERT_EQ(roundTrip.size(), 4u);
+    EXPECT_EQ(roundTrip[1].seatNumber, "A10");
+    EXPECT_EQ(roundTrip[1].id, 3);
+}
+
+/*------------------------------------------------------*/
+// Test case for a shared availability counter attached while seats are booked
+TEST(TheaterTest, AvailabilityCounterExactUnderRace) {
+    const int seatCount = 4096;
+    Theater first(1, "Theater01", makeSeats(0, seatCount));
+    Theater second(2, "Theater02", makeSeats(0, 8));
+    auto counter = std::make_shared<std::atomic<std::int64_t>>(0);
+    EXPECT_TRUE(second.attachAvailabilityCounter(counter));
+    EXPECT_FALSE(second.attachAvailabilityCounter(counter));
+    EXPECT_EQ(counter->load(), 8);
+
+    std::thread booker([&first]() {
+        for (int id = 0; id < seatCount; id += 2)
+            first.bookSeats({id, id + 1});
+    });
+    first.attachAvailabilityCounter(counter); // Somewhere during the bookings
+    booker.join();
+
+    EXPECT_EQ(first.getAvailableSeatCount(), 0u);
+    EXPECT_EQ(counter->load(), 8);
+    EXPECT_TRUE(second.holdSeats({1, 2}));
+    EXPECT_TRUE(second.releaseSeats({1}));
+    EXPECT_EQ(second.getAvailableSeatCount(), 7u);
+    EXPECT_EQ(counter->load(), 7);
+
+    // Copies start detached with the same count
+    SeatInventory copy(second.getLayout());
+    copy = SeatInventory(copy);
+    EXPECT_EQ(copy.getAvailableSeatCount(), 8u);
+}
+
+/*------------------------------------------------------*/
+// Test case for all-or-nothing multi-seat booking
+TEST(TheaterTest, BookSeatsAllOrNothing) {
+    Theater theater(1, "Theater01", makeSeats(0, 130));
+
+    EXPECT_TRUE(theater.bookSeats({1, 2, 65, 129}));
+    EXPECT_FALSE(theater.bookSeats({3, 64, 65}));   // 65 is taken
+    EXPECT_FALSE(theater.bookSeats({3, 4, 4}));     // Repeated seat
+    EXPECT_FALSE(theater.bookSeats({3, 130}));      // Unknown seat
+
+    // Nothing of the failed requests is left booked
+    EXPECT_EQ(theater.getAvailableSeatCount(), 126u);
+    EXPECT_TRUE(theater.bookSeats({3, 4, 64}));
+}
+
+/*------------------------------------------------------*/
+// Test case for concurrent overlapping group bookings: no seat is sold twice
+TEST(TheaterTest, BookSeatsConcurrentNoOverbooking) {
+    const int seatCount = 256;
+    Theater theater(1, "Theater01", makeSeats(0, seatCount));
+    std::atomic<int> bookedSeats{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([&theater, &bookedSeats, t, seatCount]() {
+            // Pairs straddle word boundaries and overlap between threads
+            for (int first = t % 2; first + 1 < seatCount; first += 2)
+            {
+                if (theater.bookSeats({first, first + 1}))
+                    bookedSeats += 2;
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(static_cast<std::size_t>(bookedSeats.load()), seatCount - theater.getAvailableSeatCount());
+}
+
+/*------------------------------------------------------*/
+// Test case for held seat states
+TEST(TheaterTest, HoldConfirmRelease) {
+    Theater theater(1, "Theater01", makeSeats(0, 4));
+
+    EXPECT_TRUE(theater.holdSeats({0, 1}));
+    EXPECT_EQ(theater.getSeatState(0), SeatState::Held);
+    EXPECT_FALSE(theater.bookSeats({1, 2}));
+    EXPECT_FALSE(theater.confirmSeats({1, 2}));  // Seat 2 is not held
+    EXPECT_EQ(theater.getSeatState(1), SeatState::Held);
+
+    EXPECT_TRUE(theater.confirmSeats({0}));
+    EXPECT_EQ(theater.getSeatState(0), SeatState::Booked);
+    EXPECT_FALSE(theater.releaseSeats({0}));     // Booked seats are not released
+    EXPECT_TRUE(theater.releaseSeats({1}));
+    EXPECT_EQ(theater.getSeatState(1), SeatState::Free);
+    EXPECT_EQ(theater.getAvailableSeats(), (std::vector<int>{1, 2, 3}));
+}
+
+/*------------------------------------------------------*/
+// Test case for racing releases and confirms of one hold: one wins, a stale
+// release never frees seats booked after the hold ended
+TEST(TheaterTest, ConcurrentHoldEndsClaimOnce) {
+    Theater theater(1, "Theater01", makeSeats(0, 130));
+    const std::vector<int> seatIds = {1, 64, 129};
+
+    for (int round = 0; round < 1000; ++round)
+    {
+        ASSERT_TRUE(theater.holdSeats(seatIds));
+        std::atomic<int> ended{0};
+        std::atomic<int> ready{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 3; ++t)
+        {
+            threads.emplace_back([&theater, &seatIds, &ended, &ready, t]() {
+                // Start together, so the three calls overlap
+                ++ready;
+                while (ready.load() < 3)
+                    std::this_thread::yield();
+                const bool released = t == 2 ? theater.confirmSeats(seatIds) : theater.releaseSeats(seatIds);
+                if (released)
+                    ++ended;
+                // Whoever released rebooks at once, racing the stale callers
+                if (released && t != 2)
+                    EXPECT_TRUE(theater.bookSeats(seatIds));
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        ASSERT_EQ(ended.load(), 1);
+        for (const int id : seatIds)
+        {
+            ASSERT_EQ(theater.getSeatState(id), SeatState::Booked);
+        }
+        ASSERT_EQ(theater.getAvailableSeatCount(), theater.getAvailableSeats().size());
+        ASSERT_TRUE(theater.cancelSeats(seatIds));
+    }
+}
+
+/*------------------------------------------------------*/
+// Test case for seats read while holds come and go never reading as booked
+TEST(TheaterTest, HeldSeatsNeverReadAsBooked) {
+    Theater theater(1, "Theater01", makeSeats(0, 256));
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> holders;
+    for (int t = 0; t < 2; ++t)
+    {
+        holders.emplace_back([&theater, &done, t]() {
+            std::vector<int> seatIds;
+            for (int id = t; id < 256; id += 2)
+                seatIds.push_back(id);
+            while (!done.load())
+            {
+                if (theater.holdSeats(seatIds))
+                    theater.releaseSeats(seatIds);
+            }
+        });
+    }
+
+    std::size_t bookedReads = 0;
+    for (int i = 0; i < 500; ++i)
+    {
+        for (const auto& seat : theater.getSeats())
+            bookedReads += seat.isBooked;
+    }
+    done = true;
+    for (auto& holder : holders)
+    {
+        holder.join();
+    }
+    EXPECT_EQ(bookedReads, 0u);
+}
+
+/*------------------------------------------------------*/
+// Test case for SeatBitmap free runs clipped to a range and crossing words
+TEST(SeatBitmapTest, ForEachFreeRun) {
+    SeatBitmap bitmap(200);
+    for (const std::size_t index : {3u, 4u, 70u, 150u})
+    {
+        bitmap.set(index);
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> runs;
+    bitmap.forEachFreeRun(2, 160, [&runs](std::size_t begin, std::size_t end) {
+        runs.emplace_back(begin, end);
+    });
+    EXPECT_EQ(runs, (std::vector<std::pair<std::size_t, std::size_t>>{{2, 3}, {5, 70}, {71, 150}, {151, 160}}));
+
+    runs.clear();
+    bitmap.forEachFreeRun(3, 5, [&runs](std::size_t begin, std::size_t end) {
+        runs.emplace_back(begin, end);
+    });
+    EXPECT_TRUE(runs.empty());
+}
+
+/*------------------------------------------------------*/
+// Test case for finding adjacent seats in the middle of the middle row first
+TEST(TheaterTest, FindBestAvailableMiddleRowFirst) {
+    Theater theater(1, "Theater01", makeRows(5, 10));
+
+    // Row 2 is the middle row; seats 4 and 5 are the middle of it
+    EXPECT_EQ(theater.findBestAvailable(2), (std::vector<int>{24, 25}));
+    EXPECT_EQ(theater.findBestAvailable(3), (std::vector<int>{24, 25, 26}));
+
+    // A party that no longer fits in the middle row moves back a row first
+    ASSERT_TRUE(theater.bookSeats({22, 23}));
+    ASSERT_TRUE(theater.bookSeats({26, 27}));
+    EXPECT_EQ(theater.findBestAvailable(2), (std::vector<int>{24, 25}));
+    EXPECT_EQ(theater.findBestAvailable(3), (std::vector<int>{34, 35, 36}));
+
+    EXPECT_EQ(theater.findBestAvailable(10), (std::vector<int>{30, 31, 32, 33, 34, 35, 36, 37, 38, 39}));
+    EXPECT_TRUE(theater.findBestAvailable(11).empty());
+    EXPECT_TRUE(theater.findBestAvailable(0).empty());
+}
+
+/*------------------------------------------------------*/
+// Test case for aisles (position gaps) and held seats breaking adjacency
+TEST(TheaterTest, FindBestAvailableRespectsGapsAndHolds) {
+    // One row: positions 0-3, an aisle, then positions 5-8
+    auto seats = makeRows(1, 8);
+    for (int i = 4; i < 8; ++i)
+    {
+        seats[i].position = i + 1;
+    }
+    Theater theater(1, "Theater01", seats);
+
+    EXPECT_TRUE(theater.findBestAvailable(5).empty());
+    EXPECT_EQ(theater.findBestAvailable(4).size(), 4u);
+
+    ASSERT_TRUE(theater.holdSeats({1}));
+    EXPECT_EQ(theater.findBestAvailable(4), (std::vector<int>{4, 5, 6, 7}));
+
+    // Structured seats come back from getSeats
+    const auto layout = theater.getSeats();
+    EXPECT_EQ(layout[5].row, 0);
+    EXPECT_EQ(layout[5].position, 6);
+}
+
+/*------------------------------------------------------*/
+// Test case for theaters without rows being searched as one row
+TEST(TheaterTest, FindBestAvailableWithoutRows) {
+    Theater theater(1, "Theater01", makeSeats(100, 9));
+
+    EXPECT_EQ(theater.findBestAvailable(3), (std::vector<int>{103, 104, 105}));
+    ASSERT_TRUE(theater.bookSeat(104));
+    EXPECT_EQ(theater.findBestAvailable(3), (std::vector<int>{101, 102, 103}));
+    EXPECT_EQ(theater.getSeats()[0].row, Seat::kNoRow);
+}
+
+/*------------------------------------------------------*/
+// Test case for a fixed-capacity theater matching Theater seat semantics
+TEST(FixedTheaterTest, BookHoldConfirmRelease) {
+    FixedTheater<130> theater(1, "Theater01", makeSeats(10, 130, 3));
+    EXPECT_EQ(theater.getAvailableSeatCount(), 130u);
+
+    EXPECT_TRUE(theater.bookSeat(10));
+    EXPECT_FALSE(theater.bookSeat(10));
+    EXPECT_FALSE(theater.bookSeat(11));             // Not a seat ID
+    EXPECT_TRUE(theater.bookSeats({13, 10 + 64 * 3, 10 + 129 * 3}));
+    EXPECT_FALSE(theater.bookSeats({16, 16}));       // Repeated seat
+    EXPECT_FALSE(theater.bookSeats({19, 13}));       // Seat 13 is taken, 19 is not claimed
+    EXPECT_EQ(theater.getSeatState(19), SeatState::Free);
+
+    EXPECT_TRUE(theater.holdSeats({16, 19}));
+    EXPECT_EQ(theater.getSeatState(16), SeatState::Held);
+    EXPECT_FALSE(theater.confirmSeats({16, 22}));    // Seat 22 is not held
+    EXPECT_TRUE(theater.confirmSeats({16}));
+    EXPECT_EQ(theater.getSeatState(16), SeatState::Booked);
+    EXPECT_FALSE(theater.releaseSeats({16}));
+    EXPECT_TRUE(theater.releaseSeats({19}));
+    EXPECT_EQ(theater.getSeatState(19), SeatState::Free);
+    EXPECT_EQ(theater.getSeatState(11), SeatState::Booked);
+
+    EXPECT_EQ(theater.getAvailableSeatCount(), 125u);
+    const auto available = theater.getAvailableSeats();
+    ASSERT_EQ(available.size(), 125u);
+    EXPECT_EQ(available.front(), 19);
+    EXPECT_EQ(available.back(), 10 + 128 * 3);
+
+    const auto seats = theater.getSeats();
+    ASSERT_EQ(seats.size(), 130u);
+    EXPECT_TRUE(seats[2].isBooked);
+    EXPECT_FALSE(seats[3].isBooked);
+    EXPECT_EQ(theater.getSeatNumber(13), "Seat 2");
+}
+
+/*------------------------------------------------------*/
+// Test case for a fixed theater through the Theater interface and a shared layout
+TEST(FixedTheaterTest, BehavesLikeTheater) {
+    const auto layout = std::make_shared<const SeatLayout>(makeRows(5, 10));
+    std::unique_ptr<TheaterBase> fixed = std::make_unique<FixedTheater<64>>(1, "Theater01", layout);
+    Theater theater(2, "Theater02", layout);
+    EXPECT_EQ(fixed->getLayout(), layout);
+
+    for (TheaterBase* target : {fixed.get(), static_cast<TheaterBase*>(&theater)})
+    {
+        ASSERT_TRUE(target->bookSeats({22, 23}));
+        ASSERT_TRUE(target->holdSeats({26, 27}));
+    }
+    EXPECT_EQ(fixed->findBestAvailable(3), theater.findBestAvailable(3));
+    EXPECT_EQ(fixed->getAvailableSeats(), theater.getAvailableSeats());
+
+    auto counter = std::make_shared<std::atomic<std::int64_t>>(0);
+    EXPECT_TRUE(fixed->attachAvailabilityCounter(counter));
+    EXPECT_FALSE(fixed->attachAvailabilityCounter(counter));
+    EXPECT_EQ(counter->load(), 46);
+    EXPECT_TRUE(fixed->releaseSeats({26, 27}));
+    EXPECT_TRUE(fixed->bookSeat(0));
+    EXPECT_EQ(counter->load(), 47);
+
+    // Seats booked in the given list start booked; too many seats are rejected
+    auto seats = makeSeats(0, 20);
+    seats[5].isBooked = true;
+    StandardTheater standard(3, "Theater03", seats);
+    EXPECT_EQ(standard.getAvailableSeatCount(), 19u);
+    EXPECT_EQ(standard.getSeatState(5), SeatState::Booked);
+    EXPECT_THROW(StandardTheater(4, "Theater04", makeSeats(0, 21)), std::invalid_argument);
+}
+
+/*------------------------------------------------------*/
+// Test case for concurrent seat-pair bookings on a fixed theater
+TEST(FixedTheaterTest, ConcurrentBookingsNeverOverbook) {
+    constexpr std::size_t seatCount = 200;
+    FixedTheater<seatCount> theater(1, "Theater01", makeSeats(0, seatCount));
+    std::atomic<int> bookedSeats{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([&theater, &bookedSeats, t]() {
+            // Overlapping pairs, some straddling a word boundary
+            for (int first = t % 2; first + 1 < static_cast<int>(seatCount); first += 2)
+            {
+                if (theater.bookSeats({first, first + 1}))
+                    bookedSeats += 2;
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(static_cast<std::size_t>(bookedSeats.load()), seatCount - theater.getAvailableSeatCount());
+    EXPECT_EQ(theater.getAvailableSeats().size(), theater.getAvailableSeatCount());
+}
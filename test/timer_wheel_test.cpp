@@ -0,0 +1,52 @@
+/**
+ * @file timer_wheel_test.cpp
+ * @brief Test for TimerWheel class
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "timer_wheel.hpp"
+
+#include <vector>
+
+/*------------------------------------------------------*/
+// Test case for timers firing exactly at their tick on every wheel level
+TEST(TimerWheelTest, FiresAtExpiryAcrossLevels) {
+    TimerWheel wheel(10);
+    const std::vector<std::uint64_t> expiries = {11, 265, 300, 70000, 20000000, (std::uint64_t{1} << 33)};
+    for (std::size_t i = 0; i < expiries.size(); ++i)
+    {
+        wheel.schedule(i, expiries[i]);
+    }
+    EXPECT_EQ(wheel.size(), expiries.size());
+
+    std::vector<TimerWheel::TimerId> expired;
+    for (std::size_t i = 0; i < expiries.size(); ++i)
+    {
+        wheel.advance(expiries[i] - 1, expired);
+        EXPECT_TRUE(expired.empty()) << "timer " << i << " fired early";
+
+        wheel.advance(expiries[i], expired);
+        ASSERT_EQ(expired.size(), 1u);
+        EXPECT_EQ(expired[0], i);
+        expired.clear();
+    }
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+/*------------------------------------------------------*/
+// Test case for past expiries and jumping far ahead in one advance
+TEST(TimerWheelTest, PastExpiryAndLargeAdvance) {
+    TimerWheel wheel(1000);
+    wheel.schedule(1, 5);      // In the past: fires on the next tick
+    wheel.schedule(2, 1500);
+    wheel.schedule(3, 1500);
+
+    std::vector<TimerWheel::TimerId> expired;
+    wheel.advance(1001, expired);
+    EXPECT_EQ(expired, (std::vector<TimerWheel::TimerId>{1}));
+
+    expired.clear();
+    wheel.advance(100000, expired);
+    EXPECT_EQ(expired, (std::vector<TimerWheel::TimerId>{2, 3}));
+    EXPECT_EQ(wheel.now(), 100000u);
+}
@@ -0,0 +1,316 @@
+/**
+ * @file write_ahead_log_test.cpp
+ * @brief Test for WriteAheadLog class and durable MovieBookingService recovery
+ * @author Gebremedhin Abreha
+ */
+#include "gtest/gtest.h"
+#include "write_ahead_log.hpp"
+#include "movie_booking_service.hpp"
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <system_error>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+
+/**
+ * @brief Log path in the test temp directory, removed with its side files.
+ */
+class TemporaryLog {
+public:
+    explicit TemporaryLog(const std::string& name) : mPath(::testing::TempDir() + name) { clean(); }
+    ~TemporaryLog() { clean(); }
+    const std::string& path() const { return mPath; }
+
+private:
+    void clean()
+    {
+        for (const auto& suffix : {"", ".old", ".checkpoint", ".checkpoint.tmp"})
+            std::remove((mPath + suffix).c_str());
+    }
+    std::string mPath;
+};
+
+/**
+ * @brief Make appends to a log fail, as on a full disk, while in scope.
+ */
+class FullLog {
+public:
+    explicit FullLog(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        ::getrlimit(RLIMIT_FSIZE, &mPrevious);
+        rlimit full = mPrevious;
+        full.rlim_cur = static_cast<rlim_t>(file.tellg());
+        mHandler = std::signal(SIGXFSZ, SIG_IGN);
+        ::setrlimit(RLIMIT_FSIZE, &full);
+    }
+    ~FullLog()
+    {
+        ::setrlimit(RLIMIT_FSIZE, &mPrevious);
+        std::signal(SIGXFSZ, mHandler);
+    }
+
+private:
+    rlimit mPrevious{};
+    void (*mHandler)(int) = SIG_DFL;
+};
+
+std::vector<std::string> readAll(const std::string& path)
+{
+    std::vector<std::string> records;
+    WriteAheadLog::readRecords(path, [&](const std::string& record) { records.push_back(record); });
+    return records;
+}
+
+} // namespace
+
+/*------------------------------------------------------*/
+// Test case for group commit: concurrent appends are all durable and share syncs
+TEST(WriteAheadLogTest, ConcurrentAppendsRoundTrip) {
+    TemporaryLog log("wal_concurrent.log");
+    const int threads = 4;
+    const int perThread = 50;
+    {
+        WriteAheadLog wal(log.path());
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t)
+        {
+            writers.emplace_back([&wal, t]() {
+                for (int i = 0; i < perThread; ++i)
+                    wal.append("record-" + std::to_string(t) + "-" + std::to_string(i));
+            });
+        }
+        for (auto& writer : writers)
+            writer.join();
+        EXPECT_LE(wal.syncCount(), static_cast<std::uint64_t>(threads * perThread));
+    }
+    EXPECT_EQ(readAll(log.path()).size(), static_cast<std::size_t>(threads * perThread));
+}
+
+/*------------------------------------------------------*/
+// Test case for recovery cutting a torn tail before appending again
+TEST(WriteAheadLogTest, RecoverTruncatesTornTail) {
+    TemporaryLog log("wal_torn.log");
+    {
+        WriteAheadLog wal(log.path());
+        wal.append("first");
+        wal.append("second");
+    }
+    {
+        std::ofstream file(log.path(), std::ios::binary | std::ios::app);
+        file.write("\x20\x00\x00\x00garbage", 11); // Header of a record that never finished
+    }
+    {
+        WriteAheadLog wal(log.path());
+        std::vector<std::string> recovered;
+        EXPECT_EQ(wal.recover([&](const std::string& record) { recovered.push_back(record); }), 2u);
+        EXPECT_EQ(recovered, (std::vector<std::string>{"first", "second"}));
+        wal.append("third");
+    }
+    EXPECT_EQ(readAll(log.path()), (std::vector<std::string>{"first", "second", "third"}));
+}
+
+/*------------------------------------------------------*/
+// Test case for a durable service recovering catalog, bookings and confirmed holds
+TEST(DurableMovieBookingServiceTest, RecoversStateFromLogAndCheckpoint) {
+    TemporaryLog log("service.log");
+    const auto rows = numberedSeats(8, 4);
+    {
+        MovieBookingService service(log.path());
+        service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+        service.addTheater(std::make_unique<Theater>(1, "Theater01", numberedSeats(8)));
+        service.addTheater(std::make_unique<Theater>(2, "Theater02", rows));
+        EXPECT_TRUE(service.bookSeats(1, {0, 1}));
+
+        service.checkpoint();
+
+        EXPECT_TRUE(service.bookSeats(1, {2}));
+        auto confirmed = service.holdSeats(2, {5, 6}, std::chrono::minutes(5));
+        auto pending = service.holdSeats(2, {7}, std::chrono::minutes(5));
+        ASSERT_TRUE(confirmed && pending);
+        EXPECT_TRUE(service.confirmHold(*confirmed));
+    }
+
+    MovieBookingService recovered(log.path());
+    EXPECT_EQ(recovered.getAllMovies(), (std::vector<int>{1}));
+    EXPECT_EQ(recovered.getTheaterName(2), "Theater02");
+    EXPECT_TRUE(recovered.isMovieShownInTheater(1, 1));
+    EXPECT_EQ(recovered.getAvailableSeats(1), (std::vector<int>{3, 4, 5, 6, 7}));
+    EXPECT_EQ(recovered.getAvailableSeats(2), (std::vector<int>{0, 1, 2, 3, 4, 7})); // Pending hold is gone
+    EXPECT_EQ(recovered.findBestAvailable(2, 2), (std::vector<int>{1, 2})); // Rows are recovered too
+    EXPECT_FALSE(recovered.bookSeats(1, {2}));
+}
+
+/*------------------------------------------------------*/
+// Test case for checkpoints racing holds never recording a held seat as booked
+TEST(DurableMovieBookingServiceTest, CheckpointDuringHoldsKeepsSeatsFree) {
+    TemporaryLog log("service_holds.log");
+    {
+        MovieBookingService service(log.path());
+        service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+        service.addTheater(std::make_unique<Theater>(1, "Theater01", numberedSeats(130)));
+
+        std::atomic<bool> done{false};
+        std::vector<std::thread> holders;
+        for (int t = 0; t < 2; ++t)
+        {
+            holders.emplace_back([&service, &done, t]() {
+                // Every other seat, across all bitmap words; every hold is released
+                std::vector<int> seatIds;
+                for (int id = t; id < 130; id += 2)
+                    seatIds.push_back(id);
+                while (!done.load())
+                {
+                    if (auto hold = service.holdSeats(1, seatIds, std::chrono::minutes(5)))
+                        service.releaseHold(*hold);
+                }
+            });
+        }
+        for (int i = 0; i < 100; ++i)
+        {
+            service.checkpoint();
+        }
+        done = true;
+        for (auto& holder : holders)
+        {
+            holder.join();
+        }
+    }
+
+    MovieBookingService recovered(log.path());
+    EXPECT_EQ(recovered.getAvailableSeats(1).size(), 130u);
+}
+
+/*------------------------------------------------------*/
+// Test case for bookings whose log append fails leaving their seats free
+TEST(DurableMovieBookingServiceTest, FailedAppendUndoesBooking) {
+    TemporaryLog log("service_full.log");
+    MovieBookingService service(log.path());
+    service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+    service.addTheater(std::make_unique<Theater>(1, "Theater01", numberedSeats(8)));
+    ASSERT_TRUE(service.addShow({10, 1, 1, 1000}));
+    auto hold = service.holdSeats(1, {6, 7}, std::chrono::minutes(5));
+    ASSERT_TRUE(hold.has_value());
+
+    {
+        const FullLog full(log.path());
+        EXPECT_THROW(service.bookSeats(1, {0, 1}), std::system_error);
+        EXPECT_THROW(service.bookShowSeats(10, {2}), std::system_error);
+        EXPECT_THROW(service.bookBatch({{1, 1, {2, 3}}, {2, 1, {4}}}), std::system_error);
+        EXPECT_THROW(service.confirmHold(*hold), std::system_error);
+    }
+
+    EXPECT_EQ(service.getAvailableSeats(1), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+    EXPECT_EQ(service.getAvailableSeatCount(1), 8u);
+    EXPECT_EQ(service.getAvailableShowSeats(10).size(), 8u);
+    EXPECT_FALSE(service.confirmHold(*hold)); // The hold went with the failed confirm
+}
+
+/*------------------------------------------------------*/
+// Test case for catalog changes whose log append fails leaving allocations unmarked
+TEST(DurableMovieBookingServiceTest, FailedAppendLeavesAllocationsUnmarked) {
+    // The new theater would show the waiting movie
+    {
+        TemporaryLog log("service_full_theater.log");
+        MovieBookingService service(log.path());
+        ASSERT_TRUE(service.addMovie(std::make_unique<Movie>(1, "Movie01")));
+
+        const FullLog full(log.path());
+        EXPECT_THROW(service.addTheater(std::make_unique<Theater>(1, "Theater01", numberedSeats(4))),
+                     std::system_error);
+        EXPECT_TRUE(service.getTheatersForMovie(1).empty());
+        EXPECT_EQ(service.getMovieAvailableSeatCount(1), 0u);
+    }
+
+    // The new movie would take the free theater
+    {
+        TemporaryLog log("service_full_movie.log");
+        MovieBookingService service(log.path());
+        auto theater = std::make_unique<Theater>(1, "Theater01", numberedSeats(8));
+        auto* published = theater.get();
+        ASSERT_TRUE(service.addTheater(std::move(theater)));
+
+        const FullLog full(log.path());
+        EXPECT_THROW(service.addMovie(std::make_unique<Movie>(1, "Movie01")), std::system_error);
+        EXPECT_FALSE(service.isValidMovie(1));
+        EXPECT_FALSE(published->isAllocated());
+        EXPECT_TRUE(published->attachAvailabilityCounter(std::make_shared<std::atomic<std::int64_t>>(0)));
+    }
+}
+
+/*------------------------------------------------------*/
+// Test case for periodic checkpoints keeping the log short
+TEST(DurableMovieBookingServiceTest, PeriodicCheckpointTruncatesLog) {
+    TemporaryLog log("service_periodic.log");
+    {
+        MovieBookingService service(log.path(), 10);
+        service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+        service.addTheater(std::make_unique<Theater>(1, "Theater01", numberedSeats(64)));
+        for (int seatId = 0; seatId < 40; ++seatId)
+        {
+            EXPECT_TRUE(service.bookSeats(1, {seatId}));
+        }
+        EXPECT_LT(readAll(log.path()).size(), 10u);
+    }
+
+    MovieBookingService recovered(log.path(), 10);
+    EXPECT_EQ(recovered.getAvailableSeats(1).size(), 24u);
+}
+
+/*------------------------------------------------------*/
+// Test case for a durable service recovering shows and their bookings
+TEST(DurableMovieBookingServiceTest, RecoversShows) {
+    TemporaryLog log("service_shows.log");
+    {
+        MovieBookingService service(log.path());
+        service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+        service.addTheater(std::make_unique<Theater>(1, "Theater01", numberedSeats(8)));
+        EXPECT_TRUE(service.addShow(ShowInfo{10, 1, 1, 1000}));
+        EXPECT_TRUE(service.bookShowSeats(10, {0, 1}));
+
+        service.checkpoint();
+
+        EXPECT_EQ(service.addShows({ShowInfo{11, 1, 1, 2000}, ShowInfo{12, 1, 1, 3000}}), 2u);
+        EXPECT_TRUE(service.bookShowSeats(11, {4}));
+        auto confirmed = service.holdShowSeats(10, {2}, std::chrono::minutes(5));
+        ASSERT_TRUE(confirmed);
+        EXPECT_TRUE(service.confirmHold(*confirmed));
+    }
+
+    MovieBookingService recovered(log.path());
+    ASSERT_EQ(recovered.getShowsForTheater(1).size(), 3u);
+    EXPECT_EQ(recovered.getShowsForMovie(1)[1].startTime, 2000);
+    EXPECT_EQ(recovered.getAvailableShowSeats(10), (std::vector<int>{3, 4, 5, 6, 7}));
+    EXPECT_EQ(recovered.getAvailableShowSeats(11), (std::vector<int>{0, 1, 2, 3, 5, 6, 7}));
+    EXPECT_EQ(recovered.getAvailableShowSeats(12).size(), 8u);
+    EXPECT_EQ(recovered.getAvailableSeats(1).size(), 8u);
+}
+
+/*------------------------------------------------------*/
+// Test case for a booking batch being logged as one record
+TEST(DurableMovieBookingServiceTest, RecoversBatch) {
+    TemporaryLog log("service_batch.log");
+    {
+        MovieBookingService service(log.path());
+        service.addMovie(std::make_unique<Movie>(1, "Movie01"));
+        service.addTheater(std::make_unique<Theater>(1, "Theater01", numberedSeats(4)));
+        service.addTheater(std::make_unique<Theater>(2, "Theater02", numberedSeats(4)));
+        const auto before = readAll(log.path()).size();
+
+        const auto results = service.bookBatch({{1, 1, {0}}, {2, 2, {1, 2}}, {3, 1, {0, 3}}});
+        EXPECT_EQ(results[2].status, MovieBookingService::BookingStatus::Conflict);
+        EXPECT_EQ(readAll(log.path()).size(), before + 1);
+    }
+
+    MovieBookingService recovered(log.path());
+    EXPECT_EQ(recovered.getAvailableSeats(1), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(recovered.getAvailableSeats(2), (std::vector<int>{0, 3}));
+}
@@ -0,0 +1,104 @@
+/**
+ * @file booking_router.cpp
+ * @brief Routes booking requests to theater-partitioned servers until interrupted
+ * @author Gebremedhin Abreha
+ *
+ * Usage:
+ *   booking_router --shard <address> [--shard <address>]... [--host <ip>]
+ *                  [--port <port>] [--unix <path>] [--threads <n>]
+ *
+ * Each shard is a booking_server, addressed as host:port or by its Unix
+ * socket path; the shards must be given in the same order every time.
+ * Listens like booking_server and prints the address it listens on.
+ * SIGINT or SIGTERM stops the router.
+ */
+
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include "booking_router.hpp"
+#include "booking_server.hpp"
+
+namespace {
+
+/**
+ * @brief Print the usage message and return the failure exit code.
+ */
+int usage()
+{
+    std::cerr << "Usage:" << std::endl
+              << "  booking_router --shard <address> [--shard <address>]... [--host <ip>]" << std::endl
+              << "                 [--port <port>] [--unix <path>] [--threads <n>]" << std::endl;
+    return EXIT_FAILURE;
+}
+
+} // namespace
+
+/**
+ * @brief Tool entry point.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit code.
+ */
+int main(int argc, const char * argv[]) {
+
+    BookingServer::Options options;
+    std::vector<std::string> shards;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option = argv[i];
+        if (i + 1 == argc)
+            return usage();
+        const std::string value = argv[++i];
+        if (option == "--host")
+            options.host = value;
+        else if (option == "--port")
+            options.port = static_cast<std::uint16_t>(std::atoi(value.c_str()));
+        else if (option == "--unix")
+            options.unixPath = value;
+        else if (option == "--threads")
+            options.threads = static_cast<std::size_t>(std::atoi(value.c_str()));
+        else if (option == "--shard")
+            shards.push_back(value);
+        else
+            return usage();
+    }
+    if (shards.empty())
+        return usage();
+
+    // Block the stop signals in every thread; main waits for them below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try
+    {
+        BookingRouter router(shards);
+        BookingServer server([&router](std::string_view request, std::string& response) {
+            router.handle(request, response);
+        }, options);
+
+        if (options.unixPath.empty())
+            std::cout << "listening on " << options.host << ":" << server.port() << std::endl;
+        else
+            std::cout << "listening on " << options.unixPath << std::endl;
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "booking_router: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file booking_server.cpp
+ * @brief Serves a movie booking service over the network until interrupted
+ * @author Gebremedhin Abreha
+ *
+ * Usage:
+ *   booking_server [--host <ip>] [--port <port>] [--unix <path>] [--threads <n>]
+ *                  [--log <path>] [--catalog <catalog.csv | image>] [--replicate <records>]
+ *                  [--max-theater-seats <n>] [--allow-file-loads]
+ *   booking_server --primary <address> [--staleness <ms>] [--host <ip>] [--port <port>]
+ *                  [--unix <path>] [--threads <n>]
+ *
+ * Listens on 127.0.0.1 and a free port unless told otherwise, and prints
+ * the address it listens on. With --log the service is durable and
+ * recovers its state from the log. A catalog ending in ".csv" is loaded
+ * with CatalogLoader, any other with loadCatalogImage. With --replicate the
+ * server keeps that many log records for read replicas. Clients may only
+ * send LOAD_CATALOG and LOAD_IMAGE with --allow-file-loads, and add
+ * theaters of up to --max-theater-seats seats. With --primary it
+ * is a read replica of the server at that address (see BookingReplica),
+ * refusing reads when it has not caught up within --staleness. The
+ * protocol is described in service_protocol.hpp; SIGINT or SIGTERM stops
+ * the server.
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <pthread.h>
+
+#include "booking_replica.hpp"
+#include "booking_server.hpp"
+#include "catalog_loader.hpp"
+#include "movie_booking_service.hpp"
+#include "service_protocol.hpp"
+
+namespace {
+
+/**
+ * @brief Print the usage message and return the failure exit code.
+ */
+int usage()
+{
+    std::cerr << "Usage:" << std::endl
+              << "  booking_server [--host <ip>] [--port <port>] [--unix <path>] [--threads <n>]" << std::endl
+              << "                 [--log <path>] [--catalog <catalog.csv | image>] [--replicate <records>]" << std::endl
+              << "                 [--max-theater-seats <n>] [--allow-file-loads]" << std::endl
+              << "  booking_server --primary <address> [--staleness <ms>] [--host <ip>] [--port <port>]" << std::endl
+              << "                 [--unix <path>] [--threads <n>]" << std::endl;
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Load a catalog file into the service.
+ */
+void loadCatalog(MovieBookingService& service, const std::string& path)
+{
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".csv") == 0)
+    {
+        std::ifstream input(path);
+        if (!input)
+            throw std::runtime_error("Cannot open " + path);
+        CatalogLoader::load(input, service);
+    }
+    else if (!service.loadCatalogImage(path))
+    {
+        throw std::runtime_error("Cannot load " + path);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Tool entry point.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit code.
+ */
+int main(int argc, const char * argv[]) {
+
+    BookingServer::Options options;
+    std::string logPath;
+    std::string catalogPath;
+    std::size_t replicate = 0;
+    BookingReplica::Options replicaOptions;
+    ServiceProtocol::Options protocolOptions;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option = argv[i];
+        if (option == "--allow-file-loads")
+        {
+            protocolOptions.allowFileLoads = true;
+            continue;
+        }
+        if (i + 1 == argc)
+            return usage();
+        const std::string value = argv[++i];
+        if (option == "--host")
+            options.host = value;
+        else if (option == "--port")
+            options.port = static_cast<std::uint16_t>(std::atoi(value.c_str()));
+        else if (option == "--unix")
+            options.unixPath = value;
+        else if (option == "--threads")
+            options.threads = static_cast<std::size_t>(std::atoi(value.c_str()));
+        else if (option == "--log")
+            logPath = value;
+        else if (option == "--catalog")
+            catalogPath = value;
+        else if (option == "--replicate")
+            replicate = static_cast<std::size_t>(std::atoll(value.c_str()));
+        else if (option == "--max-theater-seats")
+            protocolOptions.maxTheaterSeats = std::atoi(value.c_str());
+        else if (option == "--primary")
+            replicaOptions.primary = value;
+        else if (option == "--staleness")
+            replicaOptions.maxStaleness = std::chrono::milliseconds(std::atoll(value.c_str()));
+        else
+            return usage();
+    }
+    if (!replicaOptions.primary.empty() && (!logPath.empty() || !catalogPath.empty() || replicate != 0))
+        return usage(); // A replica's state comes from its primary
+
+    // Block the stop signals in every thread; main waits for them below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try
+    {
+        std::unique_ptr<MovieBookingService> service;
+        std::unique_ptr<ServiceProtocol> protocol;
+        std::unique_ptr<BookingReplica> replica;
+        BookingServer::Handler handler;
+        if (replicaOptions.primary.empty())
+        {
+            service = logPath.empty() ? std::make_unique<MovieBookingService>()
+                                      : std::make_unique<MovieBookingService>(logPath);
+            if (replicate != 0)
+                service->enableReplication(replicate);
+            if (!catalogPath.empty())
+                loadCatalog(*service, catalogPath);
+            protocol = std::make_unique<ServiceProtocol>(*service, protocolOptions);
+            handler = [&protocol](std::string_view request, std::string& response) {
+                protocol->handle(request, response);
+            };
+        }
+        else
+        {
+            replica = std::make_unique<BookingReplica>(replicaOptions);
+            handler = [&replica](std::string_view request, std::string& response) {
+                replica->handle(request, response);
+            };
+        }
+
+        BookingServer server(handler, options);
+
+        if (options.unixPath.empty())
+            std::cout << "listening on " << options.host << ":" << server.port() << std::endl;
+        else
+            std::cout << "listening on " << options.unixPath << std::endl;
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "booking_server: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file catalog_tool.cpp
+ * @brief Command-line tool to produce and inspect binary catalog images
+ * @author Gebremedhin Abreha
+ *
+ * Usage:
+ *   catalog_tool generate <image> <movies> <theaters> <seatsPerTheater>
+ *   catalog_tool import <catalog.csv> <image>
+ *   catalog_tool info <image>
+ *
+ * generate writes a synthetic catalog in which every theater has the same
+ * seat layout (stored once) and theaters are allocated to movies round-robin.
+ * import converts a line-delimited catalog (see CatalogLoader); movies and
+ * theaters are paired in ID order and left-over theaters allocated
+ * round-robin.
+ */
+
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catalog_image.hpp"
+#include "catalog_loader.hpp"
+#include "seat.hpp"
+
+namespace {
+
+/**
+ * @brief Print the usage message and return the failure exit code.
+ */
+int usage()
+{
+    std::cerr << "Usage:" << std::endl
+              << "  catalog_tool generate <image> <movies> <theaters> <seatsPerTheater>" << std::endl
+              << "  catalog_tool import <catalog.csv> <image>" << std::endl
+              << "  catalog_tool info <image>" << std::endl;
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Write a synthetic catalog image.
+ */
+void generate(const std::string& path, int movieCount, int theaterCount, int seatCapacity)
+{
+    const auto seats = numberedSeats(seatCapacity);
+
+    CatalogImageWriter writer;
+    for (int id = 1; id <= movieCount; ++id)
+    {
+        writer.addMovie(id, "Movie" + std::to_string(id));
+    }
+    for (int id = 1; id <= theaterCount; ++id)
+    {
+        writer.addTheater(id, "Theater" + std::to_string(id), seats);
+        if (movieCount > 0)
+            writer.addAllocation((id - 1) % movieCount + 1, id);
+    }
+    writer.write(path);
+}
+
+/**
+ * @brief Convert a line-delimited catalog into an image.
+ */
+void import(const std::string& catalogPath, const std::string& path)
+{
+    std::ifstream input(catalogPath);
+    if (!input)
+        throw std::runtime_error("Cannot open " + catalogPath);
+
+    CatalogImageWriter writer;
+    std::set<int> movies;
+    std::set<int> theaters;
+    CatalogLoader::parse(input,
+                         [&](int id, const std::string& name) {
+                             if (movies.insert(id).second)
+                                 writer.addMovie(id, name);
+                         },
+                         [&](int id, const std::string& name, const std::vector<Seat>& seats) {
+                             if (theaters.insert(id).second)
+                                 writer.addTheater(id, name, seats);
+                         });
+
+    if (movies.empty())
+    {
+        writer.write(path);
+        return;
+    }
+
+    auto movie = movies.begin();
+    for (const auto theaterId : theaters)
+    {
+        writer.addAllocation(*movie, theaterId);
+        if (++movie == movies.end())
+            movie = movies.begin();
+    }
+    writer.write(path);
+}
+
+/**
+ * @brief Print a summary of a catalog image.
+ */
+void info(const std::string& path)
+{
+    const CatalogImage image(path);
+
+    std::size_t seatCount = 0;
+    for (std::size_t i = 0; i < image.theaterCount(); ++i)
+    {
+        seatCount += image.theater(i).seatCount;
+    }
+
+    std::cout << "movies:      " << image.movieCount() << std::endl;
+    std::cout << "theaters:    " << image.theaterCount() << std::endl;
+    std::cout << "seats:       " << seatCount << std::endl;
+    std::cout << "allocations: " << image.allocationCount() << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief Tool entry point.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit code.
+ */
+int main(int argc, const char * argv[]) {
+
+    if (argc < 3)
+        return usage();
+
+    const std::string command = argv[1];
+    try
+    {
+        if (command == "generate" && argc == 6)
+        {
+            generate(argv[2], std::atoi(argv[3]), std::atoi(argv[4]), std::atoi(argv[5]));
+        }
+        else if (command == "import" && argc == 4)
+        {
+            import(argv[2], argv[3]);
+        }
+        else if (command == "info" && argc == 3)
+        {
+            info(argv[2]);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "catalog_tool: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}